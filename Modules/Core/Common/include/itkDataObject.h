@@ -453,6 +453,12 @@ public:
    * need regions (for instance itk::EquivalencyTable). */
   virtual bool VerifyRequestedRegion() { return true; }
 
+  /** Estimate the number of bytes needed to hold the bulk data of the
+   * RequestedRegion. This is used to plan streaming under a memory
+   * budget (see PipelineMemoryEstimator). The default implementation
+   * returns 0, which means that the size is unknown. */
+  virtual SizeValueType GetRequestedRegionMemorySize() const { return 0; }
+
   /** Copy information from the specified data set.  This method is
    * part of the pipeline execution model. By default, a ProcessObject
    * will copy meta-data from the first input to all of its
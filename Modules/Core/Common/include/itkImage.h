@@ -277,6 +277,9 @@ public:
 
   virtual unsigned int GetNumberOfComponentsPerPixel() const;
 
+  /** Number of bytes needed to hold the pixels of the RequestedRegion. */
+  virtual SizeValueType GetRequestedRegionMemorySize() const;
+
 protected:
   Image();
   void PrintSelf(std::ostream & os, Indent indent) const;
@@ -161,6 +161,15 @@ Image< TPixel, VImageDimension >
   return NumericTraits< PixelType >::GetLength(p);
 }
 
+template< class TPixel, unsigned int VImageDimension >
+typename Image< TPixel, VImageDimension >::SizeValueType
+Image< TPixel, VImageDimension >
+::GetRequestedRegionMemorySize() const
+{
+  return static_cast< SizeValueType >( this->GetRequestedRegion().GetNumberOfPixels() )
+         * sizeof( PixelType );
+}
+
 /**
  *
  */
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferAllocator_h
+#define __itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Abstract allocator of the raw memory of image buffers.
+ *
+ * An ImportImageContainer allocates its elements with the
+ * ImageBufferAllocator set with SetAllocator(), or with new[] when it has
+ * none. Containers are created with the global default allocator, which
+ * is NULL unless SetGlobalDefault() has been called, so by default image
+ * buffers are allocated with new[] as before.
+ *
+ * Subclasses implement Allocate() and Deallocate(). The memory returned
+ * by Allocate() is raw; the container constructs and destroys the
+ * elements itself.
+ *
+ * \sa PooledImageBufferAllocator
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferAllocator       Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Allocate numberOfBytes bytes of raw memory. Throws a
+   * MemoryAllocationError on failure. Must be thread safe. */
+  virtual void * Allocate(SizeValueType numberOfBytes) = 0;
+
+  /** Release a block returned by Allocate(numberOfBytes). Must be thread
+   * safe. */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes) = 0;
+
+  /** Number of bytes currently handed out by Allocate() and not yet
+   * deallocated. */
+  virtual SizeValueType GetAllocatedMemory() const { return 0; }
+
+  /** Number of bytes held by the allocator for later reuse. */
+  virtual SizeValueType GetCachedMemory() const { return 0; }
+
+  /** Set/Get the allocator used by the ImportImageContainers created from
+   * now on. NULL (the default) selects new[]. */
+  static void SetGlobalDefault(ImageBufferAllocator *allocator);
+
+  static Pointer GetGlobalDefault();
+
+protected:
+  ImageBufferAllocator() {}
+  virtual ~ImageBufferAllocator() {}
+
+private:
+  ImageBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+
+  static Pointer m_GlobalDefault;
+};
+} // end namespace itk
+
+#endif
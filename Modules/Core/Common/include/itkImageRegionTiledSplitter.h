@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegionTiledSplitter_h
+#define __itkImageRegionTiledSplitter_h
+
+#include "itkImageRegionSplitter.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+/** \class ImageRegionTiledSplitter
+ * \brief Divide a region into cache-sized tiles.
+ *
+ * ImageRegionTiledSplitter divides an ImageRegion into rectangular tiles
+ * small enough for the data a filter touches while processing one tile to
+ * stay in the cache. The tiles are ordered with the first dimension
+ * varying fastest, so that consecutive pieces are adjacent in memory.
+ *
+ * The tile size is either given explicitly with SetTileSize(), or derived
+ * from the CacheSize, the BytesPerPixel touched by the filter (typically
+ * the sum of the input and output pixel sizes) and the Radius of the
+ * neighborhood the filter reads around each output pixel: the tile is
+ * shrunk, halving its largest dimension, until the tile enlarged by the
+ * radius on each side fits in the cache. The first dimension, along which
+ * pixels are contiguous in memory, is only cut once all the other
+ * dimensions have been reduced to a single pixel.
+ *
+ * When the region contains more tiles than the requested number of
+ * pieces, neighboring tiles are merged, along the dimension with the most
+ * tiles first, until the number of pieces does not exceed the request.
+ * To benefit from cache-sized tiles in a multi-threaded filter, request
+ * many pieces per thread (see ImageSource::SetDynamicMultiThreading() and
+ * ImageSource::SetNumberOfPiecesPerThread()).
+ *
+ * ImageRegionTiledSplitter can be used by StreamingImageFilter and by
+ * ImageSource (see ImageSource::SetRegionSplitter()).
+ *
+ * \sa ImageRegionSplitter ImageRegionMultidimensionalSplitter
+ *
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+
+template< unsigned int VImageDimension >
+class ITK_EXPORT ImageRegionTiledSplitter:public ImageRegionSplitter< VImageDimension >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageRegionTiledSplitter               Self;
+  typedef ImageRegionSplitter< VImageDimension > Superclass;
+  typedef SmartPointer< Self >                   Pointer;
+  typedef SmartPointer< const Self >             ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageRegionTiledSplitter, ImageRegionSplitter);
+
+  /** Dimension of the image available at compile time. */
+  itkStaticConstMacro(ImageDimension, unsigned int, VImageDimension);
+
+  /** Index typedef support. An index is used to access pixel values. */
+  typedef typename Superclass::IndexType     IndexType;
+
+  /** Size typedef support. A size is used to define region bounds. */
+  typedef typename Superclass::SizeType      SizeType;
+  typedef typename Superclass::SizeValueType SizeValueType;
+
+  /** Region typedef support.   */
+  typedef typename Superclass::RegionType RegionType;
+
+  /** Set/Get the size of the tiles. When any of its components is 0, the
+   * default, the tile size is computed from the CacheSize, the
+   * BytesPerPixel and the Radius. */
+  itkSetMacro(TileSize, SizeType);
+  itkGetConstReferenceMacro(TileSize, SizeType);
+
+  /** Set/Get the number of bytes of cache a tile, enlarged by the Radius,
+   * should fit in. Defaults to 256 KiB, the size of a typical per-core
+   * level 2 cache. */
+  itkSetClampMacro(CacheSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(CacheSize, SizeValueType);
+
+  /** Set/Get the number of bytes touched per pixel of a tile. Defaults
+   * to 8, e.g. a float input and a float output. */
+  itkSetClampMacro(BytesPerPixel, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BytesPerPixel, SizeValueType);
+
+  /** Set/Get the radius of the neighborhood read around each pixel. The
+   * tiles are sized so that they fit in the cache together with this
+   * overlap with their neighbors. Defaults to 0. */
+  itkSetMacro(Radius, SizeType);
+  itkGetConstReferenceMacro(Radius, SizeType);
+
+  /** How many pieces can the specifed region be split? This is the number
+   * of tiles in the region, or less when the requested number of pieces
+   * is smaller. */
+  virtual unsigned int GetNumberOfSplits(const RegionType & region,
+                                         unsigned int requestedNumber);
+
+  /** Get a region definition that represents the ith piece a specified region.
+   * The "numberOfPieces" must be equal to what
+   * GetNumberOfSplits() returns. */
+  virtual RegionType GetSplit(unsigned int i, unsigned int numberOfPieces,
+                              const RegionType & region);
+
+  /** Return the size of the tiles the region is divided in, before tiles
+   * are merged to honor the requested number of pieces. */
+  SizeType ComputeTileSize(const RegionType & region) const;
+
+protected:
+  ImageRegionTiledSplitter();
+  ~ImageRegionTiledSplitter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ImageRegionTiledSplitter(const Self &); //purposely not implemented
+  void operator=(const Self &);           //purposely not implemented
+
+  /** Compute the size of the pieces and the number of pieces along each
+   * dimension for a request of requestedNumber pieces. Returns the total
+   * number of pieces. */
+  unsigned int ComputeSplits(const RegionType & region,
+                             unsigned int requestedNumber,
+                             SizeType & pieceSize,
+                             SizeType & numberOfPieces) const;
+
+  SizeType      m_TileSize;
+  SizeValueType m_CacheSize;
+  SizeValueType m_BytesPerPixel;
+  SizeType      m_Radius;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageRegionTiledSplitter.hxx"
+#endif
+
+#endif
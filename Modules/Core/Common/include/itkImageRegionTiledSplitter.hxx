@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegionTiledSplitter_hxx
+#define __itkImageRegionTiledSplitter_hxx
+
+#include "itkImageRegionTiledSplitter.h"
+#include <algorithm>
+
+namespace itk
+{
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+ImageRegionTiledSplitter< VImageDimension >
+::ImageRegionTiledSplitter()
+{
+  m_TileSize.Fill(0);
+  m_CacheSize = 256 * 1024;
+  m_BytesPerPixel = 8;
+  m_Radius.Fill(0);
+}
+
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+typename ImageRegionTiledSplitter< VImageDimension >::SizeType
+ImageRegionTiledSplitter< VImageDimension >
+::ComputeTileSize(const RegionType & region) const
+{
+  const SizeType & regionSize = region.GetSize();
+  SizeType         tileSize;
+  unsigned int     i;
+
+  bool explicitTileSize = true;
+  for ( i = 0; i < VImageDimension; ++i )
+    {
+    if ( m_TileSize[i] == 0 )
+      {
+      explicitTileSize = false;
+      }
+    }
+
+  if ( explicitTileSize )
+    {
+    for ( i = 0; i < VImageDimension; ++i )
+      {
+      tileSize[i] = std::max( std::min(m_TileSize[i], regionSize[i]),
+                              static_cast< SizeValueType >( 1 ) );
+      }
+    return tileSize;
+    }
+
+  for ( i = 0; i < VImageDimension; ++i )
+    {
+    tileSize[i] = std::max( regionSize[i], static_cast< SizeValueType >( 1 ) );
+    }
+
+  while ( true )
+    {
+    // bytes touched when processing the tile, including the overlap with
+    // the neighboring tiles
+    double footprint = static_cast< double >( m_BytesPerPixel );
+    for ( i = 0; i < VImageDimension; ++i )
+      {
+      footprint *= static_cast< double >( tileSize[i] + 2 * m_Radius[i] );
+      }
+    if ( footprint <= static_cast< double >( m_CacheSize ) )
+      {
+      return tileSize;
+      }
+
+    // halve the largest of the outer dimensions, and the first one only
+    // when all the others are reduced to a single pixel
+    unsigned int cutDim = 0;
+    for ( i = VImageDimension - 1; i > 0; --i )
+      {
+      if ( tileSize[i] > 1 && ( cutDim == 0 || tileSize[i] > tileSize[cutDim] ) )
+        {
+        cutDim = i;
+        }
+      }
+    if ( tileSize[cutDim] == 1 )
+      {
+      // even a single pixel does not fit
+      return tileSize;
+      }
+    tileSize[cutDim] = ( tileSize[cutDim] + 1 ) / 2;
+    }
+}
+
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+unsigned int
+ImageRegionTiledSplitter< VImageDimension >
+::ComputeSplits(const RegionType & region,
+                unsigned int requestedNumber,
+                SizeType & pieceSize,
+                SizeType & numberOfPieces) const
+{
+  const SizeType & regionSize = region.GetSize();
+  const SizeType   tileSize = this->ComputeTileSize(region);
+  SizeType         tilesPerPiece;
+  unsigned int     i;
+
+  if ( requestedNumber < 1 )
+    {
+    requestedNumber = 1;
+    }
+
+  SizeValueType totalNumberOfPieces = 1;
+  for ( i = 0; i < VImageDimension; ++i )
+    {
+    tilesPerPiece[i] = 1;
+    pieceSize[i] = tileSize[i];
+    numberOfPieces[i] = std::max( ( regionSize[i] + pieceSize[i] - 1 ) / pieceSize[i],
+                                  static_cast< SizeValueType >( 1 ) );
+    totalNumberOfPieces *= numberOfPieces[i];
+    }
+
+  // merge neighboring tiles along the dimension with the most pieces until
+  // the request is honored
+  while ( totalNumberOfPieces > requestedNumber )
+    {
+    unsigned int mergeDim = VImageDimension - 1;
+    for ( i = VImageDimension - 1; i > 0; --i )
+      {
+      if ( numberOfPieces[i - 1] > numberOfPieces[mergeDim] )
+        {
+        mergeDim = i - 1;
+        }
+      }
+
+    totalNumberOfPieces /= numberOfPieces[mergeDim];
+    ++tilesPerPiece[mergeDim];
+    pieceSize[mergeDim] = std::min(tilesPerPiece[mergeDim] * tileSize[mergeDim],
+                                   regionSize[mergeDim]);
+    numberOfPieces[mergeDim] = ( regionSize[mergeDim] + pieceSize[mergeDim] - 1 ) / pieceSize[mergeDim];
+    totalNumberOfPieces *= numberOfPieces[mergeDim];
+    }
+
+  return static_cast< unsigned int >( totalNumberOfPieces );
+}
+
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+unsigned int
+ImageRegionTiledSplitter< VImageDimension >
+::GetNumberOfSplits(const RegionType & region, unsigned int requestedNumber)
+{
+  SizeType pieceSize;
+  SizeType numberOfPieces;
+
+  return this->ComputeSplits(region, requestedNumber, pieceSize, numberOfPieces);
+}
+
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+typename ImageRegionTiledSplitter< VImageDimension >::RegionType
+ImageRegionTiledSplitter< VImageDimension >
+::GetSplit(unsigned int i, unsigned int numberOfPieces,
+           const RegionType & region)
+{
+  SizeType pieceSize;
+  SizeType piecesPerDimension;
+
+  const unsigned int actualNumberOfPieces =
+    this->ComputeSplits(region, numberOfPieces, pieceSize, piecesPerDimension);
+  if ( numberOfPieces != actualNumberOfPieces )
+    {
+    itkExceptionMacro( "numberOfPieces did not match GetNumberOfSplits. Expected: "
+                       << numberOfPieces << " but got "
+                       << actualNumberOfPieces );
+    }
+
+  IndexType splitIndex = region.GetIndex();
+  SizeType  splitSize;
+
+  // the first dimension varies fastest
+  SizeValueType offset = i;
+  for ( unsigned int d = 0; d < VImageDimension; ++d )
+    {
+    const SizeValueType pieceIndex = offset % piecesPerDimension[d];
+    offset /= piecesPerDimension[d];
+
+    const SizeValueType start = pieceIndex * pieceSize[d];
+    splitIndex[d] += static_cast< IndexValueType >( start );
+    splitSize[d] = std::min(pieceSize[d], region.GetSize(d) - start);
+    }
+
+  RegionType splitRegion(splitIndex, splitSize);
+
+  itkDebugMacro("  Split Piece: " << std::endl << splitRegion);
+
+  return splitRegion;
+}
+
+/**
+ *
+ */
+template< unsigned int VImageDimension >
+void
+ImageRegionTiledSplitter< VImageDimension >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+  os << indent << "CacheSize: " << m_CacheSize << std::endl;
+  os << indent << "BytesPerPixel: " << m_BytesPerPixel << std::endl;
+  os << indent << "Radius: " << m_Radius << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -30,9 +30,17 @@
 
 #include "itkProcessObject.h"
 #include "itkImage.h"
+#include "itkWorkStealingQueue.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkImageSourceCommon.h"
+#include "itkImageRegionSplitter.h"
+#include <vector>
 
 namespace itk
 {
+template< typename TPixelType, unsigned int VImageDimension >
+class VectorImage;
+
 /** \class ImageSource
  *  \brief Base class for all process objects that output image data.
  *
@@ -53,6 +61,38 @@ namespace itk
  * ProcessObject::ReleaseDataBeforeUpdateFlagOn().  A user may want to
  * set this flag to limit peak memory usage during a pipeline update.
  *
+ * By default, the output requested region is split into one piece per
+ * thread and each thread calls ThreadedGenerateData() once. When
+ * DynamicMultiThreading is on, the region is instead split into
+ * NumberOfPiecesPerThread pieces per thread, which the threads pull from a
+ * shared WorkStealingQueue, so a thread that finishes early helps with the
+ * remaining work. This balances filters whose cost per pixel is uneven.
+ * ThreadedGenerateData() is then called several times per thread, with
+ * the same threadId, so the mode is only used by filters that declare they
+ * support it by overriding CanRunDynamicMultiThreading(); the others keep
+ * the one piece per thread split.
+ *
+ * On NUMA systems, a page of memory is placed on the node of the thread
+ * that first writes to it. When FirstTouchAllocation is on,
+ * AllocateOutputs() has each thread write the part of a newly allocated
+ * output buffer that SplitRequestedRegion() assigns to it, so that the
+ * pages of every piece end up local to the thread that later processes
+ * it. This is most effective together with
+ * MultiThreader::SetGlobalDefaultUseThreadAffinity(), which keeps each
+ * thread on the same processor. The first touch is an extra threaded pass
+ * over the new buffer, before BeforeThreadedGenerateData(), which writes
+ * default-constructed pixels (TElement()) in it. It is skipped for buffers
+ * whose memory is reused (see ReleaseDataBeforeUpdateFlag) and for outputs
+ * which InPlaceImageFilter grafts from the input, since their pages are
+ * already placed and their content must be kept. FirstTouchAllocation is
+ * off by default.
+ *
+ * SplitRequestedRegion() divides the output requested region in slabs
+ * along the outermost dimension. A RegionSplitter can be set instead, for
+ * instance an ImageRegionTiledSplitter which divides the region in
+ * cache-sized tiles; subclasses which override SplitRequestedRegion()
+ * ignore it.
+ *
  * \ingroup DataSources
  * \ingroup ITKCommon
  *
@@ -89,6 +129,10 @@ public:
   itkStaticConstMacro(OutputImageDimension, unsigned int,
                       TOutputImage::ImageDimension);
 
+  /** Type of the helper class which can divide the output requested
+   * region in pieces. */
+  typedef ImageRegionSplitter< itkGetStaticConstMacro(OutputImageDimension) > RegionSplitterType;
+
   /** Get the output data of this process object.  The output of this
    * function is not valid until an appropriate Update() method has
    * been called, either explicitly or implicitly.  Both the filter
@@ -209,9 +253,46 @@ public:
   using Superclass::MakeOutput;
   virtual ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx);
 
+  /** Set/Get whether the threads of GenerateData() pull many small pieces
+   * of the output region from a work-stealing queue instead of processing
+   * exactly one piece each. Off by default. The setting is effective only
+   * if CanRunDynamicMultiThreading() also returns true. */
+  itkSetMacro(DynamicMultiThreading, bool);
+  itkGetConstMacro(DynamicMultiThreading, bool);
+  itkBooleanMacro(DynamicMultiThreading);
+
+  /** Can ThreadedGenerateData() be called several times per thread, with
+   * the same threadId? Filters whose ThreadedGenerateData() only writes
+   * the output region it is given, and does not keep results indexed by
+   * threadId, override this method to return true. False by default. */
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return false;
+  }
+
+  /** Set/Get the number of pieces per thread the output region is split
+   * into when DynamicMultiThreading is on. The actual number of pieces may
+   * be smaller if SplitRequestedRegion() cannot split that finely. */
+  itkSetClampMacro(NumberOfPiecesPerThread, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfPiecesPerThread, unsigned int);
+
+  /** Set/Get whether AllocateOutputs() first-touches newly allocated output
+   * buffers from the threads that will process them. The default is
+   * ImageSourceCommon::GetGlobalDefaultFirstTouchAllocation(). */
+  itkSetMacro(FirstTouchAllocation, bool);
+  itkGetConstMacro(FirstTouchAllocation, bool);
+  itkBooleanMacro(FirstTouchAllocation);
+
+  /** Set/Get the helper class used by SplitRequestedRegion() to divide the
+   * output requested region. When NULL, the default, the region is divided
+   * in slabs along its outermost dimension. */
+  itkSetObjectMacro(RegionSplitter, RegionSplitterType);
+  itkGetObjectMacro(RegionSplitter, RegionSplitterType);
+
 protected:
   ImageSource();
   virtual ~ImageSource() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** A version of GenerateData() specific for image processing
    * filters.  This implementation will split the processing across
@@ -263,6 +344,14 @@ protected:
    * grafting its input to its output. */
   virtual void AllocateOutputs();
 
+  /** Write, from multiple threads, the given output buffers so that each
+   * thread first-touches the region SplitRequestedRegion() assigns to it.
+   * Every pixel of those regions is set to its default value, in a
+   * SingleMethodExecute() of its own. Called by AllocateOutputs() when
+   * FirstTouchAllocation is on, only for the outputs that received a new
+   * buffer: reused buffers and outputs run in place are not passed. */
+  virtual void FirstTouchOutputs(const std::vector< OutputImageType * > & outputs);
+
   /** If an imaging filter needs to perform processing after the buffer
    * has been allocated but before threads are spawned, the filter can
    * can provide an implementation for BeforeThreadedGenerateData(). The
@@ -291,7 +380,8 @@ protected:
    * region "i" as "splitRegion". This method is called "num" times. The
    * regions must not overlap. The method returns the number of pieces that
    * the routine is capable of splitting the output RequestedRegion,
-   * i.e. return value is less than or equal to "num". */
+   * i.e. return value is less than or equal to "num". The RegionSplitter
+   * is used when one is set. */
   virtual
   unsigned int SplitRequestedRegion(unsigned int i, unsigned int num, OutputImageRegionType & splitRegion);
 
@@ -306,9 +396,93 @@ protected:
     Pointer Filter;
   };
 
+  /** Get the progress a ThreadedGenerateData() call on region starts from,
+   * and the share of the whole progress it accounts for, to construct its
+   * ProgressReporter with. They are 0 and 1 when each thread processes one
+   * piece. When DynamicMultiThreading is on, they follow the pixels of the
+   * output requested region that all the threads have already generated, so
+   * the progress does not restart with every piece. */
+  void GetProgressOfRegion(const OutputImageRegionType & region,
+                           float & initialProgress, float & progressWeight);
+
+  /** Static function used as a "callback" by the MultiThreader when
+   * DynamicMultiThreading is on. Each thread calls ThreadedGenerateData()
+   * for the pieces it gets from the work-stealing queue. */
+  static ITK_THREAD_RETURN_TYPE DynamicThreaderCallback(void *arg);
+
+  /** Internal structure used for passing the pieces and the queue to the
+   * threads when DynamicMultiThreading is on. */
+  struct DynamicThreadStruct {
+    Pointer Filter;
+    WorkStealingQueue *Queue;
+    const std::vector< OutputImageRegionType > *Pieces;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader to
+   * first-touch the output buffers. */
+  static ITK_THREAD_RETURN_TYPE FirstTouchThreaderCallback(void *arg);
+
+  /** Internal structure used for passing the outputs to first-touch to the
+   * threads. */
+  struct FirstTouchThreadStruct {
+    Pointer Filter;
+    const std::vector< OutputImageType * > *Outputs;
+  };
+
 private:
   ImageSource(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  /** Overloads returning the capacity of the buffer of an image, and
+   * writing the elements of a region of that buffer. Only Image and
+   * VectorImage expose their buffer; other output types (e.g. LabelMap)
+   * are never first-touched. */
+  template< class TImage >
+  static SizeValueType GetBufferCapacity(TImage *) { return 0; }
+
+  template< class TPixel, unsigned int VDimension >
+  static SizeValueType GetBufferCapacity(Image< TPixel, VDimension > *image)
+  {
+    return image->GetPixelContainer() ? image->GetPixelContainer()->Capacity() : 0;
+  }
+
+  template< class TPixel, unsigned int VDimension >
+  static SizeValueType GetBufferCapacity(VectorImage< TPixel, VDimension > *image)
+  {
+    return image->GetPixelContainer() ? image->GetPixelContainer()->Capacity() : 0;
+  }
+
+  template< class TImage >
+  static void FirstTouchRegion(TImage *, const OutputImageRegionType &) {}
+
+  template< class TPixel, unsigned int VDimension >
+  static void FirstTouchRegion(Image< TPixel, VDimension > *image, const OutputImageRegionType & region)
+  {
+    FirstTouchBuffer(image->GetBufferPointer(), 1, image, region);
+  }
+
+  template< class TPixel, unsigned int VDimension >
+  static void FirstTouchRegion(VectorImage< TPixel, VDimension > *image, const OutputImageRegionType & region)
+  {
+    FirstTouchBuffer(image->GetBufferPointer(), image->GetNumberOfComponentsPerPixel(), image, region);
+  }
+
+  template< class TElement >
+  static void FirstTouchBuffer(TElement *buffer, SizeValueType numberOfComponents,
+                               const ImageBase< OutputImageDimension > *image,
+                               const OutputImageRegionType & region);
+
+  bool         m_DynamicMultiThreading;
+  unsigned int m_NumberOfPiecesPerThread;
+
+  /** Pixels to generate and already generated by the pieces of the
+   * dynamic execution in progress; both 0 outside of it. */
+  SizeValueType       m_NumberOfPixelsToGenerate;
+  SizeValueType       m_NumberOfGeneratedPixels;
+  SimpleFastMutexLock m_GeneratedPixelsLock;
+  bool         m_FirstTouchAllocation;
+
+  typename RegionSplitterType::Pointer m_RegionSplitter;
 };
 } // end namespace itk
 
@@ -33,6 +33,8 @@
 
 #include "vnl/vnl_math.h"
 
+#include <algorithm>
+
 namespace itk
 {
 /**
@@ -40,7 +42,12 @@ namespace itk
  */
 template< class TOutputImage >
 ImageSource< TOutputImage >
-::ImageSource()
+::ImageSource():
+  m_DynamicMultiThreading(false),
+  m_NumberOfPiecesPerThread(8),
+  m_NumberOfPixelsToGenerate(0),
+  m_NumberOfGeneratedPixels(0),
+  m_FirstTouchAllocation( ImageSourceCommon::GetGlobalDefaultFirstTouchAllocation() )
 {
   // Create the output. We use static_cast<> here because we know the default
   // output must be of type TOutputImage
@@ -166,6 +173,23 @@ ImageSource< TOutputImage >
   // Get the output pointer
   OutputImageType *outputPtr = this->GetOutput();
 
+  if ( m_RegionSplitter )
+    {
+    const OutputImageRegionType & requestedRegion = outputPtr->GetRequestedRegion();
+    const unsigned int numberOfPieces =
+      m_RegionSplitter->GetNumberOfSplits(requestedRegion, num);
+    if ( i < numberOfPieces )
+      {
+      splitRegion = m_RegionSplitter->GetSplit(i, numberOfPieces, requestedRegion);
+      }
+    else
+      {
+      splitRegion = requestedRegion;
+      }
+    itkDebugMacro("  Split Piece: " << splitRegion);
+    return numberOfPieces;
+    }
+
   const typename TOutputImage::SizeType & requestedRegionSize =
     outputPtr->GetRequestedRegion().GetSize();
 
@@ -226,6 +250,9 @@ ImageSource< TOutputImage >
   typedef ImageBase< OutputImageDimension > ImageBaseType;
   typename ImageBaseType::Pointer outputPtr;
 
+  // Outputs that received a new buffer, to be first-touched
+  std::vector< OutputImageType * > newlyAllocatedOutputs;
+
   // Allocate the output memory
   for ( OutputDataObjectIterator it(this); !it.IsAtEnd(); it++ )
     {
@@ -238,8 +265,81 @@ ImageSource< TOutputImage >
 
     if ( outputPtr )
       {
+      // The buffer may be reused (see ReleaseDataBeforeUpdateFlag), in
+      // which case its pages are already placed.
+      OutputImageType *   image = dynamic_cast< OutputImageType * >( it.GetOutput() );
+      const SizeValueType previousCapacity = image ? GetBufferCapacity(image) : 0;
+
       outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
       outputPtr->Allocate();
+
+      if ( image && GetBufferCapacity(image) > previousCapacity )
+        {
+        newlyAllocatedOutputs.push_back(image);
+        }
+      }
+    }
+
+  if ( m_FirstTouchAllocation && !newlyAllocatedOutputs.empty() )
+    {
+    this->FirstTouchOutputs(newlyAllocatedOutputs);
+    }
+}
+
+//----------------------------------------------------------------------------
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::FirstTouchOutputs(const std::vector< OutputImageType * > & outputs)
+{
+  FirstTouchThreadStruct str;
+  str.Filter = this;
+  str.Outputs = &outputs;
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->FirstTouchThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+template< class TOutputImage >
+template< class TElement >
+void
+ImageSource< TOutputImage >
+::FirstTouchBuffer(TElement *buffer, SizeValueType numberOfComponents,
+                   const ImageBase< OutputImageDimension > *image,
+                   const OutputImageRegionType & region)
+{
+  if ( buffer == 0 || region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  // Write the region line by line; the lines along the first axis are
+  // contiguous in memory whatever the axis the region was split along.
+  const SizeValueType lineLength = region.GetSize(0) * numberOfComponents;
+  const TElement      value = TElement();
+
+  typename OutputImageRegionType::IndexType index = region.GetIndex();
+  while ( true )
+    {
+    TElement *line = buffer + image->ComputeOffset(index) * numberOfComponents;
+    std::fill(line, line + lineLength, value);
+
+    // Move to the next line
+    unsigned int dim = 1;
+    for (; dim < OutputImageDimension; ++dim )
+      {
+      ++index[dim];
+      if ( index[dim] < region.GetIndex(dim) + static_cast< OffsetValueType >( region.GetSize(dim) ) )
+        {
+        break;
+        }
+      index[dim] = region.GetIndex(dim);
+      }
+    if ( dim >= OutputImageDimension )
+      {
+      break;
       }
     }
 }
@@ -260,20 +360,104 @@ ImageSource< TOutputImage >
   this->BeforeThreadedGenerateData();
 
   // Set up the multithreaded processing
-  ThreadStruct str;
-  str.Filter = this;
-
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
 
-  // multithread the execution
-  this->GetMultiThreader()->SingleMethodExecute();
+  if ( m_DynamicMultiThreading && this->CanRunDynamicMultiThreading() )
+    {
+    // Split the requested region into many pieces up front, with the
+    // (possibly overridden) SplitRequestedRegion(), and let the threads
+    // pull them from a work-stealing queue.
+    const ThreadIdType numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+    const unsigned int numberOfRequestedPieces = numberOfThreads * m_NumberOfPiecesPerThread;
+
+    OutputImageRegionType firstPiece;
+    const unsigned int    numberOfPieces =
+      this->SplitRequestedRegion(0, numberOfRequestedPieces, firstPiece);
+
+    std::vector< OutputImageRegionType > pieces(numberOfPieces);
+    pieces[0] = firstPiece;
+    for ( unsigned int i = 1; i < numberOfPieces; ++i )
+      {
+      this->SplitRequestedRegion(i, numberOfRequestedPieces, pieces[i]);
+      }
+
+    WorkStealingQueue queue;
+    queue.Initialize(numberOfThreads, numberOfPieces);
+
+    DynamicThreadStruct str;
+    str.Filter = this;
+    str.Queue = &queue;
+    str.Pieces = &pieces;
+
+    // The progress is reported over the whole requested region, not over
+    // each piece; see GetProgressOfRegion().
+    m_NumberOfPixelsToGenerate = 0;
+    for ( unsigned int i = 0; i < numberOfPieces; ++i )
+      {
+      m_NumberOfPixelsToGenerate += pieces[i].GetNumberOfPixels();
+      }
+    m_NumberOfGeneratedPixels = 0;
+
+    this->GetMultiThreader()->SetSingleMethod(this->DynamicThreaderCallback, &str);
+
+    // multithread the execution
+    try
+      {
+      this->GetMultiThreader()->SingleMethodExecute();
+      }
+    catch ( ... )
+      {
+      m_NumberOfPixelsToGenerate = 0;
+      m_NumberOfGeneratedPixels = 0;
+      throw;
+      }
+    m_NumberOfPixelsToGenerate = 0;
+    m_NumberOfGeneratedPixels = 0;
+    }
+  else
+    {
+    ThreadStruct str;
+    str.Filter = this;
+
+    this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+
+    // multithread the execution
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
 
   // Call a method that can be overridden by a subclass to perform
   // some calculations after all the threads have completed
   this->AfterThreadedGenerateData();
 }
 
+//----------------------------------------------------------------------------
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::GetProgressOfRegion(const OutputImageRegionType & region,
+                      float & initialProgress, float & progressWeight)
+{
+  m_GeneratedPixelsLock.Lock();
+  const SizeValueType numberOfPixelsToGenerate = m_NumberOfPixelsToGenerate;
+  const SizeValueType numberOfGeneratedPixels = m_NumberOfGeneratedPixels;
+  m_GeneratedPixelsLock.Unlock();
+
+  if ( numberOfPixelsToGenerate == 0 )
+    {
+    initialProgress = 0.0f;
+    progressWeight = 1.0f;
+    return;
+    }
+
+  // The pixels of the pieces generated so far by all the threads, including
+  // the previous pieces of the calling thread, so the progress reported by
+  // thread 0 never goes backwards.
+  initialProgress = static_cast< float >( static_cast< double >( numberOfGeneratedPixels )
+                                          / numberOfPixelsToGenerate );
+  progressWeight = static_cast< float >( static_cast< double >( region.GetNumberOfPixels() )
+                                         / numberOfPixelsToGenerate );
+}
+
 //----------------------------------------------------------------------------
 // The execute method created by the subclass.
 template< class TOutputImage >
@@ -331,6 +515,85 @@ ImageSource< TOutputImage >
 
   return ITK_THREAD_RETURN_VALUE;
 }
+
+// Callback routine used by the threading library when DynamicMultiThreading
+// is on. This routine calls ThreadedGenerateData for each piece the thread
+// gets from the work-stealing queue, until all the pieces are processed.
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::DynamicThreaderCallback(void *arg)
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+
+  DynamicThreadStruct *str =
+    (DynamicThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  unsigned int piece;
+  while ( str->Queue->GetNextPiece(threadId, piece) )
+    {
+    str->Filter->ThreadedGenerateData( ( *str->Pieces )[piece], threadId );
+
+    str->Filter->m_GeneratedPixelsLock.Lock();
+    str->Filter->m_NumberOfGeneratedPixels += ( *str->Pieces )[piece].GetNumberOfPixels();
+    str->Filter->m_GeneratedPixelsLock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Callback routine used by the threading library to first-touch the output
+// buffers. Each thread writes, in every output, the region the regular
+// threaded execution will assign to it.
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::FirstTouchThreaderCallback(void *arg)
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  const ThreadIdType threadCount = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  FirstTouchThreadStruct *str =
+    (FirstTouchThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  OutputImageRegionType splitRegion;
+  const ThreadIdType    total = str->Filter->SplitRequestedRegion(threadId, threadCount, splitRegion);
+
+  if ( threadId < total )
+    {
+    for ( unsigned int i = 0; i < str->Outputs->size(); ++i )
+      {
+      OutputImageType *     output = ( *str->Outputs )[i];
+      OutputImageRegionType region = splitRegion;
+      if ( region.Crop( output->GetBufferedRegion() ) )
+        {
+        FirstTouchRegion(output, region);
+        }
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "DynamicMultiThreading: " << m_DynamicMultiThreading << std::endl;
+  os << indent << "NumberOfPiecesPerThread: " << m_NumberOfPiecesPerThread << std::endl;
+  os << indent << "FirstTouchAllocation: " << m_FirstTouchAllocation << std::endl;
+  if ( m_RegionSplitter )
+    {
+    os << indent << "RegionSplitter: " << m_RegionSplitter << std::endl;
+    }
+  else
+    {
+    os << indent << "RegionSplitter: (none)" << std::endl;
+    }
+}
 } // end namespace itk
 
 #endif
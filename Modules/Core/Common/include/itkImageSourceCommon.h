@@ -0,0 +1,54 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageSourceCommon_h
+#define __itkImageSourceCommon_h
+
+#include "itkMacro.h"
+
+namespace itk
+{
+/** \class ImageSourceCommon
+ * \brief Non-templated global settings shared by all the ImageSource
+ * instantiations.
+ *
+ * ImageSource is a class template, so a static member of ImageSource would
+ * be distinct for each output image type. The process-wide defaults of
+ * ImageSource are kept here instead.
+ *
+ * \ingroup DataSources
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageSourceCommon
+{
+public:
+  /** Set/Get the value used to initialize FirstTouchAllocation when an
+   * ImageSource is constructed. Unless it has been explicitly set, the
+   * default is read once from the ITK_FIRST_TOUCH_ALLOCATION environment
+   * variable ("ON", "1", "TRUE" or "YES" enable it) and is false
+   * otherwise. */
+  static void SetGlobalDefaultFirstTouchAllocation(const bool firstTouch);
+
+  static bool GetGlobalDefaultFirstTouchAllocation();
+
+private:
+  static bool m_GlobalDefaultFirstTouchAllocation;
+  static bool m_GlobalDefaultFirstTouchAllocationIsInitialized;
+};
+} // end namespace itk
+
+#endif
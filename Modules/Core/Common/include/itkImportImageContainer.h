@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +37,10 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * The memory managed by the container is allocated with new[], or with
+ * the ImageBufferAllocator set with SetAllocator(). The allocator is
+ * initialized with ImageBufferAllocator::GetGlobalDefault().
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -73,6 +78,15 @@ public:
   void SetImportPointer(TElement *ptr, TElementIdentifier num,
                         bool LetContainerManageMemory = false);
 
+  /** Set/Get the object owning the imported memory, for instance the
+   * memory mapping of the file the image data is read from. The
+   * container keeps the owner alive until the buffer is released or
+   * replaced. Set it after SetImportPointer(). */
+  void SetBufferOwner(const LightObject *owner)
+  { m_BufferOwner = owner; }
+  const LightObject * GetBufferOwner() const
+  { return m_BufferOwner.GetPointer(); }
+
   /** Index operator. This version can be an lvalue. */
   TElement & operator[](const ElementIdentifier id)
   { return m_ImportPointer[id]; }
@@ -132,6 +146,12 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the allocator used for the memory allocated from now on by
+   * this container. NULL selects new[]. The current buffer, if any, is
+   * still released with the allocator it was obtained from. */
+  itkSetObjectMacro(Allocator, ImageBufferAllocator);
+  itkGetObjectMacro(Allocator, ImageBufferAllocator);
+
 protected:
   ImportImageContainer();
   virtual ~ImportImageContainer();
@@ -141,6 +161,9 @@ protected:
    * call this method but should call Print() instead. */
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Allocate the elements of a new buffer, with the Allocator if one is
+   * set. Subclasses overriding AllocateElements() must also override
+   * DeallocateManagedMemory(). */
   virtual TElement * AllocateElements(ElementIdentifier size) const;
 
   virtual void DeallocateManagedMemory();
@@ -175,6 +198,14 @@ private:
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  /** Allocator for new buffers, and allocator the current buffer was
+   * obtained from (NULL for new[] or imported memory). */
+  ImageBufferAllocator::Pointer m_Allocator;
+  ImageBufferAllocator::Pointer m_BufferAllocator;
+
+  /** Object owning the imported memory. */
+  LightObject::ConstPointer m_BufferOwner;
 };
 } // end namespace itk
 
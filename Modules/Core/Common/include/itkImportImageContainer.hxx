@@ -32,6 +32,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 
 namespace itk
 {
@@ -43,6 +44,7 @@ ImportImageContainer< TElementIdentifier, TElement >
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_Allocator = ImageBufferAllocator::GetGlobalDefault();
 }
 
 template< typename TElementIdentifier, typename TElement >
@@ -75,6 +77,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferAllocator = m_Allocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -89,6 +92,7 @@ ImportImageContainer< TElementIdentifier, TElement >
   else
     {
     m_ImportPointer = this->AllocateElements(size);
+    m_BufferAllocator = m_Allocator;
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -116,6 +120,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferAllocator = m_Allocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -160,6 +165,7 @@ ImportImageContainer< TElementIdentifier, TElement >
 {
   DeallocateManagedMemory();
   m_ImportPointer = ptr;
+  m_BufferAllocator = 0;
   m_ContainerManageMemory = LetContainerManageMemory;
   m_Capacity = num;
   m_Size = num;
@@ -176,6 +182,32 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // does not do this by default.
   TElement *data;
 
+  if ( m_Allocator )
+    {
+    // The allocator throws on failure and returns raw memory; construct
+    // the elements in place, as new[] would.
+    data = static_cast< TElement * >( m_Allocator->Allocate( size * sizeof( TElement ) ) );
+    ElementIdentifier i = 0;
+    try
+      {
+      for (; i < size; ++i )
+        {
+        new ( data + i ) TElement;
+        }
+      }
+    catch ( ... )
+      {
+      // destroy the elements constructed so far and give the block back
+      while ( i > 0 )
+        {
+        data[--i].~TElement();
+        }
+      m_Allocator->Deallocate( data, size * sizeof( TElement ) );
+      throw;
+      }
+    return data;
+    }
+
   try
     {
     data = new TElement[size];
@@ -202,9 +234,22 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ImportPointer && m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_BufferAllocator )
+      {
+      for ( ElementIdentifier i = 0; i < m_Capacity; ++i )
+        {
+        m_ImportPointer[i].~TElement();
+        }
+      m_BufferAllocator->Deallocate( m_ImportPointer, m_Capacity * sizeof( TElement ) );
+      }
+    else
+      {
+      delete[] m_ImportPointer;
+      }
     }
   m_ImportPointer = 0;
+  m_BufferAllocator = 0;
+  m_BufferOwner = 0;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -221,6 +266,8 @@ ImportImageContainer< TElementIdentifier, TElement >
      << ( m_ContainerManageMemory ? "true" : "false" ) << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "Allocator: " << m_Allocator.GetPointer() << std::endl;
+  os << indent << "BufferOwner: " << m_BufferOwner.GetPointer() << std::endl;
 }
 } // end namespace itk
 
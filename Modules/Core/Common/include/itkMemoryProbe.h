@@ -34,6 +34,12 @@ namespace itk
  *   GetProcessMemoryInfo() for Windows, the SMAPS file for Linux
  *   and getrusage() otherwise.
  *
+ *   Memory cached by a recycling ImageBufferAllocator (see
+ *   PooledImageBufferAllocator) is still counted as used by the process.
+ *   GetImageBufferAllocatedMemory() and GetImageBufferCachedMemory() report
+ *   the state of the global default ImageBufferAllocator, so that the
+ *   cached part can be told apart.
+ *
  * \ingroup ITKCommon
  */
 class ITKCommon_EXPORT MemoryProbe:
@@ -50,6 +56,14 @@ public:
   /** Type for measuring the average memory. */
   typedef double MeanMemoryLoadType;
 
+  /** Memory, in kB, currently used by image buffers obtained from the
+   * global default ImageBufferAllocator. Zero when there is none. */
+  MemoryLoadType GetImageBufferAllocatedMemory() const;
+
+  /** Memory, in kB, held for reuse by the global default
+   * ImageBufferAllocator. Zero when there is none. */
+  MemoryLoadType GetImageBufferCachedMemory() const;
+
 protected:
   virtual MemoryLoadType GetInstantValue(void) const;
 
@@ -30,6 +30,7 @@
 
 #include "itkMutexLock.h"
 #include "itkThreadSupport.h"
+#include "itkThreadPool.h"
 #include "itkIntTypes.h"
 
 namespace itk
@@ -47,6 +48,27 @@ namespace itk
  * If ITK_USE_PTHREADS is defined, then
  * pthread_create() will be used to create multiple threads (on
  * a sun, for example).
+ *
+ * When UseThreadPool is on, SingleMethodExecute() runs the SingleMethod on
+ * the persistent workers of the process-wide ThreadPool instead of
+ * creating and joining a new set of threads on each call. The default
+ * is taken from GetGlobalDefaultUseThreadPool(), which can be set with
+ * SetGlobalDefaultUseThreadPool() or with the ITK_USE_THREADPOOL
+ * environment variable.
+ *
+ * When UseThreadAffinity is on, SingleMethodExecute() runs each ThreadID
+ * on a thread bound to the processor with the same rank as the ThreadID
+ * among the processors the process may run on (modulo their number): a
+ * spawned thread is bound when it starts, a ThreadPool worker when it
+ * picks up the job, unless it is already bound to that processor. ThreadID
+ * 0 is dispatched as well, since the calling thread belongs to the
+ * application and is never bound; it only waits for the others, so
+ * observers of the events invoked by ThreadID 0 (progress, for instance)
+ * are then called from another thread. Together with
+ * ImageSource::FirstTouchAllocation, this keeps each ThreadID working on
+ * memory local to its NUMA node from one call to the next. Thread affinity
+ * is supported on Linux and Windows; it is ignored on the other
+ * platforms.
  * \ingroup ITKCommon
  */
 
@@ -89,6 +111,39 @@ public:
 
   static ThreadIdType  GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get whether SingleMethodExecute() dispatches its work to the
+   * process-wide ThreadPool rather than spawning new threads. */
+  itkSetMacro(UseThreadPool, bool);
+  itkGetConstMacro(UseThreadPool, bool);
+  itkBooleanMacro(UseThreadPool);
+
+  /** Set/Get the value which is used to initialize UseThreadPool in the
+   * constructor. Unless it has been explicitly set, the default is read
+   * once from the ITK_USE_THREADPOOL environment variable ("ON", "1",
+   * "TRUE" or "YES" enable the pool) and is false otherwise. */
+  static void SetGlobalDefaultUseThreadPool(const bool GlobalDefaultUseThreadPool);
+
+  static bool GetGlobalDefaultUseThreadPool();
+
+  /** Set/Get whether SingleMethodExecute() runs each ThreadID on a thread
+   * bound to the processor of the same rank. */
+  itkSetMacro(UseThreadAffinity, bool);
+  itkGetConstMacro(UseThreadAffinity, bool);
+  itkBooleanMacro(UseThreadAffinity);
+
+  /** Set/Get the value which is used to initialize UseThreadAffinity in the
+   * constructor. Unless it has been explicitly set, the default is read
+   * once from the ITK_USE_THREAD_AFFINITY environment variable ("ON", "1",
+   * "TRUE" or "YES" enable it) and is false otherwise. */
+  static void SetGlobalDefaultUseThreadAffinity(const bool GlobalDefaultUseThreadAffinity);
+
+  static bool GetGlobalDefaultUseThreadAffinity();
+
+  /** Bind the calling thread to the processor of the given rank (modulo
+   * their number) among those it may run on. Returns false when the
+   * binding is not supported, or when there is a single processor. */
+  static bool BindCurrentThreadToProcessor(ThreadIdType rank);
+
   /** Execute the SingleMethod (as define by SetSingleMethod) using
    * m_NumberOfThreads threads. As a side effect the m_NumberOfThreads will be
    * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
@@ -130,7 +185,8 @@ public:
    * SingleMethodExecute or MultipleMethodExecute, and it is 1 for
    * threads created from SpawnThread.  The UserData is the (void
    * *)arg passed into the SetSingleMethod, SetMultipleMethod, or
-   * SpawnThread method. */
+   * SpawnThread method. UseThreadAffinity tells the SingleMethodProxy to
+   * bind the newly spawned thread to a processor. */
 #ifdef ThreadInfoStruct
 #undef ThreadInfoStruct
 #endif
@@ -141,6 +197,7 @@ public:
     MutexLock::Pointer ActiveFlagLock;
     void *UserData;
     ThreadFunctionType ThreadFunction;
+    bool UseThreadAffinity;
     enum { SUCCESS, ITK_EXCEPTION, ITK_PROCESS_ABORTED_EXCEPTION, STD_EXCEPTION, UNKNOWN } ThreadExitCode;
   };
 
@@ -200,6 +257,29 @@ private:
    */
   ThreadIdType m_NumberOfThreads;
 
+  /** Whether SingleMethodExecute() uses the ThreadPool. */
+  bool m_UseThreadPool;
+
+  /** The pool is held for as long as this threader uses it. */
+  ThreadPool::Pointer m_ThreadPool;
+
+  /** The jobs handed to the pool by SingleMethodExecute(), one per
+   * thread except the calling one. */
+  ThreadPool::ThreadJob m_ThreadJobs[ITK_MAX_THREADS];
+
+  /** Global variables holding the default value of UseThreadPool and
+   * whether it has been initialized from the environment. */
+  static bool m_GlobalDefaultUseThreadPool;
+  static bool m_GlobalDefaultUseThreadPoolIsInitialized;
+
+  /** Whether SingleMethodExecute() binds its threads to processors. */
+  bool m_UseThreadAffinity;
+
+  /** Global variables holding the default value of UseThreadAffinity and
+   * whether it has been initialized from the environment. */
+  static bool m_GlobalDefaultUseThreadAffinity;
+  static bool m_GlobalDefaultUseThreadAffinityIsInitialized;
+
   /** Static function used as a "proxy callback" by the MultiThreader.  The
    * threading library will call this routine for each thread, which
    * will delegate the control to the prescribed SingleMethod. This
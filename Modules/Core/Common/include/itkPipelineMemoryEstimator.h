@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineMemoryEstimator_h
+#define __itkPipelineMemoryEstimator_h
+
+#include "itkDataObject.h"
+
+namespace itk
+{
+/** \class PipelineMemoryEstimator
+ * \brief Estimates the memory a pipeline needs to produce a region.
+ *
+ * EstimateMemory() propagates the RequestedRegion of a data object up the
+ * pipeline, exactly as an update would, and adds up the memory that the
+ * requested regions of the data objects produced upstream will hold (see
+ * DataObject::GetRequestedRegionMemorySize()). The buffers of data objects
+ * which do not release their data are assumed to stay allocated during the
+ * whole update; the buffers of the data objects that do release their data
+ * are only counted for the filter which produces or consumes them, and the
+ * largest such filter is added to the total. Data objects without a source
+ * are provided by the application and are not counted, since streaming has
+ * no effect on them.
+ *
+ * ComputeNumberOfDivisions() uses such estimates to select the smallest
+ * number of stream divisions that keeps every piece within a memory budget.
+ * It is used by StreamingImageFilter and ImageFileWriter. Since the
+ * estimates change the requested regions of the pipeline,
+ * ComputeNumberOfDivisions() restores them before it returns.
+ *
+ * PipelineMemoryEstimator only has static methods.
+ *
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineMemoryEstimator
+{
+public:
+  /** Standard class typedefs. */
+  typedef PipelineMemoryEstimator Self;
+
+  /** Estimate the memory of the largest piece when the output is divided
+   * in numberOfDivisions pieces. The estimate may stop at the first piece
+   * which exceeds memoryBudget. clientData is the pointer given to
+   * ComputeNumberOfDivisions(). */
+  typedef SizeValueType ( *PieceMemoryFunctionType )(unsigned int numberOfDivisions,
+                                                     SizeValueType memoryBudget,
+                                                     void *clientData);
+
+  /** Propagate the RequestedRegion of data up the pipeline and estimate
+   * the number of bytes needed to produce it. The requested regions of the
+   * data objects upstream are left as the propagation set them. */
+  static SizeValueType EstimateMemory(DataObject *data);
+
+  /** Return the smallest number of divisions, up to
+   * maximumNumberOfDivisions, for which pieceMemory() does not exceed
+   * memoryBudget. The estimate is assumed to decrease when the number of
+   * divisions increases. maximumNumberOfDivisions is returned when no
+   * number of divisions fits in the budget.
+   *
+   * pieceMemory() may change the requested regions of data, the output
+   * whose pieces are estimated, and of the data objects upstream of it.
+   * They are all restored before ComputeNumberOfDivisions() returns, and
+   * the restored requested region of data is propagated once more so the
+   * state the sources derive from it (the IO region of a reader, for
+   * instance) matches it again. data may be NULL when pieceMemory() does
+   * not change any requested region. */
+  static unsigned int ComputeNumberOfDivisions(DataObject *data,
+                                               SizeValueType memoryBudget,
+                                               unsigned int maximumNumberOfDivisions,
+                                               PieceMemoryFunctionType pieceMemory,
+                                               void *clientData);
+
+private:
+  PipelineMemoryEstimator();                          //purposely not implemented
+  PipelineMemoryEstimator(const Self &);              //purposely not implemented
+  void operator=(const Self &);                       //purposely not implemented
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,139 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPooledImageBufferAllocator_h
+#define __itkPooledImageBufferAllocator_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+#include <map>
+#include <vector>
+
+namespace itk
+{
+/** \class PooledImageBufferAllocator
+ * \brief Image buffer allocator returning aligned blocks and recycling
+ * released blocks.
+ *
+ * Every block is aligned on an Alignment (64) byte boundary, which suits
+ * cache lines and SIMD loads. Block sizes are rounded up to a size class
+ * (a multiple of Alignment for small blocks, of PageSize above it), and
+ * released blocks are kept in a free list per size class instead of being
+ * returned to the system. A later request of the same size class reuses
+ * a cached block, so pipelines that repeatedly allocate and release the
+ * same buffers (e.g. multi-resolution registration, streaming) stop
+ * paying for the system allocation and the page faults.
+ *
+ * The cache is bounded by MaximumCachedMemory: when releasing a block
+ * would exceed it, the largest cached blocks are freed first. Blocks
+ * larger than MaximumCachedMemory are never cached.
+ *
+ * The allocator is thread safe. It is meant to be shared by all the
+ * filters of the process through ImageBufferAllocator::SetGlobalDefault():
+ *
+ * \code
+ *   itk::ImageBufferAllocator::SetGlobalDefault( itk::PooledImageBufferAllocator::New() );
+ * \endcode
+ *
+ * Allocation statistics are available from the accessors below, and
+ * through MemoryProbe for the global default allocator.
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PooledImageBufferAllocator:public ImageBufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef PooledImageBufferAllocator Self;
+  typedef ImageBufferAllocator       Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PooledImageBufferAllocator, ImageBufferAllocator);
+
+  /** Alignment of the blocks, in bytes. */
+  itkStaticConstMacro(Alignment, SizeValueType, 64);
+
+  /** Granularity of the size classes of blocks larger than a page. */
+  itkStaticConstMacro(PageSize, SizeValueType, 4096);
+
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+  virtual SizeValueType GetAllocatedMemory() const;
+
+  virtual SizeValueType GetCachedMemory() const;
+
+  /** Set/Get the maximum number of bytes kept in the cache. Lowering it
+   * frees cached blocks as needed. Defaults to 1 GiB. */
+  void SetMaximumCachedMemory(SizeValueType maximum);
+  itkGetConstMacro(MaximumCachedMemory, SizeValueType);
+
+  /** Free all the cached blocks. */
+  void ReleaseCachedMemory();
+
+  /** Highest value reached by GetAllocatedMemory(). */
+  SizeValueType GetPeakAllocatedMemory() const;
+
+  /** Number of calls to Allocate(). */
+  SizeValueType GetNumberOfAllocations() const;
+
+  /** Number of calls to Allocate() served from the cache. */
+  SizeValueType GetNumberOfCacheHits() const;
+
+protected:
+  PooledImageBufferAllocator();
+  ~PooledImageBufferAllocator();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  PooledImageBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+
+  /** Size of the block used for a request of numberOfBytes. */
+  static SizeValueType GetBlockSize(SizeValueType numberOfBytes);
+
+  /** Get a block from, and return a block to, the system. */
+  static void * AllocateAligned(SizeValueType blockSize);
+  static void FreeAligned(void *block);
+
+  /** Free cached blocks, largest first, until at most maximum bytes are
+   * cached. Must be called with m_Mutex held. */
+  void TrimCache(SizeValueType maximum);
+
+  typedef std::map< SizeValueType, std::vector< void * > > CacheType;
+
+  CacheType     m_Cache;
+  SizeValueType m_CachedMemory;
+  SizeValueType m_MaximumCachedMemory;
+  SizeValueType m_AllocatedMemory;
+  SizeValueType m_PeakAllocatedMemory;
+  SizeValueType m_NumberOfAllocations;
+  SizeValueType m_NumberOfCacheHits;
+
+  SimpleFastMutexLock m_Mutex;
+};
+} // end namespace itk
+
+#endif
@@ -20,6 +20,9 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImageRegionSplitter.h"
+#include "itkThreadPool.h"
+#include "itkPipelineMemoryEstimator.h"
+#include <list>
 
 namespace itk
 {
@@ -36,6 +39,28 @@ namespace itk
  * This filter will produce the entire output as one image, but the upstream
  * filters will do their processing in pieces.
  *
+ * By default the pieces are processed strictly one after another. When
+ * NumberOfPiecesInFlight is larger than one, the copy of the pieces into
+ * the output is moved off the critical path: once the upstream pipeline
+ * produced a piece, its buffer is detached from the upstream output and
+ * copied into the output image by a ThreadPool worker, while the upstream
+ * pipeline computes the next piece. The upstream pipeline itself is not
+ * reentrant and still executes one piece at a time, so the computation of
+ * the pieces never overlaps; the most that can be saved is the time of the
+ * copies. At most NumberOfPiecesInFlight pieces (the one being computed and
+ * the ones waiting to be copied) are resident at any time, and the
+ * MaximumMemoryInFlight, when set, further caps the number of bytes held
+ * by these pieces. Since the buffer of a piece is detached from the
+ * upstream output, the upstream filters must not reuse their output
+ * buffers across executions, which is the default (see
+ * ProcessObject::ReleaseDataBeforeUpdateFlag).
+ *
+ * When a MemoryBudget is set, the number of pieces is not taken from
+ * NumberOfStreamDivisions: as ImageFileWriter does, the filter selects the
+ * smallest number of pieces for which the memory the upstream pipeline needs
+ * to produce each piece, as estimated by PipelineMemoryEstimator, fits in
+ * the budget.
+ *
  * \ingroup ITKSystemObjects
  * \ingroup DataProcessing
  * \ingroup ITKCommon
@@ -87,6 +112,28 @@ public:
    * will be executed this many times. */
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get the maximum number of pieces in flight at once: the piece
+   * being computed by the upstream pipeline plus the pieces waiting to be
+   * copied to the output. 1, the default, processes the pieces
+   * sequentially. */
+  itkSetClampMacro(NumberOfPiecesInFlight, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfPiecesInFlight, unsigned int);
+
+  /** Set/Get the maximum number of bytes the resident pieces may hold when
+   * several pieces are in flight. 0, the default, means no limit. A piece
+   * is always allowed to be computed, even if it alone exceeds the
+   * budget. */
+  itkSetMacro(MaximumMemoryInFlight, SizeValueType);
+  itkGetConstMacro(MaximumMemoryInFlight, SizeValueType);
+
+  /** Set/Get the memory budget, in bytes, of the upstream pipeline. When
+   * not 0, the number of stream divisions is the smallest one for which the
+   * estimated memory needed by the upstream pipeline to produce each piece
+   * fits in the budget, and NumberOfStreamDivisions is ignored. 0, the
+   * default, uses NumberOfStreamDivisions. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
   /** Set the helper class for dividing the input into chunks. */
   itkSetObjectMacro(RegionSplitter, SplitterType);
 
@@ -120,6 +167,37 @@ protected:
   ~StreamingImageFilter();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy of one piece to the output, run by a ThreadPool worker. */
+  struct PieceCopyJob {
+    InputImagePointer     Piece;
+    OutputImageType *     Output;
+    InputImageRegionType  Region;
+    SizeValueType         NumberOfBytes;
+    ThreadPool::ThreadJob Job;
+  };
+  typedef std::list< PieceCopyJob > PieceCopyJobListType;
+
+  static ITK_THREAD_RETURN_TYPE PieceCopyCallback(void *arg);
+
+  /** Data given to EstimatePieceMemory() through the
+   * PipelineMemoryEstimator. */
+  struct PieceMemoryStruct {
+    InputImageType *     Input;
+    SplitterType *       Splitter;
+    InputImageRegionType Region;
+  };
+
+  /** Estimate the memory the upstream pipeline needs to produce the
+   * largest piece when the region is divided in numberOfDivisions pieces,
+   * stopping at the first piece which exceeds memoryBudget. */
+  static SizeValueType EstimatePieceMemory(unsigned int numberOfDivisions,
+                                           SizeValueType memoryBudget,
+                                           void *clientData);
+
+  /** Wait for the oldest copy job in the list and remove it. */
+  void WaitForOldestPieceCopy(PieceCopyJobListType & jobs,
+                              SizeValueType & residentBytes);
+
 private:
   StreamingImageFilter(const StreamingImageFilter &); //purposely not
                                                       // implemented
@@ -129,6 +207,9 @@ private:
 
   unsigned int          m_NumberOfStreamDivisions;
   RegionSplitterPointer m_RegionSplitter;
+  unsigned int          m_NumberOfPiecesInFlight;
+  SizeValueType         m_MaximumMemoryInFlight;
+  SizeValueType         m_MemoryBudget;
 };
 } // end namespace itk
 
@@ -21,6 +21,7 @@
 #include "itkCommand.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageAlgorithm.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -34,6 +35,13 @@ StreamingImageFilter< TInputImage, TOutputImage >
   // default to 10 divisions
   m_NumberOfStreamDivisions = 10;
 
+  // process the pieces sequentially, without memory limit
+  m_NumberOfPiecesInFlight = 1;
+  m_MaximumMemoryInFlight = 0;
+
+  // take the number of pieces from m_NumberOfStreamDivisions
+  m_MemoryBudget = 0;
+
   // create default region splitter
   m_RegionSplitter = ImageRegionSplitter< InputImageDimension >::New();
 }
@@ -58,6 +66,11 @@ StreamingImageFilter< TInputImage, TOutputImage >
 
   os << indent << "Number of stream divisions: " << m_NumberOfStreamDivisions
      << std::endl;
+  os << indent << "Number of pieces in flight: " << m_NumberOfPiecesInFlight
+     << std::endl;
+  os << indent << "Maximum memory in flight: " << m_MaximumMemoryInFlight
+     << std::endl;
+  os << indent << "Memory budget: " << m_MemoryBudget << std::endl;
   if ( m_RegionSplitter )
     {
     os << indent << "Region splitter:" << m_RegionSplitter << std::endl;
@@ -174,9 +187,22 @@ StreamingImageFilter< TInputImage, TOutputImage >
   unsigned int numDivisions, numDivisionsFromSplitter;
 
   numDivisions = m_NumberOfStreamDivisions;
+  if ( m_MemoryBudget > 0 )
+    {
+    PieceMemoryStruct str;
+    str.Input = inputPtr;
+    str.Splitter = m_RegionSplitter;
+    str.Region = outputRegion;
+    numDivisions = PipelineMemoryEstimator::ComputeNumberOfDivisions(
+      inputPtr, m_MemoryBudget,
+      m_RegionSplitter->GetNumberOfSplits( outputRegion, NumericTraits< unsigned int >::max() ),
+      &Self::EstimatePieceMemory, &str);
+    itkDebugMacro(<< "Memory budget of " << m_MemoryBudget << " bytes: "
+                  << numDivisions << " stream divisions");
+    }
   numDivisionsFromSplitter =
     m_RegionSplitter
-    ->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
+    ->GetNumberOfSplits(outputRegion, numDivisions);
   if ( numDivisionsFromSplitter < numDivisions )
     {
     numDivisions = numDivisionsFromSplitter;
@@ -184,29 +210,104 @@ StreamingImageFilter< TInputImage, TOutputImage >
 
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
-   * piece, and copy the results into the output image.
+   * piece, and copy the results into the output image. When several pieces
+   * may be in flight, the copy of a piece is handed to the thread pool and
+   * overlaps with the computation of the following pieces. The buffer of
+   * the piece is detached from the upstream output for that purpose, which
+   * is only possible when the input is produced by a pipeline.
    */
+  const bool pipelined = m_NumberOfPiecesInFlight > 1 && numDivisions > 1
+                         && inputPtr->GetSource();
+
+  PieceCopyJobListType copyJobs;
+  SizeValueType        residentBytes = 0;
+  SizeValueType        pieceBytes = 0;
+  ThreadPool::Pointer  threadPool;
+  if ( pipelined )
+    {
+    threadPool = ThreadPool::GetInstance();
+    }
+
   unsigned int         piece;
   InputImageRegionType streamRegion;
-  for ( piece = 0;
-        piece < numDivisions && !this->GetAbortGenerateData();
-        piece++ )
+  try
     {
-    streamRegion = m_RegionSplitter->GetSplit(piece, numDivisions,
-                                              outputRegion);
+    for ( piece = 0;
+          piece < numDivisions && !this->GetAbortGenerateData();
+          piece++ )
+      {
+      streamRegion = m_RegionSplitter->GetSplit(piece, numDivisions,
+                                                outputRegion);
 
-    inputPtr->SetRequestedRegion(streamRegion);
-    inputPtr->PropagateRequestedRegion();
-    inputPtr->UpdateOutputData();
+      // make room for the piece about to be computed
+      while ( !copyJobs.empty()
+              && ( copyJobs.size() + 1 > m_NumberOfPiecesInFlight
+                   || ( m_MaximumMemoryInFlight > 0
+                        && residentBytes + pieceBytes > m_MaximumMemoryInFlight ) ) )
+        {
+        this->WaitForOldestPieceCopy(copyJobs, residentBytes);
+        }
 
-    // copy the result to the proper place in the output. the input
-    // requested region determined by the RegionSplitter (as opposed
-    // to what the pipeline might have enlarged it to) is used to
-    // copy the regions from the input to output
-    ImageAlgorithm::Copy( inputPtr, outputPtr, streamRegion, streamRegion );
+      inputPtr->SetRequestedRegion(streamRegion);
+      inputPtr->PropagateRequestedRegion();
+      inputPtr->UpdateOutputData();
 
+      // copy the result to the proper place in the output. the input
+      // requested region determined by the RegionSplitter (as opposed
+      // to what the pipeline might have enlarged it to) is used to
+      // copy the regions from the input to output
+      if ( !pipelined )
+        {
+        ImageAlgorithm::Copy( inputPtr, outputPtr, streamRegion, streamRegion );
+        }
+      else
+        {
+        // take the buffer away from the upstream output, so the next
+        // execution of the pipeline allocates a new one
+        copyJobs.push_back( PieceCopyJob() );
+        PieceCopyJob & copyJob = copyJobs.back();
+        copyJob.Piece = InputImageType::New();
+        copyJob.Piece->Graft(inputPtr);
+        inputPtr->Initialize();
+        copyJob.Output = outputPtr;
+        copyJob.Region = streamRegion;
+        copyJob.NumberOfBytes = static_cast< SizeValueType >(
+          copyJob.Piece->GetPixelContainer()->Capacity()
+          * sizeof( typename InputImageType::PixelContainer::Element ) );
+        copyJob.Job.ThreadFunction = &Self::PieceCopyCallback;
+        copyJob.Job.UserData = &copyJob;
+        copyJob.Job.Executed = true;
+        pieceBytes = std::max(pieceBytes, copyJob.NumberOfBytes);
+        residentBytes += copyJob.NumberOfBytes;
+        try
+          {
+          threadPool->AssignWork(&copyJob.Job);
+          }
+        catch ( ExceptionObject & )
+          {
+          // no worker available: copy the piece here
+          PieceCopyCallback(&copyJob);
+          copyJob.Job.Executed = true;
+          }
+        }
 
-    this->UpdateProgress( (float)piece / numDivisions );
+      this->UpdateProgress( (float)piece / numDivisions );
+      }
+    }
+  catch ( ... )
+    {
+    // the pending copies reference the output and the job list
+    while ( !copyJobs.empty() )
+      {
+      this->WaitForOldestPieceCopy(copyJobs, residentBytes);
+      }
+    this->m_Updating = false;
+    throw;
+    }
+
+  while ( !copyJobs.empty() )
+    {
+    this->WaitForOldestPieceCopy(copyJobs, residentBytes);
     }
 
   /**
@@ -240,6 +341,53 @@ StreamingImageFilter< TInputImage, TOutputImage >
   // Mark that we are no longer updating the data in this filter
   this->m_Updating = false;
 }
+
+template< class TInputImage, class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+StreamingImageFilter< TInputImage, TOutputImage >
+::PieceCopyCallback(void *arg)
+{
+  PieceCopyJob *copyJob = static_cast< PieceCopyJob * >( arg );
+
+  ImageAlgorithm::Copy( copyJob->Piece.GetPointer(), copyJob->Output,
+                        copyJob->Region, copyJob->Region );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TInputImage, class TOutputImage >
+SizeValueType
+StreamingImageFilter< TInputImage, TOutputImage >
+::EstimatePieceMemory(unsigned int numberOfDivisions, SizeValueType memoryBudget,
+                      void *clientData)
+{
+  PieceMemoryStruct *str = static_cast< PieceMemoryStruct * >( clientData );
+
+  // the pieces at the boundary, or the ones a filter pads differently, may
+  // need more memory than the first one
+  const unsigned int numberOfSplits =
+    str->Splitter->GetNumberOfSplits(str->Region, numberOfDivisions);
+  SizeValueType largestMemory = 0;
+  for ( unsigned int piece = 0; piece < numberOfSplits && largestMemory <= memoryBudget; ++piece )
+    {
+    str->Input->SetRequestedRegion( str->Splitter->GetSplit(piece, numberOfSplits, str->Region) );
+    largestMemory = std::max( largestMemory, PipelineMemoryEstimator::EstimateMemory(str->Input) );
+    }
+  return largestMemory;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+StreamingImageFilter< TInputImage, TOutputImage >
+::WaitForOldestPieceCopy(PieceCopyJobListType & jobs,
+                         SizeValueType & residentBytes)
+{
+  PieceCopyJob & copyJob = jobs.front();
+
+  ThreadPool::GetInstance()->WaitForJob(&copyJob.Job);
+  residentBytes -= copyJob.NumberOfBytes;
+  jobs.pop_front();
+}
 } // end namespace itk
 
 #endif
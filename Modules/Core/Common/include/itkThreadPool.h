@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadPool_h
+#define __itkThreadPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkConditionVariable.h"
+#include "itkSimpleFastMutexLock.h"
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+/** \class ThreadPool
+ * \brief Process-wide pool of persistent worker threads.
+ *
+ * ThreadPool keeps a set of worker threads alive for the lifetime of the
+ * process and feeds them jobs from a FIFO queue. MultiThreader uses it
+ * (when UseThreadPool is on) instead of creating and joining a fresh set
+ * of threads on every SingleMethodExecute() call, which removes the thread
+ * creation cost from pipelines that execute many short threaded methods.
+ *
+ * The pool grows on demand: whenever a job is queued and no idle worker is
+ * available to pick it up, a new worker is started. All the jobs of one
+ * SingleMethodExecute() call are therefore guaranteed to run concurrently,
+ * which is required by threaded methods that synchronize with a Barrier,
+ * and nested threaded calls issued from within a worker cannot deadlock.
+ *
+ * The jobs are owned by the caller. A job must stay alive until
+ * WaitForJob() returned for it.
+ *
+ * A job may ask to run on a given processor (see ThreadJob). The worker
+ * which picks it up is bound to that processor first, and keeps the
+ * binding afterwards, so that it needs no system call for the next job on
+ * the same processor. MultiThreader uses it to run each ThreadID on the
+ * processor of the same rank, in every SingleMethodExecute() call.
+ *
+ * There is a single instance of the pool, accessed through GetInstance().
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadPool:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadPool                 Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadPool, Object);
+
+  /** \struct ThreadJob
+   * \brief A unit of work executed by one of the pool threads.
+   *
+   * The ThreadFunction is called with UserData as its only argument.
+   * Executed is set by the pool once the function returned. When
+   * BindToProcessor is set, the worker is bound to the processor of rank
+   * ProcessorRank (see MultiThreader::BindCurrentThreadToProcessor())
+   * before it calls the ThreadFunction. */
+  struct ThreadJob {
+    ThreadFunctionType ThreadFunction;
+    void *             UserData;
+    bool               Executed;
+    bool               BindToProcessor;
+    ThreadIdType       ProcessorRank;
+    ThreadJob():ThreadFunction(0), UserData(0), Executed(false),
+      BindToProcessor(false), ProcessorRank(0) {}
+  };
+
+  /** Return the process-wide instance of the pool, creating it on first
+   * use. */
+  static Pointer GetInstance();
+
+  /** Queue a job for execution by one of the worker threads. The job must
+   * not be modified or destroyed until WaitForJob() returned. */
+  void AssignWork(ThreadJob *job);
+
+  /** Block until the given job has been executed. */
+  void WaitForJob(ThreadJob *job);
+
+  /** Number of worker threads currently alive in the pool. */
+  ThreadIdType GetNumberOfThreads() const;
+
+  /** Number of worker threads waiting for work. */
+  ThreadIdType GetNumberOfIdleThreads() const;
+
+protected:
+  ThreadPool();
+  ~ThreadPool();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ThreadPool(const Self &);     //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  /** Start one more worker thread. Must be called with m_Mutex held. */
+  void AddThread();
+
+  /** Platform specific creation and joining of a worker thread. */
+  ThreadProcessIDType CreateWorkerThread();
+  void JoinWorkerThread(ThreadProcessIDType threadHandle);
+
+  /** Body of each worker: pull jobs from the queue until the pool is
+   * destroyed. */
+  static ITK_THREAD_RETURN_TYPE ThreadExecute(void *arg);
+
+  /** Protects the queue, the counters and the Executed flag of the jobs. */
+  mutable SimpleMutexLock m_Mutex;
+
+  /** Signaled when a job is queued or when the pool is shutting down. */
+  ConditionVariable::Pointer m_WorkAvailable;
+
+  /** Broadcast when a job has been executed. */
+  ConditionVariable::Pointer m_JobExecuted;
+
+  std::deque< ThreadJob * >          m_WorkQueue;
+  std::vector< ThreadProcessIDType > m_Threads;
+  ThreadIdType                       m_NumberOfIdleThreads;
+  bool                               m_ScheduleForDestruction;
+
+  static Pointer             m_Instance;
+  static SimpleFastMutexLock m_InstanceMutex;
+};
+}  // end namespace itk
+#endif
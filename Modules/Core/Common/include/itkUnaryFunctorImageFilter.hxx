@@ -165,7 +165,11 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
   ImageRegionConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
   ImageRegionIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
 
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  float initialProgress;
+  float progressWeight;
+  this->GetProgressOfRegion(outputRegionForThread, initialProgress, progressWeight);
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels(),
+                             100, initialProgress, progressWeight );
 
   inputIt.GoToBegin();
   outputIt.GoToBegin();
@@ -323,6 +323,9 @@ public:
 
   virtual void SetNumberOfComponentsPerPixel(unsigned int n);
 
+  /** Number of bytes needed to hold the pixels of the RequestedRegion. */
+  virtual SizeValueType GetRequestedRegionMemorySize() const;
+
 protected:
   VectorImage();
   void PrintSelf(std::ostream & os, Indent indent) const;
@@ -160,6 +160,16 @@ VectorImage< TPixel, VImageDimension >
   return this->m_VectorLength;
 }
 
+//----------------------------------------------------------------------------
+template< class TPixel, unsigned int VImageDimension >
+SizeValueType
+VectorImage< TPixel, VImageDimension >
+::GetRequestedRegionMemorySize() const
+{
+  return static_cast< SizeValueType >( this->GetRequestedRegion().GetNumberOfPixels() )
+         * this->m_VectorLength * sizeof( InternalPixelType );
+}
+
 //----------------------------------------------------------------------------
 template< class TPixel, unsigned int VImageDimension >
 void
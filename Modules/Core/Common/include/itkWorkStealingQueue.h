@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkWorkStealingQueue_h
+#define __itkWorkStealingQueue_h
+
+#include "itkSimpleFastMutexLock.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class WorkStealingQueue
+ * \brief Distributes a range of piece indices among threads with work
+ * stealing.
+ *
+ * The pieces [0, NumberOfPieces) are first dealt out as contiguous blocks,
+ * one block per thread, so that each thread processes neighboring pieces
+ * as long as it has work of its own. A thread takes pieces from the front
+ * of its own block; once the block is exhausted, it steals one piece from
+ * the back of the block of the thread that has the most pieces left.
+ * Every piece is handed out exactly once.
+ *
+ * WorkStealingQueue is not a subclass of Object and is designed to be
+ * allocated on the stack of the method that spawns the threads.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT WorkStealingQueue
+{
+public:
+  /** Standard class typedefs. */
+  typedef WorkStealingQueue Self;
+
+  WorkStealingQueue();
+  ~WorkStealingQueue() {}
+
+  /** Deal out numberOfPieces pieces to numberOfThreads threads. The number
+   * of threads is clamped to ITK_MAX_THREADS. Must be called before the
+   * threads start. */
+  void Initialize(ThreadIdType numberOfThreads, unsigned int numberOfPieces);
+
+  /** Get the next piece to process by thread threadId. Returns false once
+   * all the pieces have been handed out. */
+  bool GetNextPiece(ThreadIdType threadId, unsigned int & piece);
+
+  ThreadIdType GetNumberOfThreads() const
+  {
+    return m_NumberOfThreads;
+  }
+
+  unsigned int GetNumberOfPieces() const
+  {
+    return m_NumberOfPieces;
+  }
+
+private:
+  WorkStealingQueue(const Self &); //purposely not implemented
+  void operator=(const Self &);    //purposely not implemented
+
+  /** Remaining pieces of each thread, as the half open range
+   * [m_Begin[t], m_End[t]). */
+  unsigned int        m_Begin[ITK_MAX_THREADS];
+  unsigned int        m_End[ITK_MAX_THREADS];
+  SimpleFastMutexLock m_Lock[ITK_MAX_THREADS];
+
+  ThreadIdType m_NumberOfThreads;
+  unsigned int m_NumberOfPieces;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,53 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageSourceCommon.h"
+#include "itksys/SystemTools.hxx"
+
+namespace itk
+{
+bool ImageSourceCommon:: m_GlobalDefaultFirstTouchAllocation = false;
+bool ImageSourceCommon:: m_GlobalDefaultFirstTouchAllocationIsInitialized = false;
+
+void
+ImageSourceCommon
+::SetGlobalDefaultFirstTouchAllocation(const bool firstTouch)
+{
+  m_GlobalDefaultFirstTouchAllocation = firstTouch;
+  m_GlobalDefaultFirstTouchAllocationIsInitialized = true;
+}
+
+bool
+ImageSourceCommon
+::GetGlobalDefaultFirstTouchAllocation()
+{
+  if ( !m_GlobalDefaultFirstTouchAllocationIsInitialized )
+    {
+    itksys_stl::string firstTouchEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_FIRST_TOUCH_ALLOCATION", firstTouchEnv) )
+      {
+      firstTouchEnv = itksys::SystemTools::UpperCase(firstTouchEnv);
+      m_GlobalDefaultFirstTouchAllocation = ( firstTouchEnv == "ON"
+                                              || firstTouchEnv == "1"
+                                              || firstTouchEnv == "TRUE"
+                                              || firstTouchEnv == "YES" );
+      }
+    m_GlobalDefaultFirstTouchAllocationIsInitialized = true;
+    }
+  return m_GlobalDefaultFirstTouchAllocation;
+}
+} // end namespace itk
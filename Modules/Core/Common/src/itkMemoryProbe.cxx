@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkMemoryProbe.h"
+#include "itkImageBufferAllocator.h"
 
 namespace itk
 {
@@ -34,4 +35,20 @@ MemoryProbe
 {
   return static_cast< MemoryProbe::MemoryLoadType >( m_MemoryObserver.GetMemoryUsage() );
 }
+
+MemoryProbe::MemoryLoadType
+MemoryProbe
+::GetImageBufferAllocatedMemory() const
+{
+  ImageBufferAllocator::Pointer allocator = ImageBufferAllocator::GetGlobalDefault();
+  return allocator ? static_cast< MemoryLoadType >( allocator->GetAllocatedMemory() / 1024 ) : 0;
+}
+
+MemoryProbe::MemoryLoadType
+MemoryProbe
+::GetImageBufferCachedMemory() const
+{
+  ImageBufferAllocator::Pointer allocator = ImageBufferAllocator::GetGlobalDefault();
+  return allocator ? static_cast< MemoryLoadType >( allocator->GetCachedMemory() / 1024 ) : 0;
+}
 } // end namespace itk
@@ -48,6 +48,64 @@ ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = ITK_MAX_THREADS;
 // => Not initialized.
 ThreadIdType MultiThreader:: m_GlobalDefaultNumberOfThreads = 0;
 
+// Initialize static members that control the global default use of the
+// thread pool : not initialized, read from the environment on first use.
+bool MultiThreader:: m_GlobalDefaultUseThreadPool = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadPoolIsInitialized = false;
+
+void MultiThreader::SetGlobalDefaultUseThreadPool(const bool GlobalDefaultUseThreadPool)
+{
+  m_GlobalDefaultUseThreadPool = GlobalDefaultUseThreadPool;
+  m_GlobalDefaultUseThreadPoolIsInitialized = true;
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  if ( !m_GlobalDefaultUseThreadPoolIsInitialized )
+    {
+    itksys_stl::string itkUseThreadPoolEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREADPOOL", itkUseThreadPoolEnv) )
+      {
+      itkUseThreadPoolEnv = itksys::SystemTools::UpperCase(itkUseThreadPoolEnv);
+      m_GlobalDefaultUseThreadPool = ( itkUseThreadPoolEnv == "ON"
+                                       || itkUseThreadPoolEnv == "1"
+                                       || itkUseThreadPoolEnv == "TRUE"
+                                       || itkUseThreadPoolEnv == "YES" );
+      }
+    m_GlobalDefaultUseThreadPoolIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadPool;
+}
+
+// Initialize static members that control the global default use of thread
+// affinity : not initialized, read from the environment on first use.
+bool MultiThreader:: m_GlobalDefaultUseThreadAffinity = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadAffinityIsInitialized = false;
+
+void MultiThreader::SetGlobalDefaultUseThreadAffinity(const bool GlobalDefaultUseThreadAffinity)
+{
+  m_GlobalDefaultUseThreadAffinity = GlobalDefaultUseThreadAffinity;
+  m_GlobalDefaultUseThreadAffinityIsInitialized = true;
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadAffinity()
+{
+  if ( !m_GlobalDefaultUseThreadAffinityIsInitialized )
+    {
+    itksys_stl::string itkUseThreadAffinityEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREAD_AFFINITY", itkUseThreadAffinityEnv) )
+      {
+      itkUseThreadAffinityEnv = itksys::SystemTools::UpperCase(itkUseThreadAffinityEnv);
+      m_GlobalDefaultUseThreadAffinity = ( itkUseThreadAffinityEnv == "ON"
+                                           || itkUseThreadAffinityEnv == "1"
+                                           || itkUseThreadAffinityEnv == "TRUE"
+                                           || itkUseThreadAffinityEnv == "YES" );
+      }
+    m_GlobalDefaultUseThreadAffinityIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadAffinity;
+}
+
 void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
 {
   m_GlobalMaximumNumberOfThreads = val;
@@ -189,6 +247,7 @@ MultiThreader::MultiThreader()
     m_ThreadInfoArray[i].ThreadID           = i;
     m_ThreadInfoArray[i].ActiveFlag         = 0;
     m_ThreadInfoArray[i].ActiveFlagLock     = 0;
+    m_ThreadInfoArray[i].UseThreadAffinity  = false;
 
     m_MultipleMethod[i]                     = 0;
     m_MultipleData[i]                       = 0;
@@ -196,11 +255,14 @@ MultiThreader::MultiThreader()
     m_SpawnedThreadActiveFlag[i]            = 0;
     m_SpawnedThreadActiveFlagLock[i]        = 0;
     m_SpawnedThreadInfoArray[i].ThreadID    = i;
+    m_SpawnedThreadInfoArray[i].UseThreadAffinity = false;
     }
 
   m_SingleMethod = 0;
   m_SingleData = 0;
   m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  m_UseThreadPool = this->GetGlobalDefaultUseThreadPool();
+  m_UseThreadAffinity = this->GetGlobalDefaultUseThreadAffinity();
 }
 
 MultiThreader::~MultiThreader()
@@ -254,18 +316,53 @@ void MultiThreader::SingleMethodExecute()
   //
   // Thanks to Hannu Helminen for suggestions on how to catch
   // exceptions thrown by threads.
-  bool        exceptionOccurred = false;
-  std::string exceptionDetails;
+  //
+  // With the thread pool, the SingleMethodProxy is queued as a job for the
+  // persistent pool threads instead. Jobs are marked as executed until they
+  // are actually assigned so that waiting on a job which could not be
+  // dispatched returns immediately.
+  //
+  // With thread affinity, each ThreadID runs on a thread bound to the
+  // processor of the same rank, so that the pages a ThreadID first touched
+  // are local to it in the next calls. This includes ThreadID 0: the
+  // calling thread belongs to the application and is not bound, it only
+  // waits for the other threads.
+  const ThreadIdType firstDispatchedThread = m_UseThreadAffinity ? 0 : 1;
+  bool               exceptionOccurred = false;
+  std::string        exceptionDetails;
+  if ( m_UseThreadPool )
+    {
+    if ( m_ThreadPool.IsNull() )
+      {
+      m_ThreadPool = ThreadPool::GetInstance();
+      }
+    for ( thread_loop = firstDispatchedThread; thread_loop < m_NumberOfThreads; thread_loop++ )
+      {
+      m_ThreadJobs[thread_loop].Executed = true;
+      }
+    }
   try
     {
-    for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    for ( thread_loop = firstDispatchedThread; thread_loop < m_NumberOfThreads; thread_loop++ )
       {
       m_ThreadInfoArray[thread_loop].UserData    = m_SingleData;
       m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
       m_ThreadInfoArray[thread_loop].ThreadFunction = m_SingleMethod;
+      m_ThreadInfoArray[thread_loop].UseThreadAffinity = m_UseThreadAffinity && !m_UseThreadPool;
 
-      process_id[thread_loop] =
-        this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+      if ( m_UseThreadPool )
+        {
+        m_ThreadJobs[thread_loop].ThreadFunction = MultiThreader::SingleMethodProxy;
+        m_ThreadJobs[thread_loop].UserData = &m_ThreadInfoArray[thread_loop];
+        m_ThreadJobs[thread_loop].BindToProcessor = m_UseThreadAffinity;
+        m_ThreadJobs[thread_loop].ProcessorRank = thread_loop;
+        m_ThreadPool->AssignWork(&m_ThreadJobs[thread_loop]);
+        }
+      else
+        {
+        process_id[thread_loop] =
+          this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+        }
       }
     }
   catch ( std::exception & e )
@@ -283,24 +380,34 @@ void MultiThreader::SingleMethodExecute()
     exceptionOccurred = true;
     }
 
-  // Now, the parent thread calls this->SingleMethod() itself
-  //
+  // Now, the parent thread calls this->SingleMethod() itself, unless
+  // ThreadID 0 was dispatched too
   //
   try
     {
-    m_ThreadInfoArray[0].UserData = m_SingleData;
-    m_ThreadInfoArray[0].NumberOfThreads = m_NumberOfThreads;
-    m_SingleMethod( (void *)( &m_ThreadInfoArray[0] ) );
+    if ( firstDispatchedThread > 0 )
+      {
+      m_ThreadInfoArray[0].UserData = m_SingleData;
+      m_ThreadInfoArray[0].NumberOfThreads = m_NumberOfThreads;
+      m_SingleMethod( (void *)( &m_ThreadInfoArray[0] ) );
+      }
     }
   catch ( ProcessAborted & excp )
     {
     // Need cleanup and rethrow ProcessAborted
     // close down other threads
-    for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    for ( thread_loop = firstDispatchedThread; thread_loop < m_NumberOfThreads; thread_loop++ )
       {
       try
         {
-        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        if ( m_UseThreadPool )
+          {
+          m_ThreadPool->WaitForJob(&m_ThreadJobs[thread_loop]);
+          }
+        else
+          {
+          this->WaitForSingleMethodThread(process_id[thread_loop]);
+          }
         }
       catch ( ... )
               {}
@@ -325,11 +432,18 @@ void MultiThreader::SingleMethodExecute()
 
   // The parent thread has finished this->SingleMethod() - so now it
   // waits for each of the other processes to exit
-  for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+  for ( thread_loop = firstDispatchedThread; thread_loop < m_NumberOfThreads; thread_loop++ )
     {
     try
       {
-      this->WaitForSingleMethodThread(process_id[thread_loop]);
+      if ( m_UseThreadPool )
+        {
+        m_ThreadPool->WaitForJob(&m_ThreadJobs[thread_loop]);
+        }
+      else
+        {
+        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        }
       if ( m_ThreadInfoArray[thread_loop].ThreadExitCode
            != ThreadInfoStruct::SUCCESS )
         {
@@ -369,6 +483,13 @@ MultiThreader
   * threadInfoStruct =
     reinterpret_cast< MultiThreader::ThreadInfoStruct * >( arg );
 
+  // bind the thread to a processor if requested; it was spawned for this
+  // call and ends with it, so its affinity is not restored
+  if ( threadInfoStruct->UseThreadAffinity )
+    {
+    MultiThreader::BindCurrentThreadToProcessor(threadInfoStruct->ThreadID);
+    }
+
   // execute the user specified threader callback, catching any exceptions
   try
     {
@@ -407,6 +528,12 @@ void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
      << m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: "
      << m_GlobalDefaultNumberOfThreads << std::endl;
+  os << indent << "Use Thread Pool: " << m_UseThreadPool << std::endl;
+  os << indent << "Global Default Use Thread Pool: "
+     << m_GlobalDefaultUseThreadPool << std::endl;
+  os << indent << "Use Thread Affinity: " << m_UseThreadAffinity << std::endl;
+  os << indent << "Global Default Use Thread Affinity: "
+     << m_GlobalDefaultUseThreadAffinity << std::endl;
 }
 
 
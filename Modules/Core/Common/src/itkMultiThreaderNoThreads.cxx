@@ -32,6 +32,12 @@
 
 namespace itk
 {
+// There is no multi threading, so there is no thread to bind.
+bool MultiThreader::BindCurrentThreadToProcessor(ThreadIdType)
+{
+  return false;
+}
+
 ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreadsByPlatform()
 {
   int num;
@@ -27,6 +27,7 @@
  *=========================================================================*/
 #include "itkMultiThreader.h"
 #include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
 #include "itksys/SystemTools.hxx"
 #include <stdlib.h>
 
@@ -35,6 +36,10 @@
 #include <sys/sysctl.h>
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace itk
 {
 extern "C"
@@ -42,6 +47,57 @@ extern "C"
 typedef void *( *c_void_cast )(void *);
 }
 
+#if defined( __linux__ ) && defined( CPU_SET )
+namespace
+{
+// The processors the threads may be bound to. They are read once, before
+// any thread is bound, since a thread inherits the affinity of the thread
+// that creates it, which may be a bound pool thread.
+SimpleFastMutexLock allowedMaskLock;
+bool                allowedMaskIsInitialized = false;
+bool                allowedMaskIsValid = false;
+cpu_set_t           allowedMask;
+}
+#endif
+
+bool MultiThreader::BindCurrentThreadToProcessor(ThreadIdType rank)
+{
+#if defined( __linux__ ) && defined( CPU_SET )
+  allowedMaskLock.Lock();
+  if ( !allowedMaskIsInitialized )
+    {
+    allowedMaskIsValid =
+      ( pthread_getaffinity_np(pthread_self(), sizeof( cpu_set_t ), &allowedMask) == 0 );
+    allowedMaskIsInitialized = true;
+    }
+  allowedMaskLock.Unlock();
+  if ( !allowedMaskIsValid )
+    {
+    return false;
+    }
+  const int numberOfProcessors = CPU_COUNT(&allowedMask);
+  if ( numberOfProcessors < 2 )
+    {
+    return false;
+    }
+  int       remaining = static_cast< int >( rank % numberOfProcessors );
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for ( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+    {
+    if ( CPU_ISSET(cpu, &allowedMask) && remaining-- == 0 )
+      {
+      CPU_SET(cpu, &mask);
+      break;
+      }
+    }
+  return pthread_setaffinity_np(pthread_self(), sizeof( cpu_set_t ), &mask) == 0;
+#else
+  (void)rank;
+  return false;
+#endif
+}
+
 ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreadsByPlatform()
 {
     ThreadIdType num;
@@ -35,6 +35,35 @@
 
 namespace itk
 {
+bool MultiThreader::BindCurrentThreadToProcessor(ThreadIdType rank)
+{
+  DWORD_PTR processMask;
+  DWORD_PTR systemMask;
+  if ( !GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) )
+    {
+    return false;
+    }
+  unsigned int numberOfProcessors = 0;
+  for ( DWORD_PTR bits = processMask; bits; bits >>= 1 )
+    {
+    numberOfProcessors += static_cast< unsigned int >( bits & 1 );
+    }
+  if ( numberOfProcessors < 2 )
+    {
+    return false;
+    }
+  unsigned int remaining = rank % numberOfProcessors;
+  DWORD_PTR    mask = 1;
+  for (; mask; mask <<= 1 )
+    {
+    if ( ( processMask & mask ) && remaining-- == 0 )
+      {
+      break;
+      }
+    }
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
 ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreadsByPlatform()
 {
   SYSTEM_INFO sysInfo;
@@ -0,0 +1,261 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineMemoryEstimator.h"
+#include "itkProcessObject.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+#include <utility>
+#include <cmath>
+
+namespace
+{
+typedef std::vector< std::pair< itk::DataObject::Pointer, itk::DataObject::Pointer > >
+SavedRequestedRegionsType;
+
+// Save the requested regions of data and of all the data objects upstream
+// of it in copies of these data objects. data comes first.
+void SaveRequestedRegions(itk::DataObject *data, SavedRequestedRegionsType & saved)
+{
+  std::set< const itk::DataObject * > visitedData;
+  std::vector< itk::DataObject * >    dataToVisit(1, data);
+
+  while ( !dataToVisit.empty() )
+    {
+    itk::DataObject *current = dataToVisit.back();
+    dataToVisit.pop_back();
+    if ( !current || !visitedData.insert(current).second )
+      {
+      continue;
+      }
+
+    itk::DataObject::Pointer copy =
+      dynamic_cast< itk::DataObject * >( current->CreateAnother().GetPointer() );
+    if ( copy )
+      {
+      copy->SetRequestedRegion(current);
+      saved.push_back( std::make_pair(itk::DataObject::Pointer(current), copy) );
+      }
+
+    // the propagation sets the requested regions of all the outputs of a
+    // source, and of its inputs
+    itk::ProcessObject *source = current->GetSource();
+    if ( !source )
+      {
+      continue;
+      }
+    itk::ProcessObject::DataObjectPointerArray outputs = source->GetOutputs();
+    for ( unsigned int i = 0; i < outputs.size(); ++i )
+      {
+      dataToVisit.push_back(outputs[i]);
+      }
+    itk::ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+    for ( unsigned int i = 0; i < inputs.size(); ++i )
+      {
+      dataToVisit.push_back(inputs[i]);
+      }
+    }
+}
+
+void RestoreRequestedRegions(itk::DataObject *data, const SavedRequestedRegionsType & saved)
+{
+  if ( saved.empty() )
+    {
+    return;
+    }
+
+  // let the sources recompute what they derive from the requested region
+  // of their outputs
+  data->SetRequestedRegion(saved.front().second);
+  try
+    {
+    data->PropagateRequestedRegion();
+    }
+  catch ( itk::ExceptionObject & )
+    {
+    // the requested region was not valid before the estimate either; the
+    // requested regions are restored below in any case
+    }
+
+  for ( SavedRequestedRegionsType::const_iterator it = saved.begin(); it != saved.end(); ++it )
+    {
+    it->first->SetRequestedRegion(it->second);
+    }
+}
+
+unsigned int SearchNumberOfDivisions(itk::SizeValueType memoryBudget,
+                                     unsigned int maximumNumberOfDivisions,
+                                     itk::PipelineMemoryEstimator::PieceMemoryFunctionType pieceMemory,
+                                     void *clientData)
+{
+  // Grow the number of divisions in proportion to the excess of memory
+  // until a piece fits. Pieces rarely shrink linearly (neighborhood
+  // filters enlarge their input region by a constant amount), so the
+  // growth is usually short of the target.
+  unsigned int tooFew = 0;
+  unsigned int divisions = 1;
+  for (;; )
+    {
+    const itk::SizeValueType memory = pieceMemory(divisions, memoryBudget, clientData);
+    if ( memory <= memoryBudget )
+      {
+      break;
+      }
+    tooFew = divisions;
+    if ( divisions >= maximumNumberOfDivisions )
+      {
+      return maximumNumberOfDivisions;
+      }
+    const double guess = std::ceil( static_cast< double >( divisions )
+                                    * static_cast< double >( memory )
+                                    / static_cast< double >( memoryBudget ) );
+    if ( guess >= static_cast< double >( maximumNumberOfDivisions ) )
+      {
+      divisions = maximumNumberOfDivisions;
+      }
+    else
+      {
+      divisions = std::max( divisions + 1, static_cast< unsigned int >( guess ) );
+      }
+    }
+
+  // divisions fits and tooFew does not: bisect to find the smallest number
+  // of divisions which fits
+  while ( divisions - tooFew > 1 )
+    {
+    const unsigned int middle = tooFew + ( divisions - tooFew ) / 2;
+    if ( pieceMemory(middle, memoryBudget, clientData) <= memoryBudget )
+      {
+      divisions = middle;
+      }
+    else
+      {
+      tooFew = middle;
+      }
+    }
+  return divisions;
+}
+} // end anonymous namespace
+
+namespace itk
+{
+SizeValueType
+PipelineMemoryEstimator
+::EstimateMemory(DataObject *data)
+{
+  data->PropagateRequestedRegion();
+
+  std::set< const DataObject * >    visitedData;
+  std::set< const ProcessObject * > visitedSources;
+  std::vector< ProcessObject * >    sources;
+
+  ProcessObject *source = data->GetSource();
+  if ( source )
+    {
+    sources.push_back(source);
+    visitedSources.insert(source);
+    }
+
+  SizeValueType retainedMemory = 0;
+  SizeValueType largestTransientMemory = 0;
+  while ( !sources.empty() )
+    {
+    source = sources.back();
+    sources.pop_back();
+
+    // the released outputs of this filter live while it executes
+    SizeValueType transientMemory = 0;
+    ProcessObject::DataObjectPointerArray outputs = source->GetOutputs();
+    for ( unsigned int i = 0; i < outputs.size(); ++i )
+      {
+      const DataObject *output = outputs[i];
+      if ( !output )
+        {
+        continue;
+        }
+      if ( output->GetReleaseDataFlag() )
+        {
+        transientMemory += output->GetRequestedRegionMemorySize();
+        }
+      else if ( visitedData.insert(output).second )
+        {
+        retainedMemory += output->GetRequestedRegionMemorySize();
+        }
+      }
+
+    // and so do its released inputs, which are produced upstream
+    ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+    for ( unsigned int i = 0; i < inputs.size(); ++i )
+      {
+      DataObject *input = inputs[i];
+      if ( !input )
+        {
+        continue;
+        }
+      ProcessObject *inputSource = input->GetSource();
+      if ( !inputSource )
+        {
+        continue;
+        }
+      if ( input->GetReleaseDataFlag() )
+        {
+        transientMemory += input->GetRequestedRegionMemorySize();
+        }
+      if ( visitedSources.insert(inputSource).second )
+        {
+        sources.push_back(inputSource);
+        }
+      }
+
+    largestTransientMemory = std::max(largestTransientMemory, transientMemory);
+    }
+
+  return retainedMemory + largestTransientMemory;
+}
+
+unsigned int
+PipelineMemoryEstimator
+::ComputeNumberOfDivisions(DataObject *data,
+                           SizeValueType memoryBudget,
+                           unsigned int maximumNumberOfDivisions,
+                           PieceMemoryFunctionType pieceMemory,
+                           void *clientData)
+{
+  if ( maximumNumberOfDivisions <= 1 || memoryBudget == 0 )
+    {
+    return 1;
+    }
+
+  SavedRequestedRegionsType savedRegions;
+  SaveRequestedRegions(data, savedRegions);
+
+  unsigned int divisions;
+  try
+    {
+    divisions = SearchNumberOfDivisions(memoryBudget, maximumNumberOfDivisions,
+                                        pieceMemory, clientData);
+    }
+  catch ( ... )
+    {
+    RestoreRequestedRegions(data, savedRegions);
+    throw;
+    }
+  RestoreRequestedRegions(data, savedRegions);
+  return divisions;
+}
+} // end namespace itk
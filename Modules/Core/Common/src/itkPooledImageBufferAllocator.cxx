@@ -0,0 +1,262 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPooledImageBufferAllocator.h"
+#include "itkNumericTraits.h"
+#include <cstdlib>
+
+namespace itk
+{
+PooledImageBufferAllocator
+::PooledImageBufferAllocator():
+  m_CachedMemory(0),
+  m_MaximumCachedMemory(static_cast< SizeValueType >( 1 ) << 30),
+  m_AllocatedMemory(0),
+  m_PeakAllocatedMemory(0),
+  m_NumberOfAllocations(0),
+  m_NumberOfCacheHits(0)
+{}
+
+PooledImageBufferAllocator
+::~PooledImageBufferAllocator()
+{
+  this->ReleaseCachedMemory();
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetBlockSize(SizeValueType numberOfBytes)
+{
+  const SizeValueType granularity = ( numberOfBytes > PageSize ) ? PageSize : Alignment;
+
+  if ( numberOfBytes == 0 )
+    {
+    return granularity;
+    }
+  return ( ( numberOfBytes + granularity - 1 ) / granularity ) * granularity;
+}
+
+void *
+PooledImageBufferAllocator
+::AllocateAligned(SizeValueType blockSize)
+{
+  // Over-allocate to align the block and to store the address returned by
+  // malloc just before it.
+  void *memory = 0;
+  if ( blockSize <= NumericTraits< size_t >::max() - Alignment - sizeof( void * ) )
+    {
+    memory = malloc( static_cast< size_t >( blockSize ) + Alignment + sizeof( void * ) );
+    }
+  if ( !memory )
+    {
+    return 0;
+    }
+  const size_t address = reinterpret_cast< size_t >( memory ) + sizeof( void * );
+  void **      block = reinterpret_cast< void ** >( ( address + Alignment - 1 ) & ~( static_cast< size_t >( Alignment ) - 1 ) );
+  block[-1] = memory;
+  return block;
+}
+
+void
+PooledImageBufferAllocator
+::FreeAligned(void *block)
+{
+  free( static_cast< void ** >( block )[-1] );
+}
+
+void *
+PooledImageBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType blockSize = GetBlockSize(numberOfBytes);
+  void *              block = 0;
+
+  m_Mutex.Lock();
+  ++m_NumberOfAllocations;
+  CacheType::iterator bucket = m_Cache.find(blockSize);
+  if ( bucket != m_Cache.end() && !bucket->second.empty() )
+    {
+    block = bucket->second.back();
+    bucket->second.pop_back();
+    m_CachedMemory -= blockSize;
+    ++m_NumberOfCacheHits;
+    }
+  m_Mutex.Unlock();
+
+  if ( !block )
+    {
+    block = AllocateAligned(blockSize);
+    if ( !block )
+      {
+      // Give the cached memory back to the system and retry once.
+      m_Mutex.Lock();
+      this->TrimCache(0);
+      m_Mutex.Unlock();
+      block = AllocateAligned(blockSize);
+      }
+    if ( !block )
+      {
+      // We cannot construct an error string here because we may be out
+      // of memory.  Do not use the exception macro.
+      throw MemoryAllocationError(__FILE__, __LINE__,
+                                  "Failed to allocate memory for image.",
+                                  ITK_LOCATION);
+      }
+    }
+
+  m_Mutex.Lock();
+  m_AllocatedMemory += blockSize;
+  if ( m_AllocatedMemory > m_PeakAllocatedMemory )
+    {
+    m_PeakAllocatedMemory = m_AllocatedMemory;
+    }
+  m_Mutex.Unlock();
+
+  return block;
+}
+
+void
+PooledImageBufferAllocator
+::Deallocate(void *buffer, SizeValueType numberOfBytes)
+{
+  if ( !buffer )
+    {
+    return;
+    }
+  const SizeValueType blockSize = GetBlockSize(numberOfBytes);
+
+  m_Mutex.Lock();
+  m_AllocatedMemory -= blockSize;
+  if ( blockSize > m_MaximumCachedMemory )
+    {
+    m_Mutex.Unlock();
+    FreeAligned(buffer);
+    return;
+    }
+  this->TrimCache(m_MaximumCachedMemory - blockSize);
+  m_Cache[blockSize].push_back(buffer);
+  m_CachedMemory += blockSize;
+  m_Mutex.Unlock();
+}
+
+void
+PooledImageBufferAllocator
+::TrimCache(SizeValueType maximum)
+{
+  CacheType::iterator bucket = m_Cache.end();
+  while ( m_CachedMemory > maximum && bucket != m_Cache.begin() )
+    {
+    --bucket;
+    while ( m_CachedMemory > maximum && !bucket->second.empty() )
+      {
+      FreeAligned( bucket->second.back() );
+      bucket->second.pop_back();
+      m_CachedMemory -= bucket->first;
+      }
+    }
+}
+
+void
+PooledImageBufferAllocator
+::SetMaximumCachedMemory(SizeValueType maximum)
+{
+  m_Mutex.Lock();
+  if ( m_MaximumCachedMemory == maximum )
+    {
+    m_Mutex.Unlock();
+    return;
+    }
+  m_MaximumCachedMemory = maximum;
+  this->TrimCache(maximum);
+  m_Mutex.Unlock();
+  this->Modified();
+}
+
+void
+PooledImageBufferAllocator
+::ReleaseCachedMemory()
+{
+  m_Mutex.Lock();
+  this->TrimCache(0);
+  m_Cache.clear();
+  m_Mutex.Unlock();
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetAllocatedMemory() const
+{
+  m_Mutex.Lock();
+  const SizeValueType value = m_AllocatedMemory;
+  m_Mutex.Unlock();
+  return value;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetCachedMemory() const
+{
+  m_Mutex.Lock();
+  const SizeValueType value = m_CachedMemory;
+  m_Mutex.Unlock();
+  return value;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetPeakAllocatedMemory() const
+{
+  m_Mutex.Lock();
+  const SizeValueType value = m_PeakAllocatedMemory;
+  m_Mutex.Unlock();
+  return value;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetNumberOfAllocations() const
+{
+  m_Mutex.Lock();
+  const SizeValueType value = m_NumberOfAllocations;
+  m_Mutex.Unlock();
+  return value;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetNumberOfCacheHits() const
+{
+  m_Mutex.Lock();
+  const SizeValueType value = m_NumberOfCacheHits;
+  m_Mutex.Unlock();
+  return value;
+}
+
+void
+PooledImageBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Allocated Memory: " << this->GetAllocatedMemory() << std::endl;
+  os << indent << "Peak Allocated Memory: " << this->GetPeakAllocatedMemory() << std::endl;
+  os << indent << "Cached Memory: " << this->GetCachedMemory() << std::endl;
+  os << indent << "Maximum Cached Memory: " << m_MaximumCachedMemory << std::endl;
+  os << indent << "Number Of Allocations: " << this->GetNumberOfAllocations() << std::endl;
+  os << indent << "Number Of Cache Hits: " << this->GetNumberOfCacheHits() << std::endl;
+}
+} // end namespace itk
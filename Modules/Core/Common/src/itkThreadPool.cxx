@@ -0,0 +1,204 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkMultiThreader.h"
+
+#if defined(ITK_USE_PTHREADS)
+#include "itkThreadPoolPThreads.cxx"
+#elif defined(ITK_USE_WIN32_THREADS)
+#include "itkThreadPoolWinThreads.cxx"
+#else
+#include "itkThreadPoolNoThreads.cxx"
+#endif
+
+namespace itk
+{
+ThreadPool::Pointer ThreadPool:: m_Instance = 0;
+SimpleFastMutexLock ThreadPool:: m_InstanceMutex;
+
+ThreadPool::Pointer
+ThreadPool
+::GetInstance()
+{
+  m_InstanceMutex.Lock();
+  if ( m_Instance.IsNull() )
+    {
+    m_Instance = new ThreadPool;
+    // Remove extra reference from construction.
+    m_Instance->UnRegister();
+    }
+  m_InstanceMutex.Unlock();
+  return m_Instance;
+}
+
+ThreadPool
+::ThreadPool():
+  m_NumberOfIdleThreads(0),
+  m_ScheduleForDestruction(false)
+{
+  m_WorkAvailable = ConditionVariable::New();
+  m_JobExecuted = ConditionVariable::New();
+}
+
+ThreadPool
+::~ThreadPool()
+{
+  m_Mutex.Lock();
+  m_ScheduleForDestruction = true;
+  m_WorkAvailable->Broadcast();
+  m_Mutex.Unlock();
+
+  for ( unsigned int i = 0; i < m_Threads.size(); i++ )
+    {
+    this->JoinWorkerThread(m_Threads[i]);
+    }
+}
+
+void
+ThreadPool
+::AddThread()
+{
+  m_Threads.push_back( this->CreateWorkerThread() );
+  // The new worker counts as idle until it dequeues a job.
+  ++m_NumberOfIdleThreads;
+}
+
+void
+ThreadPool
+::AssignWork(ThreadJob *job)
+{
+  job->Executed = false;
+
+  m_Mutex.Lock();
+  m_WorkQueue.push_back(job);
+  // Never let a job wait for a busy worker: the jobs assigned together are
+  // expected to run concurrently.
+  if ( m_NumberOfIdleThreads < m_WorkQueue.size() )
+    {
+    try
+      {
+      this->AddThread();
+      }
+    catch ( ... )
+      {
+      m_WorkQueue.pop_back();
+      m_Mutex.Unlock();
+      throw;
+      }
+    }
+  m_WorkAvailable->Signal();
+  m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::WaitForJob(ThreadJob *job)
+{
+  m_Mutex.Lock();
+  while ( !job->Executed )
+    {
+    m_JobExecuted->Wait(&m_Mutex);
+    }
+  m_Mutex.Unlock();
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >( m_Threads.size() );
+  m_Mutex.Unlock();
+  return numberOfThreads;
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfIdleThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType numberOfIdleThreads = m_NumberOfIdleThreads;
+  m_Mutex.Unlock();
+  return numberOfIdleThreads;
+}
+
+ITK_THREAD_RETURN_TYPE
+ThreadPool
+::ThreadExecute(void *arg)
+{
+  ThreadPool *pool = reinterpret_cast< ThreadPool * >( arg );
+
+  // The processor the worker is bound to, if any. The binding is kept
+  // between the jobs and only changed when a job asks for another one.
+  bool         isBound = false;
+  ThreadIdType boundRank = 0;
+
+  pool->m_Mutex.Lock();
+  while ( true )
+    {
+    while ( pool->m_WorkQueue.empty() && !pool->m_ScheduleForDestruction )
+      {
+      pool->m_WorkAvailable->Wait(&pool->m_Mutex);
+      }
+    if ( pool->m_WorkQueue.empty() )
+      {
+      // Shutting down and nothing left to do.
+      break;
+      }
+
+    ThreadJob *job = pool->m_WorkQueue.front();
+    pool->m_WorkQueue.pop_front();
+    --pool->m_NumberOfIdleThreads;
+    pool->m_Mutex.Unlock();
+
+    if ( job->BindToProcessor && ( !isBound || boundRank != job->ProcessorRank ) )
+      {
+      isBound = MultiThreader::BindCurrentThreadToProcessor(job->ProcessorRank);
+      boundRank = job->ProcessorRank;
+      }
+
+    // Exceptions must be caught by the job function itself (see
+    // MultiThreader::SingleMethodProxy); the pool thread must survive.
+    try
+      {
+      ( *job->ThreadFunction )( job->UserData );
+      }
+    catch ( ... )
+      {}
+
+    pool->m_Mutex.Lock();
+    job->Executed = true;
+    ++pool->m_NumberOfIdleThreads;
+    pool->m_JobExecuted->Broadcast();
+    }
+  pool->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number Of Threads: " << m_Threads.size() << std::endl;
+  os << indent << "Number Of Idle Threads: " << m_NumberOfIdleThreads << std::endl;
+  os << indent << "Number Of Queued Jobs: " << m_WorkQueue.size() << std::endl;
+}
+} // end namespace itk
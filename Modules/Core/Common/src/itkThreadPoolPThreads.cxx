@@ -0,0 +1,57 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+
+namespace itk
+{
+extern "C"
+{
+typedef void *( *c_void_cast )(void *);
+}
+
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread()
+{
+  pthread_attr_t attr;
+  pthread_t      threadHandle;
+
+  pthread_attr_init(&attr);
+#if !defined( __CYGWIN__ )
+  pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+#endif
+
+  const int threadError =
+    pthread_create( &threadHandle, &attr, reinterpret_cast< c_void_cast >( ThreadPool::ThreadExecute ),
+                    reinterpret_cast< void * >( this ) );
+  pthread_attr_destroy(&attr);
+  if ( threadError != 0 )
+    {
+    itkExceptionMacro(<< "Unable to create a thread.  pthread_create() returned "
+                      << threadError);
+    }
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType threadHandle)
+{
+  pthread_join(threadHandle, 0);
+}
+} // end namespace itk
@@ -0,0 +1,47 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include <process.h>
+
+namespace itk
+{
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread()
+{
+  unsigned int threadId;
+  HANDLE       threadHandle = (HANDLE)_beginthreadex(0, 0,
+                                                     ( unsigned int (__stdcall *)(void *) )ThreadPool::ThreadExecute,
+                                                     reinterpret_cast< void * >( this ),
+                                                     0,
+                                                     &threadId);
+  if ( threadHandle == NULL )
+    {
+    itkExceptionMacro(<< "Unable to create a thread.");
+    }
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType threadHandle)
+{
+  WaitForSingleObject(threadHandle, INFINITE);
+  CloseHandle(threadHandle);
+}
+} // end namespace itk
@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingQueue.h"
+
+namespace itk
+{
+WorkStealingQueue::WorkStealingQueue():
+  m_NumberOfThreads(0),
+  m_NumberOfPieces(0)
+{
+  for ( ThreadIdType t = 0; t < ITK_MAX_THREADS; ++t )
+    {
+    m_Begin[t] = 0;
+    m_End[t] = 0;
+    }
+}
+
+void
+WorkStealingQueue
+::Initialize(ThreadIdType numberOfThreads, unsigned int numberOfPieces)
+{
+  if ( numberOfThreads < 1 )
+    {
+    numberOfThreads = 1;
+    }
+  if ( numberOfThreads > ITK_MAX_THREADS )
+    {
+    numberOfThreads = ITK_MAX_THREADS;
+    }
+  m_NumberOfThreads = numberOfThreads;
+  m_NumberOfPieces = numberOfPieces;
+
+  // The first (numberOfPieces % numberOfThreads) threads get one extra piece.
+  const unsigned int piecesPerThread = numberOfPieces / numberOfThreads;
+  const unsigned int remainder = numberOfPieces % numberOfThreads;
+  unsigned int       begin = 0;
+  for ( ThreadIdType t = 0; t < m_NumberOfThreads; ++t )
+    {
+    const unsigned int count = piecesPerThread + ( t < remainder ? 1 : 0 );
+    m_Begin[t] = begin;
+    m_End[t] = begin + count;
+    begin += count;
+    }
+}
+
+bool
+WorkStealingQueue
+::GetNextPiece(ThreadIdType threadId, unsigned int & piece)
+{
+  if ( threadId >= m_NumberOfThreads )
+    {
+    return false;
+    }
+
+  // Own work first, from the front to keep neighboring pieces together.
+  m_Lock[threadId].Lock();
+  if ( m_Begin[threadId] < m_End[threadId] )
+    {
+    piece = m_Begin[threadId]++;
+    m_Lock[threadId].Unlock();
+    return true;
+    }
+  m_Lock[threadId].Unlock();
+
+  // Steal from the back of the most loaded thread. The loads may change
+  // once their lock is released, so the victim is re-checked under its
+  // lock and the search is repeated until no thread has work left.
+  while ( true )
+    {
+    ThreadIdType victim = m_NumberOfThreads;
+    unsigned int maximumLoad = 0;
+    for ( ThreadIdType t = 0; t < m_NumberOfThreads; ++t )
+      {
+      m_Lock[t].Lock();
+      const unsigned int begin = m_Begin[t];
+      const unsigned int end = m_End[t];
+      m_Lock[t].Unlock();
+      if ( begin < end && end - begin > maximumLoad )
+        {
+        maximumLoad = end - begin;
+        victim = t;
+        }
+      }
+    if ( victim == m_NumberOfThreads )
+      {
+      return false;
+      }
+
+    m_Lock[victim].Lock();
+    if ( m_Begin[victim] < m_End[victim] )
+      {
+      piece = --m_End[victim];
+      m_Lock[victim].Unlock();
+      return true;
+      }
+    m_Lock[victim].Unlock();
+    }
+}
+} // end namespace itk
@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionTiledSplitter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkAbsImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+typedef itk::ImageRegionTiledSplitter< 3 > SplitterType;
+typedef SplitterType::RegionType           RegionType;
+typedef itk::Image< unsigned char, 3 >     CountImageType;
+
+// check that the pieces cover every pixel of the region exactly once
+bool CheckPartition(SplitterType *splitter, const RegionType & region, unsigned int requested)
+{
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, requested);
+  if ( numberOfPieces < 1 || numberOfPieces > requested )
+    {
+    std::cerr << "ERROR: " << numberOfPieces << " pieces for a request of " << requested << std::endl;
+    return false;
+    }
+
+  CountImageType::Pointer count = CountImageType::New();
+  count->SetRegions( region );
+  count->Allocate();
+  count->FillBuffer( 0 );
+
+  for ( unsigned int i = 0; i < numberOfPieces; ++i )
+    {
+    const RegionType piece = splitter->GetSplit(i, numberOfPieces, region);
+    if ( !region.IsInside( piece ) || piece.GetNumberOfPixels() == 0 )
+      {
+      std::cerr << "ERROR: piece " << i << " " << piece << " is not inside " << region << std::endl;
+      return false;
+      }
+    itk::ImageRegionIterator< CountImageType > it( count, piece );
+    for (; !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      }
+    }
+
+  itk::ImageRegionIteratorWithIndex< CountImageType > it( count, region );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "ERROR: pixel " << it.GetIndex() << " is covered " << int( it.Get() )
+                << " times with " << numberOfPieces << " pieces." << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageRegionTiledSplitterTest(int, char* [])
+{
+  SplitterType::Pointer splitter = SplitterType::New();
+  splitter->Print( std::cout );
+
+  RegionType::IndexType index;
+  index[0] = -3;
+  index[1] = 5;
+  index[2] = 2;
+  RegionType::SizeType size;
+  size[0] = 100;
+  size[1] = 60;
+  size[2] = 30;
+  RegionType region( index, size );
+
+  // Automatic tiles fit in the cache, including the radius, and keep
+  // whole rows
+  SplitterType::SizeType radius;
+  radius.Fill( 2 );
+  splitter->SetRadius( radius );
+  splitter->SetBytesPerPixel( 4 );
+  splitter->SetCacheSize( 32 * 1024 );
+  SplitterType::SizeType tileSize = splitter->ComputeTileSize( region );
+  std::cout << "Tile size: " << tileSize << std::endl;
+  itk::SizeValueType footprint = splitter->GetBytesPerPixel();
+  for ( unsigned int d = 0; d < 3; ++d )
+    {
+    footprint *= tileSize[d] + 2 * radius[d];
+    }
+  if ( footprint > splitter->GetCacheSize() || tileSize[0] != size[0] )
+    {
+    std::cerr << "ERROR: tile " << tileSize << " does not fit in the cache." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int numberOfTiles = splitter->GetNumberOfSplits( region, 100000 );
+  std::cout << "Number of tiles: " << numberOfTiles << std::endl;
+  if ( numberOfTiles < 2 )
+    {
+    std::cerr << "ERROR: the region was not tiled." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int requests[] = { 1, 2, 3, 7, 8, 50, 100000 };
+  for ( unsigned int r = 0; r < sizeof( requests ) / sizeof( requests[0] ); ++r )
+    {
+    if ( !CheckPartition( splitter, region, requests[r] ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Explicit tile size
+  tileSize[0] = 16;
+  tileSize[1] = 16;
+  tileSize[2] = 8;
+  splitter->SetTileSize( tileSize );
+  if ( splitter->GetNumberOfSplits( region, 100000 ) != 7 * 4 * 4 )
+    {
+    std::cerr << "ERROR: expected " << 7 * 4 * 4 << " tiles of " << tileSize
+              << ", got " << splitter->GetNumberOfSplits( region, 100000 ) << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !CheckPartition( splitter, region, 100000 ) || !CheckPartition( splitter, region, 5 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Use by ImageSource and StreamingImageFilter
+  typedef itk::Image< short, 3 >                            ImageType;
+  typedef itk::AbsImageFilter< ImageType, ImageType >       AbsFilterType;
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+  short value = -1000;
+  itk::ImageRegionIteratorWithIndex< ImageType > iit( input, region );
+  for (; !iit.IsAtEnd(); ++iit )
+    {
+    iit.Set( value );
+    value = ( value == 1000 ) ? -1000 : value + 1;
+    }
+
+  SplitterType::Pointer filterSplitter = SplitterType::New();
+  filterSplitter->SetCacheSize( 8 * 1024 );
+  filterSplitter->SetBytesPerPixel( 2 * sizeof( short ) );
+
+  AbsFilterType::Pointer abs = AbsFilterType::New();
+  abs->SetInput( input );
+  abs->InPlaceOff();
+  abs->SetRegionSplitter( filterSplitter );
+  abs->DynamicMultiThreadingOn();
+  abs->SetNumberOfPiecesPerThread( 64 );
+  if ( abs->GetRegionSplitter() != filterSplitter.GetPointer() )
+    {
+    std::cerr << "ERROR: wrong region splitter." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( abs->GetOutput() );
+  streamer->SetRegionSplitter( splitter );
+  streamer->SetNumberOfStreamDivisions( 12 );
+  streamer->Update();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > oit( streamer->GetOutput(), region );
+  for (; !oit.IsAtEnd(); ++oit )
+    {
+    const short inputValue = input->GetPixel( oit.GetIndex() );
+    if ( oit.Get() != ( inputValue < 0 ? -inputValue : inputValue ) )
+      {
+      std::cerr << "ERROR: wrong value at " << oit.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
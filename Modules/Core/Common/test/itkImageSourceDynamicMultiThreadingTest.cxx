@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "itkCommand.h"
+
+namespace
+{
+/** Source that adds one to every pixel of the region it is asked to
+ * generate, and counts the calls to ThreadedGenerateData(). */
+template< class TOutputImage >
+class CountingImageSource:public itk::ImageSource< TOutputImage >
+{
+public:
+  typedef CountingImageSource                Self;
+  typedef itk::ImageSource< TOutputImage >   Superclass;
+  typedef itk::SmartPointer< Self >          Pointer;
+  typedef itk::SmartPointer< const Self >    ConstPointer;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingImageSource, ImageSource);
+
+  itkGetConstMacro(NumberOfCalls, unsigned int);
+
+  itkSetMacro(SupportsDynamicMultiThreading, bool);
+
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return m_SupportsDynamicMultiThreading;
+  }
+
+  void SetRegion(const OutputImageRegionType & region)
+  {
+    m_Region = region;
+    this->Modified();
+  }
+
+protected:
+  CountingImageSource():m_NumberOfCalls(0), m_SupportsDynamicMultiThreading(true) {}
+
+  virtual void GenerateOutputInformation()
+  {
+    this->GetOutput()->SetLargestPossibleRegion(m_Region);
+  }
+
+  virtual void BeforeThreadedGenerateData()
+  {
+    this->GetOutput()->FillBuffer(0);
+    m_NumberOfCalls = 0;
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, itk::ThreadIdType threadId)
+  {
+    m_Mutex.Lock();
+    ++m_NumberOfCalls;
+    m_Mutex.Unlock();
+
+    float initialProgress;
+    float progressWeight;
+    this->GetProgressOfRegion(region, initialProgress, progressWeight);
+    itk::ProgressReporter progress( this, threadId, region.GetNumberOfPixels(),
+                                    100, initialProgress, progressWeight );
+
+    itk::ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      progress.CompletedPixel();
+      }
+  }
+
+private:
+  CountingImageSource(const Self &); //purposely not implemented
+  void operator=(const Self &);      //purposely not implemented
+
+  OutputImageRegionType m_Region;
+  unsigned int          m_NumberOfCalls;
+  bool                  m_SupportsDynamicMultiThreading;
+  itk::SimpleMutexLock  m_Mutex;
+};
+
+/** Records the lowest progress reported after a higher one. */
+class ProgressWatcher
+{
+public:
+  ProgressWatcher(itk::ProcessObject *process):m_Process(process)
+  {
+    this->Reset();
+  }
+
+  void Reset()
+  {
+    m_HighestProgress = 0.0f;
+    m_LargestDrop = 0.0f;
+  }
+
+  void ShowProgress()
+  {
+    const float progress = m_Process->GetProgress();
+    if ( m_HighestProgress - progress > m_LargestDrop )
+      {
+      m_LargestDrop = m_HighestProgress - progress;
+      }
+    if ( progress > m_HighestProgress )
+      {
+      m_HighestProgress = progress;
+      }
+  }
+
+  float GetLargestDrop() const { return m_LargestDrop; }
+
+private:
+  itk::ProcessObject *m_Process;
+  float               m_HighestProgress;
+  float               m_LargestDrop;
+};
+}
+
+int itkImageSourceDynamicMultiThreadingTest(int, char* [])
+{
+  typedef itk::Image< unsigned int, 3 >      ImageType;
+  typedef CountingImageSource< ImageType >   SourceType;
+
+  ImageType::RegionType region;
+  ImageType::SizeType   size;
+  size[0] = 17;
+  size[1] = 13;
+  size[2] = 97;
+  region.SetSize(size);
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetRegion(region);
+  source->SetNumberOfThreads(4);
+
+  if( source->GetDynamicMultiThreading() )
+    {
+    std::cerr << "ERROR: DynamicMultiThreading should be off by default." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  source->DynamicMultiThreadingOn();
+  source->SetNumberOfPiecesPerThread(5);
+  source->Print(std::cout);
+
+  ProgressWatcher watcher(source);
+  itk::SimpleMemberCommand< ProgressWatcher >::Pointer progressCommand =
+    itk::SimpleMemberCommand< ProgressWatcher >::New();
+  progressCommand->SetCallbackFunction(&watcher, &ProgressWatcher::ShowProgress);
+  source->AddObserver(itk::ProgressEvent(), progressCommand);
+
+  source->Update();
+
+  // The progress runs over the whole requested region; it does not restart
+  // with each piece.
+  if( watcher.GetLargestDrop() > 1e-4f )
+    {
+    std::cerr << "ERROR: the progress went back by " << watcher.GetLargestDrop() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Every pixel must be generated exactly once.
+  itk::ImageRegionConstIterator< ImageType > it( source->GetOutput(), region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if( it.Get() != 1 )
+      {
+      std::cerr << "ERROR: pixel " << it.GetIndex() << " was generated " << it.Get() << " times." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The region is split along the outermost axis into NumberOfThreads *
+  // NumberOfPiecesPerThread pieces.
+  const unsigned int expectedNumberOfCalls =
+    source->GetMultiThreader()->GetNumberOfThreads() * source->GetNumberOfPiecesPerThread();
+  if( source->GetNumberOfCalls() != expectedNumberOfCalls )
+    {
+    std::cerr << "ERROR: ThreadedGenerateData was called " << source->GetNumberOfCalls()
+              << " times instead of " << expectedNumberOfCalls << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A region that cannot be split that finely still gets fully generated.
+  size[2] = 3;
+  region.SetSize(size);
+  source->SetRegion(region);
+  source->UpdateLargestPossibleRegion();
+  itk::ImageRegionConstIterator< ImageType > it2( source->GetOutput(), region );
+  for( it2.GoToBegin(); !it2.IsAtEnd(); ++it2 )
+    {
+    if( it2.Get() != 1 )
+      {
+      std::cerr << "ERROR: pixel " << it2.GetIndex() << " was generated " << it2.Get() << " times." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if( source->GetNumberOfCalls() != size[2] )
+    {
+    std::cerr << "ERROR: expected one call per slice, got " << source->GetNumberOfCalls() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A source that does not support several calls per thread keeps the
+  // one piece per thread split.
+  size[2] = 97;
+  region.SetSize(size);
+  source->SetRegion(region);
+  source->SetSupportsDynamicMultiThreading(false);
+  source->UpdateLargestPossibleRegion();
+  if( source->GetNumberOfCalls() != source->GetMultiThreader()->GetNumberOfThreads() )
+    {
+    std::cerr << "ERROR: expected one call per thread, got " << source->GetNumberOfCalls() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSource.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkAbsImageFilter.h"
+#if defined( __linux__ )
+#include <sched.h>
+#endif
+
+namespace
+{
+#if defined( __linux__ )
+// Records the processor each ThreadID runs on.
+ITK_THREAD_RETURN_TYPE RecordProcessor(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  static_cast< int * >( info->UserData )[info->ThreadID] = sched_getcpu();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Each ThreadID runs on the same processor in every call, so that the pages
+// it first touched stay local to it.
+int ProcessorsTest(bool useThreadPool)
+{
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool(useThreadPool);
+  threader->SetNumberOfThreads(4);
+
+  int first[ITK_MAX_THREADS];
+  int next[ITK_MAX_THREADS];
+  threader->SetSingleMethod(RecordProcessor, first);
+  threader->SingleMethodExecute();
+  for ( unsigned int call = 0; call < 10; ++call )
+    {
+    threader->SetSingleMethod(RecordProcessor, next);
+    threader->SingleMethodExecute();
+    for ( itk::ThreadIdType t = 0; t < threader->GetNumberOfThreads(); ++t )
+      {
+      if ( next[t] != first[t] )
+        {
+        std::cerr << "ERROR: ThreadID " << t << " moved from processor " << first[t]
+                  << " to " << next[t] << ( useThreadPool ? " with" : " without" )
+                  << " the thread pool." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+#endif
+
+/** Source that records whether the region of each thread was
+ * default-initialized when ThreadedGenerateData() is called, then writes
+ * it with a marker value. */
+template< class TOutputImage >
+class FirstTouchCheckingImageSource:public itk::ImageSource< TOutputImage >
+{
+public:
+  typedef FirstTouchCheckingImageSource      Self;
+  typedef itk::ImageSource< TOutputImage >   Superclass;
+  typedef itk::SmartPointer< Self >          Pointer;
+  typedef itk::SmartPointer< const Self >    ConstPointer;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType   PixelType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(FirstTouchCheckingImageSource, ImageSource);
+
+  itkGetConstMacro(NumberOfInitializedPixels, itk::SizeValueType);
+  itkGetConstMacro(NumberOfMarkedPixels, itk::SizeValueType);
+
+  void SetRegion(const OutputImageRegionType & region)
+  {
+    m_Region = region;
+    this->Modified();
+  }
+
+  void SetValues(const PixelType & initial, const PixelType & marker)
+  {
+    m_Initial = initial;
+    m_Marker = marker;
+    this->Modified();
+  }
+
+protected:
+  FirstTouchCheckingImageSource():m_NumberOfInitializedPixels(0), m_NumberOfMarkedPixels(0) {}
+
+  virtual void GenerateOutputInformation()
+  {
+    this->GetOutput()->SetLargestPossibleRegion(m_Region);
+    this->GetOutput()->SetNumberOfComponentsPerPixel(
+      itk::NumericTraits< PixelType >::GetLength(m_Marker) );
+  }
+
+  virtual void BeforeThreadedGenerateData()
+  {
+    m_NumberOfInitializedPixels = 0;
+    m_NumberOfMarkedPixels = 0;
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, itk::ThreadIdType)
+  {
+    itk::SizeValueType initialized = 0;
+    itk::SizeValueType marked = 0;
+
+    itk::ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      if ( it.Get() == m_Initial )
+        {
+        ++initialized;
+        }
+      if ( it.Get() == m_Marker )
+        {
+        ++marked;
+        }
+      it.Set( m_Marker );
+      }
+
+    m_Mutex.Lock();
+    m_NumberOfInitializedPixels += initialized;
+    m_NumberOfMarkedPixels += marked;
+    m_Mutex.Unlock();
+  }
+
+private:
+  FirstTouchCheckingImageSource(const Self &); //purposely not implemented
+  void operator=(const Self &);                //purposely not implemented
+
+  OutputImageRegionType m_Region;
+  PixelType             m_Initial;
+  PixelType             m_Marker;
+  itk::SizeValueType    m_NumberOfInitializedPixels;
+  itk::SizeValueType    m_NumberOfMarkedPixels;
+  itk::SimpleMutexLock  m_Mutex;
+};
+
+template< class TImage >
+int FirstTouchTest(const typename TImage::PixelType & initial, const typename TImage::PixelType & marker)
+{
+  typedef FirstTouchCheckingImageSource< TImage > SourceType;
+
+  typename TImage::RegionType region;
+  typename TImage::SizeType   size;
+  size.Fill(23);
+  region.SetSize(size);
+
+  typename SourceType::Pointer source = SourceType::New();
+  if( !source->GetFirstTouchAllocation() )
+    {
+    std::cerr << "ERROR: FirstTouchAllocation not initialized from the global default." << std::endl;
+    return EXIT_FAILURE;
+    }
+  source->SetRegion(region);
+  source->SetValues(initial, marker);
+  source->SetNumberOfThreads(4);
+  source->Update();
+
+  // The new buffer was first-touched with default pixels.
+  if( source->GetNumberOfInitializedPixels() != region.GetNumberOfPixels() )
+    {
+    std::cerr << "ERROR: " << source->GetNumberOfInitializedPixels() << " of "
+              << region.GetNumberOfPixels() << " pixels were first-touched." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A reused buffer is not first-touched again.
+  source->Modified();
+  source->Update();
+  if( source->GetNumberOfMarkedPixels() != region.GetNumberOfPixels() )
+    {
+    std::cerr << "ERROR: the reused buffer was overwritten." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageSourceFirstTouchTest(int, char* [])
+{
+  itk::ImageSourceCommon::SetGlobalDefaultFirstTouchAllocation(true);
+  itk::MultiThreader::SetGlobalDefaultUseThreadAffinity(true);
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if( !threader->GetUseThreadAffinity() )
+    {
+    std::cerr << "ERROR: UseThreadAffinity not initialized from the global default." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+#if defined( __linux__ )
+  if( ProcessorsTest(false) == EXIT_FAILURE || ProcessorsTest(true) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+#endif
+
+  typedef itk::Image< short, 3 > ImageType;
+  if( FirstTouchTest< ImageType >( 0, 7 ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // An output run in place keeps the values of the input.
+  ImageType::RegionType region;
+  ImageType::SizeType   size;
+  size.Fill(23);
+  region.SetSize(size);
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions(region);
+  input->Allocate();
+  input->FillBuffer(-3);
+
+  typedef itk::AbsImageFilter< ImageType, ImageType > AbsFilterType;
+  AbsFilterType::Pointer abs = AbsFilterType::New();
+  abs->SetInput(input);
+  abs->InPlaceOn();
+  abs->SetNumberOfThreads(4);
+  // the input releases its buffer to the output
+  const ImageType::PixelType *inputBuffer = input->GetBufferPointer();
+  abs->Update();
+  if( abs->GetOutput()->GetBufferPointer() != inputBuffer
+      || abs->GetOutput()->GetPixel( region.GetIndex() ) != 3 )
+    {
+    std::cerr << "ERROR: the output run in place was first-touched." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::VectorImage< float, 2 > VectorImageType;
+  VectorImageType::PixelType initial(3);
+  initial.Fill(0.0f);
+  VectorImageType::PixelType marker(3);
+  marker.Fill(1.5f);
+  if( FirstTouchTest< VectorImageType >( initial, marker ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
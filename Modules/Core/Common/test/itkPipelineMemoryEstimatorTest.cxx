@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineMemoryEstimator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkAbsImageFilter.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include <algorithm>
+
+namespace
+{
+// a piece needs 1000 bytes shared among the pieces, plus 50 bytes of
+// overlap with its neighbors
+itk::SizeValueType PieceMemory(unsigned int numberOfDivisions, itk::SizeValueType,
+                               void *clientData)
+{
+  ++( *static_cast< unsigned int * >( clientData ) );
+  return ( 1000 + numberOfDivisions - 1 ) / numberOfDivisions + 50;
+}
+
+typedef itk::Image< short, 3 > ImageType;
+
+// the largest of the pieces of the data object along the last dimension
+itk::SizeValueType SlabMemory(unsigned int numberOfDivisions, itk::SizeValueType,
+                              void *clientData)
+{
+  ImageType *               image = static_cast< ImageType * >( clientData );
+  const ImageType::RegionType largest = image->GetLargestPossibleRegion();
+  const unsigned int        slices = largest.GetSize(2);
+  const unsigned int        slicesPerPiece = ( slices + numberOfDivisions - 1 ) / numberOfDivisions;
+  itk::SizeValueType        memory = 0;
+  for ( unsigned int first = 0; first < slices; first += slicesPerPiece )
+    {
+    ImageType::RegionType piece = largest;
+    piece.SetIndex( 2, first );
+    piece.SetSize( 2, std::min( slicesPerPiece, slices - first ) );
+    image->SetRequestedRegion( piece );
+    memory = std::max( memory, itk::PipelineMemoryEstimator::EstimateMemory( image ) );
+    }
+  return memory;
+}
+
+// an AbsImageFilter which reads one more slice on each side of its output,
+// as a neighborhood filter does
+class PaddedAbsImageFilter:public itk::AbsImageFilter< ImageType, ImageType >
+{
+public:
+  typedef PaddedAbsImageFilter                        Self;
+  typedef itk::AbsImageFilter< ImageType, ImageType > Superclass;
+  typedef itk::SmartPointer< Self >                   Pointer;
+
+  itkNewMacro(Self);
+
+protected:
+  PaddedAbsImageFilter() {}
+
+  void GenerateInputRequestedRegion()
+  {
+    Superclass::GenerateInputRequestedRegion();
+
+    ImageType *           input = const_cast< ImageType * >( this->GetInput() );
+    ImageType::RegionType region = input->GetRequestedRegion();
+    region.SetIndex( 2, region.GetIndex(2) - 1 );
+    region.SetSize( 2, region.GetSize(2) + 2 );
+    region.Crop( input->GetLargestPossibleRegion() );
+    input->SetRequestedRegion( region );
+  }
+
+private:
+  PaddedAbsImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+};
+}
+
+int itkPipelineMemoryEstimatorTest(int, char* [])
+{
+  typedef itk::PipelineMemoryEstimator Estimator;
+
+  // Number of divisions
+  unsigned int numberOfCalls = 0;
+  unsigned int divisions = Estimator::ComputeNumberOfDivisions(NULL, 150, 1000, PieceMemory, &numberOfCalls);
+  std::cout << "Budget 150: " << divisions << " divisions (" << numberOfCalls << " estimates)" << std::endl;
+  if ( divisions != 10 )
+    {
+    std::cerr << "ERROR: expected 10 divisions." << std::endl;
+    return EXIT_FAILURE;
+    }
+  divisions = Estimator::ComputeNumberOfDivisions(NULL, 2000, 1000, PieceMemory, &numberOfCalls);
+  if ( divisions != 1 )
+    {
+    std::cerr << "ERROR: expected 1 division for a large budget, got " << divisions << std::endl;
+    return EXIT_FAILURE;
+    }
+  divisions = Estimator::ComputeNumberOfDivisions(NULL, 150, 5, PieceMemory, &numberOfCalls);
+  if ( divisions != 5 )
+    {
+    std::cerr << "ERROR: expected the maximum of 5 divisions, got " << divisions << std::endl;
+    return EXIT_FAILURE;
+    }
+  divisions = Estimator::ComputeNumberOfDivisions(NULL, 51, 1000, PieceMemory, &numberOfCalls);
+  if ( divisions != 1000 )
+    {
+    std::cerr << "ERROR: expected 1000 divisions, got " << divisions << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Memory of a pipeline
+  typedef itk::AbsImageFilter< ImageType, ImageType >       AbsFilterType;
+  typedef itk::PipelineMonitorImageFilter< ImageType >      MonitorType;
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 64;
+  size[2] = 32;
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+  input->FillBuffer( -3 );
+
+  AbsFilterType::Pointer abs = AbsFilterType::New();
+  abs->SetInput( input );
+  abs->InPlaceOff();
+
+  MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( abs->GetOutput() );
+  monitor->UpdateOutputInformation();
+
+  // the input image is provided by the application and is not counted
+  const itk::SizeValueType sliceBytes = 64 * 64 * sizeof( short );
+  monitor->GetOutput()->SetRequestedRegion( region );
+  itk::SizeValueType memory = Estimator::EstimateMemory( monitor->GetOutput() );
+  std::cout << "Pipeline memory: " << memory << std::endl;
+  if ( memory != 2 * 32 * sliceBytes )
+    {
+    std::cerr << "ERROR: expected " << 2 * 32 * sliceBytes << " bytes." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( Estimator::EstimateMemory( input ) != 0 )
+    {
+    std::cerr << "ERROR: an image without source should not be counted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the estimates leave the requested regions of the pipeline as they were
+  monitor->GetOutput()->SetRequestedRegion( region );
+  monitor->GetOutput()->PropagateRequestedRegion();
+  divisions = Estimator::ComputeNumberOfDivisions( monitor->GetOutput(), 2 * 4 * sliceBytes, 32,
+                                                   SlabMemory, monitor->GetOutput() );
+  if ( divisions != 8 )
+    {
+    std::cerr << "ERROR: expected 8 divisions, got " << divisions << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( monitor->GetOutput()->GetRequestedRegion() != region
+       || abs->GetOutput()->GetRequestedRegion() != region )
+    {
+    std::cerr << "ERROR: the requested regions were not restored: "
+              << monitor->GetOutput()->GetRequestedRegion()
+              << abs->GetOutput()->GetRequestedRegion() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Budget driven streaming: 2 images of 4 slices per piece
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( monitor->GetOutput() );
+  streamer->SetMemoryBudget( 2 * 4 * sliceBytes );
+  streamer->Update();
+  std::cout << "Streamed in " << monitor->GetNumberOfUpdates() << " pieces" << std::endl;
+  if ( monitor->GetNumberOfUpdates() != 8 )
+    {
+    std::cerr << "ERROR: expected 8 pieces." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( streamer->GetOutput()->GetPixel( region.GetIndex() ) != 3 )
+    {
+    std::cerr << "ERROR: wrong output value." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // every piece fits in the budget, not only the first one: with a
+  // padded filter, a piece of s slices in the middle needs 3 s + 2 slices,
+  // one at the boundary 3 s + 1
+  PaddedAbsImageFilter::Pointer padded = PaddedAbsImageFilter::New();
+  padded->SetInput( abs->GetOutput() );
+  padded->InPlaceOff();
+  MonitorType::Pointer paddedMonitor = MonitorType::New();
+  paddedMonitor->SetInput( padded->GetOutput() );
+  StreamerType::Pointer paddedStreamer = StreamerType::New();
+  paddedStreamer->SetInput( paddedMonitor->GetOutput() );
+  paddedStreamer->SetMemoryBudget( ( 3 * 4 + 1 ) * sliceBytes );
+  paddedStreamer->Update();
+  std::cout << "Padded pipeline streamed in " << paddedMonitor->GetNumberOfUpdates()
+            << " pieces" << std::endl;
+  if ( paddedMonitor->GetNumberOfUpdates() != 11 )
+    {
+    std::cerr << "ERROR: expected 11 pieces of at most 3 slices." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the budget of the resident pieces does not change the number of pieces
+  monitor->ClearPipelineSavedInformation();
+  abs->Modified();
+  streamer->SetMemoryBudget( 0 );
+  streamer->SetNumberOfStreamDivisions( 4 );
+  streamer->SetMaximumMemoryInFlight( 1 );
+  streamer->Update();
+  if ( monitor->GetNumberOfUpdates() != 4 )
+    {
+    std::cerr << "ERROR: MaximumMemoryInFlight changed the number of pieces to "
+              << monitor->GetNumberOfUpdates() << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
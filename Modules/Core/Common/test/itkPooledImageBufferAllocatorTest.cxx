@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPooledImageBufferAllocator.h"
+#include "itkMemoryProbe.h"
+#include "itkImage.h"
+#include "itkRGBPixel.h"
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer CreateImage(itk::SizeValueType sizeValue)
+{
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::SizeType size;
+  size.Fill(sizeValue);
+  typename TImage::RegionType region;
+  region.SetSize(size);
+  image->SetRegions(region);
+  image->Allocate();
+  return image;
+}
+
+bool IsAligned(const void *pointer)
+{
+  return reinterpret_cast< size_t >( pointer ) % itk::PooledImageBufferAllocator::Alignment == 0;
+}
+
+// element whose constructor throws once a given number of elements exist
+class ThrowingElement
+{
+public:
+  ThrowingElement()
+  {
+    if ( m_NumberOfElements == m_MaximumNumberOfElements )
+      {
+      throw std::bad_alloc();
+      }
+    ++m_NumberOfElements;
+  }
+
+  ~ThrowingElement()
+  {
+    --m_NumberOfElements;
+  }
+
+  static unsigned int m_NumberOfElements;
+  static unsigned int m_MaximumNumberOfElements;
+};
+
+unsigned int ThrowingElement::m_NumberOfElements = 0;
+unsigned int ThrowingElement::m_MaximumNumberOfElements = 0;
+}
+
+int itkPooledImageBufferAllocatorTest(int, char* [])
+{
+  typedef itk::Image< float, 3 >                      ImageType;
+  typedef itk::Image< itk::RGBPixel< unsigned char >, 2 > RGBImageType;
+
+  itk::PooledImageBufferAllocator::Pointer allocator = itk::PooledImageBufferAllocator::New();
+  itk::ImageBufferAllocator::SetGlobalDefault( allocator );
+  allocator->Print( std::cout );
+
+  // Buffers are aligned and come from the allocator.
+  ImageType::Pointer image = CreateImage< ImageType >( 37 );
+  if( image->GetPixelContainer()->GetAllocator() != allocator.GetPointer() )
+    {
+    std::cerr << "ERROR: the container was not created with the global default allocator." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( !IsAligned( image->GetBufferPointer() ) )
+    {
+    std::cerr << "ERROR: buffer " << image->GetBufferPointer() << " is not aligned." << std::endl;
+    return EXIT_FAILURE;
+    }
+  image->FillBuffer( 1.0f );
+
+  const itk::SizeValueType imageBytes = 37 * 37 * 37 * sizeof( float );
+  if( allocator->GetAllocatedMemory() < imageBytes || allocator->GetCachedMemory() != 0 )
+    {
+    std::cerr << "ERROR: wrong statistics after the first allocation." << std::endl;
+    allocator->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  // A released buffer is cached, and reused by the next buffer of the same
+  // size.
+  const void *firstBuffer = image->GetBufferPointer();
+  image = 0;
+  if( allocator->GetAllocatedMemory() != 0 || allocator->GetCachedMemory() < imageBytes )
+    {
+    std::cerr << "ERROR: the released buffer was not cached." << std::endl;
+    allocator->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  itk::MemoryProbe probe;
+  if( probe.GetImageBufferCachedMemory() != allocator->GetCachedMemory() / 1024 )
+    {
+    std::cerr << "ERROR: MemoryProbe does not report the cached memory." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  image = CreateImage< ImageType >( 37 );
+  if( image->GetBufferPointer() != firstBuffer || allocator->GetNumberOfCacheHits() != 1 )
+    {
+    std::cerr << "ERROR: the cached buffer was not reused." << std::endl;
+    allocator->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+  if( probe.GetImageBufferAllocatedMemory() != allocator->GetAllocatedMemory() / 1024 )
+    {
+    std::cerr << "ERROR: MemoryProbe does not report the allocated memory." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Non scalar pixels.
+  RGBImageType::Pointer rgbImage = CreateImage< RGBImageType >( 13 );
+  if( !IsAligned( rgbImage->GetBufferPointer() ) )
+    {
+    std::cerr << "ERROR: RGB buffer is not aligned." << std::endl;
+    return EXIT_FAILURE;
+    }
+  RGBImageType::PixelType white;
+  white.Fill( 255 );
+  rgbImage->FillBuffer( white );
+  rgbImage = 0;
+
+  // Imported memory is still released with delete[].
+  ImageType::Pointer imported = ImageType::New();
+  imported->GetPixelContainer()->SetImportPointer( new float[10], 10, true );
+  imported = 0;
+
+  // Lowering the cache limit frees the cached blocks.
+  allocator->SetMaximumCachedMemory( 0 );
+  if( allocator->GetCachedMemory() != 0 )
+    {
+    std::cerr << "ERROR: the cache was not trimmed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  image = 0;
+  if( allocator->GetCachedMemory() != 0 || allocator->GetAllocatedMemory() != 0 )
+    {
+    std::cerr << "ERROR: a block was cached beyond the maximum." << std::endl;
+    allocator->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  // A throwing element constructor destroys the elements already built
+  // and gives the block back to the allocator.
+  typedef itk::ImportImageContainer< itk::SizeValueType, ThrowingElement > ThrowingContainerType;
+  ThrowingContainerType::Pointer throwingContainer = ThrowingContainerType::New();
+  ThrowingElement::m_MaximumNumberOfElements = 5;
+  try
+    {
+    throwingContainer->Reserve( 10 );
+    std::cerr << "ERROR: the element constructor did not throw." << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( std::bad_alloc & )
+    {
+    }
+  if( ThrowingElement::m_NumberOfElements != 0 || allocator->GetAllocatedMemory() != 0 )
+    {
+    std::cerr << "ERROR: " << ThrowingElement::m_NumberOfElements
+              << " elements were not destroyed or the block was not deallocated." << std::endl;
+    allocator->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  allocator->Print( std::cout );
+  itk::ImageBufferAllocator::SetGlobalDefault( 0 );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
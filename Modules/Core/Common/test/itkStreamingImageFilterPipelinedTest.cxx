@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkStreamingImageFilter.h"
+#include "itkAbsImageFilter.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+bool CheckOutput(const ImageType *output, const ImageType *input)
+{
+  if ( output->GetBufferedRegion() != input->GetLargestPossibleRegion() )
+    {
+    std::cerr << "ERROR: wrong output region " << output->GetBufferedRegion() << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( output, output->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const short inputValue = input->GetPixel( it.GetIndex() );
+    const short expected = inputValue < 0 ? -inputValue : inputValue;
+    if ( it.Get() != expected )
+      {
+      std::cerr << "ERROR: pixel " << it.GetIndex() << " is " << it.Get()
+                << " instead of " << expected << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkStreamingImageFilterPipelinedTest(int, char* [])
+{
+  typedef itk::AbsImageFilter< ImageType, ImageType >     AbsFilterType;
+  typedef itk::PipelineMonitorImageFilter< ImageType >    MonitorType;
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+
+  ImageType::SizeType size;
+  size[0] = 31;
+  size[1] = 17;
+  size[2] = 23;
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+  short value = -1000;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( input, region );
+  for (; !it.IsAtEnd(); ++it, ++value )
+    {
+    it.Set( value );
+    }
+
+  AbsFilterType::Pointer abs = AbsFilterType::New();
+  abs->SetInput( input );
+  abs->InPlaceOff();
+
+  MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( abs->GetOutput() );
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( monitor->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 9 );
+
+  // the number of pieces in flight can not be 0
+  streamer->SetNumberOfPiecesInFlight( 0 );
+  if ( streamer->GetNumberOfPiecesInFlight() != 1 )
+    {
+    std::cerr << "ERROR: NumberOfPiecesInFlight not clamped to 1." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the 23 slices are streamed in as many pieces as the splitter makes of
+  // 9 divisions, whatever the number of pieces in flight and the memory limit
+  const unsigned int expectedUpdates =
+    streamer->GetRegionSplitter()->GetNumberOfSplits( region, 9 );
+
+  const unsigned int piecesInFlight[] = { 1, 2, 4, 100 };
+  const itk::SizeValueType memoryLimits[] = { 0, 1, 2 * 31 * 17 * 3 * sizeof( short ) };
+  for ( unsigned int i = 0; i < sizeof( piecesInFlight ) / sizeof( piecesInFlight[0] ); ++i )
+    {
+    for ( unsigned int j = 0; j < sizeof( memoryLimits ) / sizeof( memoryLimits[0] ); ++j )
+      {
+      std::cout << "Pieces in flight: " << piecesInFlight[i]
+                << ", maximum memory in flight: " << memoryLimits[j] << std::endl;
+      streamer->SetNumberOfPiecesInFlight( piecesInFlight[i] );
+      streamer->SetMaximumMemoryInFlight( memoryLimits[j] );
+      abs->Modified();
+      monitor->ClearPipelineSavedInformation();
+      streamer->Update();
+
+      if ( monitor->GetNumberOfUpdates() != expectedUpdates )
+        {
+        std::cerr << "ERROR: the upstream pipeline was executed "
+                  << monitor->GetNumberOfUpdates() << " times instead of "
+                  << expectedUpdates << "." << std::endl;
+        return EXIT_FAILURE;
+        }
+      if ( !CheckOutput( streamer->GetOutput(), input ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // an input without source is copied directly
+  StreamerType::Pointer directStreamer = StreamerType::New();
+  directStreamer->SetInput( input );
+  directStreamer->SetNumberOfStreamDivisions( 5 );
+  directStreamer->SetNumberOfPiecesInFlight( 3 );
+  directStreamer->Update();
+  itk::ImageRegionConstIteratorWithIndex< ImageType > dit( directStreamer->GetOutput(), region );
+  for (; !dit.IsAtEnd(); ++dit )
+    {
+    if ( dit.Get() != input->GetPixel( dit.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong pixel " << dit.GetIndex() << " without upstream pipeline." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  streamer->Print( std::cout );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreader.h"
+#include "itkBarrier.h"
+
+namespace
+{
+struct ThreadPoolTestData
+{
+  itk::SimpleMutexLock Mutex;
+  unsigned int         NumberOfCalls;
+  bool                 ThreadCalled[ITK_MAX_THREADS];
+  itk::Barrier::Pointer Barrier;
+  bool                 Throw;
+};
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPoolTestData *data = static_cast< ThreadPoolTestData * >( info->UserData );
+
+  data->Mutex.Lock();
+  ++data->NumberOfCalls;
+  data->ThreadCalled[info->ThreadID] = true;
+  data->Mutex.Unlock();
+
+  // All the threads of one SingleMethodExecute() must run concurrently,
+  // otherwise this would deadlock.
+  if ( data->Barrier.IsNotNull() )
+    {
+    data->Barrier->Wait();
+    }
+
+  if ( data->Throw && info->ThreadID == info->NumberOfThreads - 1 )
+    {
+    itkGenericExceptionMacro(<< "Exception thrown on purpose from a pool thread");
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkThreadPoolTest(int argc, char* argv[])
+{
+  if( argc > 1 )
+    {
+    // Called with the ITK_USE_THREADPOOL environment variable set.
+    const bool expected = atoi( argv[1] ) != 0;
+    if( itk::MultiThreader::GetGlobalDefaultUseThreadPool() != expected )
+      {
+      std::cerr << "ERROR: Wrong global default UseThreadPool read from environment. "
+                << expected << " != " << itk::MultiThreader::GetGlobalDefaultUseThreadPool() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool( true );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if( !threader->GetUseThreadPool() )
+    {
+    std::cerr << "ERROR: UseThreadPool not initialized from the global default." << std::endl;
+    return EXIT_FAILURE;
+    }
+  threader->Print( std::cout );
+
+  const itk::ThreadIdType numberOfThreads = std::min( 4u, itk::MultiThreader::GetGlobalMaximumNumberOfThreads() );
+  threader->SetNumberOfThreads( numberOfThreads );
+
+  ThreadPoolTestData data;
+  data.Throw = false;
+  data.Barrier = itk::Barrier::New();
+  data.Barrier->Initialize( numberOfThreads );
+
+  threader->SetSingleMethod( ThreadPoolTestCallback, &data );
+
+  const unsigned int numberOfExecutions = 1000;
+  for( unsigned int execution = 0; execution < numberOfExecutions; ++execution )
+    {
+    data.NumberOfCalls = 0;
+    for( itk::ThreadIdType t = 0; t < numberOfThreads; ++t )
+      {
+      data.ThreadCalled[t] = false;
+      }
+
+    threader->SingleMethodExecute();
+
+    if( data.NumberOfCalls != numberOfThreads )
+      {
+      std::cerr << "ERROR: execution " << execution << " called the method "
+                << data.NumberOfCalls << " times instead of " << numberOfThreads << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( itk::ThreadIdType t = 0; t < numberOfThreads; ++t )
+      {
+      if( !data.ThreadCalled[t] )
+        {
+        std::cerr << "ERROR: execution " << execution << " did not run thread " << t << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // The workers are reused: the calling thread runs one piece itself.
+  itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+  pool->Print( std::cout );
+  if( pool->GetNumberOfThreads() > numberOfThreads - 1 )
+    {
+    std::cerr << "ERROR: the pool grew to " << pool->GetNumberOfThreads()
+              << " threads for " << numberOfThreads - 1 << " concurrent jobs." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // An exception in a pool thread is reported by SingleMethodExecute and
+  // leaves the pool usable.
+  data.Throw = true;
+  bool caught = false;
+  try
+    {
+    threader->SingleMethodExecute();
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cout << "Caught expected exception: " << excp << std::endl;
+    caught = true;
+    }
+  if( numberOfThreads > 1 && !caught )
+    {
+    std::cerr << "ERROR: exception thrown in a pool thread was not reported." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  data.Throw = false;
+  data.NumberOfCalls = 0;
+  threader->SingleMethodExecute();
+  if( data.NumberOfCalls != numberOfThreads )
+    {
+    std::cerr << "ERROR: the pool is not usable after an exception." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
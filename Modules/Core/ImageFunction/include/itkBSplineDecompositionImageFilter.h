@@ -60,13 +60,23 @@ namespace itk
  *               Spline order must be set before setting the image.
  *               Uses mirror boundary conditions.
  *               Requires the same order of Spline for each dimension.
- *               Can only process LargestPossibleRegion
+ *
+ * The lines along each direction are split among the threads, and each
+ * thread runs the recursions on blocks of NumberOfLinesPerBlock lines
+ * whose samples are interleaved, so that the compiler can vectorize the
+ * loops across the lines of a block.
+ *
+ * By default the coefficients of the whole LargestPossibleRegion are
+ * computed. When UsePaddedRequestedRegion is on, only the output
+ * requested region padded by the horizon of the recursions (the number
+ * of samples after which the poles fall below the tolerance) is
+ * computed, from the same input region, so that the filter can be
+ * streamed. The coefficients of the requested region then differ from
+ * the coefficients of the whole image by about the tolerance.
  *
  * \sa itkBSplineInterpolateImageFunction
  *
  * \ingroup ImageFilters
- * \ingroup SingleThreaded
- * \ingroup CannotBeStreamed
  * \ingroup ITKImageFunction
  */
 template< class TInputImage, class TOutputImage >
@@ -91,6 +101,7 @@ public:
   typedef typename Superclass::InputImagePointer      InputImagePointer;
   typedef typename Superclass::InputImageConstPointer InputImageConstPointer;
   typedef typename Superclass::OutputImagePointer     OutputImagePointer;
+  typedef typename Superclass::OutputImageRegionType  OutputImageRegionType;
 
   typedef typename itk::NumericTraits< typename TOutputImage::PixelType >::RealType CoeffType;
 
@@ -108,6 +119,15 @@ public:
 
   itkGetConstMacro(SplineOrder, int);
 
+  /** Set/Get whether only the coefficients of the padded output
+   * requested region are computed. Default is false. */
+  itkSetMacro(UsePaddedRequestedRegion, bool);
+  itkGetConstMacro(UsePaddedRequestedRegion, bool);
+  itkBooleanMacro(UsePaddedRequestedRegion);
+
+  /** Number of lines filtered together by a thread. */
+  itkStaticConstMacro(NumberOfLinesPerBlock, unsigned int, 8);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( DimensionCheck,
@@ -125,17 +145,29 @@ protected:
   virtual ~BSplineDecompositionImageFilter() {}
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Run the recursions along each direction in turn, on the lines
+   * split among the threads. */
   void GenerateData();
 
-  /** This filter requires all of the input image. */
+  /** Compute the coefficients of the lines along the current direction
+   * in the region of a thread. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  /** Split the requested region along a direction other than the
+   * current direction, so that each thread has whole lines. */
+  unsigned int SplitRequestedRegion(unsigned int i, unsigned int num,
+                                    OutputImageRegionType & splitRegion);
+
+  /** This filter requires all of the input image, or the output
+   * requested region when UsePaddedRequestedRegion is on. */
   void GenerateInputRequestedRegion();
 
-  /** This filter must produce all of its output at once. */
+  /** This filter must produce all of its output at once, or the output
+   * requested region padded by the horizon of the recursions when
+   * UsePaddedRequestedRegion is on. */
   void EnlargeOutputRequestedRegion(DataObject *output);
 
-  /** These are needed by the smoothing spline routine. */
-  std::vector< CoeffType >           m_Scratch;   // temp storage for processing
-                                                  // of Coefficients
   typename TInputImage::SizeType m_DataLength;    // Image size
 
   unsigned int m_SplineOrder;                // User specified spline order (3rd
@@ -149,6 +181,8 @@ protected:
   unsigned int m_IteratorDirection;          // Direction for iterator
                                              // incrementing
 
+  bool m_UsePaddedRequestedRegion;
+
 private:
   BSplineDecompositionImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);                  //purposely not implemented
@@ -156,29 +190,31 @@ private:
   /** Determines the poles given the Spline Order. */
   virtual void SetPoles();
 
-  /** Converts a vector of data to a vector of Spline coefficients. */
-  virtual bool DataToCoefficients1D();
+  /** Number of samples after which the poles fall below the tolerance. */
+  typename TInputImage::SizeValueType GetHorizon() const;
 
-  /** Converts an N-dimension image of data to an equivalent sized image
-   *    of spline coefficients. */
-  void DataToCoefficientsND();
+  /** Converts the interleaved lines of a block of data to Spline
+   * coefficients. The sample n of the line l is
+   * scratch[n * NumberOfLinesPerBlock + l]. */
+  bool DataToCoefficients1D(CoeffType *scratch) const;
 
   /** Determines the first coefficient for the causal filtering of the data. */
-  virtual void SetInitialCausalCoefficient(double z);
+  void SetInitialCausalCoefficient(double z, CoeffType *scratch) const;
 
   /** Determines the first coefficient for the anti-causal filtering of the
     data. */
-  virtual void SetInitialAntiCausalCoefficient(double z);
-
-  /** Used to initialize the Coefficients image before calculation. */
-  void CopyImageToImage();
-
-  /** Copies a vector of data from the Coefficients image to the m_Scratch
-    vector. */
-  void CopyCoefficientsToScratch(OutputLinearIterator &);
-
-  /** Copies a vector of data from m_Scratch to the Coefficients image. */
-  void CopyScratchToCoefficients(OutputLinearIterator &);
+  void SetInitialAntiCausalCoefficient(double z, CoeffType *scratch) const;
+
+  /** Copies the lines of a block, up to NumberOfLinesPerBlock, from the
+    input or the Coefficients image to the scratch, and returns their
+    number. The iterator is left at the beginning of the next block. */
+  template< class TIterator >
+  unsigned int CopyLinesToScratch(TIterator & Iter, CoeffType *scratch);
+
+  /** Copies the lines of a block from the scratch to the Coefficients
+    image. */
+  void CopyScratchToCoefficients(OutputLinearIterator & Iter, const CoeffType *scratch,
+                                 unsigned int numberOfLines);
 };
 } // namespace itk
 
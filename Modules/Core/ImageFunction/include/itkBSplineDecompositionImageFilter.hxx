@@ -28,8 +28,6 @@
 #ifndef __itkBSplineDecompositionImageFilter_hxx
 #define __itkBSplineDecompositionImageFilter_hxx
 #include "itkBSplineDecompositionImageFilter.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "itkVector.h"
 
@@ -46,6 +44,7 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
   int SplineOrder = 3;
   m_Tolerance = 1e-10;   // Need some guidance on this one...what is reasonable?
   m_IteratorDirection = 0;
+  m_UsePaddedRequestedRegion = false;
   this->SetSplineOrder(SplineOrder);
 }
 
@@ -61,56 +60,7 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Spline Order: " << m_SplineOrder << std::endl;
-}
-
-template< class TInputImage, class TOutputImage >
-bool
-BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::DataToCoefficients1D()
-{
-  // See Unser, 1993, Part II, Equation 2.5,
-  //   or Unser, 1999, Box 2. for an explanation.
-
-  double c0 = 1.0;
-
-  if ( m_DataLength[m_IteratorDirection] == 1 ) //Required by mirror boundaries
-    {
-    return false;
-    }
-
-  // Compute overall gain
-  for ( int k = 0; k < m_NumberOfPoles; k++ )
-    {
-    // Note for cubic splines lambda = 6
-    c0 = c0 * ( 1.0 - m_SplinePoles[k] ) * ( 1.0 - 1.0 / m_SplinePoles[k] );
-    }
-
-  // apply the gain
-  for ( unsigned int n = 0; n < m_DataLength[m_IteratorDirection]; n++ )
-    {
-    m_Scratch[n] *= c0;
-    }
-
-  // loop over all poles
-  for ( int k = 0; k < m_NumberOfPoles; k++ )
-    {
-    // causal initialization
-    this->SetInitialCausalCoefficient(m_SplinePoles[k]);
-    // causal recursion
-    for ( unsigned int n = 1; n < m_DataLength[m_IteratorDirection]; n++ )
-      {
-      m_Scratch[n] += m_SplinePoles[k] * m_Scratch[n - 1];
-      }
-
-    // anticausal initialization
-    this->SetInitialAntiCausalCoefficient(m_SplinePoles[k]);
-    // anticausal recursion
-    for ( int n = m_DataLength[m_IteratorDirection] - 2; 0 <= n; n-- )
-      {
-      m_Scratch[n] = m_SplinePoles[k] * ( m_Scratch[n + 1] - m_Scratch[n] );
-      }
-    }
-  return true;
+  os << indent << "UsePaddedRequestedRegion: " << m_UsePaddedRequestedRegion << std::endl;
 }
 
 template< class TInputImage, class TOutputImage >
@@ -174,169 +124,342 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+typename TInputImage::SizeValueType
+BSplineDecompositionImageFilter< TInputImage, TOutputImage >
+::GetHorizon() const
+{
+  typename TInputImage::SizeValueType horizon = 0;
+  for ( int k = 0; k < m_NumberOfPoles; k++ )
+    {
+    const typename TInputImage::SizeValueType poleHorizon = (typename TInputImage::SizeValueType)
+      vcl_ceil( vcl_log(m_Tolerance) / vcl_log( vcl_fabs(m_SplinePoles[k]) ) );
+    if ( poleHorizon > horizon )
+      {
+      horizon = poleHorizon;
+      }
+    }
+  return horizon;
+}
+
+template< class TInputImage, class TOutputImage >
+bool
+BSplineDecompositionImageFilter< TInputImage, TOutputImage >
+::DataToCoefficients1D(CoeffType *scratch) const
+{
+  // See Unser, 1993, Part II, Equation 2.5,
+  //   or Unser, 1999, Box 2. for an explanation.
+
+  const unsigned int L = NumberOfLinesPerBlock;
+  const typename TInputImage::SizeValueType length = m_DataLength[m_IteratorDirection];
+
+  double c0 = 1.0;
+
+  if ( length == 1 ) //Required by mirror boundaries
+    {
+    return false;
+    }
+
+  // Compute overall gain
+  for ( int k = 0; k < m_NumberOfPoles; k++ )
+    {
+    // Note for cubic splines lambda = 6
+    c0 = c0 * ( 1.0 - m_SplinePoles[k] ) * ( 1.0 - 1.0 / m_SplinePoles[k] );
+    }
+
+  // apply the gain
+  for ( unsigned int n = 0; n < length * L; n++ )
+    {
+    scratch[n] *= c0;
+    }
+
+  // loop over all poles
+  for ( int k = 0; k < m_NumberOfPoles; k++ )
+    {
+    const double z = m_SplinePoles[k];
+
+    // causal initialization
+    this->SetInitialCausalCoefficient(z, scratch);
+    // causal recursion
+    for ( unsigned int n = 1; n < length; n++ )
+      {
+      CoeffType *      current = scratch + n * L;
+      const CoeffType *previous = current - L;
+      for ( unsigned int l = 0; l < L; l++ )
+        {
+        current[l] += z * previous[l];
+        }
+      }
+
+    // anticausal initialization
+    this->SetInitialAntiCausalCoefficient(z, scratch);
+    // anticausal recursion
+    for ( int n = length - 2; 0 <= n; n-- )
+      {
+      CoeffType *      current = scratch + n * L;
+      const CoeffType *next = current + L;
+      for ( unsigned int l = 0; l < L; l++ )
+        {
+        current[l] = z * ( next[l] - current[l] );
+        }
+      }
+    }
+  return true;
+}
+
 template< class TInputImage, class TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::SetInitialCausalCoefficient(double z)
+::SetInitialCausalCoefficient(double z, CoeffType *scratch) const
 {
   /* beginning InitialCausalCoefficient */
   /* See Unser, 1999, Box 2 for explanation */
-  CoeffType     sum;
-  double        zn, z2n, iz;
+  const unsigned int L = NumberOfLinesPerBlock;
+  CoeffType          sum[NumberOfLinesPerBlock];
+  double             zn, z2n, iz;
   typename TInputImage::SizeValueType horizon;
+  const typename TInputImage::SizeValueType length = m_DataLength[m_IteratorDirection];
 
   /* this initialization corresponds to mirror boundaries */
-  horizon = m_DataLength[m_IteratorDirection];
+  horizon = length;
   zn = z;
   if ( m_Tolerance > 0.0 )
     {
     horizon = (typename TInputImage::SizeValueType)
       vcl_ceil( vcl_log(m_Tolerance) / vcl_log( vcl_fabs(z) ) );
     }
-  if ( horizon < m_DataLength[m_IteratorDirection] )
+  if ( horizon < length )
     {
     /* accelerated loop */
-    sum = m_Scratch[0];   // verify this
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      sum[l] = scratch[l];
+      }
     for ( unsigned int n = 1; n < horizon; n++ )
       {
-      sum += zn * m_Scratch[n];
+      for ( unsigned int l = 0; l < L; l++ )
+        {
+        sum[l] += zn * scratch[n * L + l];
+        }
       zn *= z;
       }
-    m_Scratch[0] = sum;
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      scratch[l] = sum[l];
+      }
     }
   else
     {
     /* full loop */
     iz = 1.0 / z;
-    z2n = vcl_pow( z, (double)( m_DataLength[m_IteratorDirection] - 1L ) );
-    sum = m_Scratch[0] + z2n * m_Scratch[m_DataLength[m_IteratorDirection] - 1L];
+    z2n = vcl_pow( z, (double)( length - 1L ) );
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      sum[l] = scratch[l] + z2n * scratch[( length - 1L ) * L + l];
+      }
     z2n *= z2n * iz;
-    for ( unsigned int n = 1; n <= ( m_DataLength[m_IteratorDirection] - 2 ); n++ )
+    for ( unsigned int n = 1; n <= ( length - 2 ); n++ )
       {
-      sum += ( zn + z2n ) * m_Scratch[n];
+      for ( unsigned int l = 0; l < L; l++ )
+        {
+        sum[l] += ( zn + z2n ) * scratch[n * L + l];
+        }
       zn *= z;
       z2n *= iz;
       }
-    m_Scratch[0] = sum / ( 1.0 - zn * zn );
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      scratch[l] = sum[l] / ( 1.0 - zn * zn );
+      }
     }
 }
 
 template< class TInputImage, class TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::SetInitialAntiCausalCoefficient(double z)
+::SetInitialAntiCausalCoefficient(double z, CoeffType *scratch) const
 {
   // this initialization corresponds to mirror boundaries
   /* See Unser, 1999, Box 2 for explanation */
   //  Also see erratum at http://bigwww.epfl.ch/publications/unser9902.html
-  m_Scratch[m_DataLength[m_IteratorDirection] - 1] =
-    ( z / ( z * z - 1.0 ) )
-    * ( z * m_Scratch[m_DataLength[m_IteratorDirection] - 2] + m_Scratch[m_DataLength[m_IteratorDirection] - 1] );
+  const unsigned int L = NumberOfLinesPerBlock;
+  CoeffType *        last = scratch + ( m_DataLength[m_IteratorDirection] - 1 ) * L;
+  const CoeffType *  beforeLast = last - L;
+  for ( unsigned int l = 0; l < L; l++ )
+    {
+    last[l] = ( z / ( z * z - 1.0 ) ) * ( z * beforeLast[l] + last[l] );
+    }
 }
 
 template< class TInputImage, class TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::DataToCoefficientsND()
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
 {
-  OutputImagePointer output = this->GetOutput();
+  typedef ImageLinearConstIteratorWithIndex< TInputImage > InputLinearIterator;
 
-  Size< ImageDimension > size = output->GetBufferedRegion().GetSize();
+  const unsigned int direction = m_IteratorDirection;
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+  const typename TInputImage::SizeValueType numberOfLines =
+    outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(direction);
 
-  unsigned int count = output->GetBufferedRegion().GetNumberOfPixels() / size[0] * ImageDimension;
+  ProgressReporter progress( this, threadId, numberOfLines, 10,
+                             static_cast< float >( direction ) / ImageDimension, 1.0f / ImageDimension );
 
-  ProgressReporter progress(this, 0, count, 10);
+  std::vector< CoeffType > scratch(m_DataLength[direction] * NumberOfLinesPerBlock);
 
-  // Initialize coeffient array
-  this->CopyImageToImage();   // Coefficients are initialized to the input data
+  OutputLinearIterator CIterator(this->GetOutput(), outputRegionForThread);
+  CIterator.SetDirection(direction);
+  CIterator.GoToBegin();
 
-  for ( unsigned int n = 0; n < ImageDimension; n++ )
-    {
-    m_IteratorDirection = n;
-    // Loop through each dimension
+  // The coefficients are initialized to the input data along the first
+  // direction, and read back from the output along the next ones
+  InputLinearIterator  inputIterator(this->GetInput(), outputRegionForThread);
+  OutputLinearIterator coefficientIterator(this->GetOutput(), outputRegionForThread);
+  inputIterator.SetDirection(direction);
+  inputIterator.GoToBegin();
+  coefficientIterator.SetDirection(direction);
+  coefficientIterator.GoToBegin();
 
-    // Initialize iterators
-    OutputLinearIterator CIterator( output, output->GetBufferedRegion() );
-    CIterator.SetDirection(m_IteratorDirection);
-    // For each data vector
-    while ( !CIterator.IsAtEnd() )
-      {
-      // Copy coefficients to scratch
-      this->CopyCoefficientsToScratch(CIterator);
+  // For each block of data vectors
+  while ( !CIterator.IsAtEnd() )
+    {
+    const unsigned int numberOfLinesInBlock = ( direction == 0 )
+                                              ? this->CopyLinesToScratch(inputIterator, &scratch[0])
+                                              : this->CopyLinesToScratch(coefficientIterator, &scratch[0]);
 
-      // Perform 1D BSpline calculations
-      this->DataToCoefficients1D();
+    // Perform 1D BSpline calculations
+    this->DataToCoefficients1D(&scratch[0]);
 
-      // Copy scratch back to coefficients.
-      // Brings us back to the end of the line we were working on.
-      CIterator.GoToBeginOfLine();
-      this->CopyScratchToCoefficients(CIterator);   // m_Scratch = m_Image;
-      CIterator.NextLine();
+    this->CopyScratchToCoefficients(CIterator, &scratch[0], numberOfLinesInBlock);
+    for ( unsigned int l = 0; l < numberOfLinesInBlock; l++ )
+      {
       progress.CompletedPixel();
       }
     }
 }
 
 /**
- * Copy the input image into the output image
+ * Copy a block of lines to the scratch
  */
 template< class TInputImage, class TOutputImage >
-void
+template< class TIterator >
+unsigned int
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyImageToImage()
+::CopyLinesToScratch(TIterator & Iter, CoeffType *scratch)
 {
-  typedef ImageRegionConstIteratorWithIndex< TInputImage > InputIterator;
-  typedef ImageRegionIterator< TOutputImage >              OutputIterator;
-  typedef typename TOutputImage::PixelType                 OutputPixelType;
-
-  InputIterator  inIt( this->GetInput(), this->GetInput()->GetBufferedRegion() );
-  OutputIterator outIt( this->GetOutput(), this->GetOutput()->GetBufferedRegion() );
+  typedef typename TOutputImage::PixelType OutputPixelType;
+  const unsigned int L = NumberOfLinesPerBlock;
 
-  inIt.GoToBegin();
-  outIt.GoToBegin();
+  unsigned int numberOfLines = 0;
+  for (; numberOfLines < L && !Iter.IsAtEnd(); numberOfLines++ )
+    {
+    typename TOutputImage::SizeValueType j = 0;
+    while ( !Iter.IsAtEndOfLine() )
+      {
+      scratch[j * L + numberOfLines] = static_cast< CoeffType >( static_cast< OutputPixelType >( Iter.Get() ) );
+      ++Iter;
+      ++j;
+      }
+    Iter.NextLine();
+    }
 
-  while ( !outIt.IsAtEnd() )
+  // the missing lines of the last block repeat the first line
+  for ( unsigned int l = numberOfLines; l < L; l++ )
     {
-    outIt.Set( static_cast< OutputPixelType >( inIt.Get() ) );
-    ++inIt;
-    ++outIt;
+    for ( typename TOutputImage::SizeValueType j = 0; j < m_DataLength[m_IteratorDirection]; j++ )
+      {
+      scratch[j * L + l] = scratch[j * L];
+      }
     }
+  return numberOfLines;
 }
 
 /**
- * Copy the scratch to one line of the output image
+ * Copy a block of lines from the scratch to the output image
  */
 template< class TInputImage, class TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyScratchToCoefficients(OutputLinearIterator & Iter)
+::CopyScratchToCoefficients(OutputLinearIterator & Iter, const CoeffType *scratch,
+                            unsigned int numberOfLines)
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
-  typename TOutputImage::SizeValueType j = 0;
-  while ( !Iter.IsAtEndOfLine() )
+  const unsigned int L = NumberOfLinesPerBlock;
+
+  for ( unsigned int l = 0; l < numberOfLines; l++ )
     {
-    Iter.Set( static_cast< OutputPixelType >( m_Scratch[j] ) );
-    ++Iter;
-    ++j;
+    typename TOutputImage::SizeValueType j = 0;
+    while ( !Iter.IsAtEndOfLine() )
+      {
+      Iter.Set( static_cast< OutputPixelType >( scratch[j * L + l] ) );
+      ++Iter;
+      ++j;
+      }
+    Iter.NextLine();
     }
 }
 
 /**
- * Copy one line of the output image to the scratch
+ * SplitRequestedRegion method.
  */
 template< class TInputImage, class TOutputImage >
-void
+unsigned int
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyCoefficientsToScratch(OutputLinearIterator & Iter)
+::SplitRequestedRegion(unsigned int i, unsigned int num,
+                       OutputImageRegionType & splitRegion)
 {
-  typename TOutputImage::SizeValueType j = 0;
+  // Initialize the splitRegion to the output requested region
+  splitRegion = this->GetOutput()->GetRequestedRegion();
+
+  typename TOutputImage::IndexType splitIndex = splitRegion.GetIndex();
+  typename TOutputImage::SizeType  splitSize  = splitRegion.GetSize();
+
+  // split on the outermost dimension available
+  // and avoid the current direction
+  int splitAxis = static_cast< int >( ImageDimension ) - 1;
+  while ( ( splitSize[splitAxis] == 1 ) ||
+          ( splitAxis == static_cast< int >( m_IteratorDirection ) ) )
+    {
+    --splitAxis;
+    if ( splitAxis < 0 )
+      { // cannot split
+      itkDebugMacro("Cannot Split");
+      return 1;
+      }
+    }
+
+  // determine the actual number of pieces that will be generated
+  const double range = static_cast< double >( splitSize[splitAxis] );
+  const unsigned int valuesPerThread =
+    static_cast< unsigned int >( vcl_ceil( range / static_cast< double >( num ) ) );
+  const unsigned int maxThreadIdUsed =
+    static_cast< unsigned int >( vcl_ceil( range / static_cast< double >( valuesPerThread ) ) ) - 1;
 
-  while ( !Iter.IsAtEndOfLine() )
+  // Split the region
+  if ( i < maxThreadIdUsed )
     {
-    m_Scratch[j] = static_cast< CoeffType >( Iter.Get() );
-    ++Iter;
-    ++j;
+    splitIndex[splitAxis] += i * valuesPerThread;
+    splitSize[splitAxis] = valuesPerThread;
     }
+  if ( i == maxThreadIdUsed )
+    {
+    splitIndex[splitAxis] += i * valuesPerThread;
+    // last thread needs to process the "rest" dimension being split
+    splitSize[splitAxis] = splitSize[splitAxis] - i * valuesPerThread;
+    }
+
+  // set the split region ivars
+  splitRegion.SetIndex(splitIndex);
+  splitRegion.SetSize(splitSize);
+
+  itkDebugMacro("Split Piece: " << splitRegion);
+
+  return maxThreadIdUsed + 1;
 }
 
 /**
@@ -347,12 +470,22 @@ void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 ::GenerateInputRequestedRegion()
 {
-  // this filter requires the all of the input image to be in
-  // the buffer
   InputImagePointer inputPtr = const_cast< TInputImage * >( this->GetInput() );
 
-  if ( inputPtr )
+  if ( !inputPtr )
+    {
+    return;
+    }
+
+  if ( m_UsePaddedRequestedRegion )
     {
+    // the output requested region is already padded
+    Superclass::GenerateInputRequestedRegion();
+    }
+  else
+    {
+    // this filter requires the all of the input image to be in
+    // the buffer
     inputPtr->SetRequestedRegionToLargestPossibleRegion();
     }
 }
@@ -366,13 +499,27 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 ::EnlargeOutputRequestedRegion(
   DataObject *output)
 {
-  // this filter requires the all of the output image to be in
-  // the buffer
   TOutputImage *imgData;
 
   imgData = dynamic_cast< TOutputImage * >( output );
-  if ( imgData )
+  if ( !imgData )
+    {
+    return;
+    }
+
+  if ( m_UsePaddedRequestedRegion )
+    {
+    // the coefficients farther than the horizon from the requested
+    // region do not contribute to it
+    typename TOutputImage::RegionType outputRegion = imgData->GetRequestedRegion();
+    outputRegion.PadByRadius( static_cast< typename TOutputImage::OffsetValueType >( this->GetHorizon() ) );
+    outputRegion.Crop( imgData->GetLargestPossibleRegion() );
+    imgData->SetRequestedRegion(outputRegion);
+    }
+  else
     {
+    // this filter requires the all of the output image to be in
+    // the buffer
     imgData->SetRequestedRegionToLargestPossibleRegion();
     }
 }
@@ -385,31 +532,26 @@ void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  // Allocate scratch memory
-  InputImageConstPointer inputPtr = this->GetInput();
-
-  m_DataLength = inputPtr->GetBufferedRegion().GetSize();
-
-  typename TOutputImage::SizeValueType maxLength = 0;
-  for ( unsigned int n = 0; n < ImageDimension; n++ )
-    {
-    if ( m_DataLength[n] > maxLength )
-      {
-      maxLength = m_DataLength[n];
-      }
-    }
-  m_Scratch.resize(maxLength);
-
   // Allocate memory for output image
   OutputImagePointer outputPtr = this->GetOutput();
   outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
   outputPtr->Allocate();
 
-  // Calculate actual output
-  this->DataToCoefficientsND();
+  m_DataLength = outputPtr->GetBufferedRegion().GetSize();
+
+  // Calculate actual output, one direction after the other
+  typename ImageSource< TOutputImage >::ThreadStruct str;
+  str.Filter = this;
 
-  // Clean up
-  m_Scratch.clear();
+  MultiThreader *multithreader = this->GetMultiThreader();
+  multithreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  multithreader->SetSingleMethod(this->ThreaderCallback, &str);
+
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    m_IteratorDirection = n;
+    multithreader->SingleMethodExecute();
+    }
 }
 } // namespace itk
 
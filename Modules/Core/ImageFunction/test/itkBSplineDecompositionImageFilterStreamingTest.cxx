@@ -0,0 +1,218 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineDecompositionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Image< double, Dimension >                                ImageType;
+typedef itk::BSplineDecompositionImageFilter< ImageType, ImageType >   FilterType;
+
+ImageType::Pointer CreateImage(const ImageType::SizeType & size)
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int seed = 3;
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    seed = seed * 1103515245u + 12345u;
+    it.Set( static_cast< double >( ( seed >> 8 ) % 10000 ) / 100.0 );
+    }
+  return image;
+}
+
+ImageType::Pointer Decompose(ImageType *image, unsigned int splineOrder, itk::ThreadIdType numberOfThreads)
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetSplineOrder(splineOrder);
+  filter->SetNumberOfThreads(numberOfThreads);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+// the spline of the coefficients interpolates the image: the sampled
+// B-spline kernel, with mirror boundaries, gives back the input
+bool CheckInterpolation(const ImageType *image, const ImageType *coefficients, unsigned int splineOrder)
+{
+  const double kernels[][5] = { { 1.0 }, { 1.0 }, { 1.0 / 8, 6.0 / 8, 1.0 / 8 },
+                                { 1.0 / 6, 4.0 / 6, 1.0 / 6 },
+                                { 1.0 / 384, 76.0 / 384, 230.0 / 384, 76.0 / 384, 1.0 / 384 },
+                                { 1.0 / 120, 26.0 / 120, 66.0 / 120, 26.0 / 120, 1.0 / 120 } };
+  const int radius = static_cast< int >( splineOrder / 2 );
+
+  const ImageType::RegionType region = coefficients->GetBufferedRegion();
+  ImageType::Pointer          samples = ImageType::New();
+  samples->SetRegions(region);
+  samples->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > sit( samples, region );
+  for (; !sit.IsAtEnd(); ++sit )
+    {
+    sit.Set( coefficients->GetPixel( sit.GetIndex() ) );
+    }
+
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    ImageType::Pointer convolved = ImageType::New();
+    convolved->SetRegions(region);
+    convolved->Allocate();
+    const int length = static_cast< int >( region.GetSize(d) );
+    for ( itk::ImageRegionIteratorWithIndex< ImageType > it( convolved, region ); !it.IsAtEnd(); ++it )
+      {
+      double value = 0.0;
+      for ( int k = -radius; k <= radius; ++k )
+        {
+        int position = static_cast< int >( it.GetIndex()[d] ) + k;
+        if ( length == 1 )
+          {
+          position = 0;
+          }
+        position = ( position < 0 ) ? -position : position;
+        position = ( position >= length ) ? 2 * ( length - 1 ) - position : position;
+        ImageType::IndexType index = it.GetIndex();
+        index[d] = position;
+        value += kernels[splineOrder][k + radius] * samples->GetPixel(index);
+        }
+      it.Set(value);
+      }
+    samples = convolved;
+    }
+
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    if ( vnl_math_abs( it.Get() - samples->GetPixel( it.GetIndex() ) ) > 1e-6 )
+      {
+      std::cerr << "ERROR: with spline order " << splineOrder << ", the spline is "
+                << samples->GetPixel( it.GetIndex() ) << " instead of " << it.Get() << " at "
+                << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// only the padded requested region is computed, and its coefficients
+// are the coefficients of the whole image
+bool CheckPaddedRequestedRegion(ImageType *image, const ImageType *expected, unsigned int splineOrder)
+{
+  ImageType::IndexType start;
+  start[0] = 31;
+  start[1] = 9;
+  start[2] = 2;
+  ImageType::SizeType size;
+  size[0] = 7;
+  size[1] = 5;
+  size[2] = 3;
+  const ImageType::RegionType requestedRegion(start, size);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetSplineOrder(splineOrder);
+  filter->UsePaddedRequestedRegionOn();
+
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(3);
+  streamer->GetOutput()->SetRequestedRegion(requestedRegion);
+  streamer->Update();
+
+  // the last piece is buffered
+  const ImageType::RegionType & bufferedRegion = filter->GetOutput()->GetBufferedRegion();
+  if ( bufferedRegion.GetNumberOfPixels() >= image->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    std::cerr << "ERROR: the filter computed " << bufferedRegion << std::endl;
+    return false;
+    }
+
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( streamer->GetOutput(), requestedRegion );
+        !it.IsAtEnd(); ++it )
+    {
+    if ( vnl_math_abs( it.Get() - expected->GetPixel( it.GetIndex() ) ) > 1e-6 )
+      {
+      std::cerr << "ERROR: with spline order " << splineOrder << ", the coefficient of the padded region is "
+                << it.Get() << " instead of " << expected->GetPixel( it.GetIndex() ) << " at "
+                << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkBSplineDecompositionImageFilterStreamingTest(int, char *[])
+{
+  // the numbers of lines are not multiples of the number of lines of a
+  // block, and the lines of the last direction have a single sample
+  ImageType::SizeType size;
+  size[0] = 83;
+  size[1] = 27;
+  size[2] = 9;
+  ImageType::SizeType flatSize;
+  flatSize[0] = 19;
+  flatSize[1] = 13;
+  flatSize[2] = 1;
+  ImageType::Pointer image = CreateImage(size);
+  ImageType::Pointer flatImage = CreateImage(flatSize);
+
+  try
+    {
+    for ( unsigned int splineOrder = 0; splineOrder <= 5; ++splineOrder )
+      {
+      ImageType::Pointer coefficients = Decompose(image, splineOrder, 1);
+      if ( !CheckInterpolation(image, coefficients, splineOrder)
+           || !CheckInterpolation(flatImage, Decompose(flatImage, splineOrder, 3), splineOrder) )
+        {
+        return EXIT_FAILURE;
+        }
+
+      // the lines are split among the threads
+      ImageType::Pointer threaded = Decompose(image, splineOrder, 5);
+      for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( coefficients,
+                                                                    coefficients->GetBufferedRegion() );
+            !it.IsAtEnd(); ++it )
+        {
+        if ( it.Get() != threaded->GetPixel( it.GetIndex() ) )
+          {
+          std::cerr << "ERROR: with spline order " << splineOrder << ", 5 threads give "
+                    << threaded->GetPixel( it.GetIndex() ) << " instead of " << it.Get() << " at "
+                    << it.GetIndex() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      if ( !CheckPaddedRequestedRegion(image, coefficients, splineOrder) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
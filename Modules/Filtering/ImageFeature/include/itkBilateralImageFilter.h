@@ -22,6 +22,7 @@
 #include "itkFixedArray.h"
 #include "itkNeighborhoodIterator.h"
 #include "itkNeighborhood.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -52,6 +53,20 @@ namespace itk
  * Manduchi (Bilateral Filtering for Gray and ColorImages. IEEE
  * ICCV. 1998.)
  *
+ * The cost of the exact operator grows with the size of the domain
+ * kernel. When UseBilateralGrid is on, the filter is approximated with
+ * a bilateral grid (Paris and Durand, A Fast Approximation of the
+ * Bilateral Filter using a Signal Processing Approach. ECCV. 2006.):
+ * the pixels are splatted in a grid whose cells span the domain sigma
+ * divided by GridSamplingRate along each direction and the range sigma
+ * divided by GridSamplingRate in intensity, the grid is blurred with
+ * a separable Gaussian and the output is interpolated in the blurred
+ * grid. The cost is then nearly independent of the domain sigma, and
+ * the accuracy increases with GridSamplingRate. The threads process
+ * their regions in tiles with a grid each, so the output does not
+ * depend on the number of threads and of stream divisions. Radius and
+ * AutomaticKernelSize are not used by the approximation.
+ *
  * \sa GaussianOperator
  * \sa RecursiveGaussianImageFilter
  * \sa DiscreteGaussianImageFilter
@@ -167,6 +182,22 @@ public:
   itkSetMacro(NumberOfRangeGaussianSamples, unsigned long);
   itkGetConstMacro(NumberOfRangeGaussianSamples, unsigned long);
 
+  /** Set/Get whether the filter is approximated with a bilateral grid.
+   * Default is false. */
+  itkSetMacro(UseBilateralGrid, bool);
+  itkGetConstMacro(UseBilateralGrid, bool);
+  itkBooleanMacro(UseBilateralGrid);
+
+  /** Set/Get the number of cells of the bilateral grid per domain
+   * sigma and per range sigma. Cells are never smaller than a pixel.
+   * Default is 1. */
+  itkSetMacro(GridSamplingRate, double);
+  itkGetConstMacro(GridSamplingRate, double);
+
+  /** Number of cells along each direction of the tiles filtered with a
+   * bilateral grid. */
+  itkStaticConstMacro(BilateralGridTileSize, unsigned int, 16);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( OutputHasNumericTraitsCheck,
@@ -190,6 +221,8 @@ protected:
     m_DomainMu = 2.5;  // keep small to keep kernels small
     m_RangeMu = 4.0;   // can be bigger then DomainMu since we only
                        // index into a single table
+    m_UseBilateralGrid = false;
+    m_GridSamplingRate = 1.0;
   }
 
   virtual ~BilateralImageFilter() {}
@@ -203,6 +236,11 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  /** Approximate the filter on the region of a thread with a bilateral
+   * grid. */
+  void ThreadedGenerateDataWithBilateralGrid(const OutputImageRegionType & outputRegionForThread,
+                                             ThreadIdType threadId);
+
   /** BilateralImageFilter needs a larger input requested region than
    * the output requested region (larger by the size of the domain
    * Gaussian kernel).  As such, BilateralImageFilter needs to provide
@@ -216,6 +254,23 @@ private:
   BilateralImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);       //purposely not implemented
 
+  typedef typename TInputImage::SpacingType InputSpacingType;
+
+  /** Compute the size in pixels of the cells of the bilateral grid, the
+   * domain sigma in cells and the radius in cells of the grid blur.
+   * Return false when the sigmas or the sampling rate are not positive. */
+  bool ComputeBilateralGridGeometry(const InputSpacingType & spacing, ArrayType & cellSize,
+                                    ArrayType & sigma, SizeType & radius) const;
+
+  /** Splat the input pixels around a tile of the output in a bilateral
+   * grid, blur the grid, and interpolate the output in the grid. */
+  void FilterTileWithBilateralGrid(const OutputImageRegionType & tile, ProgressReporter & progress);
+
+  /** Convolve the grid, whose first dimension is the range, along one
+   * dimension with the kernel of that dimension. */
+  void BlurBilateralGrid(std::vector< double > & grid, const std::vector< SizeValueType > & gridSize,
+                         unsigned int dimension, std::vector< double > & buffer) const;
+
   /** The standard deviation of the gaussian blurring kernel in the image
       range. Units are intensity. */
   double m_RangeSigma;
@@ -242,6 +297,15 @@ private:
   double                m_DynamicRange;
   double                m_DynamicRangeUsed;
   std::vector< double > m_RangeGaussianTable;
+
+  /** Parameters of the bilateral grid. The kernels of the grid blur are
+   * indexed as the grid dimensions: the range first, then the image
+   * directions. */
+  bool                                m_UseBilateralGrid;
+  double                              m_GridSamplingRate;
+  ArrayType                           m_GridCellSize;
+  SizeType                            m_GridRadius;
+  std::vector< std::vector< double > > m_GridKernels;
 };
 } // end namespace itk
 
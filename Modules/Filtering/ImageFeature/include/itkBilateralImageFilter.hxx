@@ -20,6 +20,7 @@
 
 #include "itkBilateralImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
 #include "itkGaussianImageSource.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
@@ -59,7 +60,22 @@ throw( InvalidRequestedRegionError )
   typename TInputImage::SizeType radius;
   unsigned int i;
 
-  if ( m_AutomaticKernelSize )
+  // the grid of a tile reaches the blur radius and two cells beyond
+  // the cells of the tile; invalid grid parameters are reported when
+  // the filter runs
+  ArrayType cellSize;
+  ArrayType sigma;
+  SizeType  gridRadius;
+  if ( m_UseBilateralGrid
+       && this->ComputeBilateralGridGeometry(inputPtr->GetSpacing(), cellSize, sigma, gridRadius) )
+    {
+    for ( i = 0; i < ImageDimension; i++ )
+      {
+      radius[i] = static_cast< typename TInputImage::SizeType::SizeValueType >(
+        vcl_ceil( ( gridRadius[i] + 2 ) * cellSize[i] ) );
+      }
+    }
+  else if ( m_AutomaticKernelSize )
     {
     for ( i = 0; i < ImageDimension; i++ )
       {
@@ -107,6 +123,30 @@ throw( InvalidRequestedRegionError )
     }
 }
 
+template< class TInputImage, class TOutputImage >
+bool
+BilateralImageFilter< TInputImage, TOutputImage >
+::ComputeBilateralGridGeometry(const InputSpacingType & spacing, ArrayType & cellSize,
+                               ArrayType & sigma, SizeType & radius) const
+{
+  if ( m_GridSamplingRate <= 0.0 || m_RangeSigma <= 0.0 )
+    {
+    return false;
+    }
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const double sigmaInPixels = m_DomainSigma[i] / spacing[i];
+    if ( sigmaInPixels <= 0.0 )
+      {
+      return false;
+      }
+    cellSize[i] = vnl_math_max(sigmaInPixels / m_GridSamplingRate, 1.0);
+    sigma[i] = sigmaInPixels / cellSize[i];
+    radius[i] = static_cast< SizeValueType >( vcl_ceil(m_DomainMu * sigma[i]) );
+    }
+  return true;
+}
+
 template< class TInputImage, class TOutputImage >
 void
 BilateralImageFilter< TInputImage, TOutputImage >
@@ -126,6 +166,42 @@ BilateralImageFilter< TInputImage, TOutputImage >
   const typename InputImageType::SpacingType inputSpacing = inputImage->GetSpacing();
   const typename InputImageType::PointType inputOrigin  = inputImage->GetOrigin();
 
+  if ( m_UseBilateralGrid )
+    {
+    // Build the sampled Gaussians which blur the grid, the range has
+    // GridSamplingRate cells per sigma
+    ArrayType sigma;
+    if ( !this->ComputeBilateralGridGeometry(inputSpacing, m_GridCellSize, sigma, m_GridRadius) )
+      {
+      itkExceptionMacro(<< "GridSamplingRate " << m_GridSamplingRate << ", RangeSigma " << m_RangeSigma
+                        << " and DomainSigma " << m_DomainSigma
+                        << " must be positive to filter with a bilateral grid");
+      }
+
+    m_GridKernels.resize(ImageDimension + 1);
+    for ( i = 0; i <= ImageDimension; i++ )
+      {
+      const double        kernelSigma = ( i == 0 ) ? m_GridSamplingRate : sigma[i - 1];
+      const SizeValueType kernelRadius = ( i == 0 )
+                                         ? static_cast< SizeValueType >( vcl_ceil(m_RangeMu * m_GridSamplingRate) )
+                                         : m_GridRadius[i - 1];
+      std::vector< double > & kernel = m_GridKernels[i];
+      kernel.resize(2 * kernelRadius + 1);
+      double norm = 0.0;
+      for ( SizeValueType k = 0; k < kernel.size(); ++k )
+        {
+        const double x = static_cast< double >( k ) - static_cast< double >( kernelRadius );
+        kernel[k] = vcl_exp(-0.5 * x * x / ( kernelSigma * kernelSigma ) );
+        norm += kernel[k];
+        }
+      for ( SizeValueType k = 0; k < kernel.size(); ++k )
+        {
+        kernel[k] /= norm;
+        }
+      }
+    return;
+    }
+
   if ( m_AutomaticKernelSize )
     {
     for ( i = 0; i < ImageDimension; i++ )
@@ -235,6 +311,12 @@ BilateralImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  if ( m_UseBilateralGrid )
+    {
+    this->ThreadedGenerateDataWithBilateralGrid(outputRegionForThread, threadId);
+    return;
+    }
+
   typename TInputImage::ConstPointer input = this->GetInput();
   typename TOutputImage::Pointer output = this->GetOutput();
   typename TInputImage::IndexValueType i;
@@ -330,6 +412,310 @@ BilateralImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithBilateralGrid(const OutputImageRegionType & outputRegionForThread,
+                                        ThreadIdType threadId)
+{
+  typedef typename OutputImageType::IndexValueType IndexValueType;
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // Split the region of the thread in tiles of BilateralGridTileSize
+  // cells along each direction, so that the grids stay small
+  SizeType      tileSize;
+  SizeType      numberOfTiles;
+  SizeValueType totalNumberOfTiles = 1;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    tileSize[i] = vnl_math_max( static_cast< SizeValueType >( BilateralGridTileSize * m_GridCellSize[i] ),
+                                static_cast< SizeValueType >( 1 ) );
+    numberOfTiles[i] = ( outputRegionForThread.GetSize(i) + tileSize[i] - 1 ) / tileSize[i];
+    totalNumberOfTiles *= numberOfTiles[i];
+    }
+
+  for ( SizeValueType t = 0; t < totalNumberOfTiles; ++t )
+    {
+    OutputImageRegionType tile;
+    SizeValueType         position = t;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      const SizeValueType offset = ( position % numberOfTiles[i] ) * tileSize[i];
+      position /= numberOfTiles[i];
+      tile.SetIndex( i, outputRegionForThread.GetIndex(i) + static_cast< IndexValueType >( offset ) );
+      tile.SetSize( i, vnl_math_min( tileSize[i], outputRegionForThread.GetSize(i) - offset ) );
+      }
+    this->FilterTileWithBilateralGrid(tile, progress);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::FilterTileWithBilateralGrid(const OutputImageRegionType & tile, ProgressReporter & progress)
+{
+  typedef typename InputImageType::IndexValueType IndexValueType;
+  typedef typename InputImageType::RegionType     InputRegionType;
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *     output = this->GetOutput();
+  const double          rangeCellSize = m_RangeSigma / m_GridSamplingRate;
+  const unsigned int    gridDimension = ImageDimension + 1;
+
+  // The cells of the grid are centered on the multiples of the cell
+  // size, and the pixels are splatted in their nearest cell. The grid
+  // covers the cells of the tile, the cell after them for the
+  // interpolation, and the blur radius around them; the splatted
+  // region covers the pixels of those cells.
+  std::vector< SizeValueType > gridSize(gridDimension);
+  IndexValueType               cellStart[ImageDimension];
+  InputRegionType              splatRegion;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const double         cellSize = m_GridCellSize[i];
+    const IndexValueType first = tile.GetIndex(i);
+    const IndexValueType last = first + static_cast< IndexValueType >( tile.GetSize(i) ) - 1;
+    const IndexValueType radius = static_cast< IndexValueType >( m_GridRadius[i] );
+    cellStart[i] = static_cast< IndexValueType >( vcl_floor(first / cellSize) ) - radius;
+    const IndexValueType cellEnd = static_cast< IndexValueType >( vcl_floor(last / cellSize) ) + 1 + radius;
+    gridSize[i + 1] = static_cast< SizeValueType >( cellEnd - cellStart[i] + 1 );
+
+    // one more pixel on each side against the rounding, the cells of
+    // the pixels are checked when splatting
+    const IndexValueType splatFirst =
+      static_cast< IndexValueType >( vcl_ceil( ( cellStart[i] - 0.5 ) * cellSize ) ) - 1;
+    const IndexValueType splatLast =
+      static_cast< IndexValueType >( vcl_floor( ( cellEnd + 0.5 ) * cellSize ) ) + 1;
+    splatRegion.SetIndex(i, splatFirst);
+    splatRegion.SetSize( i, static_cast< SizeValueType >( splatLast - splatFirst + 1 ) );
+    }
+  splatRegion.Crop( input->GetBufferedRegion() );
+
+  // the cell of each index of the splatted region, -1 outside the grid
+  std::vector< IndexValueType > cellOfIndex[ImageDimension];
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    cellOfIndex[i].resize( splatRegion.GetSize(i) );
+    for ( SizeValueType j = 0; j < splatRegion.GetSize(i); ++j )
+      {
+      const IndexValueType index = splatRegion.GetIndex(i) + static_cast< IndexValueType >( j );
+      const IndexValueType cell =
+        static_cast< IndexValueType >( vcl_floor(index / m_GridCellSize[i] + 0.5) ) - cellStart[i];
+      cellOfIndex[i][j] = ( cell >= 0 && cell < static_cast< IndexValueType >( gridSize[i + 1] ) ) ? cell : -1;
+      }
+    }
+
+  // Find the cells of the lines of the splatted region in the image
+  // directions, and the range of the cells in intensity
+  typedef ImageLinearConstIteratorWithIndex< InputImageType > InputIteratorType;
+  InputIteratorType it(input, splatRegion);
+  it.SetDirection(0);
+
+  std::vector< IndexValueType > lineCells;
+  IndexValueType                rangeMin = NumericTraits< IndexValueType >::max();
+  IndexValueType                rangeMax = NumericTraits< IndexValueType >::NonpositiveMin();
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
+    {
+    const typename InputImageType::IndexType & lineIndex = it.GetIndex();
+    IndexValueType                             lineCell = 0;
+    for ( unsigned int i = ImageDimension - 1; i > 0 && lineCell >= 0; i-- )
+      {
+      const IndexValueType cell = cellOfIndex[i][lineIndex[i] - splatRegion.GetIndex(i)];
+      lineCell = ( cell < 0 ) ? -1 : lineCell * static_cast< IndexValueType >( gridSize[i + 1] ) + cell;
+      }
+    if ( lineCell < 0 )
+      {
+      lineCells.push_back(-1);
+      continue;
+      }
+    lineCells.push_back( lineCell * static_cast< IndexValueType >( gridSize[1] ) );
+    for ( SizeValueType j = 0; !it.IsAtEndOfLine(); ++it, ++j )
+      {
+      if ( cellOfIndex[0][j] >= 0 )
+        {
+        const IndexValueType rangeCell =
+          static_cast< IndexValueType >( vcl_floor(static_cast< double >( it.Get() ) / rangeCellSize + 0.5) );
+        rangeMin = vnl_math_min(rangeMin, rangeCell);
+        rangeMax = vnl_math_max(rangeMax, rangeCell);
+        }
+      }
+    }
+  if ( rangeMin > rangeMax )
+    {
+    return;
+    }
+
+  // the range of the grid has one more cell on each side for the
+  // interpolation
+  const IndexValueType rangeStart = rangeMin - 1;
+  gridSize[0] = static_cast< SizeValueType >( rangeMax - rangeMin + 3 );
+
+  SizeValueType numberOfCells = 1;
+  for ( unsigned int a = 0; a < gridDimension; a++ )
+    {
+    numberOfCells *= gridSize[a];
+    }
+  std::vector< double > values(numberOfCells, 0.0);
+  std::vector< double > weights(numberOfCells, 0.0);
+
+  // Splat
+  SizeValueType line = 0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine(), ++line )
+    {
+    if ( lineCells[line] < 0 )
+      {
+      continue;
+      }
+    for ( SizeValueType j = 0; !it.IsAtEndOfLine(); ++it, ++j )
+      {
+      const IndexValueType cell = cellOfIndex[0][j];
+      if ( cell >= 0 )
+        {
+        const double         value = static_cast< double >( it.Get() );
+        const IndexValueType rangeCell = static_cast< IndexValueType >( vcl_floor(value / rangeCellSize + 0.5) );
+        const SizeValueType  c = static_cast< SizeValueType >(
+          ( lineCells[line] + cell ) * static_cast< IndexValueType >( gridSize[0] ) + rangeCell - rangeStart );
+        values[c] += value;
+        weights[c] += 1.0;
+        }
+      }
+    }
+
+  // Blur
+  std::vector< double > buffer;
+  for ( unsigned int a = 0; a < gridDimension; a++ )
+    {
+    this->BlurBilateralGrid(values, gridSize, a, buffer);
+    this->BlurBilateralGrid(weights, gridSize, a, buffer);
+    }
+
+  // Slice: interpolate the output linearly between the cells around
+  // the position of each pixel in the blurred grid
+  std::vector< SizeValueType > stride(gridDimension);
+  stride[0] = 1;
+  for ( unsigned int a = 1; a < gridDimension; a++ )
+    {
+    stride[a] = stride[a - 1] * gridSize[a - 1];
+    }
+  const unsigned int           numberOfCorners = 1u << gridDimension;
+  std::vector< SizeValueType > cornerOffset(numberOfCorners, 0);
+  for ( unsigned int corner = 0; corner < numberOfCorners; corner++ )
+    {
+    for ( unsigned int a = 0; a < gridDimension; a++ )
+      {
+      if ( corner & ( 1u << a ) )
+        {
+        cornerOffset[corner] += stride[a];
+        }
+      }
+    }
+
+  // the offset of the cell below each index of the tile, and the
+  // distance to it in cells
+  std::vector< SizeValueType > cellBelow[ImageDimension];
+  std::vector< double >        fractionAbove[ImageDimension];
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    cellBelow[i].resize( tile.GetSize(i) );
+    fractionAbove[i].resize( tile.GetSize(i) );
+    for ( SizeValueType j = 0; j < tile.GetSize(i); ++j )
+      {
+      const double x = ( tile.GetIndex(i) + static_cast< IndexValueType >( j ) ) / m_GridCellSize[i];
+      const double below = vcl_floor(x);
+      cellBelow[i][j] = static_cast< SizeValueType >( static_cast< IndexValueType >( below ) - cellStart[i] )
+                        * stride[i + 1];
+      fractionAbove[i][j] = x - below;
+      }
+    }
+
+  InputIteratorType                               inputIt(input, tile);
+  ImageLinearIteratorWithIndex< OutputImageType > outputIt(output, tile);
+  inputIt.SetDirection(0);
+  outputIt.SetDirection(0);
+  std::vector< double > fraction(gridDimension);
+  for ( inputIt.GoToBegin(), outputIt.GoToBegin(); !outputIt.IsAtEnd(); inputIt.NextLine(), outputIt.NextLine() )
+    {
+    const typename OutputImageType::IndexType & lineIndex = outputIt.GetIndex();
+    SizeValueType                               lineOffset = 0;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      const SizeValueType j = static_cast< SizeValueType >( lineIndex[i] - tile.GetIndex(i) );
+      lineOffset += cellBelow[i][j];
+      fraction[i + 1] = fractionAbove[i][j];
+      }
+    for ( SizeValueType j = 0; !outputIt.IsAtEndOfLine(); ++inputIt, ++outputIt, ++j )
+      {
+      const double z = static_cast< double >( inputIt.Get() ) / rangeCellSize - rangeStart;
+      const double below = vcl_floor(z);
+      fraction[0] = z - below;
+      fraction[1] = fractionAbove[0][j];
+      const SizeValueType base = lineOffset + cellBelow[0][j] + static_cast< SizeValueType >( below );
+
+      double val = 0.0;
+      double normFactor = 0.0;
+      for ( unsigned int corner = 0; corner < numberOfCorners; corner++ )
+        {
+        double weight = 1.0;
+        for ( unsigned int a = 0; a < gridDimension; a++ )
+          {
+          weight *= ( corner & ( 1u << a ) ) ? fraction[a] : 1.0 - fraction[a];
+          }
+        val += weight * values[base + cornerOffset[corner]];
+        normFactor += weight * weights[base + cornerOffset[corner]];
+        }
+      outputIt.Set( static_cast< OutputPixelType >( val / normFactor ) );
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::BlurBilateralGrid(std::vector< double > & grid, const std::vector< SizeValueType > & gridSize,
+                    unsigned int dimension, std::vector< double > & buffer) const
+{
+  typedef typename InputImageType::IndexValueType IndexValueType;
+
+  const std::vector< double > & kernel = m_GridKernels[dimension];
+  const IndexValueType          radius = static_cast< IndexValueType >( kernel.size() / 2 );
+
+  // the grid is a sequence of slabs, which are sequences of cells along
+  // the dimension, which are sequences of inner values
+  SizeValueType inner = 1;
+  for ( unsigned int a = 0; a < dimension; a++ )
+    {
+    inner *= gridSize[a];
+    }
+  const IndexValueType length = static_cast< IndexValueType >( gridSize[dimension] );
+  const SizeValueType  slabSize = inner * gridSize[dimension];
+
+  // the cells beyond the grid are empty
+  buffer.resize(slabSize);
+  for ( SizeValueType slab = 0; slab < grid.size(); slab += slabSize )
+    {
+    double *data = &grid[slab];
+    std::copy( data, data + slabSize, buffer.begin() );
+    for ( IndexValueType c = 0; c < length; ++c )
+      {
+      double *             out = data + c * inner;
+      const IndexValueType kBegin = vnl_math_max(-radius, -c);
+      const IndexValueType kEnd = vnl_math_min(radius, length - 1 - c);
+      std::fill(out, out + inner, 0.0);
+      for ( IndexValueType k = kBegin; k <= kEnd; ++k )
+        {
+        const double  weight = kernel[k + radius];
+        const double *in = &buffer[( c + k ) * inner];
+        for ( SizeValueType j = 0; j < inner; ++j )
+          {
+          out[j] += weight * in[j];
+          }
+        }
+      }
+    }
+}
+
 template< class TInputImage, class TOutputImage >
 void
 BilateralImageFilter< TInputImage, TOutputImage >
@@ -345,6 +731,8 @@ BilateralImageFilter< TInputImage, TOutputImage >
   os << indent << "Amount of dynamic range used: " << m_DynamicRangeUsed << std::endl;
   os << indent << "AutomaticKernelSize: " << m_AutomaticKernelSize << std::endl;
   os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "UseBilateralGrid: " << m_UseBilateralGrid << std::endl;
+  os << indent << "GridSamplingRate: " << m_GridSamplingRate << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBilateralImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Image< float, Dimension >                          ImageType;
+typedef itk::BilateralImageFilter< ImageType, ImageType >       FilterType;
+typedef itk::StreamingImageFilter< ImageType, ImageType >       StreamerType;
+
+// two plateaus separated by a plane, with noise
+ImageType::Pointer CreateImage()
+{
+  ImageType::SizeType size;
+  size[0] = 53;
+  size[1] = 41;
+  size[2] = 19;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+  image->SetSpacing(spacing);
+
+  unsigned int seed = 5;
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    seed = seed * 1103515245u + 12345u;
+    const float noise = static_cast< float >( ( seed >> 8 ) % 41 ) - 20.0f;
+    it.Set( ( 2 * index[0] + index[1] < 60 ? 50.0f : 200.0f ) + noise );
+    }
+  return image;
+}
+
+ImageType::Pointer Filter(ImageType *image, bool useBilateralGrid, double samplingRate,
+                          unsigned int numberOfStreamDivisions, itk::ThreadIdType numberOfThreads)
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetDomainSigma(3.0);
+  filter->SetRangeSigma(30.0);
+  filter->SetUseBilateralGrid(useBilateralGrid);
+  filter->SetGridSamplingRate(samplingRate);
+  filter->SetNumberOfThreads(numberOfThreads);
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+}
+
+int itkBilateralImageFilterGridTest(int, char *[])
+{
+  ImageType::Pointer image = CreateImage();
+
+  try
+    {
+    ImageType::Pointer exact = Filter(image, false, 1.0, 1, 1);
+    const double       samplingRates[] = { 1.0, 2.0 };
+    const double       tolerances[] = { 1.5, 0.5 };
+    for ( unsigned int s = 0; s < 2; ++s )
+      {
+      // the grids of the tiles do not depend on the split of the output
+      ImageType::Pointer grid = Filter(image, true, samplingRates[s], 1, 1);
+      ImageType::Pointer streamed = Filter(image, true, samplingRates[s], 4, 3);
+
+      double maximumError = 0.0;
+      double totalError = 0.0;
+      itk::ImageRegionConstIteratorWithIndex< ImageType > it( exact, exact->GetLargestPossibleRegion() );
+      for (; !it.IsAtEnd(); ++it )
+        {
+        const float value = grid->GetPixel( it.GetIndex() );
+        if ( value != streamed->GetPixel( it.GetIndex() ) )
+          {
+          std::cerr << "ERROR: at " << it.GetIndex() << " the streamed grid gives "
+                    << streamed->GetPixel( it.GetIndex() ) << " instead of " << value << std::endl;
+          return EXIT_FAILURE;
+          }
+        const double error = vnl_math_abs( static_cast< double >( value ) - it.Get() );
+        maximumError = vnl_math_max(maximumError, error);
+        totalError += error;
+        }
+      const double meanError = totalError / exact->GetLargestPossibleRegion().GetNumberOfPixels();
+      std::cout << "GridSamplingRate " << samplingRates[s] << ": mean error " << meanError
+                << ", maximum error " << maximumError << std::endl;
+
+      // the edge of 150 is preserved
+      if ( meanError > tolerances[s] || maximumError > 10.0 )
+        {
+        std::cerr << "ERROR: the bilateral grid is too far from the exact filter" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->UseBilateralGridOn();
+  filter->SetGridSamplingRate(0.0);
+  try
+    {
+    filter->Update();
+    std::cerr << "ERROR: a GridSamplingRate of 0 should throw" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
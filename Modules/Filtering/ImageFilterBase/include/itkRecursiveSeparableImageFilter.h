@@ -43,6 +43,14 @@ namespace itk
  * G. Farneback & C.-F. Westin, "On Implementation of Recursive Gaussian
  * Filters", so far unpublished.
  *
+ * For scalar pixels, NumberOfLinesPerBlock adjacent lines are filtered
+ * together: their pixels are interleaved in a buffer, so that each step
+ * of the recursion applies to all the lines at once in a loop the
+ * compiler vectorizes, and so that the lines of the slower directions
+ * are read and written in runs of neighbouring pixels. Multi-component
+ * pixels, or UseMultiLineFiltering set to false, filter the lines one
+ * at a time.
+ *
  * \ingroup ImageFilters
  * \ingroup ITKImageFilterBase
  */
@@ -87,6 +95,15 @@ public:
   /** Set the direction in which the filter is to be applied. */
   itkSetMacro(Direction, unsigned int);
 
+  /** Set/Get whether adjacent lines of scalar pixels are filtered
+   * together, NumberOfLinesPerBlock at a time. The default is on. */
+  itkSetMacro(UseMultiLineFiltering, bool);
+  itkGetConstMacro(UseMultiLineFiltering, bool);
+  itkBooleanMacro(UseMultiLineFiltering);
+
+  /** Number of lines filtered together. */
+  itkStaticConstMacro(NumberOfLinesPerBlock, unsigned int, 8);
+
   /** Set Input Image. */
   void SetInputImage(const TInputImage *);
 
@@ -130,6 +147,17 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        unsigned int ln);
 
+  /** Apply the Recursive Filter to NumberOfLinesPerBlock lines at once.
+   * The pixel i of line l is at index i * NumberOfLinesPerBlock + l of
+   * the parameters "outs", "data" and "scratch", which hold ln *
+   * NumberOfLinesPerBlock values. */
+  void FilterDataBlock(RealType *outs, const RealType *data, RealType *scratch,
+                       unsigned int ln);
+
+  /** Filter the lines of the region by blocks of NumberOfLinesPerBlock
+   * lines. */
+  void ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
@@ -170,6 +198,8 @@ private:
   /** Direction in which the filter is to be applied
    * this should be in the range [0,ImageDimension-1]. */
   unsigned int m_Direction;
+
+  bool m_UseMultiLineFiltering;
 };
 } // end namespace itk
 
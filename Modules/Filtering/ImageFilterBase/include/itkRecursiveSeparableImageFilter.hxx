@@ -22,7 +22,9 @@
 #include "itkObjectFactory.h"
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
+#include "itkIsSame.h"
 #include <new>
+#include <vector>
 
 namespace itk
 {
@@ -31,6 +33,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::RecursiveSeparableImageFilter()
 {
   m_Direction = 0;
+  m_UseMultiLineFiltering = true;
   this->SetNumberOfRequiredOutputs(1);
   this->SetNumberOfRequiredInputs(1);
 
@@ -152,6 +155,140 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to a block of interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataBlock(RealType *outs, const RealType *data,
+                  RealType *scratch, unsigned int ln)
+{
+  const unsigned int L = NumberOfLinesPerBlock;
+
+  // the coefficients are copied, so that the stores in the buffers do
+  // not force to reload them in the loops
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+
+  /**
+   * Causal direction pass, the borders are initialized as in
+   * FilterDataArray
+   */
+  for ( unsigned int l = 0; l < L; l++ )
+    {
+    const unsigned int k0 = l;
+    const unsigned int k1 = k0 + L;
+    const unsigned int k2 = k1 + L;
+    const unsigned int k3 = k2 + L;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV1 = data[k0];
+
+    scratch[k0] = RealType(outV1    * n0 +    outV1 * n1 + outV1    * n2 + outV1 * n3);
+    scratch[k1] = RealType(data[k1] * n0 +    outV1 * n1 + outV1    * n2 + outV1 * n3);
+    scratch[k2] = RealType(data[k2] * n0 + data[k1] * n1 + outV1    * n2 + outV1 * n3);
+    scratch[k3] = RealType(data[k3] * n0 + data[k2] * n1 + data[k1] * n2 + outV1 * n3);
+
+    scratch[k0] -= RealType(outV1       * m_BN1 + outV1       * m_BN2 + outV1       * m_BN3 + outV1 * m_BN4);
+    scratch[k1] -= RealType(scratch[k0] * d1    + outV1       * m_BN2 + outV1       * m_BN3 + outV1 * m_BN4);
+    scratch[k2] -= RealType(scratch[k1] * d1    + scratch[k0] * d2    + outV1       * m_BN3 + outV1 * m_BN4);
+    scratch[k3] -= RealType(scratch[k2] * d1    + scratch[k1] * d2    + scratch[k0] * d3    + outV1 * m_BN4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = 4; i < ln; i++ )
+    {
+    const RealType *data0 = data + i * L;
+    const RealType *data1 = data0 - L;
+    const RealType *data2 = data1 - L;
+    const RealType *data3 = data2 - L;
+    RealType *      s0 = scratch + i * L;
+    const RealType *s1 = s0 - L;
+    const RealType *s2 = s1 - L;
+    const RealType *s3 = s2 - L;
+    const RealType *s4 = s3 - L;
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      s0[l]  = RealType(data0[l] * n0 + data1[l] * n1 + data2[l] * n2 + data3[l] * n3);
+      s0[l] -= RealType(s1[l] * d1 + s2[l] * d2 + s3[l] * d3 + s4[l] * d4);
+      }
+    }
+
+  /**
+   * Store the causal result
+   */
+  for ( unsigned int k = 0; k < ln * L; k++ )
+    {
+    outs[k] = scratch[k];
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  for ( unsigned int l = 0; l < L; l++ )
+    {
+    const unsigned int k0 = ( ln - 1 ) * L + l;
+    const unsigned int k1 = k0 - L;
+    const unsigned int k2 = k1 - L;
+    const unsigned int k3 = k2 - L;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV2 = data[k0];
+
+    scratch[k0] = RealType(outV2    * m1 + outV2    * m2 + outV2    * m3 + outV2 * m4);
+    scratch[k1] = RealType(data[k0] * m1 + outV2    * m2 + outV2    * m3 + outV2 * m4);
+    scratch[k2] = RealType(data[k1] * m1 + data[k0] * m2 + outV2    * m3 + outV2 * m4);
+    scratch[k3] = RealType(data[k2] * m1 + data[k1] * m2 + data[k0] * m3 + outV2 * m4);
+
+    scratch[k0] -= RealType(outV2       * m_BM1 + outV2       * m_BM2 + outV2       * m_BM3 + outV2 * m_BM4);
+    scratch[k1] -= RealType(scratch[k0] * d1    + outV2       * m_BM2 + outV2       * m_BM3 + outV2 * m_BM4);
+    scratch[k2] -= RealType(scratch[k1] * d1    + scratch[k0] * d2    + outV2       * m_BM3 + outV2 * m_BM4);
+    scratch[k3] -= RealType(scratch[k2] * d1    + scratch[k1] * d2    + scratch[k0] * d3    + outV2 * m_BM4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = ln - 4; i > 0; i-- )
+    {
+    const RealType *data0 = data + i * L;
+    const RealType *data1 = data0 + L;
+    const RealType *data2 = data1 + L;
+    const RealType *data3 = data2 + L;
+    const RealType *s0 = scratch + i * L;
+    const RealType *s1 = s0 + L;
+    const RealType *s2 = s1 + L;
+    const RealType *s3 = s2 + L;
+    RealType *      s = scratch + ( i - 1 ) * L;
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      s[l]  = RealType(data0[l] * m1 + data1[l] * m2 + data2[l] * m3 + data3[l] * m4);
+      s[l] -= RealType(s0[l] * d1 + s1[l] * d2 + s2[l] * d3 + s3[l] * d4);
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for ( unsigned int k = 0; k < ln * L; k++ )
+    {
+    outs[k] += scratch[k];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -285,6 +422,13 @@ void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
+  // the lines of scalar pixels are filtered in blocks
+  if ( m_UseMultiLineFiltering && IsSame< RealType, ScalarRealType >::Value )
+    {
+    this->ThreadedGenerateDataInBlocks(outputRegionForThread, threadId);
+    return;
+    }
+
   typedef typename TOutputImage::PixelType OutputPixelType;
 
   typedef ImageLinearConstIteratorWithIndex< TInputImage > InputConstIteratorType;
@@ -367,6 +511,95 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   delete[] scratch;
 }
 
+/**
+ * Compute Recursive filter
+ * NumberOfLinesPerBlock lines at a time in one of the dimensions
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  typedef typename TOutputImage::PixelType OutputPixelType;
+
+  typedef ImageLinearConstIteratorWithIndex< TInputImage > InputConstIteratorType;
+  typedef ImageLinearIteratorWithIndex< TOutputImage >     OutputIteratorType;
+
+  const unsigned int L = NumberOfLinesPerBlock;
+
+  typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
+  typename TOutputImage::Pointer     outputImage( this->GetOutput() );
+
+  InputConstIteratorType inputIterator(inputImage,  outputRegionForThread);
+  OutputIteratorType     outputIterator(outputImage, outputRegionForThread);
+
+  inputIterator.SetDirection(this->m_Direction);
+  outputIterator.SetDirection(this->m_Direction);
+
+  const unsigned int ln = outputRegionForThread.GetSize()[this->m_Direction];
+
+  // the lanes of the lines missing in the last block are filtered too,
+  // but not written
+  std::vector< RealType > inps(ln * L);
+  std::vector< RealType > outs(ln * L);
+  std::vector< RealType > scratch(ln * L);
+
+  // the iterators of the lines of a block, they are copies of the
+  // iterators of the region since a default iterator can not be copied
+  std::vector< InputConstIteratorType > inputLines(L, inputIterator);
+  std::vector< OutputIteratorType >     outputLines(L, outputIterator);
+
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / ln;
+  ProgressReporter    progress(this, threadId, numberOfLinesToProcess, 10);
+
+  inputIterator.GoToBegin();
+  outputIterator.GoToBegin();
+
+  while ( !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+    {
+    unsigned int numberOfLines = 0;
+    while ( numberOfLines < L && !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+      {
+      inputLines[numberOfLines] = inputIterator;
+      outputLines[numberOfLines] = outputIterator;
+      ++numberOfLines;
+      inputIterator.NextLine();
+      outputIterator.NextLine();
+      }
+
+    // the lines are read together, the pixels of the lines along the
+    // slower directions are neighbours in memory
+    for ( unsigned int i = 0; i < ln; i++ )
+      {
+      RealType *inp = &inps[i * L];
+      for ( unsigned int l = 0; l < numberOfLines; l++ )
+        {
+        inp[l] = inputLines[l].Get();
+        ++inputLines[l];
+        }
+      }
+
+    this->FilterDataBlock(&outs[0], &inps[0], &scratch[0], ln);
+
+    for ( unsigned int i = 0; i < ln; i++ )
+      {
+      const RealType *out = &outs[i * L];
+      for ( unsigned int l = 0; l < numberOfLines; l++ )
+        {
+        outputLines[l].Set( static_cast< OutputPixelType >( out[l] ) );
+        ++outputLines[l];
+        }
+      }
+
+    // Although the method name is CompletedPixel(),
+    // this is being called after each line is processed
+    for ( unsigned int l = 0; l < numberOfLines; l++ )
+      {
+      progress.CompletedPixel();
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
@@ -375,6 +608,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Direction: " << m_Direction << std::endl;
+  os << indent << "UseMultiLineFiltering: " << ( m_UseMultiLineFiltering ? "On" : "Off" ) << std::endl;
 }
 } // end namespace itk
 
@@ -92,6 +92,13 @@ public:
   typedef typename TInputImage::PixelType     InputPixelType;
   typedef typename TOutputImage::PixelType    OutputPixelType;
 
+  /** The absolute value of a pixel depends on that pixel only, so the
+   * output can be generated in any number of pieces per thread. */
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return true;
+  }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( ConvertibleCheck,
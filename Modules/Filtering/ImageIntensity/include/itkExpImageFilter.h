@@ -88,6 +88,13 @@ public:
   itkTypeMacro(ExpImageFilter,
                UnaryFunctorImageFilter);
 
+  /** Functor::Exp has no state: ThreadedGenerateData() may be called for
+   * many pieces per thread. */
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return true;
+  }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( InputConvertibleToDoubleCheck,
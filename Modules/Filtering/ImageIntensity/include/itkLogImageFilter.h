@@ -84,6 +84,13 @@ public:
   itkTypeMacro(LogImageFilter,
                UnaryFunctorImageFilter);
 
+  /** Functor::Log has no state, and each output pixel depends only on the
+   * input pixel at the same index, so DynamicMultiThreading is supported. */
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return true;
+  }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( InputConvertibleToDoubleCheck,
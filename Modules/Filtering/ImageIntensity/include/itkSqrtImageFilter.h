@@ -86,6 +86,13 @@ public:
   itkTypeMacro(SqrtImageFilter,
                UnaryFunctorImageFilter);
 
+  /** Each output pixel is the square root of the input pixel at the same
+   * index, so the filter supports DynamicMultiThreading. */
+  virtual bool CanRunDynamicMultiThreading() const
+  {
+    return true;
+  }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( InputConvertibleToDoubleCheck,
@@ -20,6 +20,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
+#include <vector>
 
 namespace itk
 {
@@ -43,6 +45,14 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * For scalar pixels, the separable convolution is computed tile by tile
+ * by the threads of this filter: each tile of the output is loaded with
+ * the halo of the kernels, the 1D kernels are applied axis by axis in
+ * two buffers small enough to stay in the cache, and the tile is
+ * written to the output. No intermediate image is allocated, and the
+ * result is the one of the pipeline of NeighborhoodOperatorImageFilter
+ * used for the other pixel types, or when UseFusedConvolution is off.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -98,6 +108,13 @@ public:
   /** Typedef of double containers */
   typedef FixedArray< double, itkGetStaticConstMacro(ImageDimension) > ArrayType;
 
+  typedef typename TOutputImage::RegionType OutputImageRegionType;
+
+  /** Type of the pixel used for intermediate results, and of the
+   * coefficients of the kernels. */
+  typedef typename NumericTraits< OutputPixelType >::RealType         RealOutputPixelType;
+  typedef typename NumericTraits< RealOutputPixelType >::ValueType    RealOutputPixelValueType;
+
   /** The variance for the discrete Gaussian kernel.  Sets the variance
    * independently for each dimension, but
    * see also SetVariance(const double v). The default is 0.0 in each
@@ -212,6 +229,14 @@ public:
   itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether the convolution of scalar pixels is computed tile
+   * by tile, without intermediate images. The internal pipeline and its
+   * InternalNumberOfStreamDivisions are then not used. The default is
+   * on. */
+  itkSetMacro(UseFusedConvolution, bool);
+  itkGetConstMacro(UseFusedConvolution, bool);
+  itkBooleanMacro(UseFusedConvolution);
+
   /** DiscreteGaussianImageFilter needs a larger input requested region
    * than the output requested region (larger by the size of the
    * Gaussian kernel).  As such, DiscreteGaussianImageFilter needs to
@@ -239,6 +264,7 @@ protected:
     m_UseImageSpacing = true;
     m_FilterDimensionality = ImageDimension;
     m_InternalNumberOfStreamDivisions = ImageDimension * ImageDimension;
+    m_UseFusedConvolution = true;
   }
 
   virtual ~DiscreteGaussianImageFilter() {}
@@ -248,9 +274,16 @@ protected:
    * ThreadedGenerateData(), its GenerateData() delegates all
    * calculations to an NeighborhoodOperatorImageFilter.  Since the
    * NeighborhoodOperatorImageFilter is multithreaded, this filter is
-   * multithreaded by default. */
+   * multithreaded by default. For scalar pixels, the threads of this
+   * filter compute the convolution in ThreadedGenerateData(). */
   void GenerateData();
 
+  /** Compute the kernels of the fused convolution. */
+  void BeforeThreadedGenerateData();
+
+  /** Convolve the tiles of the region with the kernels. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId);
+
 private:
   DiscreteGaussianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);              //purposely not implemented
@@ -277,6 +310,20 @@ private:
   /** Number of pieces to divide the input on the internal composite
   pipeline. The upstream pipeline will not be effected. */
   unsigned int m_InternalNumberOfStreamDivisions;
+
+  /** The fused convolution is only defined for scalar pixels. */
+  void ConvolveTiles(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId, TrueType);
+  void ConvolveTiles(const OutputImageRegionType &, ThreadIdType, FalseType) {}
+
+  /** Apply the kernel of a direction to the values of a tile. */
+  void ConvolveAlongDirection(const RealOutputPixelValueType *input, RealOutputPixelValueType *output,
+                              SizeValueType size[], unsigned int direction) const;
+
+  bool m_UseFusedConvolution;
+
+  /** The coefficients of the kernels of the fused convolution, in each
+   * filtered direction. */
+  std::vector< std::vector< RealOutputPixelValueType > > m_Kernels;
 };
 } // end namespace itk
 
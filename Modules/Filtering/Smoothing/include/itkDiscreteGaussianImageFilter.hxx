@@ -23,7 +23,9 @@
 #include "itkGaussianOperator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
+#include "itkProgressReporter.h"
 #include "itkStreamingImageFilter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -53,6 +55,13 @@ throw( InvalidRequestedRegionError )
 
   for ( unsigned int i = 0; i < TInputImage::ImageDimension; i++ )
     {
+    // the directions which are not smoothed are not padded
+    if ( i >= m_FilterDimensionality )
+      {
+      radius[i] = 0;
+      continue;
+      }
+
     // Determine the size of the operator in this dimension.  Note that the
     // Gaussian is built as a 1D operator in each of the specified directions.
     oper.SetDirection(i);
@@ -117,6 +126,14 @@ void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
+  // scalar pixels are convolved tile by tile by the threads of this
+  // filter
+  if ( m_UseFusedConvolution && IsSame< RealOutputPixelType, RealOutputPixelValueType >::Value )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
   typename TOutputImage::Pointer output = this->GetOutput();
 
   output->SetBufferedRegion( output->GetRequestedRegion() );
@@ -153,11 +170,8 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     return;
     }
 
-  // Type of the pixel to use for intermediate results
-  typedef typename NumericTraits< OutputPixelType >::RealType RealOutputPixelType;
-  typedef Image< OutputPixelType, ImageDimension >            RealOutputImageType;
-
-  typedef typename NumericTraits<RealOutputPixelType>::ValueType RealOutputPixelValueType;
+  // Type of the image to use for intermediate results
+  typedef Image< OutputPixelType, ImageDimension > RealOutputImageType;
 
   // Type definition for the internal neighborhood filter
   //
@@ -328,6 +342,293 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  const InputImageType *input = this->GetInput();
+
+  unsigned int filterDimensionality = m_FilterDimensionality;
+  if ( filterDimensionality > ImageDimension )
+    {
+    filterDimensionality = ImageDimension;
+    }
+
+  // the kernels are the coefficients of the operators of the internal
+  // pipeline
+  m_Kernels.resize(filterDimensionality);
+  for ( unsigned int i = 0; i < filterDimensionality; ++i )
+    {
+    GaussianOperator< RealOutputPixelValueType, ImageDimension > oper;
+    oper.SetDirection(i);
+    if ( m_UseImageSpacing == true )
+      {
+      if ( input->GetSpacing()[i] == 0.0 )
+        {
+        itkExceptionMacro(<< "Pixel spacing cannot be zero");
+        }
+      else
+        {
+        // convert the variance from physical units to pixels
+        double s = input->GetSpacing()[i];
+        s = s * s;
+        oper.SetVariance(m_Variance[i] / s);
+        }
+      }
+    else
+      {
+      oper.SetVariance(m_Variance[i]);
+      }
+    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+    oper.SetMaximumError(m_MaximumError[i]);
+    oper.CreateDirectional();
+
+    m_Kernels[i].assign( oper.Begin(), oper.End() );
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  this->ConvolveTiles( outputRegionForThread, threadId,
+                       typename IsSame< RealOutputPixelType, RealOutputPixelValueType >::Type() );
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ConvolveTiles(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId, TrueType)
+{
+  typedef typename InputImageType::IndexValueType IndexValueType;
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *     output = this->GetOutput();
+
+  const unsigned int filterDimensionality = static_cast< unsigned int >( m_Kernels.size() );
+
+  SizeValueType radius[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    radius[d] = ( d < filterDimensionality ) ? m_Kernels[d].size() / 2 : 0;
+    }
+
+  // the largest dimension of the tiles is halved until a tile and its
+  // halo hold at most 32768 values, the two buffers of a tile of
+  // doubles then fit in the cache
+  const SizeValueType                      maximumTileSize = 32768;
+  typename OutputImageRegionType::SizeType tileSize = outputRegionForThread.GetSize();
+  for (;; )
+    {
+    SizeValueType paddedTileSize = 1;
+    unsigned int  largest = 0;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      paddedTileSize *= tileSize[d] + 2 * radius[d];
+      if ( tileSize[d] >= tileSize[largest] )
+        {
+        largest = d;
+        }
+      }
+    if ( paddedTileSize <= maximumTileSize || tileSize[largest] == 1 )
+      {
+      break;
+      }
+    tileSize[largest] = ( tileSize[largest] + 1 ) / 2;
+    }
+
+  SizeValueType bufferSize = 1;
+  SizeValueType numberOfTiles = 1;
+  SizeValueType numberOfTilesAlong[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    bufferSize *= tileSize[d] + 2 * radius[d];
+    numberOfTilesAlong[d] = ( outputRegionForThread.GetSize(d) + tileSize[d] - 1 ) / tileSize[d];
+    numberOfTiles *= numberOfTilesAlong[d];
+    }
+
+  std::vector< RealOutputPixelValueType > buffer0(bufferSize);
+  std::vector< RealOutputPixelValueType > buffer1(bufferSize);
+
+  // the values outside of the input are the values of its border, as
+  // with the ZeroFluxNeumannBoundaryCondition of the internal pipeline
+  const InputInternalPixelType *inputBuffer = input->GetBufferPointer();
+  const typename InputImageType::NeighborhoodAccessorFunctorType accessor = input->GetNeighborhoodAccessor();
+  const OffsetValueType *                                      offsetTable = input->GetOffsetTable();
+  const typename InputImageType::IndexType                     bufferStart = input->GetBufferedRegion().GetIndex();
+  IndexValueType                                               bufferLast[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    bufferLast[d] = bufferStart[d] + static_cast< IndexValueType >( input->GetBufferedRegion().GetSize(d) ) - 1;
+    }
+
+  ProgressReporter progress(this, threadId, numberOfTiles);
+
+  SizeValueType tile[ImageDimension];
+  std::fill(tile, tile + ImageDimension, 0);
+  for ( SizeValueType t = 0; t < numberOfTiles; ++t )
+    {
+    OutputImageRegionType tileRegion;
+    IndexValueType        start[ImageDimension];
+    SizeValueType         size[ImageDimension];
+    SizeValueType         numberOfValues = 1;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      const SizeValueType offset = tile[d] * tileSize[d];
+      tileRegion.SetIndex( d, outputRegionForThread.GetIndex(d) + static_cast< IndexValueType >( offset ) );
+      tileRegion.SetSize( d, std::min( tileSize[d], outputRegionForThread.GetSize(d) - offset ) );
+      start[d] = tileRegion.GetIndex(d) - static_cast< IndexValueType >( radius[d] );
+      size[d] = tileRegion.GetSize(d) + 2 * radius[d];
+      numberOfValues *= size[d];
+      }
+
+    // load the tile and its halo, row by row
+    RealOutputPixelValueType *values = &buffer0[0];
+    SizeValueType             row[ImageDimension];
+    std::fill(row, row + ImageDimension, 0);
+    for ( SizeValueType k = 0; k < numberOfValues; k += size[0] )
+      {
+      OffsetValueType rowOffset = 0;
+      for ( unsigned int d = 1; d < ImageDimension; ++d )
+        {
+        const IndexValueType index = std::min( std::max( start[d] + static_cast< IndexValueType >( row[d] ),
+                                                         bufferStart[d] ), bufferLast[d] );
+        rowOffset += ( index - bufferStart[d] ) * offsetTable[d];
+        }
+      for ( SizeValueType x = 0; x < size[0]; ++x )
+        {
+        const IndexValueType index = std::min( std::max( start[0] + static_cast< IndexValueType >( x ),
+                                                         bufferStart[0] ), bufferLast[0] );
+        values[k + x] = static_cast< RealOutputPixelValueType >(
+          accessor.Get( inputBuffer + rowOffset + ( index - bufferStart[0] ) ) );
+        }
+      for ( unsigned int d = 1; d < ImageDimension; ++d )
+        {
+        if ( ++row[d] < size[d] )
+          {
+          break;
+          }
+        row[d] = 0;
+        }
+      }
+
+    // the directions are filtered in the order of the internal
+    // pipeline, whose intermediate images hold output pixels
+    RealOutputPixelValueType *in = &buffer0[0];
+    RealOutputPixelValueType *out = &buffer1[0];
+    for ( unsigned int d = filterDimensionality; d > 0; --d )
+      {
+      this->ConvolveAlongDirection(in, out, size, d - 1);
+      if ( d > 1 )
+        {
+        numberOfValues = 1;
+        for ( unsigned int i = 0; i < ImageDimension; ++i )
+          {
+          numberOfValues *= size[i];
+          }
+        for ( SizeValueType k = 0; k < numberOfValues; ++k )
+          {
+          out[k] = static_cast< RealOutputPixelValueType >( static_cast< OutputPixelType >( out[k] ) );
+          }
+        }
+      std::swap(in, out);
+      }
+
+    SizeValueType k = 0;
+    for ( ImageRegionIterator< OutputImageType > it(output, tileRegion); !it.IsAtEnd(); ++it )
+      {
+      it.Set( static_cast< OutputPixelType >( in[k++] ) );
+      }
+
+    progress.CompletedPixel();
+
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      if ( ++tile[d] < numberOfTilesAlong[d] )
+        {
+        break;
+        }
+      tile[d] = 0;
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ConvolveAlongDirection(const RealOutputPixelValueType *input, RealOutputPixelValueType *output,
+                         SizeValueType size[], unsigned int direction) const
+{
+  const std::vector< RealOutputPixelValueType > & kernel = m_Kernels[direction];
+  const SizeValueType                             kernelSize = kernel.size();
+  const SizeValueType                             length = size[direction];
+  const SizeValueType                             outputLength = length - ( kernelSize - 1 );
+
+  // the values are lines of "inner" values along the direction,
+  // "outer" times
+  SizeValueType inner = 1;
+  SizeValueType outer = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( d < direction )
+      {
+      inner *= size[d];
+      }
+    else if ( d > direction )
+      {
+      outer *= size[d];
+      }
+    }
+
+  if ( inner == 1 )
+    {
+    for ( SizeValueType o = 0; o < outer; ++o )
+      {
+      const RealOutputPixelValueType *in = input + o * length;
+      RealOutputPixelValueType *      out = output + o * outputLength;
+      for ( SizeValueType j = 0; j < outputLength; ++j )
+        {
+        RealOutputPixelValueType sum = NumericTraits< RealOutputPixelValueType >::Zero;
+        for ( SizeValueType i = 0; i < kernelSize; ++i )
+          {
+          sum += kernel[i] * in[j + i];
+          }
+        out[j] = sum;
+        }
+      }
+    }
+  else
+    {
+    // the kernel is applied to "inner" neighbouring values at once
+    for ( SizeValueType o = 0; o < outer; ++o )
+      {
+      for ( SizeValueType j = 0; j < outputLength; ++j )
+        {
+        const RealOutputPixelValueType *in = input + ( o * length + j ) * inner;
+        RealOutputPixelValueType *      out = output + ( o * outputLength + j ) * inner;
+        const RealOutputPixelValueType  w0 = kernel[0];
+        for ( SizeValueType x = 0; x < inner; ++x )
+          {
+          out[x] = w0 * in[x];
+          }
+        for ( SizeValueType i = 1; i < kernelSize; ++i )
+          {
+          const RealOutputPixelValueType  w = kernel[i];
+          const RealOutputPixelValueType *ini = in + i * inner;
+          for ( SizeValueType x = 0; x < inner; ++x )
+            {
+            out[x] += w * ini[x];
+            }
+          }
+        }
+      }
+    }
+
+  size[direction] = outputLength;
+}
+
 template< class TInputImage, class TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
@@ -341,6 +642,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
   os << indent << "InternalNumberOfStreamDivisions: " << m_InternalNumberOfStreamDivisions << std::endl;
+  os << indent << "UseFusedConvolution: " << m_UseFusedConvolution << std::endl;
 }
 } // end namespace itk
 
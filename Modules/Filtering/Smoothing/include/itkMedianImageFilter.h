@@ -35,6 +35,19 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For 8 and 16 bit integer pixels and neighborhoods of at least
+ * MinimumHistogramNeighborhoodSize pixels, the median is computed with a
+ * histogram of the neighborhood which slides along the lines of the
+ * image: moving to the next pixel removes the pixels of the slice of
+ * the neighborhood left behind and adds the pixels of the new slice,
+ * and the median is found by moving from the median of the previous
+ * pixel. A second, coarse histogram, with one bin per range of the
+ * square root of the number of values, lets the median skip the empty
+ * ranges, so it moves by at most a few hundred bins even for 16 bit
+ * pixels. The cost per pixel then grows with the size of a slice of the
+ * neighborhood instead of the size of the neighborhood. The result is
+ * the one of the selection of the median among the neighborhood pixels.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -84,6 +97,11 @@ public:
 
   typedef typename InputImageType::SizeType InputSizeType;
 
+  /** Smallest number of pixels of the neighborhood for which the median
+   * of 8 and 16 bit integers is computed with a sliding histogram.
+   * Smaller neighborhoods are faster to sort. */
+  itkStaticConstMacro(MinimumHistogramNeighborhoodSize, unsigned int, 25);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( SameDimensionCheck,
@@ -112,9 +130,31 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  /** Compute the median of the region with a sliding histogram. Return
+   * false if the neighborhood is too small for the histogram to be
+   * faster. */
+  bool ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId);
+
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
+
+  /** The sliding histogram is only used for the pixel types with a
+   * small number of values. */
+  template< class TPixel >
+  bool ComputeMedianWithHistogram(const OutputImageRegionType &, ThreadIdType, const TPixel *)
+  { return false; }
+  bool ComputeMedianWithHistogram(const OutputImageRegionType & region, ThreadIdType threadId, const char *)
+  { return this->ThreadedGenerateDataWithHistogram(region, threadId); }
+  bool ComputeMedianWithHistogram(const OutputImageRegionType & region, ThreadIdType threadId, const signed char *)
+  { return this->ThreadedGenerateDataWithHistogram(region, threadId); }
+  bool ComputeMedianWithHistogram(const OutputImageRegionType & region, ThreadIdType threadId, const unsigned char *)
+  { return this->ThreadedGenerateDataWithHistogram(region, threadId); }
+  bool ComputeMedianWithHistogram(const OutputImageRegionType & region, ThreadIdType threadId, const short *)
+  { return this->ThreadedGenerateDataWithHistogram(region, threadId); }
+  bool ComputeMedianWithHistogram(const OutputImageRegionType & region, ThreadIdType threadId, const unsigned short *)
+  { return this->ThreadedGenerateDataWithHistogram(region, threadId); }
 };
 } // end namespace itk
 
@@ -22,6 +22,7 @@
 #include "itkConstNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
@@ -42,6 +43,13 @@ MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  // the median of 8 and 16 bit integers is computed with a histogram
+  if ( this->ComputeMedianWithHistogram( outputRegionForThread, threadId,
+                                         static_cast< const InputPixelType * >( 0 ) ) )
+    {
+    return;
+    }
+
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
   typename  InputImageType::ConstPointer input  = this->GetInput();
@@ -94,6 +102,195 @@ MedianImageFilter< TInputImage, TOutputImage >
       }
     }
 }
+
+template< class TInputImage, class TOutputImage >
+bool
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId)
+{
+  typedef typename InputImageType::IndexValueType IndexValueType;
+
+  const InputSizeType radius = this->GetRadius();
+  SizeValueType       neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * radius[d] + 1;
+    }
+  if ( neighborhoodSize < MinimumHistogramNeighborhoodSize )
+    {
+    return false;
+    }
+
+  OutputImageType *     output = this->GetOutput();
+  const InputImageType *input = this->GetInput();
+
+  // a bin for each value of the pixel type
+  const IndexValueType minimum = static_cast< IndexValueType >( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const IndexValueType maximum = static_cast< IndexValueType >( NumericTraits< InputPixelType >::max() );
+  const SizeValueType          numberOfBins = maximum - minimum + 1;
+  std::vector< SizeValueType > histogram(numberOfBins, 0);
+
+  // a coarse histogram, whose bins count the values of
+  // binsPerCoarseBin consecutive bins, lets the median skip the empty
+  // ranges of the histogram: it moves by at most the number of coarse
+  // bins plus twice binsPerCoarseBin steps, i.e. 256 + 512 for 16 bit
+  // pixels, instead of up to the 65536 bins of the histogram
+  unsigned int coarseShift = 0;
+  while ( ( SizeValueType( 1 ) << ( 2 * ( coarseShift + 1 ) ) ) <= numberOfBins )
+    {
+    ++coarseShift;
+    }
+  const SizeValueType          binsPerCoarseBin = SizeValueType( 1 ) << coarseShift;
+  std::vector< SizeValueType > coarseHistogram( ( numberOfBins + binsPerCoarseBin - 1 ) >> coarseShift, 0 );
+
+  // the pixels outside of the input are the pixels of its border, as
+  // with the ZeroFluxNeumannBoundaryCondition
+  const typename InputImageType::InternalPixelType *inputBuffer = input->GetBufferPointer();
+  const typename InputImageType::NeighborhoodAccessorFunctorType accessor = input->GetNeighborhoodAccessor();
+  const OffsetValueType *                        offsetTable = input->GetOffsetTable();
+  const typename InputImageType::IndexType       bufferStart = input->GetBufferedRegion().GetIndex();
+  IndexValueType                                 bufferLast[InputImageDimension];
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    bufferLast[d] = bufferStart[d] + static_cast< IndexValueType >( input->GetBufferedRegion().GetSize(d) ) - 1;
+    }
+
+  // the offsets of the rows of the neighborhood along the first
+  // direction
+  const IndexValueType           radius0 = static_cast< IndexValueType >( radius[0] );
+  const SizeValueType            numberOfRows = neighborhoodSize / ( 2 * radius[0] + 1 );
+  std::vector< OffsetValueType > rows(numberOfRows);
+
+  // the median is the smallest value whose number of smaller or equal
+  // values in the neighborhood is greater than rank
+  const SizeValueType rank = neighborhoodSize / 2;
+  SizeValueType       median = 0;
+  SizeValueType       numberOfSmallerValues = 0;
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ImageLinearIteratorWithIndex< OutputImageType > it(output, outputRegionForThread);
+  it.SetDirection(0);
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
+    {
+    const typename OutputImageType::IndexType lineIndex = it.GetIndex();
+
+    IndexValueType neighbor[InputImageDimension];
+    for ( unsigned int d = 1; d < InputImageDimension; ++d )
+      {
+      neighbor[d] = -static_cast< IndexValueType >( radius[d] );
+      }
+    for ( SizeValueType r = 0; r < numberOfRows; ++r )
+      {
+      OffsetValueType offset = 0;
+      for ( unsigned int d = 1; d < InputImageDimension; ++d )
+        {
+        const IndexValueType index = std::min( std::max( lineIndex[d] + neighbor[d], bufferStart[d] ), bufferLast[d] );
+        offset += ( index - bufferStart[d] ) * offsetTable[d];
+        }
+      rows[r] = offset;
+      for ( unsigned int d = 1; d < InputImageDimension; ++d )
+        {
+        if ( ++neighbor[d] <= static_cast< IndexValueType >( radius[d] ) )
+          {
+          break;
+          }
+        neighbor[d] = -static_cast< IndexValueType >( radius[d] );
+        }
+      }
+
+    // the histogram of the neighborhood of the first pixel of the line
+    IndexValueType x = lineIndex[0] - radius0;
+    for (; x <= lineIndex[0] + radius0; ++x )
+      {
+      const OffsetValueType column = std::min( std::max( x, bufferStart[0] ), bufferLast[0] ) - bufferStart[0];
+      for ( SizeValueType r = 0; r < numberOfRows; ++r )
+        {
+        const SizeValueType bin = static_cast< IndexValueType >( accessor.Get(inputBuffer + rows[r] + column) )
+                                  - minimum;
+        ++histogram[bin];
+        ++coarseHistogram[bin >> coarseShift];
+        numberOfSmallerValues += ( bin < median );
+        }
+      }
+
+    for ( x = lineIndex[0];; ++x )
+      {
+      while ( numberOfSmallerValues > rank )
+        {
+        if ( ( median & ( binsPerCoarseBin - 1 ) ) == 0
+             && numberOfSmallerValues - coarseHistogram[( median >> coarseShift ) - 1] > rank )
+          {
+          median -= binsPerCoarseBin;
+          numberOfSmallerValues -= coarseHistogram[median >> coarseShift];
+          }
+        else
+          {
+          --median;
+          numberOfSmallerValues -= histogram[median];
+          }
+        }
+      while ( numberOfSmallerValues + histogram[median] <= rank )
+        {
+        if ( ( median & ( binsPerCoarseBin - 1 ) ) == 0
+             && numberOfSmallerValues + coarseHistogram[median >> coarseShift] <= rank )
+          {
+          numberOfSmallerValues += coarseHistogram[median >> coarseShift];
+          median += binsPerCoarseBin;
+          }
+        else
+          {
+          numberOfSmallerValues += histogram[median];
+          ++median;
+          }
+        }
+      it.Set( static_cast< OutputPixelType >( static_cast< IndexValueType >( median ) + minimum ) );
+      progress.CompletedPixel();
+
+      ++it;
+      if ( it.IsAtEndOfLine() )
+        {
+        break;
+        }
+
+      // slide the neighborhood
+      const OffsetValueType left =
+        std::min( std::max( x - radius0, bufferStart[0] ), bufferLast[0] ) - bufferStart[0];
+      const OffsetValueType right =
+        std::min( std::max( x + radius0 + 1, bufferStart[0] ), bufferLast[0] ) - bufferStart[0];
+      for ( SizeValueType r = 0; r < numberOfRows; ++r )
+        {
+        const SizeValueType removed = static_cast< IndexValueType >( accessor.Get(inputBuffer + rows[r] + left) )
+                                      - minimum;
+        --histogram[removed];
+        --coarseHistogram[removed >> coarseShift];
+        numberOfSmallerValues -= ( removed < median );
+        const SizeValueType added = static_cast< IndexValueType >( accessor.Get(inputBuffer + rows[r] + right) )
+                                    - minimum;
+        ++histogram[added];
+        ++coarseHistogram[added >> coarseShift];
+        numberOfSmallerValues += ( added < median );
+        }
+      }
+
+    // empty the histogram for the next line, its median is a good start
+    for ( IndexValueType x0 = x - radius0; x0 <= x + radius0; ++x0 )
+      {
+      const OffsetValueType column = std::min( std::max( x0, bufferStart[0] ), bufferLast[0] ) - bufferStart[0];
+      for ( SizeValueType r = 0; r < numberOfRows; ++r )
+        {
+        const SizeValueType bin = static_cast< IndexValueType >( accessor.Get(inputBuffer + rows[r] + column) )
+                                  - minimum;
+        --histogram[bin];
+        --coarseHistogram[bin >> coarseShift];
+        }
+      }
+    numberOfSmallerValues = 0;
+    }
+
+  return true;
+}
 } // end namespace itk
 
 #endif
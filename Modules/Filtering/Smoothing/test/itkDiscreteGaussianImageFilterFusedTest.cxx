@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer CreateImage(const typename TImage::SizeType & size)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  typename TImage::SpacingType spacing;
+  for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+    {
+    spacing[d] = 0.5 + 0.25 * d;
+    }
+  image->SetSpacing(spacing);
+  for ( itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    unsigned int value = 0;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+      {
+      value = value * 31 + static_cast< unsigned int >( it.GetIndex()[d] ) * ( 7 + d );
+      }
+    it.Set( static_cast< typename TImage::PixelType >( value % 251 ) );
+    }
+  return image;
+}
+
+template< class TImage >
+typename TImage::Pointer Smooth(TImage *image, bool useFusedConvolution, unsigned int filterDimensionality,
+                                unsigned int numberOfStreamDivisions)
+{
+  typedef itk::DiscreteGaussianImageFilter< TImage, TImage > FilterType;
+  typedef itk::StreamingImageFilter< TImage, TImage >        StreamerType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetVariance(2.3);
+  filter->SetMaximumKernelWidth(17);
+  filter->SetFilterDimensionality(filterDimensionality);
+  filter->SetUseFusedConvolution(useFusedConvolution);
+
+  // the streamed pieces request the input they need around them
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+// the tiles convolved by the threads are the images of the internal
+// pipeline
+template< class TImage >
+bool Compare(const typename TImage::SizeType & size)
+{
+  typename TImage::Pointer image = CreateImage< TImage >(size);
+
+  const unsigned int divisions[] = { 1, 3 };
+  for ( unsigned int filterDimensionality = 1; filterDimensionality <= TImage::ImageDimension;
+        ++filterDimensionality )
+    {
+    for ( unsigned int s = 0; s < 2; ++s )
+      {
+      typename TImage::Pointer expected = Smooth< TImage >(image, false, filterDimensionality, 1);
+      typename TImage::Pointer fused = Smooth< TImage >(image, true, filterDimensionality, divisions[s]);
+
+      itk::ImageRegionConstIteratorWithIndex< TImage > it( expected, expected->GetLargestPossibleRegion() );
+      for (; !it.IsAtEnd(); ++it )
+        {
+        if ( it.Get() != fused->GetPixel( it.GetIndex() ) )
+          {
+          std::cerr << "ERROR: at " << it.GetIndex() << " with FilterDimensionality " << filterDimensionality
+                    << " and " << divisions[s] << " stream divisions, the internal pipeline gives "
+                    << static_cast< double >( it.Get() ) << " and the fused convolution "
+                    << static_cast< double >( fused->GetPixel( it.GetIndex() ) ) << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+}
+
+int itkDiscreteGaussianImageFilterFusedTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >         FloatImageType;
+  typedef itk::Image< unsigned char, 2 > CharImageType;
+
+  FloatImageType::SizeType floatSize;
+  floatSize[0] = 47;
+  floatSize[1] = 39;
+  floatSize[2] = 31;
+
+  // the kernel is wider than the last dimension
+  CharImageType::SizeType charSize;
+  charSize[0] = 211;
+  charSize[1] = 5;
+
+  try
+    {
+    if ( !Compare< FloatImageType >(floatSize) || !Compare< CharImageType >(charSize) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
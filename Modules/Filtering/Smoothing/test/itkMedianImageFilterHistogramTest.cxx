@@ -0,0 +1,132 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Image< float, Dimension > FloatImageType;
+
+// the median of the float pixels is selected among the neighborhood
+// pixels, the median of the 8 and 16 bit integers is computed with the
+// histogram
+template< class TImage >
+bool Compare(const typename TImage::SizeType & radius, int minimum, int maximum, unsigned int numberOfStreamDivisions)
+{
+  typename TImage::SizeType size;
+  size[0] = 37;
+  size[1] = 23;
+  size[2] = 11;
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  FloatImageType::Pointer floatImage = FloatImageType::New();
+  floatImage->SetRegions(size);
+  floatImage->Allocate();
+
+  unsigned int                                      seed = 17;
+  itk::ImageRegionIteratorWithIndex< TImage >       it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< FloatImageType > fit( floatImage, floatImage->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it, ++fit )
+    {
+    // a smooth ramp with noise, so that the median moves far and near
+    seed = seed * 1103515245u + 12345u;
+    const int noise = static_cast< int >( ( seed >> 8 ) % static_cast< unsigned int >( maximum - minimum + 1 ) );
+    const int value = ( it.GetIndex()[0] % 3 ) ? minimum + noise : minimum + ( maximum - minimum ) / 37 * it.GetIndex()[0];
+    it.Set( static_cast< typename TImage::PixelType >( value ) );
+    fit.Set( static_cast< float >( value ) );
+    }
+
+  typedef itk::MedianImageFilter< TImage, TImage >                 FilterType;
+  typedef itk::MedianImageFilter< FloatImageType, FloatImageType > FloatFilterType;
+  typedef itk::StreamingImageFilter< TImage, TImage >              StreamerType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetRadius(radius);
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+
+  typename FloatFilterType::Pointer floatFilter = FloatFilterType::New();
+  floatFilter->SetInput(floatImage);
+  FloatImageType::SizeType floatRadius;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    floatRadius[d] = radius[d];
+    }
+  floatFilter->SetRadius(floatRadius);
+  try
+    {
+    streamer->Update();
+    floatFilter->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< FloatImageType > eit( floatFilter->GetOutput(),
+                                                                floatImage->GetLargestPossibleRegion() );
+  for (; !eit.IsAtEnd(); ++eit )
+    {
+    const float median = static_cast< float >( streamer->GetOutput()->GetPixel( eit.GetIndex() ) );
+    if ( median != eit.Get() )
+      {
+      std::cerr << "ERROR: at " << eit.GetIndex() << " with radius " << radius << ", the median is " << median
+                << " instead of " << eit.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkMedianImageFilterHistogramTest(int, char *[])
+{
+  typedef itk::Image< unsigned char, Dimension >  CharImageType;
+  typedef itk::Image< short, Dimension >          ShortImageType;
+  typedef itk::Image< unsigned short, Dimension > UnsignedShortImageType;
+
+  // the smallest neighborhood uses the selection
+  const unsigned int radii[][Dimension] = { { 1, 1, 0 }, { 1, 1, 1 }, { 0, 2, 3 }, { 4, 1, 2 }, { 20, 3, 1 } };
+  for ( unsigned int r = 0; r < 5; ++r )
+    {
+    CharImageType::SizeType radius;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      radius[d] = radii[r][d];
+      }
+    for ( unsigned int divisions = 1; divisions <= 3; divisions += 2 )
+      {
+      if ( !Compare< CharImageType >(radius, 0, 255, divisions)
+           || !Compare< ShortImageType >(radius, -3000, 29000, divisions)
+           || !Compare< UnsignedShortImageType >(radius, 0, 65535, divisions) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+typedef itk::Image< float, 3 >                                      ImageType;
+typedef itk::RecursiveGaussianImageFilter< ImageType, ImageType >   FilterType;
+
+ImageType::Pointer Filter(ImageType *image, unsigned int direction, FilterType::OrderEnumType order,
+                          bool useMultiLineFiltering, const ImageType::RegionType & requestedRegion)
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetDirection(direction);
+  filter->SetOrder(order);
+  filter->SetSigma(1.7);
+  filter->SetUseMultiLineFiltering(useMultiLineFiltering);
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  filter->Update();
+  return filter->GetOutput();
+}
+}
+
+// the lines filtered in blocks are the lines filtered one at a time
+int itkRecursiveGaussianImageFilterMultiLineTest(int, char *[])
+{
+  // the numbers of lines are not multiples of the number of lines of a
+  // block
+  ImageType::SizeType size;
+  size[0] = 23;
+  size[1] = 13;
+  size[2] = 11;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< float >( ( index[0] * 7 + index[1] * 13 + index[2] * 29 ) % 17 ) - 3.5f * index[2] );
+    }
+
+  ImageType::IndexType start;
+  start[0] = 2;
+  start[1] = 3;
+  start[2] = 1;
+  ImageType::SizeType regionSize;
+  regionSize[0] = 17;
+  regionSize[1] = 9;
+  regionSize[2] = 7;
+  const ImageType::RegionType regions[] = { image->GetLargestPossibleRegion(),
+                                            ImageType::RegionType(start, regionSize) };
+
+  const FilterType::OrderEnumType orders[] = { FilterType::ZeroOrder, FilterType::FirstOrder,
+                                               FilterType::SecondOrder };
+  for ( unsigned int r = 0; r < 2; ++r )
+    {
+    for ( unsigned int direction = 0; direction < 3; ++direction )
+      {
+      for ( unsigned int o = 0; o < 3; ++o )
+        {
+        ImageType::Pointer lines = Filter(image, direction, orders[o], false, regions[r]);
+        ImageType::Pointer blocks = Filter(image, direction, orders[o], true, regions[r]);
+
+        itk::ImageRegionConstIteratorWithIndex< ImageType > it( lines, lines->GetRequestedRegion() );
+        for (; !it.IsAtEnd(); ++it )
+          {
+          const float difference = it.Get() - blocks->GetPixel( it.GetIndex() );
+          if ( difference > 1e-5f || difference < -1e-5f )
+            {
+            std::cerr << "ERROR: at " << it.GetIndex() << " in direction " << direction << " with order "
+                      << o << ", the lines filtered one at a time give " << it.Get()
+                      << " and the lines filtered in blocks " << blocks->GetPixel( it.GetIndex() ) << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
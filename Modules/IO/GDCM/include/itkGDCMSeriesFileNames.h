@@ -21,6 +21,7 @@
 #include "itkProcessObject.h"
 #include "itkObjectFactory.h"
 #include "itkMacro.h"
+#include "itkMultiThreader.h"
 #include <vector>
 #include "gdcmSerieHelper.h"
 
@@ -44,6 +45,12 @@ namespace itk
  *    dicom objects, you may want to try calling ->SetUseSeriesDetails(true)
  *    prior to calling SetDirectory().
  *
+ *  The headers of the files are parsed by NumberOfThreads threads, and
+ *  the files are read up to the pixel data only. When a CacheFileName is
+ *  set, the parsed headers are kept in that file, along with the
+ *  modification time and the size of each file, so that the files of a
+ *  directory which was already scanned are not parsed again.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOGDCM
@@ -170,6 +177,14 @@ public:
   itkGetConstMacro(LoadPrivateTags, bool);
   itkBooleanMacro(LoadPrivateTags);
 
+  /** Set/Get the file where the headers of the scanned files are
+   * cached. The cache is read and updated by SetDirectory(). Only the
+   * elements of the top level of the headers are kept, the sequences
+   * are not. Empty by default, which disables the cache.
+   */
+  itkSetStringMacro(CacheFileName);
+  itkGetStringMacro(CacheFileName);
+
 protected:
   GDCMSeriesFileNames();
   ~GDCMSeriesFileNames();
@@ -179,6 +194,12 @@ private:
   GDCMSeriesFileNames(const Self &); //purposely not implemented
   void operator=(const Self &);      //purposely not implemented
 
+  /** Parse the headers of the files of the input directory, or get them
+   * from the cache, and give the DICOM images to the SerieHelper. */
+  void ScanInputDirectory();
+
+  static ITK_THREAD_RETURN_TYPE ScanInputDirectoryThreaderCallback(void *arg);
+
   /** Contains the input directory where the DICOM serie is found */
   std::string m_InputDirectory;
 
@@ -199,6 +220,8 @@ private:
   bool m_Recursive;
   bool m_LoadSequences;
   bool m_LoadPrivateTags;
+
+  std::string m_CacheFileName;
 };
 } //namespace ITK
 
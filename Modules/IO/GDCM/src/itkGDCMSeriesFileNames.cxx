@@ -21,23 +21,209 @@
 #include "itkGDCMSeriesFileNames.h"
 #include "itksys/SystemTools.hxx"
 #include "itkProgressReporter.h"
+#include "gdcmDirectory.h"
+#include "gdcmReader.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
 
 namespace itk
 {
+namespace
+{
+// gives access to SerieHelper::AddFile(), to add files whose header was
+// parsed elsewhere
+class ScannedSerieHelper:public gdcm::SerieHelper
+{
+public:
+  bool AddScannedFile(gdcm::FileWithName & file)
+  {
+    return this->AddFile(file);
+  }
+};
+
+typedef gdcm::SmartPointer< gdcm::FileWithName > ScannedFilePointer;
+
+// the header of a file, as it is kept in the cache
+struct CachedHeader
+{
+  long int                         ModifiedTime;
+  unsigned long                    FileLength;
+  bool                             IsImage;
+  int                              TransferSyntax;
+  std::vector< gdcm::DataElement > Elements;
+};
+
+typedef std::map< std::string, CachedHeader > HeaderCacheType;
+
+const char CacheSignature[] = "ITK GDCMSeriesFileNames header cache 1\n";
+
+struct ScanInputDirectoryStruct
+{
+  std::vector< std::string >        FileNames;
+  std::vector< ScannedFilePointer > Files;
+};
+
+template< class T >
+bool ReadCacheValue(std::istream & is, T & value)
+{
+  return is.read(reinterpret_cast< char * >( &value ), sizeof( T ) ).good();
+}
+
+template< class T >
+void WriteCacheValue(std::ostream & os, const T & value)
+{
+  os.write(reinterpret_cast< const char * >( &value ), sizeof( T ) );
+}
+
+// read the headers of a cache file, an unreadable cache is ignored
+void ReadHeaderCache(const std::string & fileName, HeaderCacheType & cache)
+{
+  std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string   signature( sizeof( CacheSignature ) - 1, '\0' );
+  if ( !is.read( &signature[0], signature.size() ) || signature != CacheSignature )
+    {
+    return;
+    }
+  HeaderCacheType headers;
+  uint32_t        pathLength;
+  while ( ReadCacheValue(is, pathLength) )
+    {
+    std::string path(pathLength, '\0');
+    CachedHeader header;
+    int32_t      isImage;
+    uint32_t     numberOfElements;
+    if ( pathLength == 0 || !is.read(&path[0], pathLength)
+         || !ReadCacheValue(is, header.ModifiedTime)
+         || !ReadCacheValue(is, header.FileLength)
+         || !ReadCacheValue(is, isImage)
+         || !ReadCacheValue(is, header.TransferSyntax)
+         || !ReadCacheValue(is, numberOfElements) )
+      {
+      return;
+      }
+    header.IsImage = ( isImage != 0 );
+    for ( uint32_t e = 0; e < numberOfElements; ++e )
+      {
+      uint16_t group;
+      uint16_t element;
+      int32_t  vr;
+      uint32_t length;
+      if ( !ReadCacheValue(is, group) || !ReadCacheValue(is, element)
+           || !ReadCacheValue(is, vr) || !ReadCacheValue(is, length) )
+        {
+        return;
+        }
+      std::vector< char > value(length);
+      if ( length && !is.read(&value[0], length) )
+        {
+        return;
+        }
+      gdcm::DataElement de( gdcm::Tag(group, element) );
+      de.SetVR( static_cast< gdcm::VR::VRType >( vr ) );
+      de.SetByteValue(length ? &value[0] : "", length);
+      header.Elements.push_back(de);
+      }
+    headers[path] = header;
+    }
+  cache.swap(headers);
+}
+
+void WriteHeaderCache(const std::string & fileName, const HeaderCacheType & cache)
+{
+  std::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  os.write(CacheSignature, sizeof( CacheSignature ) - 1);
+  for ( HeaderCacheType::const_iterator it = cache.begin(); it != cache.end(); ++it )
+    {
+    const CachedHeader & header = it->second;
+    WriteCacheValue( os, static_cast< uint32_t >( it->first.size() ) );
+    os.write( it->first.c_str(), it->first.size() );
+    WriteCacheValue(os, header.ModifiedTime);
+    WriteCacheValue(os, header.FileLength);
+    WriteCacheValue( os, static_cast< int32_t >( header.IsImage ) );
+    WriteCacheValue(os, header.TransferSyntax);
+    WriteCacheValue( os, static_cast< uint32_t >( header.Elements.size() ) );
+    for ( size_t e = 0; e < header.Elements.size(); ++e )
+      {
+      const gdcm::DataElement & de = header.Elements[e];
+      const gdcm::ByteValue *   bv = de.GetByteValue();
+      const uint32_t            length = bv ? static_cast< uint32_t >( bv->GetLength() ) : 0;
+      WriteCacheValue( os, de.GetTag().GetGroup() );
+      WriteCacheValue( os, de.GetTag().GetElement() );
+      WriteCacheValue( os, static_cast< int32_t >( de.GetVR() ) );
+      WriteCacheValue(os, length);
+      if ( length )
+        {
+        os.write(bv->GetPointer(), length);
+        }
+      }
+    }
+}
+
+// the elements of the top level of a header, sequences and encapsulated
+// values are left out
+void AddCachedElements(const gdcm::DataSet & ds, std::vector< gdcm::DataElement > & elements)
+{
+  for ( gdcm::DataSet::ConstIterator it = ds.Begin(); it != ds.End(); ++it )
+    {
+    if ( it->GetByteValue() && !it->GetVL().IsUndefined() )
+      {
+      elements.push_back(*it);
+      }
+    }
+}
+
+void CacheHeader(const gdcm::FileWithName *file, CachedHeader & header)
+{
+  header.Elements.clear();
+  header.IsImage = ( file != 0 );
+  header.TransferSyntax = gdcm::TransferSyntax::TS_END;
+  if ( file )
+    {
+    header.TransferSyntax = file->GetHeader().GetDataSetTransferSyntax();
+    AddCachedElements(file->GetHeader(), header.Elements);
+    AddCachedElements(file->GetDataSet(), header.Elements);
+    }
+}
+
+ScannedFilePointer FileFromCachedHeader(const std::string & fileName, const CachedHeader & header)
+{
+  gdcm::File file;
+  file.GetHeader().SetDataSetTransferSyntax(
+    static_cast< gdcm::TransferSyntax::TSType >( header.TransferSyntax ) );
+  for ( size_t e = 0; e < header.Elements.size(); ++e )
+    {
+    if ( header.Elements[e].GetTag().GetGroup() == 0x0002 )
+      {
+      file.GetHeader().Insert(header.Elements[e]);
+      }
+    else
+      {
+      file.GetDataSet().Insert(header.Elements[e]);
+      }
+    }
+  ScannedFilePointer scanned = new gdcm::FileWithName(file);
+  scanned->filename = fileName;
+  return scanned;
+}
+}
+
 GDCMSeriesFileNames::GDCMSeriesFileNames()
 {
-  m_SerieHelper = new gdcm::SerieHelper();
+  m_SerieHelper = new ScannedSerieHelper();
   m_InputDirectory = "";
   m_OutputDirectory = "";
   m_UseSeriesDetails = true;
   m_Recursive = false;
   m_LoadSequences = false;
   m_LoadPrivateTags = false;
+  m_CacheFileName = "";
 }
 
 GDCMSeriesFileNames::~GDCMSeriesFileNames()
 {
-  delete m_SerieHelper;
+  delete static_cast< ScannedSerieHelper * >( m_SerieHelper );
 }
 
 void GDCMSeriesFileNames::SetInputDirectory(const char *name)
@@ -72,11 +258,139 @@ void GDCMSeriesFileNames::SetInputDirectory(std::string const & name)
   m_SerieHelper->SetUseSeriesDetails(m_UseSeriesDetails);
   m_SerieHelper->SetLoadMode( ( m_LoadSequences ? 0 : gdcm::LD_NOSEQ )
                               | ( m_LoadPrivateTags ? 0 : gdcm::LD_NOSHADOW ) );
-  m_SerieHelper->SetDirectory(name, m_Recursive);
+  this->ScanInputDirectory();
   //as a side effect it also execute
   this->Modified();
 }
 
+void GDCMSeriesFileNames::ScanInputDirectory()
+{
+  ScanInputDirectoryStruct str;
+
+  gdcm::Directory directory;
+  directory.Load(m_InputDirectory, m_Recursive);
+  str.FileNames = directory.GetFilenames();
+  str.Files.resize( str.FileNames.size() );
+
+  // the headers of the files which did not change since they were cached
+  // are not parsed again
+  HeaderCacheType              cache;
+  std::vector< SizeValueType > filesToParse;
+  std::vector< long int >      modifiedTimes( str.FileNames.size() );
+  std::vector< unsigned long > fileLengths( str.FileNames.size() );
+  if ( !m_CacheFileName.empty() )
+    {
+    ReadHeaderCache(m_CacheFileName, cache);
+    }
+  for ( SizeValueType f = 0; f < str.FileNames.size(); ++f )
+    {
+    const std::string & fileName = str.FileNames[f];
+    if ( !m_CacheFileName.empty() )
+      {
+      modifiedTimes[f] = itksys::SystemTools::ModifiedTime( fileName.c_str() );
+      fileLengths[f] = itksys::SystemTools::FileLength( fileName.c_str() );
+      HeaderCacheType::const_iterator cached = cache.find(fileName);
+      if ( cached != cache.end()
+           && cached->second.ModifiedTime == modifiedTimes[f]
+           && cached->second.FileLength == fileLengths[f] )
+        {
+        if ( cached->second.IsImage )
+          {
+          str.Files[f] = FileFromCachedHeader(fileName, cached->second);
+          }
+        continue;
+        }
+      }
+    filesToParse.push_back(f);
+    }
+
+  if ( !filesToParse.empty() )
+    {
+    // the files are parsed by consecutive chunks, only the files which
+    // are not in the cache are kept in the structure
+    ScanInputDirectoryStruct parseStr;
+    for ( SizeValueType p = 0; p < filesToParse.size(); ++p )
+      {
+      parseStr.FileNames.push_back(str.FileNames[filesToParse[p]]);
+      }
+    parseStr.Files.resize( filesToParse.size() );
+
+    const ThreadIdType numberOfThreads = static_cast< ThreadIdType >(
+      std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+                static_cast< SizeValueType >( filesToParse.size() ) ) );
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(Self::ScanInputDirectoryThreaderCallback, &parseStr);
+    threader->SingleMethodExecute();
+
+    for ( SizeValueType p = 0; p < filesToParse.size(); ++p )
+      {
+      str.Files[filesToParse[p]] = parseStr.Files[p];
+      }
+
+    if ( !m_CacheFileName.empty() )
+      {
+      for ( SizeValueType p = 0; p < filesToParse.size(); ++p )
+        {
+        const SizeValueType f = filesToParse[p];
+        CachedHeader &      header = cache[str.FileNames[f]];
+        header.ModifiedTime = modifiedTimes[f];
+        header.FileLength = fileLengths[f];
+        CacheHeader(str.Files[f], header);
+        }
+      WriteHeaderCache(m_CacheFileName, cache);
+      }
+    }
+
+  // the files are added in the order of the directory, whatever thread
+  // parsed them
+  ScannedSerieHelper *serieHelper = static_cast< ScannedSerieHelper * >( m_SerieHelper );
+  for ( SizeValueType f = 0; f < str.Files.size(); ++f )
+    {
+    if ( str.Files[f] )
+      {
+      serieHelper->AddScannedFile(*str.Files[f]);
+      }
+    }
+}
+
+ITK_THREAD_RETURN_TYPE GDCMSeriesFileNames::ScanInputDirectoryThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ScanInputDirectoryStruct *       str = static_cast< ScanInputDirectoryStruct * >( info->UserData );
+
+  const SizeValueType numberOfFiles = str->FileNames.size();
+  const SizeValueType firstFile = numberOfFiles * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType lastFile = numberOfFiles * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+
+  // the files are read up to the pixel data, whose value is skipped
+  const gdcm::Tag       pixelDataTag(0x7fe0, 0x0010);
+  std::set< gdcm::Tag > skipTags;
+  skipTags.insert(pixelDataTag);
+  for ( SizeValueType f = firstFile; f < lastFile; ++f )
+    {
+    gdcm::Reader reader;
+    reader.SetFileName( str->FileNames[f].c_str() );
+    if ( !reader.ReadUpToTag(pixelDataTag, skipTags) )
+      {
+      continue;
+      }
+
+    // only the DICOM files which hold an image are kept
+    const gdcm::DataSet & ds = reader.GetFile().GetDataSet();
+    if ( !ds.FindDataElement( gdcm::Tag(0x0028, 0x0010) )
+         || !ds.FindDataElement( gdcm::Tag(0x0028, 0x0011) ) )
+      {
+      continue;
+      }
+    ScannedFilePointer file = new gdcm::FileWithName( reader.GetFile() );
+    file->filename = str->FileNames[f];
+    str->Files[f] = file;
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 const SerieUIDContainer & GDCMSeriesFileNames::GetSeriesUIDs()
 {
   m_SeriesUIDs.clear();
@@ -278,6 +592,7 @@ void GDCMSeriesFileNames::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "InputDirectory: " << m_InputDirectory << std::endl;
   os << indent << "LoadSequences:" << m_LoadSequences << std::endl;
   os << indent << "LoadPrivateTags:" << m_LoadPrivateTags << std::endl;
+  os << indent << "CacheFileName: " << m_CacheFileName << std::endl;
   if ( m_Recursive )
     {
     os << indent << "Recursive: True" << std::endl;
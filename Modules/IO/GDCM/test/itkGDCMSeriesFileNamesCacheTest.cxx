@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkGDCMImageIO.h"
+#include "itkGDCMSeriesFileNames.h"
+#include "itkMetaDataObject.h"
+#include "itksys/SystemTools.hxx"
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+typedef itk::Image< short, 2 > ImageType;
+
+// write a CT slice at the position z of a series
+void WriteSlice(const std::string & fileName, const std::string & seriesUID, const std::string & z)
+{
+  ImageType::SizeType size;
+  size.Fill(8);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  image->FillBuffer(1);
+
+  itk::MetaDataDictionary & dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData< std::string >(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData< std::string >(dictionary, "0020|000e", seriesUID);
+  itk::EncapsulateMetaData< std::string >(dictionary, "0020|0032", "0\\0\\" + z);
+
+  itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+  io->KeepOriginalUIDOn();
+
+  itk::ImageFileWriter< ImageType >::Pointer writer = itk::ImageFileWriter< ImageType >::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetImageIO(io);
+  writer->Update();
+}
+
+// the files of the series, ordered by position
+bool CheckSeries(const std::string & directory, const std::string & cacheFileName,
+                 const std::string & seriesUID, const std::vector< std::string > & expected,
+                 itk::ThreadIdType numberOfThreads)
+{
+  itk::GDCMSeriesFileNames::Pointer names = itk::GDCMSeriesFileNames::New();
+  names->SetNumberOfThreads(numberOfThreads);
+  names->SetCacheFileName(cacheFileName);
+  names->SetUseSeriesDetails(false);
+  names->SetDirectory(directory);
+
+  const itk::SerieUIDContainer & seriesUIDs = names->GetSeriesUIDs();
+  if ( seriesUIDs.size() != 2 )
+    {
+    std::cerr << "ERROR: " << seriesUIDs.size() << " series found instead of 2" << std::endl;
+    return false;
+    }
+
+  const itk::FilenamesContainer & fileNames = names->GetFileNames(seriesUID);
+  if ( fileNames.size() != expected.size() )
+    {
+    std::cerr << "ERROR: " << fileNames.size() << " files in the series instead of "
+              << expected.size() << std::endl;
+    return false;
+    }
+  for ( size_t i = 0; i < fileNames.size(); ++i )
+    {
+    if ( itksys::SystemTools::GetFilenameName(fileNames[i]) != expected[i] )
+      {
+      std::cerr << "ERROR: file " << i << " of the series is " << fileNames[i]
+                << " instead of " << expected[i] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkGDCMSeriesFileNamesCacheTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = std::string(argv[1]) + "/itkGDCMSeriesFileNamesCacheTest";
+  const std::string cacheFileName = std::string(argv[1]) + "/itkGDCMSeriesFileNamesCacheTest.cache";
+  itksys::SystemTools::RemoveADirectory( directory.c_str() );
+  itksys::SystemTools::MakeDirectory( directory.c_str() );
+  itksys::SystemTools::RemoveFile( cacheFileName.c_str() );
+
+  // the names of the files are not in the order of the positions
+  const std::string seriesUID = "1.2.826.0.1.3680043.2.1125.1";
+  const char *      names[] = { "e.dcm", "b.dcm", "g.dcm", "a.dcm", "f.dcm", "c.dcm", "d.dcm" };
+  const char *      positions[] = { "0", "1.5", "3", "4.5", "6", "7.5", "9" };
+  std::vector< std::string > expected;
+  try
+    {
+    for ( unsigned int i = 0; i < 7; ++i )
+      {
+      WriteSlice(directory + "/" + names[i], seriesUID, positions[i]);
+      expected.push_back(names[i]);
+      }
+    WriteSlice(directory + "/other1.dcm", "1.2.826.0.1.3680043.2.1125.2", "0");
+    WriteSlice(directory + "/other2.dcm", "1.2.826.0.1.3680043.2.1125.2", "1");
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a file which is not DICOM is skipped
+  std::ofstream text( ( directory + "/notes.txt" ).c_str() );
+  text << "not a DICOM file" << std::endl;
+  text.close();
+
+  // without cache, with one thread and several
+  if ( !CheckSeries(directory, "", seriesUID, expected, 1)
+       || !CheckSeries(directory, "", seriesUID, expected, 4) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the first scan fills the cache, the second one uses it
+  if ( !CheckSeries(directory, cacheFileName, seriesUID, expected, 4)
+       || !itksys::SystemTools::FileExists( cacheFileName.c_str() )
+       || !CheckSeries(directory, cacheFileName, seriesUID, expected, 4) )
+    {
+    std::cerr << "ERROR: wrong series with the cache " << cacheFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a modified file is parsed again, the first slice moves to the end
+  try
+    {
+    WriteSlice(directory + "/e.dcm", seriesUID, "100");
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+  expected.erase( expected.begin() );
+  expected.push_back("e.dcm");
+  if ( !CheckSeries(directory, cacheFileName, seriesUID, expected, 4) )
+    {
+    std::cerr << "ERROR: the modified file was not parsed again" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
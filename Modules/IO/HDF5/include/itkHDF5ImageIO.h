@@ -79,6 +79,12 @@ class MetaDataDictionary;
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The VoxelData is written in chunks which are bricks of
+ * ImageIOBase::ChunkSize voxels, by default bricks of about 256k voxels,
+ * and deflated at ImageIOBase::CompressionLevel, 5 by default. A
+ * CompressionLevel of 0 writes the chunks uncompressed. A streamed read
+ * only decompresses the chunks which intersect the requested region,
+ * with a chunk cache large enough to hold a layer of them.
  *
  */
 
@@ -186,6 +192,8 @@ private:
                        unsigned long numElements);
   void SetupStreaming(H5::DataSpace *imageSpace,
                       H5::DataSpace *slabSpace);
+  /** Open the voxel data set with a chunk cache for the IORegion. */
+  H5::DataSet *OpenVoxelDataSet(const std::string &VoxelDataName);
   H5::H5File  *m_H5File;
   H5::DataSet *m_VoxelDataSet;
   bool         m_ImageInformationWritten;
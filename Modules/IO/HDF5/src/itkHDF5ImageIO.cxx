@@ -21,6 +21,8 @@
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include "vcl_cmath.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -69,6 +71,102 @@ const std::string VoxelType("/VoxelType");
 const std::string VoxelData("/VoxelData");
 const std::string MetaDataName("/MetaData");
 
+// the chunk cache is not made larger than that
+const size_t MaximumChunkCacheSize = 256 * 1024 * 1024;
+
+size_t NextPrime(size_t n)
+{
+  for ( ;; ++n )
+    {
+    size_t d = 2;
+    while ( d * d <= n && n % d != 0 )
+      {
+      ++d;
+      }
+    if ( n > 1 && d * d > n )
+      {
+      return n;
+      }
+    }
+}
+
+// create a dataset access property list whose chunk cache holds a
+// layer of the chunks which intersect the region, the layer which is
+// across the slowest moving dimension. The region can then be read or
+// written by consecutive slabs along that dimension while each chunk is
+// decompressed, or compressed, only once. All arrays list the slowest
+// moving dimension first, as HDF5 does.
+hid_t CreateChunkCacheAccessPropList(const std::vector< hsize_t > & chunk,
+                                     const std::vector< hsize_t > & start,
+                                     const std::vector< hsize_t > & size,
+                                     size_t elementSize)
+{
+  size_t chunkBytes = elementSize;
+  size_t numberOfChunks = 1;
+  for ( size_t i = 0; i < chunk.size(); ++i )
+    {
+    chunkBytes *= chunk[i];
+    if ( i > 0 && size[i] > 0 )
+      {
+      numberOfChunks *= ( start[i] + size[i] - 1 ) / chunk[i] - start[i] / chunk[i] + 1;
+      }
+    }
+  // the default size of the HDF5 cache is 1 MiB
+  const size_t cacheBytes = std::max( static_cast< size_t >( 1024 * 1024 ),
+                                      std::min(numberOfChunks * chunkBytes, MaximumChunkCacheSize) );
+  const size_t chunksInCache = cacheBytes / std::max(chunkBytes, static_cast< size_t >( 1 ) ) + 1;
+
+  hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  H5Pset_chunk_cache( dapl, NextPrime( std::max( static_cast< size_t >( 521 ), 100 * chunksInCache ) ),
+                      cacheBytes, 1.0 );
+  return dapl;
+}
+
+// the IORegion in the HDF5 order, slowest moving dimension first
+void GetHDFRegion(const ImageIOBase *io,
+                  std::vector<hsize_t> &start, std::vector<hsize_t> &size)
+{
+  const ImageIORegion & region = io->GetIORegion();
+  const int numComponents = io->GetNumberOfComponents();
+  const int HDFDim(io->GetNumberOfDimensions() +
+                   (numComponents > 1 ? 1 : 0));
+  start.assign(HDFDim, 0);
+  size.assign(HDFDim, numComponents);
+  const int limit = (numComponents > 1 ? HDFDim - 1 : HDFDim);
+  for(int i=0; i < limit; i++)
+    {
+    start[limit - i - 1] = region.GetIndex()[i];
+    size[limit - i - 1] = region.GetSize()[i];
+    }
+}
+
+// the size of the chunks in which the voxel data is written, in the
+// HDF5 order
+void ComputeChunkSize(const ImageIOBase *io, std::vector<hsize_t> &chunk)
+{
+  const std::vector<SizeValueType> & chunkSize = io->GetChunkSize();
+  const unsigned int numDims = io->GetNumberOfDimensions();
+  const int numComponents = io->GetNumberOfComponents();
+
+  // by default, bricks of about 256k voxels, which are small enough for
+  // the region of interest of a large volume to be read without
+  // decompressing much more data than needed
+  const SizeValueType defaultEdge = static_cast<SizeValueType>(
+    vcl_pow(2.0, 18.0 / numDims) + 0.5);
+
+  chunk.assign(numDims + (numComponents > 1 ? 1 : 0), numComponents);
+  for(unsigned int i = 0; i < numDims; i++)
+    {
+    SizeValueType edge = defaultEdge;
+    if(i < chunkSize.size() && chunkSize[i] > 0)
+      {
+      edge = chunkSize[i];
+      }
+    chunk[numDims - i - 1] = std::max(static_cast<SizeValueType>(1),
+                                      std::min(edge, static_cast<SizeValueType>(io->GetDimensions(i))));
+    }
+}
+
 template <typename TScalar>
 H5::PredType GetType()
 {
@@ -953,18 +1051,56 @@ HDF5ImageIO
   VoxelDataName += VoxelData;
   if(this->m_VoxelDataSet == 0)
     {
-    this->m_VoxelDataSet = new H5::DataSet();
-    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    this->m_VoxelDataSet = this->OpenVoxelDataSet(VoxelDataName);
     }
   H5::DataType voxelType = this->m_VoxelDataSet->getDataType();
   H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
 
 
+  // only the chunks which intersect the region are read
   H5::DataSpace dspace;
   this->SetupStreaming(&imageSpace,&dspace);
   this->m_VoxelDataSet->read(buffer,voxelType,dspace,imageSpace);
 }
 
+H5::DataSet *
+HDF5ImageIO
+::OpenVoxelDataSet(const std::string &VoxelDataName)
+{
+  H5::DataSet *voxelDataSet = new H5::DataSet();
+  *voxelDataSet = this->m_H5File->openDataSet(VoxelDataName);
+
+  // open the data set again with a chunk cache large enough for the
+  // IORegion, when the data is chunked
+  H5::DSetCreatPropList plist = voxelDataSet->getCreatePlist();
+  if(plist.getLayout() != H5D_CHUNKED)
+    {
+    return voxelDataSet;
+    }
+  const int HDFDim = voxelDataSet->getSpace().getSimpleExtentNdims();
+  std::vector<hsize_t> chunk(HDFDim);
+  plist.getChunk(HDFDim,&chunk[0]);
+  std::vector<hsize_t> start;
+  std::vector<hsize_t> size;
+  GetHDFRegion(this,start,size);
+  if(static_cast<int>(start.size()) != HDFDim)
+    {
+    return voxelDataSet;
+    }
+
+  hid_t dapl = CreateChunkCacheAccessPropList(chunk,start,size,
+                                              voxelDataSet->getDataType().getSize());
+  hid_t dataSetId = H5Dopen2(this->m_H5File->getId(),VoxelDataName.c_str(),dapl);
+  H5Pclose(dapl);
+  if(dataSetId < 0)
+    {
+    return voxelDataSet;
+    }
+  voxelDataSet->close();
+  delete voxelDataSet;
+  return new H5::DataSet(dataSetId);
+}
+
 template <typename TType>
 bool
 HDF5ImageIO
@@ -1244,21 +1380,38 @@ HDF5ImageIO
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
+    // the chunks are bricks of ChunkSize, compressed at
+    // CompressionLevel, 5 by default
+    std::vector<hsize_t> chunk;
+    ComputeChunkSize(this,chunk);
     H5::DSetCreatPropList plist;
-    plist.setDeflate(5);
-    dims[0] = 1;
-    plist.setChunk(numDims,dims);
+    const int compressionLevel = this->GetCompressionLevel();
+    if(compressionLevel != 0)
+      {
+      plist.setDeflate(compressionLevel < 0 ? 5 : compressionLevel);
+      }
+    plist.setChunk(numDims,&chunk[0]);
 
     //
-    // Create DataSet Once, potentially write to it many times
+    // Create DataSet Once, potentially write to it many times.
+    // The chunk cache keeps the chunks which the pieces of a
+    // streamed write share until they are complete.
     if(this->m_VoxelDataSet == 0)
       {
-      this->m_VoxelDataSet = new H5::DataSet();
-      *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName,
-                                                              dataType,
-                                                              imageSpace,plist);
+      std::vector<hsize_t> start(numDims,0);
+      std::vector<hsize_t> size(dims,dims + numDims);
+      hid_t dapl = CreateChunkCacheAccessPropList(chunk,start,size,dataType.getSize());
+      hid_t dataSetId = H5Dcreate2(this->m_H5File->getId(),VoxelDataName.c_str(),
+                                   dataType.getId(),imageSpace.getId(),
+                                   H5P_DEFAULT,plist.getId(),dapl);
+      H5Pclose(dapl);
+      if(dataSetId < 0)
+        {
+        delete [] dims;
+        itkExceptionMacro(<< "Cannot create " << VoxelDataName
+                          << " in " << this->GetFileName());
+        }
+      this->m_VoxelDataSet = new H5::DataSet(dataSetId);
       }
     H5::DataSpace dspace;
     this->SetupStreaming(&imageSpace,&dspace);
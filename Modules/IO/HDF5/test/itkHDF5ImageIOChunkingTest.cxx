@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkHDF5ImageIO.h"
+#include "itkVector.h"
+
+namespace
+{
+template< class TPixel >
+void SetExpectedValue(TPixel & pixel, const itk::Index< 3 > & index)
+{
+  pixel = static_cast< TPixel >( index[0] + 11 * index[1] - 5 * index[2] );
+}
+
+template< class TValue, unsigned int VLength >
+void SetExpectedValue(itk::Vector< TValue, VLength > & pixel, const itk::Index< 3 > & index)
+{
+  for ( unsigned int i = 0; i < VLength; ++i )
+    {
+    pixel[i] = static_cast< TValue >( index[i % 3] * ( i + 1 ) - index[2] );
+    }
+}
+
+template< class TImage >
+bool CheckImage(const TImage *image, const typename TImage::RegionType & region)
+{
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << "ERROR: " << image->GetBufferedRegion() << " was read instead of "
+              << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(image, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    typename TImage::PixelType expected;
+    SetExpectedValue( expected, it.GetIndex() );
+    if ( it.Get() != expected )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// write the image in several pieces with the given chunks and
+// compression, then read it whole and read a region of it
+template< class TImage >
+bool WriteAndRead(const std::string & fileName, const std::vector< itk::SizeValueType > & chunkSize,
+                  int compressionLevel)
+{
+  typename TImage::SizeType size;
+  size[0] = 70;
+  size[1] = 50;
+  size[2] = 30;
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    typename TImage::PixelType value;
+    SetExpectedValue( value, it.GetIndex() );
+    it.Set(value);
+    }
+
+  itk::HDF5ImageIO::Pointer writerIO = itk::HDF5ImageIO::New();
+  writerIO->SetChunkSize(chunkSize);
+  writerIO->SetCompressionLevel(compressionLevel);
+
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetImageIO(writerIO);
+  writer->SetNumberOfStreamDivisions(4);
+  writer->Update();
+  // close the file
+  writer = typename WriterType::Pointer();
+  writerIO = itk::HDF5ImageIO::Pointer();
+
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO( itk::HDF5ImageIO::New() );
+  reader->Update();
+  if ( !CheckImage< TImage >( reader->GetOutput(), image->GetBufferedRegion() ) )
+    {
+    std::cerr << "ERROR: " << fileName << " was not read" << std::endl;
+    return false;
+    }
+
+  // a region which crosses several chunks in each dimension
+  typename TImage::RegionType region;
+  region.SetIndex(0, 13);
+  region.SetIndex(1, 7);
+  region.SetIndex(2, 9);
+  region.SetSize(0, 41);
+  region.SetSize(1, 30);
+  region.SetSize(2, 17);
+  itk::HDF5ImageIO::Pointer readerIO = itk::HDF5ImageIO::New();
+  reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(readerIO);
+  reader->UseStreamingOn();
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->Update();
+  if ( !CheckImage< TImage >( reader->GetOutput(), region ) )
+    {
+    std::cerr << "ERROR: region of " << fileName << " was not read" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkHDF5ImageIOChunkingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  std::vector< itk::SizeValueType > chunkSize(3, 16);
+  chunkSize[2] = 0;
+  io->SetChunkSize(chunkSize);
+  io->SetCompressionLevel(20);
+  if ( io->GetCompressionLevel() != 9 || io->GetChunkSize() != chunkSize )
+    {
+    std::cerr << "ERROR: the chunk size or the compression level was not set" << std::endl;
+    return EXIT_FAILURE;
+    }
+  io->Print(std::cout);
+
+  try
+    {
+    typedef itk::Image< short, 3 >                       ScalarImageType;
+    typedef itk::Image< itk::Vector< float, 2 >, 3 >     VectorImageType;
+
+    // the default chunks, and the default compression
+    std::vector< itk::SizeValueType > defaultSize;
+    if ( !WriteAndRead< ScalarImageType >(directory + "/itkHDF5ImageIOChunkingTest1.hdf5",
+                                          defaultSize, -1) )
+      {
+      return EXIT_FAILURE;
+      }
+    // bricks cut by the border of the image, with and without compression
+    if ( !WriteAndRead< ScalarImageType >(directory + "/itkHDF5ImageIOChunkingTest2.hdf5",
+                                          chunkSize, 1)
+         || !WriteAndRead< ScalarImageType >(directory + "/itkHDF5ImageIOChunkingTest3.hdf5",
+                                             chunkSize, 0) )
+      {
+      return EXIT_FAILURE;
+      }
+    // a brick larger than the image, and vector pixels
+    chunkSize[0] = 100;
+    chunkSize.resize(2);
+    if ( !WriteAndRead< VectorImageType >(directory + "/itkHDF5ImageIOChunkingTest4.hdf5",
+                                          chunkSize, 9) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkDirectFileWriter_h
+#define __itkDirectFileWriter_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class DirectFileWriter
+ * \brief Writes chunks of memory at given offsets of an existing file,
+ * on several threads.
+ *
+ * Write() splits the bytes to write in windows of at most BufferSize
+ * bytes which never overlap, and writes the windows in parallel with
+ * positioned writes, so that the threads share the file without
+ * seeking.
+ *
+ * With UseDirectIO, the file is opened with O_DIRECT where the system
+ * provides it, and the data bypasses the page cache. The windows are
+ * then aligned on the pages of the file: the chunks falling in a window
+ * are gathered in an aligned staging buffer, the bytes of the window
+ * which they do not cover are read from the file first, and the whole
+ * window is written at once. The file is truncated back to its size
+ * when the last window extends past the data. When the file system
+ * refuses O_DIRECT, the windows are written through the page cache.
+ *
+ * The chunks must not overlap. The file is not created, it must exist.
+ *
+ * \sa StreamingImageIOBase::StreamWriteBufferAsBinary()
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT DirectFileWriter:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef DirectFileWriter           Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DirectFileWriter, Object);
+
+  /** Bytes of memory to write at an offset of the file. */
+  struct ChunkType {
+    SizeValueType Offset;
+    const void *  Data;
+    SizeValueType NumberOfBytes;
+  };
+  typedef std::vector< ChunkType > ChunkContainerType;
+
+  /** Set/Get a boolean to bypass the page cache of the system, when it
+   * supports it. The default is on. */
+  itkSetMacro(UseDirectIO, bool);
+  itkGetConstMacro(UseDirectIO, bool);
+  itkBooleanMacro(UseDirectIO);
+
+  /** Set/Get the number of threads which write the windows. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Set/Get the largest number of bytes written at once by a thread,
+   * which is also the size of the staging buffer of each thread with
+   * direct I/O. The default is 4 MiB. */
+  itkSetClampMacro(BufferSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BufferSize, SizeValueType);
+
+  /** Write the chunks to the file. An exception is thrown if the file
+   * can not be opened or a write fails. */
+  void Write(const std::string & fileName, const ChunkContainerType & chunks);
+
+  /** True if the last Write() bypassed the page cache. */
+  itkGetConstMacro(DirectIOUsed, bool);
+
+protected:
+  DirectFileWriter();
+  ~DirectFileWriter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Write the windows assigned to a thread. */
+  static ITK_THREAD_RETURN_TYPE WriteThreaderCallback(void *arg);
+
+  bool WriteWindow(SizeValueType window, char *staging);
+
+private:
+  DirectFileWriter(const Self &); //purposely not implemented
+  void operator=(const Self &);   //purposely not implemented
+
+  /** Split the chunks in windows aligned on alignment bytes. */
+  void ComputeWindows(SizeValueType alignment);
+
+  /** Write all the windows, return false if one of them failed. */
+  bool WriteWindows(int file);
+
+  /** A range of the file written at once, and the first chunk which
+   * may have bytes in it. */
+  struct WindowType {
+    SizeValueType Offset;
+    SizeValueType NumberOfBytes;
+    SizeValueType FirstChunk;
+  };
+
+  bool          m_UseDirectIO;
+  ThreadIdType  m_NumberOfThreads;
+  SizeValueType m_BufferSize;
+  bool          m_DirectIOUsed;
+
+  /** State of the current Write() shared with the threads. */
+  ChunkContainerType        m_Chunks;
+  std::vector< WindowType > m_Windows;
+  std::vector< char >       m_WindowSucceeded;
+  SizeValueType             m_WindowSize;
+  SizeValueType             m_Alignment;
+  int                       m_File;
+};
+} // end namespace itk
+
+#endif
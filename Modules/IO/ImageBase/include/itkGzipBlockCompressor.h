@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGzipBlockCompressor_h
+#define __itkGzipBlockCompressor_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include <istream>
+#include <vector>
+
+namespace itk
+{
+/** \class GzipBlockCompressor
+ * \brief Compresses and decompresses gzip members block by block on
+ * several threads.
+ *
+ * Compress() splits the data in blocks of BlockSize bytes which are
+ * deflated independently, and in parallel, with no history shared
+ * between the blocks. Every block but the last one ends with a sync
+ * flush, so that the concatenation of the blocks is a single deflate
+ * stream, wrapped in a gzip member which any gzip or zlib reader can
+ * decompress.
+ *
+ * The uncompressed size, the block size and the compressed size of
+ * every block are stored in an extra field (subfield identifier "IT")
+ * of the gzip header. Decompress() uses this index to inflate the
+ * blocks of such a member in parallel; members without the index are
+ * inflated sequentially.
+ *
+ * The index also gives random access to the uncompressed data:
+ * DecompressRanges() reads from a stream and inflates only the blocks
+ * which hold the requested bytes.
+ *
+ * The index holds at most 8189 blocks, the BlockSize is multiplied for
+ * larger data.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT GzipBlockCompressor:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef GzipBlockCompressor        Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(GzipBlockCompressor, Object);
+
+  /** A range of the uncompressed data, given by its offset and its
+   * number of bytes. */
+  typedef std::pair< SizeValueType, SizeValueType > RangeType;
+  typedef std::vector< RangeType >                  RangeContainerType;
+
+  /** Set/Get the number of uncompressed bytes of each block. The
+   * default is 1 MiB. */
+  itkSetClampMacro(BlockSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BlockSize, SizeValueType);
+
+  /** Set/Get the zlib compression level, from 0 (no compression) to
+   * 9 (best compression). -1 selects the default zlib level. */
+  itkSetClampMacro(CompressionLevel, int, -1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the number of threads which compress or decompress the
+   * blocks. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Compress numberOfBytes bytes of data in a gzip member with a
+   * block index. */
+  void Compress(const void *data, SizeValueType numberOfBytes,
+                std::vector< char > & member);
+
+  /** Decompress the gzip member starting at the beginning of member in
+   * data, which must have room for the numberOfBytes uncompressed
+   * bytes of the member. Blocks are inflated in parallel when the
+   * member has a block index. An exception is thrown if the member is
+   * corrupted or does not hold numberOfBytes bytes. */
+  void Decompress(const void *member, SizeValueType memberSize,
+                  void *data, SizeValueType numberOfBytes);
+
+  /** Decompress the ranges of the uncompressed data of the gzip member
+   * which begins at the current position of the stream. The ranges must
+   * be sorted and must not overlap, their bytes are stored one after the
+   * other in data. Only the compressed blocks holding bytes of the
+   * ranges are read, and they are inflated in parallel. The member must
+   * have a block index. Since only a part of the data is inflated, its
+   * checksum is not verified. */
+  void DecompressRanges(std::istream & stream, const RangeContainerType & ranges,
+                        void *data);
+
+  /** Return true if the buffer begins with a gzip member with a block
+   * index, and report the size of the member and of its uncompressed
+   * data. */
+  static bool GetIndexedMemberSize(const void *buffer, SizeValueType bufferSize,
+                                   SizeValueType & memberSize,
+                                   SizeValueType & numberOfBytes);
+
+  /** Return true if a gzip member with a block index begins at the
+   * current position of the stream. The position is restored. */
+  static bool HasBlockIndex(std::istream & stream);
+
+protected:
+  GzipBlockCompressor();
+  ~GzipBlockCompressor() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Deflate or inflate the blocks assigned to a thread. */
+  static ITK_THREAD_RETURN_TYPE CompressThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE DecompressThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE DecompressRangesThreaderCallback(void *arg);
+
+  bool CompressBlock(SizeValueType block);
+  bool DecompressBlock(SizeValueType block);
+
+  /** Inflate the ith block read by DecompressRanges(), and copy its
+   * bytes which belong to the ranges. */
+  bool DecompressRangesBlock(SizeValueType i);
+
+private:
+  GzipBlockCompressor(const Self &); //purposely not implemented
+  void operator=(const Self &);      //purposely not implemented
+
+  /** The block index read from, or written to, the gzip header. */
+  struct BlockIndex {
+    SizeValueType NumberOfBytes;
+    SizeValueType BlockSize;
+    SizeValueType HeaderSize;
+    std::vector< SizeValueType > CompressedBlockSizes;
+  };
+
+  static bool ReadBlockIndex(const unsigned char *buffer, SizeValueType bufferSize,
+                             BlockIndex & index);
+
+  static bool ReadBlockIndex(std::istream & stream, BlockIndex & index);
+
+  SizeValueType m_BlockSize;
+  int           m_CompressionLevel;
+  ThreadIdType  m_NumberOfThreads;
+
+  /** State shared with the threads during Compress() and
+   * Decompress(). */
+  const unsigned char *                        m_Input;
+  unsigned char *                              m_Output;
+  BlockIndex                                   m_Index;
+  std::vector< SizeValueType >                 m_BlockOffsets;
+  std::vector< std::vector< unsigned char > >  m_Blocks;
+  std::vector< unsigned long >                 m_BlockCRCs;
+  std::vector< char >                          m_BlockSucceeded;
+  std::vector< SizeValueType >                 m_BlockNumbers;
+  const RangeContainerType *                   m_Ranges;
+  std::vector< SizeValueType >                 m_RangeOutputOffsets;
+};
+} // end namespace itk
+
+#endif
@@ -24,6 +24,8 @@
 #include "itkImageRegion.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -81,6 +83,25 @@ public:
  * raw binary format) have no accepted suffix, so you will have to
  * manually create the ImageIO instance of the write type.
  *
+ * When UseMemoryMapping is on in the ImageIO, no conversion is needed
+ * and the ImageIO can map the region to read (see
+ * ImageIOBase::MapIORegion()), the pixel container of the output points
+ * directly into a copy-on-write memory mapping of the file. Only the
+ * pages of the file which are accessed are then read from disk.
+ *
+ * When UsePrefetching is on and the pipeline streams the reader piece
+ * by piece, each update starts reading the piece which should be
+ * requested next on a background thread, while the pipeline processes
+ * the current one. The next piece is the current one moved by the
+ * offset between the two last requested regions, or by its own size
+ * along the slowest dimension which is split. If the next request is
+ * for that piece, its pixels are taken from the prefetch buffer
+ * instead of being read. The background thread reads with its own
+ * instance of the ImageIO, created by CreateAnother(), so only ImageIOs
+ * which get everything from the file, and can stream, are prefetched.
+ * The file library of the ImageIO must not be used by another thread of
+ * the pipeline meanwhile, if it is not thread safe.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
@@ -154,6 +175,12 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the next streamed piece is read ahead on a
+   * background thread. Off by default. */
+  itkSetMacro(UsePrefetching, bool);
+  itkGetConstReferenceMacro(UsePrefetching, bool);
+  itkBooleanMacro(UsePrefetching);
+
 protected:
   ImageFileReader();
   ~ImageFileReader();
@@ -172,6 +199,30 @@ protected:
   /** Does the real work. */
   virtual void GenerateData();
 
+  /** Make the output buffer point into a memory mapping of the file
+   * when the ImageIO supports it and the file pixels can be used as they
+   * are. Returns false if the data must be read. */
+  bool MapOutputBuffer();
+
+  /** Wait for the piece read on the background thread. Returns true and
+   * swaps it into m_LoadBuffer when it is the actual IO region of the
+   * current update, of the current file. */
+  bool TakePrefetchedRegion();
+
+  /** Start reading, on a background thread, the piece which should
+   * follow the current requested region. */
+  void StartPrefetch();
+
+  /** Wait for the background thread, if one is running. */
+  void WaitForPrefetch();
+
+  /** Compute the piece which should follow current, after previous, in
+   * the largest region. Returns false if there is none. */
+  static bool ComputeNextRegion(const ImageRegionType & current, const ImageRegionType & previous,
+                                const ImageRegionType & largest, ImageRegionType & next);
+
+  static ITK_THREAD_RETURN_TYPE PrefetchThreaderCallback(void *arg);
+
   ImageIOBase::Pointer m_ImageIO;
 
   bool m_UserSpecifiedImageIO; // keep track whether the
@@ -179,6 +230,8 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UsePrefetching;
+
 private:
   ImageFileReader(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
@@ -188,6 +241,22 @@ private:
   // The region that the ImageIO class will return when we ask to
   // produce the requested region.
   ImageIORegion m_ActualIORegion;
+
+  // The pixels of the file for the current update, and the ones read
+  // ahead for the next one. The two buffers are swapped.
+  std::vector< char > m_LoadBuffer;
+  std::vector< char > m_PrefetchBuffer;
+
+  // The state of the background read. The thread only writes the
+  // prefetch members, and they are only read after it is joined.
+  MultiThreader::Pointer m_PrefetchThreader;
+  int                    m_PrefetchThreadId;
+  ImageIOBase::Pointer   m_PrefetchImageIO;
+  std::string            m_PrefetchFileName;
+  ImageIORegion          m_PrefetchRequestedRegion;
+  ImageIORegion          m_PrefetchIORegion;
+  bool                   m_PrefetchSucceeded;
+  ImageRegionType        m_PreviousRequestedRegion;
 };
 } //namespace ITK
 
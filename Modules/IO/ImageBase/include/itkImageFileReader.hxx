@@ -26,6 +26,7 @@
 #include "itkVectorImage.h"
 
 #include "itksys/SystemTools.hxx"
+#include <algorithm>
 #include <fstream>
 
 namespace itk
@@ -38,12 +39,17 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UsePrefetching = false;
+  m_PrefetchThreadId = -1;
+  m_PrefetchSucceeded = false;
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
 ImageFileReader< TOutputImage, ConvertPixelTraits >
 ::~ImageFileReader()
-{}
+{
+  this->WaitForPrefetch();
+}
 
 template< class TOutputImage, class ConvertPixelTraits >
 void ImageFileReader< TOutputImage, ConvertPixelTraits >
@@ -63,6 +69,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "m_UsePrefetching: " << m_UsePrefetching << "\n";
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -353,6 +360,12 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 {
   typename TOutputImage::Pointer output = this->GetOutput();
 
+  if ( this->MapOutputBuffer() )
+    {
+    itkDebugMacro(<< "The output buffer is mapped from the file.");
+    return;
+    }
+
   itkDebugMacro (<< "ImageFileReader::GenerateData() \n"
                  << "Allocating the buffer with the EnlargedRequestedRegion \n"
                  << output->GetRequestedRegion() << "\n");
@@ -382,6 +395,32 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   itkDebugMacro (<< "Setting imageIO IORegion to: " << m_ActualIORegion);
   m_ImageIO->SetIORegion(m_ActualIORegion);
 
+  // When the previous update read this region ahead, its pixels are
+  // taken from the prefetch buffer while the next piece is read
+  if ( m_UsePrefetching && this->TakePrefetchedRegion() )
+    {
+    itkDebugMacro(<< "The region was prefetched.");
+    this->StartPrefetch();
+
+    const ImageIOBase::IOComponentType ioType =
+      ImageIOBase
+      ::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+    if ( m_ImageIO->GetComponentType() != ioType
+         || ( m_ImageIO->GetNumberOfComponents() !=
+              ConvertPixelTraits::GetNumberOfComponents() ) )
+      {
+      this->DoConvertBuffer( static_cast< void * >( &m_LoadBuffer[0] ),
+                             output->GetBufferedRegion().GetNumberOfPixels() );
+      }
+    else
+      {
+      const OutputImagePixelType *loaded = reinterpret_cast< const OutputImagePixelType * >( &m_LoadBuffer[0] );
+      std::copy( loaded, loaded + output->GetBufferedRegion().GetNumberOfPixels(),
+                 output->GetPixelContainer()->GetBufferPointer() );
+      }
+    return;
+    }
+
   char *loadBuffer = 0;
   // the size of the buffer is computed based on the actual number of
   // pixels to be read and the actual size of the pixels to be read
@@ -468,6 +507,218 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
     delete[] loadBuffer;
     loadBuffer = 0;
     }
+
+  // The next piece is read once the ImageIO is done with this one
+  this->StartPrefetch();
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::TakePrefetchedRegion()
+{
+  if ( m_PrefetchThreadId < 0 )
+    {
+    return false;
+    }
+  this->WaitForPrefetch();
+
+  // the prefetch ImageIO must have found the same file as m_ImageIO
+  if ( !m_PrefetchSucceeded
+       || m_PrefetchFileName != this->GetFileName()
+       || !( m_PrefetchIORegion == m_ActualIORegion )
+       || m_ActualIORegion.GetNumberOfPixels() == 0
+       || m_PrefetchImageIO->GetComponentType() != m_ImageIO->GetComponentType()
+       || m_PrefetchImageIO->GetNumberOfComponents() != m_ImageIO->GetNumberOfComponents()
+       || m_PrefetchImageIO->GetNumberOfDimensions() != m_ImageIO->GetNumberOfDimensions() )
+    {
+    return false;
+    }
+  for ( unsigned int i = 0; i < m_ImageIO->GetNumberOfDimensions(); ++i )
+    {
+    if ( m_PrefetchImageIO->GetDimensions(i) != m_ImageIO->GetDimensions(i) )
+      {
+      return false;
+      }
+    }
+
+  m_LoadBuffer.swap(m_PrefetchBuffer);
+  return true;
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::StartPrefetch()
+{
+  this->WaitForPrefetch();
+
+  if ( !m_UsePrefetching || !m_UseStreaming || !m_ImageIO->CanStreamRead() )
+    {
+    return;
+    }
+
+  typename TOutputImage::Pointer output = this->GetOutput();
+  const ImageRegionType current = output->GetRequestedRegion();
+  const ImageRegionType largest = output->GetLargestPossibleRegion();
+  ImageRegionType       next;
+  const bool            hasNext = ComputeNextRegion(current, m_PreviousRequestedRegion, largest, next);
+  m_PreviousRequestedRegion = current;
+  if ( !hasNext )
+    {
+    return;
+    }
+
+  if ( m_PrefetchImageIO.IsNull()
+       || strcmp( m_PrefetchImageIO->GetNameOfClass(), m_ImageIO->GetNameOfClass() ) != 0 )
+    {
+    m_PrefetchImageIO = dynamic_cast< ImageIOBase * >( m_ImageIO->CreateAnother().GetPointer() );
+    if ( m_PrefetchImageIO.IsNull() )
+      {
+      return;
+      }
+    }
+
+  typedef ImageIORegionAdaptor< TOutputImage::ImageDimension > ImageIOAdaptor;
+  m_PrefetchRequestedRegion = ImageIORegion(TOutputImage::ImageDimension);
+  ImageIOAdaptor::Convert( next, m_PrefetchRequestedRegion, largest.GetIndex() );
+  m_PrefetchFileName = this->GetFileName();
+  m_PrefetchSucceeded = false;
+
+  if ( m_PrefetchThreader.IsNull() )
+    {
+    m_PrefetchThreader = MultiThreader::New();
+    }
+  itkDebugMacro(<< "Prefetching " << next);
+  m_PrefetchThreadId = m_PrefetchThreader->SpawnThread(PrefetchThreaderCallback, this);
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::WaitForPrefetch()
+{
+  if ( m_PrefetchThreadId >= 0 )
+    {
+    m_PrefetchThreader->TerminateThread(m_PrefetchThreadId);
+    m_PrefetchThreadId = -1;
+    }
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::ComputeNextRegion(const ImageRegionType & current, const ImageRegionType & previous,
+                    const ImageRegionType & largest, ImageRegionType & next)
+{
+  typename ImageRegionType::OffsetType offset;
+  offset.Fill(0);
+
+  // The pieces of the splitters have the same size, but the last one, so
+  // the offset between two pieces of the same size is kept. Otherwise
+  // the current piece is moved along the slowest dimension it splits.
+  bool moved = false;
+  if ( current.GetSize() == previous.GetSize() )
+    {
+    offset = current.GetIndex() - previous.GetIndex();
+    for ( unsigned int i = 0; i < TOutputImage::ImageDimension; ++i )
+      {
+      moved = moved || offset[i] != 0;
+      }
+    }
+  for ( int i = TOutputImage::ImageDimension - 1; !moved && i >= 0; --i )
+    {
+    if ( current.GetSize(i) < largest.GetSize(i) )
+      {
+      offset[i] = current.GetSize(i);
+      moved = true;
+      }
+    }
+  if ( !moved )
+    {
+    return false;
+    }
+
+  next = current;
+  next.SetIndex(current.GetIndex() + offset);
+  return next.Crop(largest);
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+ITK_THREAD_RETURN_TYPE
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::PrefetchThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           reader = static_cast< Self * >( info->UserData );
+  ImageIOBase *                    io = reader->m_PrefetchImageIO;
+
+  try
+    {
+    io->SetFileName( reader->m_PrefetchFileName.c_str() );
+    io->ReadImageInformation();
+    io->SetUseStreamedReading(true);
+    reader->m_PrefetchIORegion = io->GenerateStreamableReadRegionFromRequestedRegion(reader->m_PrefetchRequestedRegion);
+    io->SetIORegion(reader->m_PrefetchIORegion);
+
+    const size_t size = reader->m_PrefetchIORegion.GetNumberOfPixels()
+                        * ( io->GetComponentSize() * io->GetNumberOfComponents() );
+    reader->m_PrefetchBuffer.resize(size);
+    if ( size > 0 )
+      {
+      io->Read( static_cast< void * >( &reader->m_PrefetchBuffer[0] ) );
+      }
+    reader->m_PrefetchSucceeded = true;
+    }
+  catch ( ... )
+    {
+    // the piece is read again by the next update
+    reader->m_PrefetchSucceeded = false;
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MapOutputBuffer()
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // the pixels of the file must not need any conversion
+  const ImageIOBase::IOComponentType ioType =
+    ImageIOBase
+    ::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  const size_t sizeOfActualIORegion = m_ActualIORegion.GetNumberOfPixels()
+                                      * ( m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents() );
+  if ( !m_ImageIO->GetUseMemoryMapping()
+       || m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()
+       || m_ActualIORegion.GetNumberOfPixels() != output->GetRequestedRegion().GetNumberOfPixels()
+       || sizeOfActualIORegion % sizeof( OutputImagePixelType ) != 0 )
+    {
+    return false;
+    }
+
+  m_ImageIO->SetFileName( this->GetFileName().c_str() );
+  m_ImageIO->SetIORegion(m_ActualIORegion);
+
+  MemoryMappedFileRegion::Pointer mapping = m_ImageIO->MapIORegion();
+  if ( !mapping
+       || reinterpret_cast< size_t >( mapping->GetPointer() ) % m_ImageIO->GetComponentSize() != 0 )
+    {
+    return false;
+    }
+
+  // the container keeps the mapping alive as long as it uses it
+  typename TOutputImage::PixelContainerPointer container = TOutputImage::PixelContainer::New();
+  container->SetImportPointer( static_cast< OutputImagePixelType * >( mapping->GetPointer() ),
+                               sizeOfActualIORegion / sizeof( OutputImagePixelType ) );
+  container->SetBufferOwner(mapping);
+
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->SetPixelContainer(container);
+  return true;
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
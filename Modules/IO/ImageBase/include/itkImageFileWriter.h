@@ -159,6 +159,16 @@ public:
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get the memory budget, in bytes. When not 0, the number of
+   * stream divisions is the smallest one for which the memory needed by
+   * the upstream pipeline to produce each piece, as estimated by
+   * PipelineMemoryEstimator, fits in the budget, and
+   * NumberOfStreamDivisions is ignored. The ImageIO must support streamed
+   * writing for the image to be divided. 0, the default, means no
+   * limit. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
   /** Aliased to the Write() method to be consistent with the rest of the
    * pipeline. */
   virtual void Update()
@@ -201,6 +211,23 @@ protected:
   /** Does the real work. */
   void GenerateData(void);
 
+  /** Data given to EstimatePieceMemory() through the
+   * PipelineMemoryEstimator. */
+  struct PieceMemoryStruct {
+    ImageIOBase *          ImageIO;
+    InputImageType *       Input;
+    ImageIORegion          PasteIORegion;
+    ImageIORegion          LargestIORegion;
+    InputImageRegionType   LargestRegion;
+  };
+
+  /** Estimate the memory the upstream pipeline needs to produce the
+   * largest piece when the image is written in numberOfDivisions pieces,
+   * stopping at the first piece which exceeds memoryBudget. */
+  static SizeValueType EstimatePieceMemory(unsigned int numberOfDivisions,
+                                           SizeValueType memoryBudget,
+                                           void *clientData);
+
 private:
   ImageFileWriter(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
@@ -213,6 +240,7 @@ private:
 
   ImageIORegion m_PasteIORegion;
   unsigned int  m_NumberOfStreamDivisions;
+  SizeValueType m_MemoryBudget;
   bool          m_UserSpecifiedIORegion;    // track whether the region
                                             // is user specified
   bool m_FactorySpecifiedImageIO;           //track whether the factory
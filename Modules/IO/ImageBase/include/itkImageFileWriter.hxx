@@ -32,6 +32,7 @@
 #include "itkDiffusionTensor3D.h"
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
+#include "itkPipelineMemoryEstimator.h"
 #include <complex>
 
 namespace itk
@@ -48,6 +49,7 @@ ImageFileWriter< TInputImage >
   m_UserSpecifiedIORegion = false;
   m_UserSpecifiedImageIO = false;
   m_NumberOfStreamDivisions = 1;
+  m_MemoryBudget = 0;
 }
 
 //---------------------------------------------------------
@@ -255,7 +257,7 @@ ImageFileWriter< TInputImage >
   // Notify start event observers
   this->InvokeEvent( StartEvent() );
 
-  if ( m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion )
+  if ( m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion || m_MemoryBudget > 0 )
     {
     m_ImageIO->SetUseStreamedWriting(true);
     }
@@ -287,10 +289,30 @@ ImageFileWriter< TInputImage >
 
   // Determin the actual number of divisions of the input. This is determined
   // by what the ImageIO can do
-  unsigned int numDivisions;
+  unsigned int numDivisions = m_NumberOfStreamDivisions;
+
+  // With a memory budget, use the smallest number of divisions whose
+  // pieces fit in the budget
+  if ( m_MemoryBudget > 0 )
+    {
+    PieceMemoryStruct str;
+    str.ImageIO = m_ImageIO;
+    str.Input = nonConstInput;
+    str.PasteIORegion = pasteIORegion;
+    str.LargestIORegion = largestIORegion;
+    str.LargestRegion = largestRegion;
+    numDivisions = PipelineMemoryEstimator::ComputeNumberOfDivisions(
+      nonConstInput, m_MemoryBudget,
+      m_ImageIO->GetActualNumberOfSplitsForWriting(NumericTraits< unsigned int >::max(),
+                                                   pasteIORegion,
+                                                   largestIORegion),
+      &Self::EstimatePieceMemory, &str);
+    itkDebugMacro(<< "Memory budget of " << m_MemoryBudget << " bytes: "
+                  << numDivisions << " stream divisions");
+    }
 
   // this may fail and throw an exception if the configuration is not supported
-  numDivisions = m_ImageIO->GetActualNumberOfSplitsForWriting(m_NumberOfStreamDivisions,
+  numDivisions = m_ImageIO->GetActualNumberOfSplitsForWriting(numDivisions,
                                                               pasteIORegion,
                                                               largestIORegion);
 
@@ -384,7 +406,7 @@ ImageFileWriter< TInputImage >
   // before this test, bad stuff would happened when they don't match
   if ( bufferedRegion != ioRegion )
     {
-    if ( m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion )
+    if ( m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion || m_MemoryBudget > 0 )
       {
       itkDebugMacro("Requested stream region does not match generated output");
       itkDebugMacro("input filter may not support streaming well");
@@ -416,6 +438,43 @@ ImageFileWriter< TInputImage >
   m_ImageIO->Write(dataPtr);
 }
 
+//---------------------------------------------------------
+template< class TInputImage >
+SizeValueType
+ImageFileWriter< TInputImage >
+::EstimatePieceMemory(unsigned int numberOfDivisions, SizeValueType memoryBudget,
+                      void *clientData)
+{
+  PieceMemoryStruct *str = static_cast< PieceMemoryStruct * >( clientData );
+
+  // the pieces at the boundary, or the ones a filter pads differently, may
+  // need more memory than the first one
+  const unsigned int numberOfSplits =
+    str->ImageIO->GetActualNumberOfSplitsForWriting(numberOfDivisions,
+                                                    str->PasteIORegion,
+                                                    str->LargestIORegion);
+  SizeValueType largestMemory = 0;
+  for ( unsigned int piece = 0; piece < numberOfSplits && largestMemory <= memoryBudget; ++piece )
+    {
+    ImageIORegion pieceIORegion =
+      str->ImageIO->GetSplitRegionForWriting(piece, numberOfSplits,
+                                             str->PasteIORegion,
+                                             str->LargestIORegion);
+
+    InputImageRegionType pieceRegion;
+    ImageIORegionAdaptor< TInputImage::ImageDimension >::
+    Convert( pieceIORegion, pieceRegion, str->LargestRegion.GetIndex() );
+
+    str->Input->SetRequestedRegion(pieceRegion);
+    const SizeValueType memory = PipelineMemoryEstimator::EstimateMemory(str->Input);
+    if ( memory > largestMemory )
+      {
+      largestMemory = memory;
+      }
+    }
+  return largestMemory;
+}
+
 //---------------------------------------------------------
 template< class TInputImage >
 void
@@ -439,6 +498,7 @@ ImageFileWriter< TInputImage >
 
   os << indent << "IO Region: " << m_PasteIORegion << "\n";
   os << indent << "Number of Stream Divisions: " << m_NumberOfStreamDivisions << "\n";
+  os << indent << "Memory Budget: " << m_MemoryBudget << "\n";
 
   if ( m_UseCompression )
     {
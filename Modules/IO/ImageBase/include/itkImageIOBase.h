@@ -23,6 +23,7 @@
 #include "itkLightProcessObject.h"
 #include "itkIndent.h"
 #include "itkImageIORegion.h"
+#include "itkMemoryMappedFileRegion.h"
 #include "itkRGBPixel.h"
 #include "itkRGBAPixel.h"
 #include "itkVariableLengthVector.h"
@@ -192,6 +193,38 @@ public:
   itkGetConstMacro(UseCompression, bool);
   itkBooleanMacro(UseCompression);
 
+  /** Set/Get the number of threads which compress the data. When it is
+   * greater than 1, ImageIOs which support it write the compressed data
+   * as a gzip member whose blocks are deflated in parallel, and inflate
+   * the blocks of such members in parallel when reading. The default
+   * is 1, which keeps the compression of the file format. */
+  itkSetClampMacro(NumberOfCompressionThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfCompressionThreads, ThreadIdType);
+
+  /** Set/Get the level of the compression, from 0 to 9, for ImageIOs
+   * which support it. 0 stores the data without compression, even in
+   * file formats which always compress it. The default, -1, uses the
+   * level of the file format. */
+  itkSetClampMacro(CompressionLevel, int, -1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the size of the chunks, or bricks, in which ImageIOs which
+   * support it store the data, fastest moving dimension first. A
+   * dimension which is missing or 0 is chosen by the ImageIO, as are all
+   * of them when ChunkSize is empty, the default. */
+  void SetChunkSize(const std::vector< SizeValueType > & size)
+  {
+    if ( m_ChunkSize != size )
+      {
+      m_ChunkSize = size;
+      this->Modified();
+      }
+  }
+  const std::vector< SizeValueType > & GetChunkSize() const
+  {
+    return m_ChunkSize;
+  }
+
   /** Set/Get a boolean to use streaming while reading or not. */
   itkSetMacro(UseStreamedReading, bool);
   itkGetConstMacro(UseStreamedReading, bool);
@@ -202,6 +235,30 @@ public:
   itkGetConstMacro(UseStreamedWriting, bool);
   itkBooleanMacro(UseStreamedWriting);
 
+  /** Set/Get a boolean to read the data through a memory mapping of the
+   * file or not. When on, ImageIOs which support it let the operating
+   * system read only the pages of the file which hold the IORegion, and
+   * MapIORegion() may be used to access the data without copying it. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get a boolean to write the data bypassing the page cache of the
+   * system. When on, ImageIOs which support it write the data in large
+   * blocks aligned on the pages of the file, with O_DIRECT where it is
+   * available, so that writing a large image does not evict the cached
+   * data of other processes. */
+  itkSetMacro(UseDirectIO, bool);
+  itkGetConstMacro(UseDirectIO, bool);
+  itkBooleanMacro(UseDirectIO);
+
+  /** Set/Get the number of threads which write the data. When it is
+   * greater than 1, ImageIOs which support it write the parts of the
+   * IORegion in parallel, at their offsets in the file. The default is
+   * 1. */
+  itkSetClampMacro(NumberOfWritingThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWritingThreads, ThreadIdType);
+
   /** Convenience method returns the IOComponentType as a string. This can be
    * used for writing output files. */
   static std::string GetComponentTypeAsString(IOComponentType);
@@ -322,6 +379,19 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) = 0;
 
+  /** Map the IORegion of the file in memory, as an alternative to
+   * Read(). The mapped bytes are exactly the ones Read() would store in
+   * its buffer, so the mapping can be used as the image buffer. NULL is
+   * returned when UseMemoryMapping is off, when the file can not be
+   * mapped, for instance because it is missing or too short, or when the
+   * file data can not be used as is, for instance because it is
+   * compressed, needs byte swapping or because the IORegion is not
+   * contiguous in the file. The default implementation returns NULL. */
+  virtual MemoryMappedFileRegion::Pointer MapIORegion()
+  {
+    return 0;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -551,12 +621,30 @@ protected:
   /** Should we compress the data? */
   bool m_UseCompression;
 
+  /** How many threads compress or decompress the data */
+  ThreadIdType m_NumberOfCompressionThreads;
+
+  /** The level of the compression, -1 for the level of the format */
+  int m_CompressionLevel;
+
+  /** The size of the chunks in which the data is stored */
+  std::vector< SizeValueType > m_ChunkSize;
+
   /** Should we use streaming for reading */
   bool m_UseStreamedReading;
 
   /** Should we use streaming for writing */
   bool m_UseStreamedWriting;
 
+  /** Should we read through a memory mapping of the file */
+  bool m_UseMemoryMapping;
+
+  /** Should we write bypassing the page cache */
+  bool m_UseDirectIO;
+
+  /** How many threads write the data */
+  ThreadIdType m_NumberOfWritingThreads;
+
   /** The region to read or write. The region contains information about the
    * data within the region to read or write. */
   ImageIORegion m_IORegion;
@@ -622,6 +710,15 @@ protected:
   /** Convenient method to read a buffer as binary. Return true on success. */
   bool ReadBufferAsBinary(std::istream & os, void *buffer, SizeType numberOfBytesToBeRead);
 
+  /** Convenient method to implement MapIORegion() for files which store
+   * the pixels uncompressed and unpadded, starting at dataPosition. The
+   * IORegion is mapped when UseMemoryMapping is on and the IORegion is
+   * contiguous in the file. NULL is returned otherwise, and when the file
+   * can not be opened or is too short, so that the caller falls back to
+   * Read(). */
+  MemoryMappedFileRegion::Pointer MapIORegionFromFile(const std::string & fileName,
+                                                      SizeType dataPosition);
+
   /** Insert an extension to the list of supported extensions for reading. */
   void AddSupportedReadExtension(const char *extension);
 
@@ -48,7 +48,14 @@ public:
   typedef enum { ReadMode, WriteMode } FileModeType;
 
   /** Create the appropriate ImageIO depending on the particulars of the file.
-    */
+   * The ImageIOs which list the extension of the file in their supported
+   * read, or write, extensions are tried first, then the other ones in
+   * the order of the registered factories. The ImageIOs of the factories
+   * are kept as prototypes, and built again only when a factory is
+   * registered, unregistered, enabled or disabled; they are released as
+   * soon as one of the factories is deleted. Each probe still runs on a
+   * new ImageIO made by CreateAnother() from the prototype.
+   */
   static ImageIOBasePointer CreateImageIO(const char *path, FileModeType mode);
 
 protected:
@@ -23,6 +23,8 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -34,6 +36,13 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * Only the files which hold a slice of the requested region are read,
+ * unless the MetaDataDictionaryArray has to be updated. The slices can
+ * be read concurrently by NumberOfReadingThreads threads, each one
+ * decoding its files straight into the output buffer. The header of
+ * the first file, parsed in GenerateOutputInformation(), is not parsed
+ * again when its slice is read.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -154,9 +163,18 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get the number of threads used to read the files. Each thread
+   * reads whole files with its own ImageFileReader. When an ImageIO is
+   * set and several threads are used, each thread reads with its own
+   * instance created with CreateAnother(). The default is 1, which
+   * reads the files one after the other. */
+  itkSetClampMacro(NumberOfReadingThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfReadingThreads, ThreadIdType);
+
 protected:
   ImageSeriesReader():m_ImageIO(0), m_ReverseOrder(false),
-    m_UseStreaming(true), m_MetaDataDictionaryArrayUpdate(true) {}
+    m_UseStreaming(true), m_NumberOfReadingThreads(1),
+    m_MetaDataDictionaryArrayUpdate(true) {}
   ~ImageSeriesReader();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -185,14 +203,44 @@ protected:
 
   bool m_UseStreaming;
 
+  ThreadIdType m_NumberOfReadingThreads;
+
 private:
   ImageSeriesReader(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
 
   typedef ImageFileReader< TOutputImage > ReaderType;
 
+  /** Internal structure used for passing the slices to read to the
+   * threads. */
+  struct ReadSlicesStruct
+  {
+    Self *                              Filter;
+    ImageRegionType                     RequestedRegion;
+    ImageRegionType                     SliceRegionToRequest;
+    SizeType                            ValidSize;
+    bool                                UpdateMetaDataDictionaryArray;
+    std::vector< int >                  Slices;
+    std::vector< ImageIOBase::Pointer > ImageIOs;
+    std::vector< std::string >          ErrorMessages;
+    SizeValueType                       NextSlice;
+    SizeValueType                       NumberOfSlicesRead;
+    SimpleFastMutexLock                 Mutex;
+  };
+
   int ComputeMovingDimensionIndex(ReaderType *reader);
 
+  /** Read the slice i of the series in the output buffer, or only its
+   * header when it is outside of the requested region, and keep its
+   * MetaDataDictionary if needed. */
+  void ReadSlice(int i, ImageIOBase *imageIO, const ReadSlicesStruct & str);
+
+  static ITK_THREAD_RETURN_TYPE ReadSlicesThreaderCallback(void *arg);
+
+  /** The reader of the first file of the series, whose header was
+   * parsed in GenerateOutputInformation(). */
+  typename ReaderType::Pointer m_FirstFileReader;
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
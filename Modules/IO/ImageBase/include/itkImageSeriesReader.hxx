@@ -54,6 +54,7 @@ void ImageSeriesReader< TOutputImage >
 
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "NumberOfReadingThreads: " << m_NumberOfReadingThreads << std::endl;
 
   if ( m_ImageIO )
     {
@@ -125,6 +126,7 @@ void ImageSeriesReader< TOutputImage >
       }
     }
   m_MetaDataDictionaryArray.clear();
+  m_FirstFileReader = 0;
 
   if ( m_FileNames.size() == 0 )
     {
@@ -142,10 +144,19 @@ void ImageSeriesReader< TOutputImage >
       {
       reader->SetImageIO(m_ImageIO);
       }
+    reader->SetUseStreaming(m_UseStreaming);
 
     // update the MetaDataDictionary and output information
     reader->UpdateOutputInformation();
 
+    // keep the reader of the first file, so that its header is not
+    // parsed again in GenerateData. This is not possible when the
+    // ImageIO is shared with the reader of the second file.
+    if ( i == 0 && ( !m_ImageIO || numberOfFiles == 1 ) )
+      {
+      m_FirstFileReader = reader;
+      }
+
     const TOutputImage * readerOutput = reader->GetOutput();
 
     if ( m_FileNames.size() == 1 )
@@ -305,11 +316,6 @@ void ImageSeriesReader< TOutputImage >
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0,
-                            requestedRegion.GetSize(TOutputImage::ImageDimension-1),
-                            100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -319,146 +325,288 @@ void ImageSeriesReader< TOutputImage >
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
     && m_MetaDataDictionaryArrayUpdate;
 
-  typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
-  IndexType                           sliceStartIndex = requestedRegion.GetIndex();
-  const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
-
+  // the slices to read, or whose header is needed
+  ReadSlicesStruct str;
+  str.Filter = this;
+  str.RequestedRegion = requestedRegion;
+  str.SliceRegionToRequest = sliceRegionToRequest;
+  str.ValidSize = validSize;
+  str.UpdateMetaDataDictionaryArray = needToUpdateMetaDataDictionaryArray;
+  str.NextSlice = 0;
+  str.NumberOfSlicesRead = 0;
+
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
   for ( int i = 0; i != numberOfFiles; ++i )
     {
     if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
       {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
       }
-
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
-
-    // check if we need this slice
-    if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
+    if ( requestedRegion.IsInside(sliceStartIndex) || needToUpdateMetaDataDictionaryArray )
       {
-      continue;
+      str.Slices.push_back(i);
       }
+    }
 
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_FileNames[iFileName].c_str() );
-
-    TOutputImage * readerOutput = reader->GetOutput();
+  if ( needToUpdateMetaDataDictionaryArray )
+    {
+    m_MetaDataDictionaryArray.assign(numberOfFiles, 0);
+    }
 
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( m_NumberOfReadingThreads ),
+              static_cast< SizeValueType >( str.Slices.size() ) ) );
+  if ( numberOfThreads <= 1 )
+    {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0, str.Slices.size(), 100);
+    for ( size_t s = 0; s < str.Slices.size(); ++s )
+      {
+      this->ReadSlice(str.Slices[s], m_ImageIO, str);
+      progress.CompletedPixel();
+      }
+    }
+  else
+    {
+    // the ImageIO objects keep the state of the file they read, each
+    // thread needs its own
+    str.ImageIOs.resize(numberOfThreads);
     if ( m_ImageIO )
       {
-      reader->SetImageIO(m_ImageIO);
+      for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
+        {
+        str.ImageIOs[t] = dynamic_cast< ImageIOBase * >( m_ImageIO->CreateAnother().GetPointer() );
+        if ( !str.ImageIOs[t] )
+          {
+          itkExceptionMacro(<< "Cannot create another " << m_ImageIO->GetNameOfClass());
+          }
+        }
       }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
+    str.ErrorMessages.resize(numberOfThreads);
+
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(Self::ReadSlicesThreaderCallback, &str);
+    threader->SingleMethodExecute();
 
-    // update the data or info
-    if ( !insideRequestedRegion )
+    for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
       {
-      reader->UpdateOutputInformation();
+      if ( !str.ErrorMessages[t].empty() )
+        {
+        m_FirstFileReader = 0;
+        itkExceptionMacro(<< str.ErrorMessages[t]);
+        }
       }
-    else
-      {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
+    }
 
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
+  // the header of the first file will be parsed again at the next update
+  m_FirstFileReader = 0;
+
+  // update the time if we modified the meta array
+  if ( needToUpdateMetaDataDictionaryArray )
+    {
+    m_MetaDataDictionaryArrayMTime.Modified();
+    }
+}
+
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSeriesReader< TOutputImage >
+::ReadSlicesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ReadSlicesStruct *               str = static_cast< ReadSlicesStruct * >( info->UserData );
+  const ThreadIdType               threadId = info->ThreadID;
 
-      // check that the size of each slice is the same
-      if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+  // the threads take the next slice to read until all are read, so
+  // that a slow file does not delay the others
+  try
+    {
+    while ( true )
+      {
+      str->Mutex.Lock();
+      const SizeValueType next = str->NextSlice++;
+      str->Mutex.Unlock();
+      if ( next >= str->Slices.size() )
         {
-        itkExceptionMacro( << "Size mismatch! The size of  "
-                           << m_FileNames[iFileName].c_str()
-                           << " is "
-                           << readerOutput->GetLargestPossibleRegion().GetSize()
-                           << " and does not match the required size "
-                           << validSize
-                           << " from file "
-                           << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+        break;
         }
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+      str->Filter->ReadSlice(str->Slices[next], str->ImageIOs[threadId], *str);
 
-      if( readSize == sliceRegionToRequest.GetSize() )
+      str->Mutex.Lock();
+      const SizeValueType numberOfSlicesRead = ++str->NumberOfSlicesRead;
+      str->Mutex.Unlock();
+      if ( threadId == 0 )
         {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
+        str->Filter->UpdateProgress( static_cast< float >( numberOfSlicesRead ) / str->Slices.size() );
+        }
+      }
+    }
+  catch ( ExceptionObject & err )
+    {
+    str->ErrorMessages[threadId] = err.GetDescription();
+    }
+  catch ( std::exception & err )
+    {
+    str->ErrorMessages[threadId] = err.what();
+    }
+
+  // the other threads stop at their next slice
+  if ( !str->ErrorMessages[threadId].empty() )
+    {
+    str->Mutex.Lock();
+    str->NextSlice = str->Slices.size();
+    str->Mutex.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage >
+void ImageSeriesReader< TOutputImage >
+::ReadSlice(int i, ImageIOBase *imageIO, const ReadSlicesStruct & str)
+{
+  TOutputImage *output = this->GetOutput();
 
-        const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+  const ImageRegionType & requestedRegion = str.RequestedRegion;
+  const ImageRegionType & sliceRegionToRequest = str.SliceRegionToRequest;
 
-        typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-        const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+    {
+    sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
 
+  const int  numberOfFiles = static_cast< int >( m_FileNames.size() );
+  const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
+  const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
-        const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
-          ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+  // configure reader, the reader of the first file already knows its header
+  typename ReaderType::Pointer reader;
+  if ( i == 0 && m_FirstFileReader )
+    {
+    reader = m_FirstFileReader;
+    }
+  else
+    {
+    reader = ReaderType::New();
+    reader->SetFileName( m_FileNames[iFileName].c_str() );
+    if ( imageIO )
+      {
+      reader->SetImageIO(imageIO);
+      }
+    reader->SetUseStreaming(m_UseStreaming);
+    }
 
-        const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool       bufferDelete = false;
+  TOutputImage * readerOutput = reader->GetOutput();
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
 
-        typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+  // update the data or info
+  if ( !insideRequestedRegion )
+    {
+    reader->UpdateOutputInformation();
+    }
+  else
+    {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
 
-        if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
-          {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
-                                                               bufferDelete );
-          }
-        else
-          {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice,
-                                                               bufferDelete );
-          }
-        readerOutput->UpdateOutputData();
-        }
-      else
-        {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
+    // propagate the requested region to determin what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
 
-        reader->Update();
+    // check that the size of each slice is the same
+    if ( readerOutput->GetLargestPossibleRegion().GetSize() != str.ValidSize )
+      {
+      itkExceptionMacro( << "Size mismatch! The size of  "
+                         << m_FileNames[iFileName].c_str()
+                         << " is "
+                         << readerOutput->GetLargestPossibleRegion().GetSize()
+                         << " and does not match the required size "
+                         << str.ValidSize
+                         << " from file "
+                         << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+      }
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex( sliceStartIndex );
+    // get the size of the region to be read
+    SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
 
-        // set the moving dimension to a size of 1
-        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-          {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-          }
+    // output of buffer copy
+    ImageRegionType outRegion = requestedRegion;
+    outRegion.SetIndex( sliceStartIndex );
 
-        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+    // set the moving dimension to a size of 1
+    if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+      {
+      outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+      }
 
-        }
+    if( readSize == sliceRegionToRequest.GetSize() )
+      {
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
 
-      // report progress for read slices
-      progress.CompletedPixel();
+      const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+      typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
+      const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+
+
+      const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
+        ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
 
-     } // end !insidedRequestedRegion
+      const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool       bufferDelete = false;
+
+      typename  TOutputImage::InternalPixelType * outputSliceBuffer = output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+      if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
+        {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
+                                                             bufferDelete );
+        }
+      else
+        {
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice,
+                                                             bufferDelete );
+        }
+      readerOutput->UpdateOutputData();
 
-    // Deep copy the MetaDataDictionary into the array
-    if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
+      // the reader may have replaced our buffer, by a memory mapping
+      // of the file for instance
+      if ( readerOutput->GetBufferPointer() != outputSliceBuffer )
+        {
+        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+        }
+      }
+    else
       {
-      DictionaryRawPointer newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      m_MetaDataDictionaryArray.push_back(newDictionary);
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
+
+      reader->Update();
+
+      ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+
       }
 
-    } // end per slice loop
+   } // end !insidedRequestedRegion
 
-  // update the time if we modified the meta array
-  if ( needToUpdateMetaDataDictionaryArray )
+  // Deep copy the MetaDataDictionary into the array, each slice has
+  // its own entry so that the threads do not share any
+  if ( reader->GetImageIO() && str.UpdateMetaDataDictionaryArray )
     {
-    m_MetaDataDictionaryArrayMTime.Modified();
+    DictionaryRawPointer newDictionary = new DictionaryType;
+    *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    m_MetaDataDictionaryArray[i] = newDictionary;
     }
 }
 
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedFileRegion_h
+#define __itkMemoryMappedFileRegion_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFileRegion
+ * \brief Maps a range of bytes of a file in memory.
+ *
+ * Map() maps numberOfBytes bytes of a file, starting at an arbitrary
+ * offset, in the address space of the process. The operating system
+ * reads the pages of the file only when they are first accessed, so
+ * mapping a large file is cheap and only the parts of the file actually
+ * used are read from disk.
+ *
+ * The mapping is private: the memory can be written to, but the
+ * modifications are copied on write and never reach the file.
+ *
+ * The mapping is released by Unmap() or when the object is destroyed.
+ * An ImportImageContainer pointing into the mapping keeps the
+ * MemoryMappedFileRegion alive through SetBufferOwner().
+ *
+ * \sa ImageIOBase::MapIORegion()
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT MemoryMappedFileRegion:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedFileRegion     Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFileRegion, Object);
+
+  /** Map numberOfBytes bytes of the file, starting at offset. A previous
+   * mapping is released first. An exception is thrown if the file can
+   * not be opened or is too short. */
+  void Map(const std::string & fileName, SizeValueType offset, SizeValueType numberOfBytes);
+
+  /** Release the mapping. */
+  void Unmap();
+
+  /** Pointer to the first mapped byte, NULL when nothing is mapped. */
+  void * GetPointer() const { return m_Pointer; }
+
+  /** Number of bytes mapped from the offset given to Map(). */
+  itkGetConstMacro(NumberOfBytes, SizeValueType);
+
+  /** Offset in the file of the first mapped byte. */
+  itkGetConstMacro(Offset, SizeValueType);
+
+  itkGetStringMacro(FileName);
+
+protected:
+  MemoryMappedFileRegion();
+  ~MemoryMappedFileRegion();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  MemoryMappedFileRegion(const Self &); //purposely not implemented
+  void operator=(const Self &);         //purposely not implemented
+
+  std::string   m_FileName;
+  SizeValueType m_Offset;
+  SizeValueType m_NumberOfBytes;
+  void *        m_Pointer;
+
+  /** Start and length of the mapping, which begins at a page boundary
+   * of the file. */
+  void *        m_MappedAddress;
+  SizeValueType m_MappedLength;
+};
+} // end namespace itk
+
+#endif
@@ -126,6 +126,11 @@ protected:
    * file for the size of the image in the dimensions of the
    * m_IORegion. This means that the image file could be broken into
    * slices, but not blocks for this methods to be used.
+   *
+   * When UseMemoryMapping is on, the part of the file spanned by the
+   * IORegion is memory mapped and the data is copied from the mapping
+   * instead of being read from os, so the pages of the file outside of
+   * the IORegion are not read.
    */
   virtual bool StreamReadBufferAsBinary(std::istream & os, void *buffer);
 
@@ -139,6 +144,11 @@ protected:
    * This methods relies on GetDataPosition to determin where the data
    * is located in the file. It usesy m_IORegion determin the requested
    * region to written.
+   *
+   * When UseDirectIO is on, or NumberOfWritingThreads is greater than
+   * 1, os is flushed and the chunks of the IORegion are written to the
+   * file by a DirectFileWriter instead, in parallel and bypassing the
+   * page cache as requested.
    */
   virtual bool StreamWriteBufferAsBinary(std::ostream & os, const void *buffer);
 
@@ -0,0 +1,381 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for O_DIRECT
+#endif
+
+#include "itkDirectFileWriter.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined( WIN32 ) || defined( _WIN32 )
+#include <fstream>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+bool ChunkOffsetLess(const DirectFileWriter::ChunkType & a, const DirectFileWriter::ChunkType & b)
+{
+  return a.Offset < b.Offset;
+}
+
+#if !defined( WIN32 ) && !defined( _WIN32 )
+// pwrite() and pread() may transfer less than asked, and are limited
+// to 2GB at once on some systems
+const SizeValueType MaximumTransferSize = 1024 * 1024 * 1024;
+
+bool WriteAll(int file, const char *data, SizeValueType numberOfBytes, SizeValueType offset)
+{
+  while ( numberOfBytes > 0 )
+    {
+    const ssize_t written = pwrite( file, data, static_cast< size_t >( std::min(numberOfBytes, MaximumTransferSize) ),
+                                    static_cast< off_t >( offset ) );
+    if ( written < 0 && errno == EINTR )
+      {
+      continue;
+      }
+    if ( written <= 0 )
+      {
+      return false;
+      }
+    data += written;
+    offset += written;
+    numberOfBytes -= written;
+    }
+  return true;
+}
+
+// read up to numberOfBytes, and zero the bytes past the end of the
+// file; a regular file only reads less than asked at its end, which
+// also keeps the next read aligned with O_DIRECT
+bool ReadAll(int file, char *data, SizeValueType numberOfBytes, SizeValueType offset)
+{
+  while ( numberOfBytes > 0 )
+    {
+    const SizeValueType toRead = std::min(numberOfBytes, MaximumTransferSize);
+    const ssize_t       count = pread( file, data, static_cast< size_t >( toRead ), static_cast< off_t >( offset ) );
+    if ( count < 0 && errno == EINTR )
+      {
+      continue;
+      }
+    if ( count < 0 )
+      {
+      return false;
+      }
+    data += count;
+    offset += count;
+    numberOfBytes -= count;
+    if ( static_cast< SizeValueType >( count ) < toRead )
+      {
+      std::memset(data, 0, numberOfBytes);
+      break;
+      }
+    }
+  return true;
+}
+#endif
+}
+
+DirectFileWriter::DirectFileWriter()
+{
+  m_UseDirectIO = true;
+  m_NumberOfThreads = 1;
+  m_BufferSize = 4 * 1024 * 1024;
+  m_DirectIOUsed = false;
+  m_WindowSize = 0;
+  m_Alignment = 1;
+  m_File = -1;
+}
+
+void
+DirectFileWriter
+::Write(const std::string & fileName, const ChunkContainerType & chunks)
+{
+  m_Chunks.clear();
+  for ( ChunkContainerType::const_iterator it = chunks.begin(); it != chunks.end(); ++it )
+    {
+    if ( it->NumberOfBytes > 0 )
+      {
+      m_Chunks.push_back(*it);
+      }
+    }
+  std::sort(m_Chunks.begin(), m_Chunks.end(), ChunkOffsetLess);
+  m_DirectIOUsed = false;
+  if ( m_Chunks.empty() )
+    {
+    return;
+    }
+
+#if defined( WIN32 ) || defined( _WIN32 )
+  // without positioned writes, the chunks are written in order
+  std::fstream file(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if ( file.fail() )
+    {
+    m_Chunks.clear();
+    itkExceptionMacro(<< "Could not open file for writing: " << fileName);
+    }
+  for ( ChunkContainerType::const_iterator it = m_Chunks.begin(); it != m_Chunks.end(); ++it )
+    {
+    file.seekp(static_cast< std::streamoff >( it->Offset ), std::ios::beg);
+    file.write(static_cast< const char * >( it->Data ), static_cast< std::streamsize >( it->NumberOfBytes ) );
+    }
+  m_Chunks.clear();
+  if ( file.fail() )
+    {
+    itkExceptionMacro(<< "Fail writing " << fileName);
+    }
+#else
+  m_File = -1;
+#if defined( O_DIRECT )
+  if ( m_UseDirectIO )
+    {
+    // file systems which do not support O_DIRECT refuse to open the file
+    m_File = open(fileName.c_str(), O_RDWR | O_DIRECT);
+    m_DirectIOUsed = ( m_File >= 0 );
+    }
+#endif
+  if ( m_File < 0 )
+    {
+    m_File = open(fileName.c_str(), O_RDWR);
+    }
+  if ( m_File < 0 )
+    {
+    m_Chunks.clear();
+    itkExceptionMacro(<< "Could not open file for writing: " << fileName);
+    }
+#if defined( F_NOCACHE )
+  if ( m_UseDirectIO && !m_DirectIOUsed )
+    {
+    m_DirectIOUsed = ( fcntl(m_File, F_NOCACHE, 1) != -1 );
+    }
+#endif
+
+  struct stat fileStatus;
+  SizeValueType fileSize = 0;
+  if ( fstat(m_File, &fileStatus) == 0 )
+    {
+    fileSize = static_cast< SizeValueType >( fileStatus.st_size );
+    }
+  const SizeValueType dataEnd = std::max( fileSize, m_Chunks.back().Offset + m_Chunks.back().NumberOfBytes );
+
+  bool succeeded = false;
+  if ( m_DirectIOUsed )
+    {
+    this->ComputeWindows( static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) ) );
+    succeeded = this->WriteWindows(m_File);
+    if ( !succeeded )
+      {
+      // the file was opened with O_DIRECT but the writes were refused,
+      // write through the page cache instead
+      close(m_File);
+      m_File = open(fileName.c_str(), O_RDWR);
+      m_DirectIOUsed = false;
+      }
+    }
+  if ( !m_DirectIOUsed && m_File >= 0 )
+    {
+    this->ComputeWindows(1);
+    succeeded = this->WriteWindows(m_File);
+    }
+
+  // the aligned windows may extend past the end of the data
+  if ( succeeded && fstat(m_File, &fileStatus) == 0
+       && static_cast< SizeValueType >( fileStatus.st_size ) > dataEnd )
+    {
+    succeeded = ( ftruncate( m_File, static_cast< off_t >( dataEnd ) ) == 0 );
+    }
+  if ( m_File >= 0 )
+    {
+    close(m_File);
+    }
+  m_File = -1;
+  m_Chunks.clear();
+  m_Windows.clear();
+  m_WindowSucceeded.clear();
+
+  if ( !succeeded )
+    {
+    itkExceptionMacro(<< "Fail writing " << fileName);
+    }
+#endif
+}
+
+void
+DirectFileWriter
+::ComputeWindows(SizeValueType alignment)
+{
+  m_Alignment = alignment;
+  m_WindowSize = ( m_BufferSize + alignment - 1 ) / alignment * alignment;
+  m_Windows.clear();
+
+  // chunks which share an aligned block, or follow each other, are
+  // written in the same run of windows; the gaps between the runs are
+  // left untouched
+  const SizeValueType numberOfChunks = m_Chunks.size();
+  SizeValueType       c = 0;
+  while ( c < numberOfChunks )
+    {
+    const SizeValueType runBegin = m_Chunks[c].Offset / alignment * alignment;
+    SizeValueType       runEnd = ( m_Chunks[c].Offset + m_Chunks[c].NumberOfBytes + alignment - 1 )
+                                 / alignment * alignment;
+    SizeValueType       last = c + 1;
+    while ( last < numberOfChunks && m_Chunks[last].Offset / alignment * alignment <= runEnd )
+      {
+      runEnd = std::max( runEnd, ( m_Chunks[last].Offset + m_Chunks[last].NumberOfBytes + alignment - 1 )
+                         / alignment * alignment );
+      ++last;
+      }
+
+    SizeValueType first = c;
+    for ( SizeValueType offset = runBegin; offset < runEnd; offset += m_WindowSize )
+      {
+      while ( m_Chunks[first].Offset + m_Chunks[first].NumberOfBytes <= offset )
+        {
+        ++first;
+        }
+      WindowType window;
+      window.Offset = offset;
+      window.NumberOfBytes = std::min(m_WindowSize, runEnd - offset);
+      window.FirstChunk = first;
+      m_Windows.push_back(window);
+      }
+    c = last;
+    }
+}
+
+bool
+DirectFileWriter
+::WriteWindows(int file)
+{
+  m_File = file;
+  m_WindowSucceeded.assign(m_Windows.size(), 0);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min( static_cast< SizeValueType >( m_NumberOfThreads ),
+                                            static_cast< SizeValueType >( m_Windows.size() ) ) ) );
+  threader->SetSingleMethod(Self::WriteThreaderCallback, this);
+  threader->SingleMethodExecute();
+
+  return std::find(m_WindowSucceeded.begin(), m_WindowSucceeded.end(), 0) == m_WindowSucceeded.end();
+}
+
+ITK_THREAD_RETURN_TYPE
+DirectFileWriter
+::WriteThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+#if !defined( WIN32 ) && !defined( _WIN32 )
+  // each thread gathers its windows in its own aligned staging buffer
+  void *staging = 0;
+  if ( self->m_DirectIOUsed
+       && posix_memalign( &staging, static_cast< size_t >( self->m_Alignment ),
+                          static_cast< size_t >( self->m_WindowSize ) ) != 0 )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const SizeValueType numberOfWindows = self->m_Windows.size();
+  for ( SizeValueType w = info->ThreadID; w < numberOfWindows; w += info->NumberOfThreads )
+    {
+    self->m_WindowSucceeded[w] = self->WriteWindow( w, static_cast< char * >( staging ) );
+    }
+  free(staging);
+#endif
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+DirectFileWriter
+::WriteWindow(SizeValueType window, char *staging)
+{
+#if defined( WIN32 ) || defined( _WIN32 )
+  (void)window;
+  (void)staging;
+  return false;
+#else
+  const WindowType &  w = m_Windows[window];
+  const SizeValueType windowEnd = w.Offset + w.NumberOfBytes;
+
+  if ( !staging )
+    {
+    // through the page cache, the chunks are written from the caller's
+    // memory
+    for ( SizeValueType c = w.FirstChunk; c < m_Chunks.size() && m_Chunks[c].Offset < windowEnd; ++c )
+      {
+      const ChunkType &   chunk = m_Chunks[c];
+      const SizeValueType begin = std::max(chunk.Offset, w.Offset);
+      const SizeValueType end = std::min(chunk.Offset + chunk.NumberOfBytes, windowEnd);
+      if ( !WriteAll(m_File, static_cast< const char * >( chunk.Data ) + ( begin - chunk.Offset ),
+                     end - begin, begin) )
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  SizeValueType covered = 0;
+  for ( SizeValueType c = w.FirstChunk; c < m_Chunks.size() && m_Chunks[c].Offset < windowEnd; ++c )
+    {
+    covered += std::min(m_Chunks[c].Offset + m_Chunks[c].NumberOfBytes, windowEnd)
+               - std::max(m_Chunks[c].Offset, w.Offset);
+    }
+
+  // the bytes of the window between the chunks keep their content
+  if ( covered < w.NumberOfBytes && !ReadAll(m_File, staging, w.NumberOfBytes, w.Offset) )
+    {
+    return false;
+    }
+
+  for ( SizeValueType c = w.FirstChunk; c < m_Chunks.size() && m_Chunks[c].Offset < windowEnd; ++c )
+    {
+    const ChunkType &   chunk = m_Chunks[c];
+    const SizeValueType begin = std::max(chunk.Offset, w.Offset);
+    const SizeValueType end = std::min(chunk.Offset + chunk.NumberOfBytes, windowEnd);
+    std::memcpy(staging + ( begin - w.Offset ),
+                static_cast< const char * >( chunk.Data ) + ( begin - chunk.Offset ), end - begin);
+    }
+
+  return WriteAll(m_File, staging, w.NumberOfBytes, w.Offset);
+#endif
+}
+
+void
+DirectFileWriter
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseDirectIO: " << ( m_UseDirectIO ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "BufferSize: " << m_BufferSize << std::endl;
+  os << indent << "DirectIOUsed: " << ( m_DirectIOUsed ? "On" : "Off" ) << std::endl;
+}
+} // end namespace itk
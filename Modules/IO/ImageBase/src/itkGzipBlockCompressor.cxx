@@ -0,0 +1,757 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkGzipBlockCompressor.h"
+#include "itk_zlib.h"
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+// gzip header with the FEXTRA flag, no time stamp and an unknown OS
+const unsigned int GzipHeaderSize = 10;
+const unsigned int GzipTrailerSize = 8;
+
+// the extra field holds the "IT" subfield, its length is stored on
+// 16 bits
+const unsigned int   IndexSubfieldHeaderSize = 4;
+const unsigned int   IndexFixedSize = 16;
+const SizeValueType  MaximumNumberOfBlocks =
+  ( 0xFFFF - IndexSubfieldHeaderSize - IndexFixedSize ) / 8;
+
+// largest number of bytes given to zlib at once
+const SizeValueType MaximumChunkSize = 1 << 30;
+
+// flags of the gzip header
+const unsigned char HeaderCRCFlag = 0x02;
+const unsigned char ExtraFlag = 0x04;
+const unsigned char NameFlag = 0x08;
+const unsigned char CommentFlag = 0x10;
+
+void AppendLittleEndian(std::vector< char > & buffer, uint64_t value, unsigned int numberOfBytes)
+{
+  for ( unsigned int i = 0; i < numberOfBytes; ++i )
+    {
+    buffer.push_back( static_cast< char >( ( value >> ( 8 * i ) ) & 0xFF ) );
+    }
+}
+
+uint64_t ReadLittleEndian(const unsigned char *buffer, unsigned int numberOfBytes)
+{
+  uint64_t value = 0;
+  for ( unsigned int i = numberOfBytes; i > 0; --i )
+    {
+    value = ( value << 8 ) | buffer[i - 1];
+    }
+  return value;
+}
+
+// inflate a block of raw deflate data, which does not refer to the data
+// of the previous blocks; only the last block ends the stream
+bool InflateBlock(const unsigned char *input, SizeValueType inputSize,
+                  unsigned char *output, SizeValueType length, bool last)
+{
+  z_stream z;
+  z.zalloc = Z_NULL;
+  z.zfree = Z_NULL;
+  z.opaque = Z_NULL;
+  z.next_in = const_cast< Bytef * >( input );
+  z.avail_in = static_cast< uInt >( inputSize );
+  if ( inflateInit2(&z, -MAX_WBITS) != Z_OK )
+    {
+    return false;
+    }
+
+  // zlib refuses a null output even when there is nothing to inflate
+  unsigned char empty;
+  z.next_out = length > 0 ? output : &empty;
+  z.avail_out = static_cast< uInt >( length );
+
+  const int result = inflate(&z, Z_SYNC_FLUSH);
+  inflateEnd(&z);
+
+  return z.avail_out == 0
+         && ( last ? result == Z_STREAM_END : ( result == Z_OK || result == Z_BUF_ERROR ) );
+}
+}
+
+GzipBlockCompressor::GzipBlockCompressor()
+{
+  m_BlockSize = 1 << 20;
+  m_CompressionLevel = Z_DEFAULT_COMPRESSION;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_Input = 0;
+  m_Output = 0;
+  m_Ranges = 0;
+}
+
+void
+GzipBlockCompressor
+::Compress(const void *data, SizeValueType numberOfBytes, std::vector< char > & member)
+{
+  // the block index is limited by the size of the extra field, the
+  // blocks are enlarged by a whole factor to keep their alignment
+  SizeValueType blockSize = m_BlockSize;
+  if ( numberOfBytes / blockSize >= MaximumNumberOfBlocks )
+    {
+    blockSize *= numberOfBytes / blockSize / MaximumNumberOfBlocks + 1;
+    }
+  if ( blockSize > MaximumChunkSize )
+    {
+    itkExceptionMacro(<< "Can not compress " << numberOfBytes << " bytes in less than "
+                      << MaximumNumberOfBlocks << " blocks");
+    }
+  SizeValueType numberOfBlocks = ( numberOfBytes + blockSize - 1 ) / blockSize;
+  if ( numberOfBlocks == 0 )
+    {
+    numberOfBlocks = 1;
+    }
+
+  m_Input = static_cast< const unsigned char * >( data );
+  m_Index.NumberOfBytes = numberOfBytes;
+  m_Index.BlockSize = blockSize;
+  m_Blocks.assign( numberOfBlocks, std::vector< unsigned char >() );
+  m_BlockCRCs.assign(numberOfBlocks, 0);
+  m_BlockSucceeded.assign(numberOfBlocks, 0);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min( static_cast< SizeValueType >( m_NumberOfThreads ), numberOfBlocks ) ) );
+  threader->SetSingleMethod(Self::CompressThreaderCallback, this);
+  threader->SingleMethodExecute();
+  m_Input = 0;
+
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    if ( !m_BlockSucceeded[b] )
+      {
+      m_Blocks.clear();
+      itkExceptionMacro(<< "Compression of block " << b << " failed");
+      }
+    }
+
+  const unsigned int indexSize = IndexFixedSize + 8 * static_cast< unsigned int >( numberOfBlocks );
+  SizeValueType      memberSize = GzipHeaderSize + 2 + IndexSubfieldHeaderSize + indexSize + GzipTrailerSize;
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    memberSize += m_Blocks[b].size();
+    }
+
+  member.clear();
+  member.reserve(memberSize);
+
+  const unsigned char header[GzipHeaderSize] = { 0x1F, 0x8B, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 0xFF };
+  member.insert(member.end(), header, header + GzipHeaderSize);
+  AppendLittleEndian(member, IndexSubfieldHeaderSize + indexSize, 2);
+  member.push_back('I');
+  member.push_back('T');
+  AppendLittleEndian(member, indexSize, 2);
+  AppendLittleEndian(member, numberOfBytes, 8);
+  AppendLittleEndian(member, blockSize, 8);
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    AppendLittleEndian(member, m_Blocks[b].size(), 8);
+    }
+
+  // the checksum of the whole data is combined from the checksums of
+  // the blocks
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    if ( !m_Blocks[b].empty() )
+      {
+      member.insert( member.end(), m_Blocks[b].begin(), m_Blocks[b].end() );
+      }
+    std::vector< unsigned char >().swap(m_Blocks[b]);
+
+    const SizeValueType length = std::min( blockSize, numberOfBytes - b * blockSize );
+    crc = crc32_combine( crc, m_BlockCRCs[b], static_cast< z_off_t >( length ) );
+    }
+  m_Blocks.clear();
+
+  AppendLittleEndian(member, crc, 4);
+  AppendLittleEndian(member, numberOfBytes & 0xFFFFFFFF, 4);
+}
+
+ITK_THREAD_RETURN_TYPE
+GzipBlockCompressor
+::CompressThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfBlocks = self->m_Blocks.size();
+  for ( SizeValueType b = info->ThreadID; b < numberOfBlocks; b += info->NumberOfThreads )
+    {
+    self->m_BlockSucceeded[b] = self->CompressBlock(b);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+GzipBlockCompressor
+::CompressBlock(SizeValueType block)
+{
+  const SizeValueType  start = block * m_Index.BlockSize;
+  const SizeValueType  length = std::min(m_Index.BlockSize, m_Index.NumberOfBytes - start);
+  const unsigned char *input = m_Input + start;
+  const bool           last = ( block + 1 == m_Blocks.size() );
+
+  m_BlockCRCs[block] = crc32( crc32(0L, Z_NULL, 0), input, static_cast< uInt >( length ) );
+
+  // raw deflate, the gzip header and trailer are written by Compress()
+  z_stream z;
+  z.zalloc = Z_NULL;
+  z.zfree = Z_NULL;
+  z.opaque = Z_NULL;
+  if ( deflateInit2(&z, m_CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+    return false;
+    }
+
+  std::vector< unsigned char > & output = m_Blocks[block];
+  output.resize( deflateBound( &z, static_cast< uLong >( length ) ) + 16 );
+
+  z.next_in = const_cast< Bytef * >( input );
+  z.avail_in = static_cast< uInt >( length );
+
+  // a sync flush ends the block on a byte boundary without marking the
+  // end of the stream
+  const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+  bool      succeeded = false;
+  for (;; )
+    {
+    z.next_out = &output[0] + z.total_out;
+    z.avail_out = static_cast< uInt >( output.size() - z.total_out );
+    const int result = deflate(&z, flush);
+    if ( result == Z_STREAM_END || ( !last && result == Z_OK && z.avail_out > 0 ) )
+      {
+      succeeded = true;
+      break;
+      }
+    if ( result != Z_OK && result != Z_BUF_ERROR )
+      {
+      break;
+      }
+    output.resize(2 * output.size());
+    }
+
+  output.resize(z.total_out);
+  deflateEnd(&z);
+  return succeeded;
+}
+
+void
+GzipBlockCompressor
+::Decompress(const void *member, SizeValueType memberSize, void *data, SizeValueType numberOfBytes)
+{
+  const unsigned char *input = static_cast< const unsigned char * >( member );
+  unsigned char *      output = static_cast< unsigned char * >( data );
+
+  BlockIndex index;
+  if ( !Self::ReadBlockIndex(input, memberSize, index) )
+    {
+    // inflate sequentially any gzip or zlib stream
+    z_stream z;
+    z.zalloc = Z_NULL;
+    z.zfree = Z_NULL;
+    z.opaque = Z_NULL;
+    z.next_in = Z_NULL;
+    z.avail_in = 0;
+    z.next_out = Z_NULL;
+    z.avail_out = 0;
+    if ( inflateInit2(&z, 15 + 32) != Z_OK )
+      {
+      itkExceptionMacro(<< "Could not initialize the decompression");
+      }
+
+    SizeValueType consumed = 0;
+    SizeValueType produced = 0;
+    int           result = Z_OK;
+    while ( result == Z_OK )
+      {
+      if ( z.avail_in == 0 && consumed < memberSize )
+        {
+        z.next_in = const_cast< Bytef * >( input + consumed );
+        z.avail_in = static_cast< uInt >( std::min(memberSize - consumed, MaximumChunkSize) );
+        consumed += z.avail_in;
+        }
+      if ( z.avail_out == 0 && produced < numberOfBytes )
+        {
+        z.next_out = output + produced;
+        z.avail_out = static_cast< uInt >( std::min(numberOfBytes - produced, MaximumChunkSize) );
+        produced += z.avail_out;
+        }
+      result = inflate(&z, Z_NO_FLUSH);
+      }
+    inflateEnd(&z);
+
+    if ( result != Z_STREAM_END || produced - z.avail_out != numberOfBytes )
+      {
+      itkExceptionMacro(<< "The compressed data is corrupted or does not hold "
+                        << numberOfBytes << " bytes");
+      }
+    return;
+    }
+
+  if ( index.NumberOfBytes != numberOfBytes )
+    {
+    itkExceptionMacro(<< "The compressed data holds " << index.NumberOfBytes
+                      << " bytes instead of " << numberOfBytes);
+    }
+
+  const SizeValueType numberOfBlocks = index.CompressedBlockSizes.size();
+  m_BlockOffsets.resize(numberOfBlocks);
+  SizeValueType offset = index.HeaderSize;
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    m_BlockOffsets[b] = offset;
+    offset += index.CompressedBlockSizes[b];
+    }
+  if ( offset + GzipTrailerSize > memberSize )
+    {
+    itkExceptionMacro(<< "The compressed data is truncated");
+    }
+
+  m_Input = input;
+  m_Output = output;
+  m_Index = index;
+  m_BlockCRCs.assign(numberOfBlocks, 0);
+  m_BlockSucceeded.assign(numberOfBlocks, 0);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min( static_cast< SizeValueType >( m_NumberOfThreads ), numberOfBlocks ) ) );
+  threader->SetSingleMethod(Self::DecompressThreaderCallback, this);
+  threader->SingleMethodExecute();
+  m_Input = 0;
+  m_Output = 0;
+
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+    {
+    if ( !m_BlockSucceeded[b] )
+      {
+      itkExceptionMacro(<< "Decompression of block " << b << " failed");
+      }
+    const SizeValueType length = std::min( index.BlockSize, numberOfBytes - b * index.BlockSize );
+    crc = crc32_combine( crc, m_BlockCRCs[b], static_cast< z_off_t >( length ) );
+    }
+
+  if ( crc != ReadLittleEndian(input + offset, 4)
+       || ( numberOfBytes & 0xFFFFFFFF ) != ReadLittleEndian(input + offset + 4, 4) )
+    {
+    itkExceptionMacro(<< "The checksum of the decompressed data does not match");
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+GzipBlockCompressor
+::DecompressThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfBlocks = self->m_BlockOffsets.size();
+  for ( SizeValueType b = info->ThreadID; b < numberOfBlocks; b += info->NumberOfThreads )
+    {
+    self->m_BlockSucceeded[b] = self->DecompressBlock(b);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+GzipBlockCompressor
+::DecompressBlock(SizeValueType block)
+{
+  const SizeValueType start = block * m_Index.BlockSize;
+  const SizeValueType length = std::min(m_Index.BlockSize, m_Index.NumberOfBytes - start);
+  unsigned char *     output = m_Output + start;
+  const bool          last = ( block + 1 == m_BlockOffsets.size() );
+
+  const bool succeeded = InflateBlock(m_Input + m_BlockOffsets[block],
+                                      m_Index.CompressedBlockSizes[block],
+                                      output, length, last);
+  if ( succeeded )
+    {
+    m_BlockCRCs[block] = crc32( crc32(0L, Z_NULL, 0), output, static_cast< uInt >( length ) );
+    }
+  return succeeded;
+}
+
+void
+GzipBlockCompressor
+::DecompressRanges(std::istream & stream, const RangeContainerType & ranges, void *data)
+{
+  const std::streampos memberPosition = stream.tellg();
+
+  BlockIndex index;
+  if ( !Self::ReadBlockIndex(stream, index) )
+    {
+    itkExceptionMacro(<< "The compressed data has no block index");
+    }
+
+  // the blocks holding bytes of the ranges, and where the ranges are
+  // stored in data
+  m_BlockNumbers.clear();
+  m_RangeOutputOffsets.resize( ranges.size() );
+  SizeValueType outputOffset = 0;
+  SizeValueType rangesEnd = 0;
+  for ( SizeValueType r = 0; r < ranges.size(); ++r )
+    {
+    const SizeValueType offset = ranges[r].first;
+    const SizeValueType length = ranges[r].second;
+    if ( offset < rangesEnd || length > index.NumberOfBytes || offset > index.NumberOfBytes - length )
+      {
+      itkExceptionMacro(<< "The range of " << length << " bytes at " << offset
+                        << " is not sorted or not in the " << index.NumberOfBytes
+                        << " bytes of the compressed data");
+      }
+    m_RangeOutputOffsets[r] = outputOffset;
+    outputOffset += length;
+    if ( length == 0 )
+      {
+      continue;
+      }
+    rangesEnd = offset + length;
+
+    const SizeValueType lastBlock = ( rangesEnd - 1 ) / index.BlockSize;
+    for ( SizeValueType b = offset / index.BlockSize; b <= lastBlock; ++b )
+      {
+      if ( m_BlockNumbers.empty() || m_BlockNumbers.back() < b )
+        {
+        m_BlockNumbers.push_back(b);
+        }
+      }
+    }
+  if ( m_BlockNumbers.empty() )
+    {
+    return;
+    }
+
+  // read the compressed blocks, consecutive blocks at once
+  std::vector< SizeValueType > compressedOffsets( index.CompressedBlockSizes.size() );
+  SizeValueType                offset = index.HeaderSize;
+  for ( SizeValueType b = 0; b < compressedOffsets.size(); ++b )
+    {
+    compressedOffsets[b] = offset;
+    offset += index.CompressedBlockSizes[b];
+    }
+
+  const SizeValueType numberOfBlocks = m_BlockNumbers.size();
+  m_BlockOffsets.resize(numberOfBlocks);
+  SizeValueType compressedSize = 0;
+  for ( SizeValueType i = 0; i < numberOfBlocks; ++i )
+    {
+    m_BlockOffsets[i] = compressedSize;
+    compressedSize += index.CompressedBlockSizes[m_BlockNumbers[i]];
+    }
+
+  std::vector< unsigned char > compressedData(compressedSize + 1);
+  for ( SizeValueType i = 0; i < numberOfBlocks; )
+    {
+    SizeValueType next = i + 1;
+    while ( next < numberOfBlocks && m_BlockNumbers[next] == m_BlockNumbers[next - 1] + 1 )
+      {
+      ++next;
+      }
+    const SizeValueType runSize = ( next < numberOfBlocks ? m_BlockOffsets[next] : compressedSize )
+                                  - m_BlockOffsets[i];
+    stream.seekg( memberPosition
+                  + static_cast< std::streamoff >( compressedOffsets[m_BlockNumbers[i]] ) );
+    if ( !stream.read( reinterpret_cast< char * >( &compressedData[m_BlockOffsets[i]] ),
+                       static_cast< std::streamsize >( runSize ) ) )
+      {
+      itkExceptionMacro(<< "The compressed data is truncated");
+      }
+    i = next;
+    }
+
+  m_Input = &compressedData[0];
+  m_Output = static_cast< unsigned char * >( data );
+  m_Index = index;
+  m_Ranges = &ranges;
+  m_BlockSucceeded.assign(numberOfBlocks, 0);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min( static_cast< SizeValueType >( m_NumberOfThreads ), numberOfBlocks ) ) );
+  threader->SetSingleMethod(Self::DecompressRangesThreaderCallback, this);
+  threader->SingleMethodExecute();
+  m_Input = 0;
+  m_Output = 0;
+  m_Ranges = 0;
+
+  for ( SizeValueType i = 0; i < numberOfBlocks; ++i )
+    {
+    if ( !m_BlockSucceeded[i] )
+      {
+      itkExceptionMacro(<< "Decompression of block " << m_BlockNumbers[i] << " failed");
+      }
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+GzipBlockCompressor
+::DecompressRangesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfBlocks = self->m_BlockNumbers.size();
+  for ( SizeValueType i = info->ThreadID; i < numberOfBlocks; i += info->NumberOfThreads )
+    {
+    self->m_BlockSucceeded[i] = self->DecompressRangesBlock(i);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+GzipBlockCompressor
+::DecompressRangesBlock(SizeValueType i)
+{
+  const SizeValueType        block = m_BlockNumbers[i];
+  const SizeValueType        start = block * m_Index.BlockSize;
+  const SizeValueType        length = std::min(m_Index.BlockSize, m_Index.NumberOfBytes - start);
+  const SizeValueType        end = start + length;
+  const bool                 last = ( block + 1 == m_Index.CompressedBlockSizes.size() );
+  const RangeContainerType & ranges = *m_Ranges;
+
+  // the first range which ends in the block or after it
+  SizeValueType first = 0;
+  SizeValueType count = ranges.size();
+  while ( count > 0 )
+    {
+    const SizeValueType step = count / 2;
+    if ( ranges[first + step].first + ranges[first + step].second <= start )
+      {
+      first += step + 1;
+      count -= step + 1;
+      }
+    else
+      {
+      count = step;
+      }
+    }
+
+  // a block inside a single range is inflated in place
+  if ( first < ranges.size() && ranges[first].first <= start
+       && ranges[first].first + ranges[first].second >= end )
+    {
+    return InflateBlock(m_Input + m_BlockOffsets[i], m_Index.CompressedBlockSizes[block],
+                        m_Output + m_RangeOutputOffsets[first] + ( start - ranges[first].first ),
+                        length, last);
+    }
+
+  std::vector< unsigned char > blockData( length + 1 );
+  if ( !InflateBlock(m_Input + m_BlockOffsets[i], m_Index.CompressedBlockSizes[block],
+                     &blockData[0], length, last) )
+    {
+    return false;
+    }
+  for ( SizeValueType r = first; r < ranges.size() && ranges[r].first < end; ++r )
+    {
+    const SizeValueType copyStart = std::max(ranges[r].first, start);
+    const SizeValueType copyEnd = std::min(ranges[r].first + ranges[r].second, end);
+    if ( copyStart < copyEnd )
+      {
+      std::copy( blockData.begin() + ( copyStart - start ),
+                 blockData.begin() + ( copyEnd - start ),
+                 m_Output + m_RangeOutputOffsets[r] + ( copyStart - ranges[r].first ) );
+      }
+    }
+  return true;
+}
+
+bool
+GzipBlockCompressor
+::GetIndexedMemberSize(const void *buffer, SizeValueType bufferSize,
+                       SizeValueType & memberSize, SizeValueType & numberOfBytes)
+{
+  BlockIndex index;
+  if ( !Self::ReadBlockIndex(static_cast< const unsigned char * >( buffer ), bufferSize, index) )
+    {
+    return false;
+    }
+
+  memberSize = index.HeaderSize + GzipTrailerSize;
+  for ( SizeValueType b = 0; b < index.CompressedBlockSizes.size(); ++b )
+    {
+    memberSize += index.CompressedBlockSizes[b];
+    }
+  numberOfBytes = index.NumberOfBytes;
+  return true;
+}
+
+bool
+GzipBlockCompressor
+::HasBlockIndex(std::istream & stream)
+{
+  const std::streampos position = stream.tellg();
+  BlockIndex           index;
+  const bool           found = Self::ReadBlockIndex(stream, index);
+
+  stream.clear();
+  stream.seekg(position);
+  return found;
+}
+
+bool
+GzipBlockCompressor
+::ReadBlockIndex(std::istream & stream, BlockIndex & index)
+{
+  std::vector< unsigned char > header(GzipHeaderSize + 2);
+  if ( !stream.read( reinterpret_cast< char * >( &header[0] ), header.size() )
+       || header[0] != 0x1F || header[1] != 0x8B || !( header[3] & ExtraFlag ) )
+    {
+    return false;
+    }
+
+  const SizeValueType extraSize = ReadLittleEndian(&header[GzipHeaderSize], 2);
+  header.resize(GzipHeaderSize + 2 + extraSize);
+  if ( extraSize > 0
+       && !stream.read( reinterpret_cast< char * >( &header[GzipHeaderSize + 2] ), extraSize ) )
+    {
+    return false;
+    }
+
+  // the name and the comment end with a null byte
+  const unsigned char stringFlags[] = { NameFlag, CommentFlag };
+  for ( unsigned int f = 0; f < 2; ++f )
+    {
+    if ( header[3] & stringFlags[f] )
+      {
+      char c;
+      do
+        {
+        if ( !stream.get(c) )
+          {
+          return false;
+          }
+        header.push_back( static_cast< unsigned char >( c ) );
+        }
+      while ( c != 0 );
+      }
+    }
+  if ( header[3] & HeaderCRCFlag )
+    {
+    char crc[2];
+    if ( !stream.read(crc, 2) )
+      {
+      return false;
+      }
+    header.insert(header.end(), crc, crc + 2);
+    }
+
+  return Self::ReadBlockIndex(&header[0], header.size(), index);
+}
+
+bool
+GzipBlockCompressor
+::ReadBlockIndex(const unsigned char *buffer, SizeValueType bufferSize, BlockIndex & index)
+{
+  if ( bufferSize < GzipHeaderSize + 2
+       || buffer[0] != 0x1F || buffer[1] != 0x8B || buffer[2] != Z_DEFLATED
+       || !( buffer[3] & ExtraFlag ) )
+    {
+    return false;
+    }
+
+  const SizeValueType extraSize = ReadLittleEndian(buffer + GzipHeaderSize, 2);
+  const SizeValueType extraEnd = GzipHeaderSize + 2 + extraSize;
+  if ( extraEnd > bufferSize )
+    {
+    return false;
+    }
+
+  bool          found = false;
+  SizeValueType position = GzipHeaderSize + 2;
+  while ( !found && position + IndexSubfieldHeaderSize <= extraEnd )
+    {
+    const SizeValueType subfieldSize = ReadLittleEndian(buffer + position + 2, 2);
+    const SizeValueType subfieldData = position + IndexSubfieldHeaderSize;
+    if ( subfieldData + subfieldSize > extraEnd )
+      {
+      return false;
+      }
+    if ( buffer[position] == 'I' && buffer[position + 1] == 'T'
+         && subfieldSize >= IndexFixedSize && ( subfieldSize - IndexFixedSize ) % 8 == 0 )
+      {
+      index.NumberOfBytes = ReadLittleEndian(buffer + subfieldData, 8);
+      index.BlockSize = ReadLittleEndian(buffer + subfieldData + 8, 8);
+      const SizeValueType numberOfBlocks = ( subfieldSize - IndexFixedSize ) / 8;
+      index.CompressedBlockSizes.resize(numberOfBlocks);
+      for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+        {
+        index.CompressedBlockSizes[b] = ReadLittleEndian(buffer + subfieldData + IndexFixedSize + 8 * b, 8);
+        }
+      found = true;
+      }
+    position = subfieldData + subfieldSize;
+    }
+
+  if ( !found || index.BlockSize == 0 || index.BlockSize > MaximumChunkSize
+       || index.CompressedBlockSizes.empty()
+       || index.CompressedBlockSizes.size() !=
+       std::max( ( index.NumberOfBytes + index.BlockSize - 1 ) / index.BlockSize,
+                 static_cast< SizeValueType >( 1 ) ) )
+    {
+    return false;
+    }
+
+  // skip the optional fields which follow the extra field
+  position = extraEnd;
+  if ( buffer[3] & NameFlag )
+    {
+    while ( position < bufferSize && buffer[position] != 0 )
+      {
+      ++position;
+      }
+    ++position;
+    }
+  if ( buffer[3] & CommentFlag )
+    {
+    while ( position < bufferSize && buffer[position] != 0 )
+      {
+      ++position;
+      }
+    ++position;
+    }
+  if ( buffer[3] & HeaderCRCFlag )
+    {
+    position += 2;
+    }
+  if ( position > bufferSize )
+    {
+    return false;
+    }
+  index.HeaderSize = position;
+  return true;
+}
+
+void
+GzipBlockCompressor
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+}
+} // end namespace itk
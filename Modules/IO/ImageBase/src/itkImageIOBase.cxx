@@ -42,8 +42,13 @@ void ImageIOBase::Reset(const bool)
     }
   m_NumberOfDimensions = 0;
   m_UseCompression = false;
+  m_NumberOfCompressionThreads = 1;
+  m_CompressionLevel = -1;
   m_UseStreamedReading = false;
   m_UseStreamedWriting = false;
+  m_UseMemoryMapping = false;
+  m_UseDirectIO = false;
+  m_NumberOfWritingThreads = 1;
 }
 
 ImageIOBase::~ImageIOBase()
@@ -323,6 +328,57 @@ ImageIOBase
   return true;
 }
 
+MemoryMappedFileRegion::Pointer
+ImageIOBase
+::MapIORegionFromFile(const std::string & fileName, ImageIOBase::SizeType dataPosition)
+{
+  if ( !m_UseMemoryMapping || m_IORegion.GetNumberOfPixels() == 0 )
+    {
+    return 0;
+    }
+
+  // The IORegion is contiguous in the file when it covers whole rows,
+  // slices... up to one dimension, and a single index in the higher
+  // dimensions. The dimensions of the file beyond the ones of the
+  // IORegion are read at index 0.
+  const unsigned int regionDimension = m_IORegion.GetImageDimension();
+  const SizeType     pixelSize = this->GetPixelSize();
+  SizeType           offset = 0;
+  SizeType           stride = pixelSize;
+  bool               partial = false;
+  for ( unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i )
+    {
+    const SizeType index = i < regionDimension ? m_IORegion.GetIndex(i) : 0;
+    const SizeType size = i < regionDimension ? m_IORegion.GetSize(i) : 1;
+    if ( partial && size != 1 )
+      {
+      return 0;
+      }
+    if ( size != static_cast< SizeType >( this->GetDimensions(i) ) )
+      {
+      partial = true;
+      }
+    offset += index * stride;
+    stride *= this->GetDimensions(i);
+    }
+
+  // a file which can not be opened or is too short is left to Read(),
+  // which reports the error
+  MemoryMappedFileRegion::Pointer mapping = MemoryMappedFileRegion::New();
+  try
+    {
+    mapping->Map( fileName,
+                  static_cast< SizeValueType >( dataPosition + offset ),
+                  static_cast< SizeValueType >( m_IORegion.GetNumberOfPixels() * pixelSize ) );
+    }
+  catch ( ExceptionObject & err )
+    {
+    itkDebugMacro(<< "Could not map " << fileName << ": " << err.GetDescription());
+    return 0;
+    }
+  return mapping;
+}
+
 unsigned int ImageIOBase::GetPixelSize() const
 {
   if ( m_ComponentType == UNKNOWNCOMPONENTTYPE
@@ -990,6 +1046,14 @@ void ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
     {
     os << indent << "UseCompression: Off" << std::endl;
     }
+  os << indent << "NumberOfCompressionThreads: " << m_NumberOfCompressionThreads << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "ChunkSize: ( ";
+  for ( unsigned int i = 0; i < m_ChunkSize.size(); i++ )
+    {
+    os << m_ChunkSize[i] << " ";
+    }
+  os << ")" << std::endl;
   if ( m_UseStreamedReading )
     {
     os << indent << "UseStreamedReading: On" << std::endl;
@@ -1006,6 +1070,23 @@ void ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
     {
     os << indent << "UseStreamedWriting: Off" << std::endl;
     }
+  if ( m_UseMemoryMapping )
+    {
+    os << indent << "UseMemoryMapping: On" << std::endl;
+    }
+  else
+    {
+    os << indent << "UseMemoryMapping: Off" << std::endl;
+    }
+  if ( m_UseDirectIO )
+    {
+    os << indent << "UseDirectIO: On" << std::endl;
+    }
+  else
+    {
+    os << indent << "UseDirectIO: Off" << std::endl;
+    }
+  os << indent << "NumberOfWritingThreads: " << m_NumberOfWritingThreads << std::endl;
 }
 
 } //namespace itk
@@ -15,48 +15,199 @@
  *  limitations under the License.
  *
  *=========================================================================*/
-
 #include "itkImageIOFactory.h"
-
+#include "itkCommand.h"
+#include "itkMutexLockHolder.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itksys/SystemTools.hxx"
 
 namespace itk
 {
+namespace
+{
+typedef std::vector< ImageIOBase::Pointer > ImageIOPrototypeContainer;
+
+void ImageIOFactoryDeleted(const Object *factory, const EventObject &, void *);
+
+/** The ImageIO prototypes of the registered factories, and what they
+ * were built from: the factories and the enable flags of their
+ * overrides. The cache observes the DeleteEvent of the factories, so
+ * that it never refers to a deleted factory. */
+struct ImageIOPrototypeCache {
+  std::list< ObjectFactoryBase * > Factories;
+  std::list< unsigned long >       ObserverTags;
+  std::list< std::list< bool > >   EnableFlags;
+  ImageIOPrototypeContainer        Prototypes;
+
+  // Forget the factories and release the prototypes. The observer of
+  // deletedFactory, which is being deleted, goes away with it.
+  void Clear(const Object *deletedFactory)
+  {
+    std::list< unsigned long >::const_iterator tag = ObserverTags.begin();
+    for ( std::list< ObjectFactoryBase * >::const_iterator f = Factories.begin();
+          f != Factories.end(); ++f, ++tag )
+      {
+      if ( *f != deletedFactory )
+        {
+        ( *f )->RemoveObserver(*tag);
+        }
+      }
+    Factories.clear();
+    ObserverTags.clear();
+    EnableFlags.clear();
+    Prototypes.clear();
+  }
+
+  void Observe(const std::list< ObjectFactoryBase * > & factories)
+  {
+    CStyleCommand::Pointer deleted = CStyleCommand::New();
+    // Object::UnRegister() is const, and so is the DeleteEvent it invokes
+    deleted->SetConstCallback(&ImageIOFactoryDeleted);
+    for ( std::list< ObjectFactoryBase * >::const_iterator f = factories.begin();
+          f != factories.end(); ++f )
+      {
+      ObserverTags.push_back( ( *f )->AddObserver(DeleteEvent(), deleted) );
+      Factories.push_back(*f);
+      }
+  }
+
+  ~ImageIOPrototypeCache()
+  {
+    this->Clear(0);
+  }
+};
+
+ImageIOPrototypeCache & GetImageIOPrototypeCache()
+{
+  static ImageIOPrototypeCache cache;
+  return cache;
+}
+
+SimpleFastMutexLock ImageIOPrototypeCacheLock;
+
+// A cached factory is deleted, typically by
+// ObjectFactoryBase::UnRegisterAllFactories(), which then closes the
+// library of the dynamically loaded ones: the prototypes they created must
+// be released before their code goes away, and a new factory may later be
+// allocated at the same address.
+void ImageIOFactoryDeleted(const Object *factory, const EventObject &, void *)
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(ImageIOPrototypeCacheLock);
+  GetImageIOPrototypeCache().Clear(factory);
+}
+
+// a copy of the prototypes, which are rebuilt when a factory was
+// registered, unregistered, enabled or disabled since the last call
+ImageIOPrototypeContainer GetImageIOPrototypes()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(ImageIOPrototypeCacheLock);
+
+  const std::list< ObjectFactoryBase * > factories = ObjectFactoryBase::GetRegisteredFactories();
+  std::list< std::list< bool > >         enableFlags;
+  for ( std::list< ObjectFactoryBase * >::const_iterator f = factories.begin();
+        f != factories.end(); ++f )
+    {
+    enableFlags.push_back( ( *f )->GetEnableFlags() );
+    }
+
+  ImageIOPrototypeCache & cache = GetImageIOPrototypeCache();
+  if ( cache.Factories != factories || cache.EnableFlags != enableFlags )
+    {
+    cache.Clear(0);
+    cache.Observe(factories);
+    cache.EnableFlags = enableFlags;
+    std::list< LightObject::Pointer > allobjects =
+      ObjectFactoryBase::CreateAllInstance("itkImageIOBase");
+    for ( std::list< LightObject::Pointer >::iterator i = allobjects.begin();
+          i != allobjects.end(); ++i )
+      {
+      ImageIOBase *io = dynamic_cast< ImageIOBase * >( i->GetPointer() );
+      if ( io )
+        {
+        cache.Prototypes.push_back(io);
+        }
+      else
+        {
+        std::cerr << "Error ImageIO factory did not return an ImageIOBase: "
+                  << ( *i )->GetNameOfClass()
+                  << std::endl;
+        }
+      }
+    }
+  return cache.Prototypes;
+}
+
+bool HasExtension(const std::string & lowerCasePath,
+                  const ImageIOBase::ArrayOfExtensionsType & extensions)
+{
+  for ( ImageIOBase::ArrayOfExtensionsType::const_iterator e = extensions.begin();
+        e != extensions.end(); ++e )
+    {
+    const std::string extension = itksys::SystemTools::LowerCase(*e);
+    if ( !extension.empty() && lowerCasePath.size() > extension.size()
+         && lowerCasePath.compare(lowerCasePath.size() - extension.size(),
+                                  extension.size(), extension) == 0 )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+}
+
 ImageIOBase::Pointer
 ImageIOFactory::CreateImageIO(const char *path, FileModeType mode)
 {
-  std::list< ImageIOBase::Pointer > possibleImageIO;
-  std::list< LightObject::Pointer > allobjects =
-    ObjectFactoryBase::CreateAllInstance("itkImageIOBase");
-  for ( std::list< LightObject::Pointer >::iterator i = allobjects.begin();
-        i != allobjects.end(); ++i )
+  if ( path == 0 )
     {
-    ImageIOBase *io = dynamic_cast< ImageIOBase * >( i->GetPointer() );
-    if ( io )
+    return 0;
+    }
+  const ImageIOPrototypeContainer prototypes = GetImageIOPrototypes();
+
+  // the ImageIOs which support the extension of the file are tried
+  // first, then the others, in the order of the registration of
+  // their factories
+  const std::string         lowerCasePath = itksys::SystemTools::LowerCase(path);
+  ImageIOPrototypeContainer candidates;
+  ImageIOPrototypeContainer others;
+  for ( ImageIOPrototypeContainer::const_iterator k = prototypes.begin();
+        k != prototypes.end(); ++k )
+    {
+    const ImageIOBase::ArrayOfExtensionsType & extensions =
+      ( mode == ReadMode ? ( *k )->GetSupportedReadExtensions() : ( *k )->GetSupportedWriteExtensions() );
+    if ( HasExtension(lowerCasePath, extensions) )
       {
-      possibleImageIO.push_back(io);
+      candidates.push_back(*k);
       }
     else
       {
-      std::cerr << "Error ImageIO factory did not return an ImageIOBase: "
-                << ( *i )->GetNameOfClass()
-                << std::endl;
+      others.push_back(*k);
       }
     }
-  for ( std::list< ImageIOBase::Pointer >::iterator k = possibleImageIO.begin();
-        k != possibleImageIO.end(); ++k )
+  candidates.insert( candidates.end(), others.begin(), others.end() );
+
+  // a new ImageIO is tried each time, since CanReadFile and
+  // CanWriteFile may change its state
+  for ( ImageIOPrototypeContainer::const_iterator k = candidates.begin();
+        k != candidates.end(); ++k )
     {
+    ImageIOBase::Pointer io = dynamic_cast< ImageIOBase * >( ( *k )->CreateAnother().GetPointer() );
+    if ( io.IsNull() )
+      {
+      continue;
+      }
     if ( mode == ReadMode )
       {
-      if ( ( *k )->CanReadFile(path) )
+      if ( io->CanReadFile(path) )
         {
-        return *k;
+        return io;
         }
       }
     else if ( mode == WriteMode )
       {
-      if ( ( *k )->CanWriteFile(path) )
+      if ( io->CanWriteFile(path) )
         {
-        return *k;
+        return io;
         }
       }
     }
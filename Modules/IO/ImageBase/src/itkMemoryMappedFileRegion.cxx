@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFileRegion.h"
+
+#if defined( WIN32 ) || defined( _WIN32 )
+#include "itkWindows.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+MemoryMappedFileRegion::MemoryMappedFileRegion()
+{
+  m_Offset = 0;
+  m_NumberOfBytes = 0;
+  m_Pointer = 0;
+  m_MappedAddress = 0;
+  m_MappedLength = 0;
+}
+
+MemoryMappedFileRegion::~MemoryMappedFileRegion()
+{
+  this->Unmap();
+}
+
+void
+MemoryMappedFileRegion
+::Map(const std::string & fileName, SizeValueType offset, SizeValueType numberOfBytes)
+{
+  this->Unmap();
+
+  if ( numberOfBytes == 0 )
+    {
+    itkExceptionMacro(<< "Can not map 0 bytes of " << fileName);
+    }
+
+#if defined( WIN32 ) || defined( _WIN32 )
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType granularity = systemInfo.dwAllocationGranularity;
+  const SizeValueType mappedOffset = offset - offset % granularity;
+  const SizeValueType mappedLength = numberOfBytes + ( offset - mappedOffset );
+
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    itkExceptionMacro(<< "Could not open file for mapping: " << fileName);
+    }
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx(file, &fileSize)
+       || static_cast< SizeValueType >( fileSize.QuadPart ) < offset + numberOfBytes )
+    {
+    CloseHandle(file);
+    itkExceptionMacro(<< "File " << fileName << " is too short to map "
+                      << numberOfBytes << " bytes at offset " << offset);
+    }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if ( mapping == NULL )
+    {
+    itkExceptionMacro(<< "Could not create a file mapping for " << fileName);
+    }
+
+  // the view keeps a reference to the mapping object
+  void *address = MapViewOfFile( mapping, FILE_MAP_COPY,
+                                 static_cast< DWORD >( static_cast< unsigned __int64 >( mappedOffset ) >> 32 ),
+                                 static_cast< DWORD >( mappedOffset & 0xFFFFFFFF ),
+                                 static_cast< SIZE_T >( mappedLength ) );
+  CloseHandle(mapping);
+  if ( address == NULL )
+    {
+    itkExceptionMacro(<< "Could not map " << numberOfBytes << " bytes of " << fileName);
+    }
+#else
+  const SizeValueType pageSize = static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) );
+  const SizeValueType mappedOffset = offset - offset % pageSize;
+  const SizeValueType mappedLength = numberOfBytes + ( offset - mappedOffset );
+
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if ( file < 0 )
+    {
+    itkExceptionMacro(<< "Could not open file for mapping: " << fileName);
+    }
+
+  struct stat fileStatus;
+  if ( fstat(file, &fileStatus) != 0
+       || static_cast< SizeValueType >( fileStatus.st_size ) < offset + numberOfBytes )
+    {
+    close(file);
+    itkExceptionMacro(<< "File " << fileName << " is too short to map "
+                      << numberOfBytes << " bytes at offset " << offset);
+    }
+
+  // the mapping stays valid once the file is closed
+  void *address = mmap(0, static_cast< size_t >( mappedLength ), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, file, static_cast< off_t >( mappedOffset ) );
+  close(file);
+  if ( address == MAP_FAILED )
+    {
+    itkExceptionMacro(<< "Could not map " << numberOfBytes << " bytes of " << fileName);
+    }
+#endif
+
+  m_FileName = fileName;
+  m_Offset = offset;
+  m_NumberOfBytes = numberOfBytes;
+  m_MappedAddress = address;
+  m_MappedLength = mappedLength;
+  m_Pointer = static_cast< char * >( address ) + ( offset - mappedOffset );
+  this->Modified();
+}
+
+void
+MemoryMappedFileRegion
+::Unmap()
+{
+  if ( !m_MappedAddress )
+    {
+    return;
+    }
+
+#if defined( WIN32 ) || defined( _WIN32 )
+  UnmapViewOfFile(m_MappedAddress);
+#else
+  munmap( m_MappedAddress, static_cast< size_t >( m_MappedLength ) );
+#endif
+
+  m_Offset = 0;
+  m_NumberOfBytes = 0;
+  m_Pointer = 0;
+  m_MappedAddress = 0;
+  m_MappedLength = 0;
+  this->Modified();
+}
+
+void
+MemoryMappedFileRegion
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Offset: " << m_Offset << std::endl;
+  os << indent << "NumberOfBytes: " << m_NumberOfBytes << std::endl;
+  os << indent << "Pointer: " << m_Pointer << std::endl;
+}
+} // end namespace itk
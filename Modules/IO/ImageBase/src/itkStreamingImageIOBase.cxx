@@ -16,8 +16,10 @@
  *
  *=========================================================================*/
 #include "itkStreamingImageIOBase.h"
+#include "itkDirectFileWriter.h"
 
 #include "itksys/SystemTools.hxx"
+#include <algorithm>
 
 namespace itk
 {
@@ -56,6 +58,29 @@ bool StreamingImageIOBase
           && m_IORegion.GetSize(movingDirection - 1) == this->GetDimensions(movingDirection - 1) );
   sizeOfChunk *= this->GetPixelSize();
 
+  // With UseMemoryMapping the bytes spanned by the IORegion are mapped
+  // and the chunks are copied from the mapping, so that only the pages
+  // of the file holding the IORegion are read.
+  MemoryMappedFileRegion::Pointer mapping;
+  std::streamoff                  mappingPos = 0;
+  if ( m_UseMemoryMapping )
+    {
+    std::streamoff lastPixelPos = 0;
+    SizeValueType  subDimensionQuantity = 1;
+    for ( unsigned int i = 0; i < m_IORegion.GetImageDimension(); ++i )
+      {
+      const std::streamoff stride = static_cast< std::streamoff >( subDimensionQuantity * this->GetPixelSize() );
+      mappingPos += stride * m_IORegion.GetIndex(i);
+      lastPixelPos += stride * ( m_IORegion.GetIndex(i) + m_IORegion.GetSize(i) - 1 );
+      subDimensionQuantity *= this->GetDimensions(i);
+      }
+
+    mapping = MemoryMappedFileRegion::New();
+    mapping->Map( m_FileName,
+                  static_cast< SizeValueType >( static_cast< std::streamoff >( dataPos ) + mappingPos ),
+                  static_cast< SizeValueType >( lastPixelPos - mappingPos + this->GetPixelSize() ) );
+    }
+
   ImageIORegion::IndexType currentIndex = m_IORegion.GetIndex();
 
   while ( m_IORegion.IsInside(currentIndex) )
@@ -75,21 +100,30 @@ bool StreamingImageIOBase
       << "Reading " << sizeOfChunk << " of " << sizeOfRegion << " bytes for " << m_FileName << " at " << dataPos
       + seekPos << " position in file");
 
-    file.seekg(dataPos + seekPos, std::ios::beg);
-
-    if ( ! this->ReadBufferAsBinary(file, buffer, sizeOfChunk) )
+    if ( mapping )
       {
-      itkExceptionMacro( "Error reading in ReadBufferAsBinary!" );
+      const char *chunk = static_cast< const char * >( mapping->GetPointer() )
+                          + ( static_cast< std::streamoff >( seekPos ) - mappingPos );
+      std::copy(chunk, chunk + sizeOfChunk, buffer);
       }
+    else
+      {
+      file.seekg(dataPos + seekPos, std::ios::beg);
 
-    // increment the buffer pointer
-    buffer += sizeOfChunk;
+      if ( ! this->ReadBufferAsBinary(file, buffer, sizeOfChunk) )
+        {
+        itkExceptionMacro( "Error reading in ReadBufferAsBinary!" );
+        }
 
-    if ( file.fail() )
-      {
-      itkExceptionMacro(<< "Fail reading");
+      if ( file.fail() )
+        {
+        itkExceptionMacro(<< "Fail reading");
+        }
       }
 
+    // increment the buffer pointer
+    buffer += sizeOfChunk;
+
     if ( movingDirection == m_IORegion.GetImageDimension() )
       {
       break;
@@ -187,6 +221,11 @@ bool StreamingImageIOBase::StreamWriteBufferAsBinary(std::ostream & file, const
           && m_IORegion.GetSize(movingDirection - 1) == this->GetDimensions(movingDirection - 1) );
   sizeOfChunk *= this->GetPixelSize();
 
+  // With UseDirectIO or several writing threads, the chunks are
+  // gathered and written by a DirectFileWriter once they are all known.
+  const bool                           useDirectFileWriter = m_UseDirectIO || m_NumberOfWritingThreads > 1;
+  DirectFileWriter::ChunkContainerType chunks;
+
   ImageIORegion::IndexType currentIndex = m_IORegion.GetIndex();
   while ( m_IORegion.IsInside(currentIndex) )
     {
@@ -201,10 +240,21 @@ bool StreamingImageIOBase::StreamWriteBufferAsBinary(std::ostream & file, const
       subDimensionQuantity *= this->GetDimensions(i);
       }
 
-    file.seekp(dataPos + seekPos, std::ios::beg);
-    if ( !this->WriteBufferAsBinary(file, buffer, sizeOfChunk) )
+    if ( useDirectFileWriter )
       {
-      itkExceptionMacro( "Error reading in WriteBufferAsBinary!" );
+      DirectFileWriter::ChunkType chunk;
+      chunk.Offset = static_cast< SizeValueType >( static_cast< std::streamoff >( dataPos + seekPos ) );
+      chunk.Data = buffer;
+      chunk.NumberOfBytes = static_cast< SizeValueType >( sizeOfChunk );
+      chunks.push_back(chunk);
+      }
+    else
+      {
+      file.seekp(dataPos + seekPos, std::ios::beg);
+      if ( !this->WriteBufferAsBinary(file, buffer, sizeOfChunk) )
+        {
+        itkExceptionMacro( "Error reading in WriteBufferAsBinary!" );
+        }
       }
 
     // increment the buffer pointer
@@ -239,6 +289,22 @@ bool StreamingImageIOBase::StreamWriteBufferAsBinary(std::ostream & file, const
       }
     }
 
+  if ( useDirectFileWriter )
+    {
+    // what was written through the stream, like the header, must reach
+    // the file before the chunks
+    file.flush();
+    if ( file.fail() )
+      {
+      itkExceptionMacro(<< "Fail writing");
+      }
+
+    DirectFileWriter::Pointer writer = DirectFileWriter::New();
+    writer->SetUseDirectIO(m_UseDirectIO);
+    writer->SetNumberOfThreads(m_NumberOfWritingThreads);
+    writer->Write(m_FileName, chunks);
+    }
+
   return true;
 }
 
@@ -0,0 +1,231 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGzipBlockCompressor.h"
+#include "itk_zlib.h"
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+
+// inflate a gzip member with zlib, as any gzip reader would
+bool InflateSequentially(const std::vector< char > & member, std::vector< char > & data)
+{
+  z_stream z;
+  z.zalloc = Z_NULL;
+  z.zfree = Z_NULL;
+  z.opaque = Z_NULL;
+  z.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( &member[0] ) );
+  z.avail_in = static_cast< uInt >( member.size() );
+  if ( inflateInit2(&z, 15 + 16) != Z_OK )
+    {
+    return false;
+    }
+  std::vector< char > output( data.size() + 1 );
+  z.next_out = reinterpret_cast< Bytef * >( &output[0] );
+  z.avail_out = static_cast< uInt >( output.size() );
+  const int result = inflate(&z, Z_FINISH);
+  inflateEnd(&z);
+  return result == Z_STREAM_END && z.total_out == data.size()
+         && std::equal( data.begin(), data.end(), output.begin() );
+}
+
+}
+
+int itkGzipBlockCompressorTest(int, char* [])
+{
+  typedef itk::GzipBlockCompressor CompressorType;
+
+  // compressible data, which is not the same in every block
+  std::vector< char > data(1000003);
+  for ( size_t i = 0; i < data.size(); ++i )
+    {
+    data[i] = static_cast< char >( ( i * i / 1000 + i / 7 ) % 251 );
+    }
+
+  CompressorType::Pointer compressor = CompressorType::New();
+  compressor->SetBlockSize(65536);
+  compressor->SetNumberOfThreads(4);
+  compressor->SetCompressionLevel(6);
+  compressor->Print(std::cout);
+
+  std::vector< char > member;
+  compressor->Compress(&data[0], data.size(), member);
+  std::cout << data.size() << " bytes compressed to " << member.size() << std::endl;
+
+  // the member is a valid gzip stream
+  if ( !InflateSequentially(member, data) )
+    {
+    std::cerr << "ERROR: zlib could not inflate the compressed data" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::SizeValueType memberSize = 0;
+  itk::SizeValueType numberOfBytes = 0;
+  if ( !CompressorType::GetIndexedMemberSize(&member[0], member.size(), memberSize, numberOfBytes)
+       || memberSize != member.size() || numberOfBytes != data.size() )
+    {
+    std::cerr << "ERROR: the block index is missing or wrong" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the blocks are inflated in parallel, whatever the number of threads
+  const itk::ThreadIdType numberOfThreads[] = { 1, 3, 8 };
+  for ( unsigned int t = 0; t < 3; ++t )
+    {
+    std::vector< char > decompressed( data.size() );
+    compressor->SetNumberOfThreads(numberOfThreads[t]);
+    compressor->Decompress(&member[0], member.size(), &decompressed[0], decompressed.size());
+    if ( decompressed != data )
+      {
+      std::cerr << "ERROR: wrong data decompressed with " << numberOfThreads[t]
+                << " threads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // ranges of the data are inflated from the blocks which hold them
+  std::stringstream stream;
+  stream << "leading bytes";
+  const std::streampos memberPosition = stream.tellp();
+  stream.write( &member[0], member.size() );
+  stream.seekg(memberPosition);
+  if ( !CompressorType::HasBlockIndex(stream) || stream.tellg() != memberPosition )
+    {
+    std::cerr << "ERROR: the block index is not found in the stream" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  CompressorType::RangeContainerType ranges;
+  ranges.push_back( CompressorType::RangeType(0, 10) );
+  ranges.push_back( CompressorType::RangeType(65530, 12) );
+  ranges.push_back( CompressorType::RangeType(70000, 0) );
+  ranges.push_back( CompressorType::RangeType(131072, 3 * 65536) );
+  ranges.push_back( CompressorType::RangeType(500000, 17) );
+  ranges.push_back( CompressorType::RangeType(500017, 5) );
+  ranges.push_back( CompressorType::RangeType(data.size() - 3, 3) );
+  std::vector< char > expected;
+  for ( size_t r = 0; r < ranges.size(); ++r )
+    {
+    expected.insert( expected.end(), data.begin() + ranges[r].first,
+                     data.begin() + ranges[r].first + ranges[r].second );
+    }
+  std::vector< char > rangeData( expected.size() );
+  compressor->SetNumberOfThreads(4);
+  compressor->DecompressRanges(stream, ranges, &rangeData[0]);
+  if ( rangeData != expected )
+    {
+    std::cerr << "ERROR: wrong ranges decompressed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // members are found one after the other
+  std::vector< char > secondMember;
+  compressor->Compress(&data[0], 1000, secondMember);
+  std::vector< char > members(member);
+  members.insert( members.end(), secondMember.begin(), secondMember.end() );
+  if ( !CompressorType::GetIndexedMemberSize(&members[memberSize], members.size() - memberSize,
+                                             memberSize, numberOfBytes)
+       || memberSize != secondMember.size() || numberOfBytes != 1000 )
+    {
+    std::cerr << "ERROR: the second member is not found" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // empty data
+  std::vector< char > emptyMember;
+  compressor->Compress(0, 0, emptyMember);
+  compressor->Decompress(&emptyMember[0], emptyMember.size(), 0, 0);
+
+  // streams without block index are inflated sequentially
+  std::vector< char > zlibStream( compressBound( static_cast< uLong >( data.size() ) ) );
+  uLongf              zlibSize = static_cast< uLongf >( zlibStream.size() );
+  compress( reinterpret_cast< Bytef * >( &zlibStream[0] ), &zlibSize,
+            reinterpret_cast< const Bytef * >( &data[0] ), static_cast< uLong >( data.size() ) );
+  if ( CompressorType::GetIndexedMemberSize(&zlibStream[0], zlibSize, memberSize, numberOfBytes) )
+    {
+    std::cerr << "ERROR: a zlib stream has no block index" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector< char > decompressed( data.size() );
+  compressor->Decompress(&zlibStream[0], zlibSize, &decompressed[0], decompressed.size());
+  if ( decompressed != data )
+    {
+    std::cerr << "ERROR: wrong data decompressed from a zlib stream" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // errors are reported
+  bool caught = false;
+  try
+    {
+    compressor->Decompress(&member[0], member.size(), &decompressed[0], decompressed.size() - 1);
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "ERROR: a wrong size was not detected" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  caught = false;
+  std::vector< char > corrupted(member);
+  corrupted[corrupted.size() / 2] ^= 0x55;
+  try
+    {
+    compressor->Decompress(&corrupted[0], corrupted.size(), &decompressed[0], decompressed.size());
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "ERROR: corrupted data was not detected" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  caught = false;
+  ranges.clear();
+  ranges.push_back( CompressorType::RangeType(data.size() - 3, 4) );
+  try
+    {
+    stream.clear();
+    stream.seekg(memberPosition);
+    compressor->DecompressRanges(stream, ranges, &rangeData[0]);
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "ERROR: a range out of the data was not detected" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,318 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+// every pixel gets a value computed from its index
+template< class TImage >
+typename TImage::PixelType ExpectedValue(const typename TImage::IndexType & index)
+{
+  return static_cast< typename TImage::PixelType >( index[0] + 3 * index[1] + 7 * index[2] );
+}
+
+template< class TImage >
+bool CheckImage(const TImage *image, const typename TImage::RegionType & region)
+{
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << "ERROR: buffered region " << image->GetBufferedRegion()
+              << " instead of " << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, region );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue< TImage >( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// read region from fileName with memory mapping, and check whether the
+// output buffer points into the file
+template< class TImage >
+bool ReadRegion(const std::string & fileName,
+                const typename TImage::RegionType & region,
+                bool expectMapped)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+
+  itk::ImageIOBase::Pointer imageIO =
+    itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::ImageIOFactory::ReadMode );
+  if ( imageIO.IsNull() )
+    {
+    std::cerr << "ERROR: no ImageIO for " << fileName << std::endl;
+    return false;
+    }
+  imageIO->UseMemoryMappingOn();
+
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( imageIO );
+  reader->UseStreamingOn();
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion( region );
+  reader->GetOutput()->Update();
+
+  typename TImage::Pointer image = reader->GetOutput();
+  image->DisconnectPipeline();
+  reader = 0;
+
+  const bool mapped = image->GetPixelContainer()->GetBufferOwner() != 0;
+  std::cout << fileName << " " << region.GetIndex() << " " << region.GetSize()
+            << ( mapped ? " mapped" : " read" ) << std::endl;
+  if ( mapped != expectMapped )
+    {
+    std::cerr << "ERROR: the buffer of " << fileName << " is "
+              << ( mapped ? "" : "not " ) << "mapped." << std::endl;
+    return false;
+    }
+
+  // the mapping outlives the reader
+  if ( !CheckImage< TImage >( image, region ) )
+    {
+    return false;
+    }
+
+  // the mapping is copy on write
+  typename TImage::IndexType index = region.GetIndex();
+  image->SetPixel( index, image->GetPixel(index) + 1 );
+  image = 0;
+
+  typename ReaderType::Pointer checkReader = ReaderType::New();
+  checkReader->SetFileName( fileName );
+  checkReader->Update();
+  if ( checkReader->GetOutput()->GetPixel(index) != ExpectedValue< TImage >( index ) )
+    {
+    std::cerr << "ERROR: writing to the mapped buffer modified " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// keep the first half of fileName
+bool TruncateFile(const std::string & fileName)
+{
+  const unsigned long length = itksys::SystemTools::FileLength( fileName.c_str() );
+  std::vector< char > buffer( length / 2 );
+
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  in.read( &buffer[0], buffer.size() );
+  if ( !in )
+    {
+    std::cerr << "ERROR: could not read " << fileName << std::endl;
+    return false;
+    }
+  in.close();
+
+  std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+  out.write( &buffer[0], buffer.size() );
+  return !out.fail();
+}
+
+// a truncated file can not be mapped: MapIORegion() returns NULL, and the
+// reader falls back to Read(), which reports the short file
+template< class TImage >
+bool ReadTruncated(const std::string & fileName, const std::string & dataFileName)
+{
+  if ( !TruncateFile( dataFileName ) )
+    {
+    return false;
+    }
+
+  itk::ImageIOBase::Pointer imageIO =
+    itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::ImageIOFactory::ReadMode );
+  imageIO->UseMemoryMappingOn();
+  imageIO->SetFileName( fileName );
+  imageIO->ReadImageInformation();
+  itk::ImageIORegion ioRegion( TImage::ImageDimension );
+  for ( unsigned int i = 0; i < TImage::ImageDimension; ++i )
+    {
+    ioRegion.SetSize( i, imageIO->GetDimensions(i) );
+    }
+  imageIO->SetIORegion( ioRegion );
+  if ( imageIO->MapIORegion().IsNotNull() )
+    {
+    std::cerr << "ERROR: the truncated " << dataFileName << " was mapped." << std::endl;
+    return false;
+    }
+
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( imageIO );
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << fileName << " truncated: " << err.GetDescription() << std::endl;
+    return true;
+    }
+  if ( reader->GetOutput()->GetPixelContainer()->GetBufferOwner() != 0 )
+    {
+    std::cerr << "ERROR: the buffer of the truncated " << dataFileName << " is mapped." << std::endl;
+    return false;
+    }
+  return true;
+}
+
+template< class TImage >
+bool WriteImage(const std::string & fileName)
+{
+  typename TImage::SizeType size;
+  size[0] = 37;
+  size[1] = 21;
+  size[2] = 13;
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue< TImage >( it.GetIndex() ) );
+    }
+
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName( fileName );
+  writer->SetInput( image );
+  try
+    {
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkImageFileReaderMemoryMappingTest(int argc, char* argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  typedef itk::Image< unsigned char, 3 > ImageType;
+  typedef itk::Image< short, 3 >         ShortImageType;
+
+  ImageType::RegionType largestRegion;
+  largestRegion.SetSize(0, 37);
+  largestRegion.SetSize(1, 21);
+  largestRegion.SetSize(2, 13);
+
+  // a few whole slices are contiguous in the file
+  ImageType::RegionType slab = largestRegion;
+  slab.SetIndex(2, 4);
+  slab.SetSize(2, 3);
+
+  // part of each row is not
+  ImageType::RegionType block = slab;
+  block.SetIndex(0, 5);
+  block.SetSize(0, 20);
+  block.SetIndex(1, 2);
+  block.SetSize(1, 10);
+
+  const char *extensions[] = { ".vtk", ".mha", ".mhd" };
+  for ( unsigned int e = 0; e < 3; ++e )
+    {
+    const std::string fileName = directory + "/itkImageFileReaderMemoryMappingTest" + extensions[e];
+    if ( !WriteImage< ImageType >( fileName ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    try
+      {
+      if ( !ReadRegion< ImageType >( fileName, largestRegion, true )
+           || !ReadRegion< ImageType >( fileName, slab, true )
+           || !ReadRegion< ImageType >( fileName, block, false ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    catch ( itk::ExceptionObject & err )
+      {
+      std::cerr << err << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // truncated files
+  const std::string vtkFileName = directory + "/itkImageFileReaderMemoryMappingTest.vtk";
+  const std::string mhdFileName = directory + "/itkImageFileReaderMemoryMappingTest.mhd";
+  const std::string rawFileName = directory + "/itkImageFileReaderMemoryMappingTest.raw";
+  try
+    {
+    if ( !ReadTruncated< ImageType >( vtkFileName, vtkFileName )
+         || !ReadTruncated< ImageType >( mhdFileName, rawFileName ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the big endian data of VTK files needs to be swapped on little
+  // endian systems
+  const std::string fileName = directory + "/itkImageFileReaderMemoryMappingTestShort.vtk";
+  if ( !WriteImage< ShortImageType >( fileName ) )
+    {
+    return EXIT_FAILURE;
+    }
+  try
+    {
+    if ( !ReadRegion< ShortImageType >( fileName, largestRegion,
+                                        itk::ByteSwapper< short >::SystemIsBigEndian() ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
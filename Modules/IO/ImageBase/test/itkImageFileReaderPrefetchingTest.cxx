@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+#include "itkMetaImageIO.h"
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+short ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast< short >( index[0] + 40 * index[1] - 1200 * index[2] );
+}
+
+// a MetaImageIO counting the regions read by the instance set on the
+// reader, the prefetched ones are read by the instances it creates
+class CountingMetaImageIO:public itk::MetaImageIO
+{
+public:
+  typedef CountingMetaImageIO            Self;
+  typedef itk::MetaImageIO               Superclass;
+  typedef itk::SmartPointer< Self >      Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingMetaImageIO, MetaImageIO);
+
+  virtual void Read(void *buffer)
+  {
+    ++m_NumberOfReads;
+    Superclass::Read(buffer);
+  }
+
+  unsigned int m_NumberOfReads;
+
+protected:
+  CountingMetaImageIO():m_NumberOfReads(0) {}
+};
+
+template< class TOutputImage >
+bool ReadStreamed(const std::string & fileName, unsigned int numberOfDivisions, bool usePrefetching,
+                  unsigned int & numberOfReads)
+{
+  typedef itk::ImageFileReader< TOutputImage >                      ReaderType;
+  typedef itk::StreamingImageFilter< TOutputImage, TOutputImage >   StreamerType;
+
+  CountingMetaImageIO::Pointer io = CountingMetaImageIO::New();
+
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->SetUsePrefetching(usePrefetching);
+
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( reader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfDivisions);
+  try
+    {
+    streamer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+  numberOfReads = io->m_NumberOfReads;
+
+  itk::ImageRegionConstIteratorWithIndex< TOutputImage > it( streamer->GetOutput(),
+                                                             streamer->GetOutput()->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != static_cast< typename TOutputImage::PixelType >( ExpectedValue( it.GetIndex() ) ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << " with " << numberOfDivisions
+                << " divisions" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageFileReaderPrefetchingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string fileName = std::string(argv[1]) + "/itkImageFileReaderPrefetchingTest.mha";
+
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 30;
+  size[2] = 24;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue( it.GetIndex() ) );
+    }
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  try
+    {
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // with prefetching, the reader's ImageIO only reads the first piece,
+  // the next ones are read ahead
+  const unsigned int divisions[] = { 1, 4, 7, 24 };
+  for ( unsigned int d = 0; d < 4; ++d )
+    {
+    unsigned int numberOfReads = 0;
+    if ( !ReadStreamed< ImageType >(fileName, divisions[d], false, numberOfReads)
+         || numberOfReads < 1 )
+      {
+      std::cerr << "ERROR: reading without prefetching failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( !ReadStreamed< ImageType >(fileName, divisions[d], true, numberOfReads)
+         || numberOfReads != 1 )
+      {
+      std::cerr << "ERROR: reading " << divisions[d] << " pieces with prefetching failed, the ImageIO read "
+                << numberOfReads << " pieces" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // the pixels read ahead are converted too
+    typedef itk::Image< float, 3 > FloatImageType;
+    if ( !ReadStreamed< FloatImageType >(fileName, divisions[d], true, numberOfReads)
+         || numberOfReads != 1 )
+      {
+      std::cerr << "ERROR: reading " << divisions[d] << " pieces of float with prefetching failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
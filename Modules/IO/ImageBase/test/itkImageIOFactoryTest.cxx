@@ -0,0 +1,221 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageIOFactory.h"
+#include "itkCreateObjectFunction.h"
+#include "itkVersion.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+// an ImageIO which counts the files it is asked to read, and which can
+// read all of them, or only the files with its extension
+class ProbeCountingImageIO:public itk::ImageIOBase
+{
+public:
+  typedef ProbeCountingImageIO          Self;
+  typedef itk::ImageIOBase              Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ProbeCountingImageIO, ImageIOBase);
+
+  static unsigned int m_NumberOfProbes;
+  static int          m_NumberOfInstances;
+
+  virtual bool CanReadFile(const char *fileName)
+  {
+    ++m_NumberOfProbes;
+    return this->HasSupportedReadExtension(fileName);
+  }
+  virtual void ReadImageInformation() {}
+  virtual void Read(void *) {}
+  virtual bool CanWriteFile(const char *fileName)
+  {
+    return this->HasSupportedReadExtension(fileName);
+  }
+  virtual void WriteImageInformation() {}
+  virtual void Write(const void *) {}
+
+protected:
+  ProbeCountingImageIO()
+  {
+    this->AddSupportedReadExtension(".probe");
+    this->AddSupportedWriteExtension(".probe");
+    ++m_NumberOfInstances;
+  }
+  ~ProbeCountingImageIO()
+  {
+    --m_NumberOfInstances;
+  }
+
+  bool HasSupportedReadExtension(const char *fileName) const
+  {
+    const std::string name = fileName;
+    return name.size() > 6 && itksys::SystemTools::LowerCase( name.substr(name.size() - 6) ) == ".probe";
+  }
+};
+
+unsigned int ProbeCountingImageIO::m_NumberOfProbes = 0;
+int          ProbeCountingImageIO::m_NumberOfInstances = 0;
+
+class GreedyImageIO:public itk::ImageIOBase
+{
+public:
+  typedef GreedyImageIO                 Self;
+  typedef itk::ImageIOBase              Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(GreedyImageIO, ImageIOBase);
+
+  static unsigned int m_NumberOfProbes;
+
+  virtual bool CanReadFile(const char *)
+  {
+    ++m_NumberOfProbes;
+    return true;
+  }
+  virtual void ReadImageInformation() {}
+  virtual void Read(void *) {}
+  virtual bool CanWriteFile(const char *) { return false; }
+  virtual void WriteImageInformation() {}
+  virtual void Write(const void *) {}
+};
+
+unsigned int GreedyImageIO::m_NumberOfProbes = 0;
+
+template< class TImageIO >
+class TestImageIOFactory:public itk::ObjectFactoryBase
+{
+public:
+  typedef TestImageIOFactory           Self;
+  typedef itk::ObjectFactoryBase       Superclass;
+  typedef itk::SmartPointer< Self >    Pointer;
+
+  virtual const char * GetITKSourceVersion() const { return ITK_SOURCE_VERSION; }
+  virtual const char * GetDescription() const { return "ImageIO factory for testing"; }
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(TestImageIOFactory, ObjectFactoryBase);
+
+protected:
+  TestImageIOFactory()
+  {
+    typename TImageIO::Pointer io = TImageIO::New();
+    this->RegisterOverride("itkImageIOBase", io->GetNameOfClass(), "ImageIO for testing", 1,
+                           itk::CreateObjectFunction< TImageIO >::New());
+  }
+};
+
+template< class TImageIO >
+bool IsA(const itk::ImageIOBase *io)
+{
+  return dynamic_cast< const TImageIO * >( io ) != 0;
+}
+}
+
+int itkImageIOFactoryTest(int, char *[])
+{
+  typedef itk::ImageIOFactory FactoryType;
+
+  // the greedy ImageIO comes first, it would read any file
+  TestImageIOFactory< ProbeCountingImageIO >::Pointer probeFactory =
+    TestImageIOFactory< ProbeCountingImageIO >::New();
+  TestImageIOFactory< GreedyImageIO >::Pointer greedyFactory =
+    TestImageIOFactory< GreedyImageIO >::New();
+  itk::ObjectFactoryBase::RegisterFactory(probeFactory, itk::ObjectFactoryBase::INSERT_AT_FRONT);
+  itk::ObjectFactoryBase::RegisterFactory(greedyFactory, itk::ObjectFactoryBase::INSERT_AT_FRONT);
+
+  // the ImageIO of the extension is tried first, whatever its case
+  const char *fileNames[] = { "image.probe", "IMAGE.PROBE", "dir.probe/image.Probe" };
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    ProbeCountingImageIO::m_NumberOfProbes = 0;
+    GreedyImageIO::m_NumberOfProbes = 0;
+    itk::ImageIOBase::Pointer io = FactoryType::CreateImageIO(fileNames[i], FactoryType::ReadMode);
+    if ( !IsA< ProbeCountingImageIO >(io) || ProbeCountingImageIO::m_NumberOfProbes != 1
+         || GreedyImageIO::m_NumberOfProbes != 0 )
+      {
+      std::cerr << "ERROR: " << fileNames[i] << " was not probed by its ImageIO first" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // a new ImageIO is returned by each call
+  itk::ImageIOBase::Pointer first = FactoryType::CreateImageIO("image.probe", FactoryType::WriteMode);
+  itk::ImageIOBase::Pointer second = FactoryType::CreateImageIO("image.probe", FactoryType::WriteMode);
+  if ( !IsA< ProbeCountingImageIO >(first) || !IsA< ProbeCountingImageIO >(second) || first == second )
+    {
+    std::cerr << "ERROR: the same ImageIO was returned twice" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // other files are probed in the order of the factories
+  GreedyImageIO::m_NumberOfProbes = 0;
+  itk::ImageIOBase::Pointer io = FactoryType::CreateImageIO("image.unknown", FactoryType::ReadMode);
+  if ( !IsA< GreedyImageIO >(io) || GreedyImageIO::m_NumberOfProbes != 1 )
+    {
+    std::cerr << "ERROR: image.unknown was not read by the first ImageIO" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // disabling, and unregistering, a factory is taken into account
+  greedyFactory->SetEnableFlag(false, "itkImageIOBase", "GreedyImageIO");
+  GreedyImageIO::m_NumberOfProbes = 0;
+  io = FactoryType::CreateImageIO("image.unknown", FactoryType::ReadMode);
+  if ( IsA< GreedyImageIO >(io) || GreedyImageIO::m_NumberOfProbes != 0 )
+    {
+    std::cerr << "ERROR: a disabled ImageIO was used" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::ObjectFactoryBase::UnRegisterFactory(probeFactory);
+  io = FactoryType::CreateImageIO("image.probe", FactoryType::ReadMode);
+  if ( IsA< ProbeCountingImageIO >(io) )
+    {
+    std::cerr << "ERROR: an unregistered ImageIO was used" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::ObjectFactoryBase::UnRegisterFactory(greedyFactory);
+
+  // the prototypes of a factory are released when it is deleted, as
+  // UnRegisterAllFactories() does before it closes the libraries of the
+  // dynamically loaded factories
+  first = 0;
+  second = 0;
+  probeFactory = TestImageIOFactory< ProbeCountingImageIO >::New();
+  itk::ObjectFactoryBase::RegisterFactory(probeFactory);
+  io = FactoryType::CreateImageIO("image.probe", FactoryType::ReadMode);
+  if ( !IsA< ProbeCountingImageIO >(io) )
+    {
+    std::cerr << "ERROR: a registered ImageIO was not used" << std::endl;
+    return EXIT_FAILURE;
+    }
+  io = 0;
+  itk::ObjectFactoryBase::UnRegisterFactory(probeFactory);
+  probeFactory = 0;
+  if ( ProbeCountingImageIO::m_NumberOfInstances != 0 )
+    {
+    std::cerr << "ERROR: " << ProbeCountingImageIO::m_NumberOfInstances
+              << " ImageIO prototypes outlived their factory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
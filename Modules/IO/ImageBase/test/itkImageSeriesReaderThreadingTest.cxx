@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+
+namespace
+{
+typedef itk::Image< short, 2 >                 SliceType;
+typedef itk::Image< short, 3 >                 ImageType;
+typedef itk::ImageSeriesReader< ImageType >    ReaderType;
+
+short ExpectedValue(itk::IndexValueType x, itk::IndexValueType y, itk::IndexValueType z)
+{
+  return static_cast< short >( x + 50 * y + 3000 * z );
+}
+
+// the slice z of the output holds the file z, or the file
+// numberOfFiles - z - 1 in reverse order
+bool CheckImage(const ImageType *image, const ImageType::RegionType & region,
+                itk::IndexValueType numberOfFiles, bool reverseOrder)
+{
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << "ERROR: " << image->GetBufferedRegion() << " was read instead of "
+              << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it(image, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const itk::IndexValueType  file = reverseOrder ? numberOfFiles - index[2] - 1 : index[2];
+    if ( it.Get() != ExpectedValue(index[0], index[1], file) )
+      {
+      std::cerr << "ERROR: wrong value at " << index << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool ReadSeries(const ReaderType::FileNamesContainer & fileNames, const ImageType::RegionType & region,
+                itk::ThreadIdType numberOfThreads, bool reverseOrder, bool useImageIO)
+{
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfReadingThreads(numberOfThreads);
+  reader->SetReverseOrder(reverseOrder);
+  if ( useImageIO )
+    {
+    reader->SetImageIO( itk::MetaImageIO::New() );
+    }
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->Update();
+
+  const itk::IndexValueType numberOfFiles = static_cast< itk::IndexValueType >( fileNames.size() );
+  if ( !CheckImage(reader->GetOutput(), region, numberOfFiles, reverseOrder) )
+    {
+    std::cerr << "ERROR: series read with " << numberOfThreads << " threads" << std::endl;
+    return false;
+    }
+
+  // every file has its dictionary, in the order of the slices
+  const ReaderType::DictionaryArrayType *dictionaries = reader->GetMetaDataDictionaryArray();
+  if ( dictionaries->size() != fileNames.size() )
+    {
+    std::cerr << "ERROR: " << dictionaries->size() << " dictionaries instead of "
+              << fileNames.size() << std::endl;
+    return false;
+    }
+  for ( size_t i = 0; i < dictionaries->size(); ++i )
+    {
+    if ( !( *dictionaries )[i] )
+      {
+      std::cerr << "ERROR: missing dictionary " << i << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageSeriesReaderThreadingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  const itk::IndexValueType numberOfFiles = 12;
+  SliceType::SizeType       sliceSize;
+  sliceSize[0] = 40;
+  sliceSize[1] = 30;
+
+  ReaderType::FileNamesContainer fileNames;
+  try
+    {
+    for ( itk::IndexValueType z = 0; z < numberOfFiles; ++z )
+      {
+      SliceType::Pointer slice = SliceType::New();
+      slice->SetRegions(sliceSize);
+      slice->Allocate();
+      itk::ImageRegionIteratorWithIndex< SliceType > it( slice, slice->GetBufferedRegion() );
+      for (; !it.IsAtEnd(); ++it )
+        {
+        it.Set( ExpectedValue(it.GetIndex()[0], it.GetIndex()[1], z) );
+        }
+
+      std::ostringstream fileName;
+      fileName << directory << "/itkImageSeriesReaderThreadingTest" << z << ".mha";
+      fileNames.push_back( fileName.str() );
+
+      itk::ImageFileWriter< SliceType >::Pointer writer = itk::ImageFileWriter< SliceType >::New();
+      writer->SetFileName( fileName.str() );
+      writer->SetInput(slice);
+      writer->Update();
+      }
+
+    ImageType::RegionType largestRegion;
+    largestRegion.SetSize(0, sliceSize[0]);
+    largestRegion.SetSize(1, sliceSize[1]);
+    largestRegion.SetSize(2, numberOfFiles);
+
+    // only the slices of the region are decoded
+    ImageType::RegionType region;
+    region.SetIndex(0, 5);
+    region.SetIndex(1, 7);
+    region.SetIndex(2, 3);
+    region.SetSize(0, 20);
+    region.SetSize(1, 15);
+    region.SetSize(2, 6);
+
+    const itk::ThreadIdType numberOfThreads[] = { 1, 4, 20 };
+    for ( unsigned int t = 0; t < 3; ++t )
+      {
+      if ( !ReadSeries(fileNames, largestRegion, numberOfThreads[t], false, false)
+           || !ReadSeries(fileNames, region, numberOfThreads[t], false, false)
+           || !ReadSeries(fileNames, largestRegion, numberOfThreads[t], true, false)
+           || !ReadSeries(fileNames, region, numberOfThreads[t], true, true) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a file which can not be read is reported by the thread which reads it
+  fileNames[7] = directory + "/itkImageSeriesReaderThreadingTestMissing.mha";
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfReadingThreads(4);
+  reader->SetImageIO( itk::MetaImageIO::New() );
+  bool caught = false;
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "ERROR: the missing file was not reported" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
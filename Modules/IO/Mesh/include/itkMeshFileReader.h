@@ -154,6 +154,14 @@ public:
 
   itkGetObjectMacro(MeshIO, MeshIOBase);
 
+  /** Set/Get the number of points, pixels or cell buffer values read at
+   * once when the MeshIO can stream. The file is then converted into the
+   * output mesh block by block, without a buffer of the whole file. The
+   * cell buffer grows when a single cell does not fit in it. The default
+   * is 1048576. */
+  itkSetClampMacro(BlockSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BlockSize, SizeValueType);
+
   /** Prepare the allocation of the output mesh during the first back
    * propagation of the pipeline. */
   virtual void GenerateOutputInformation();
@@ -161,9 +169,19 @@ public:
   template< typename T >
   void ReadPoints(T *buffer);
 
+  /** Set numberOfPoints points from firstPoint with the coordinates of
+   * buffer. */
+  template< typename T >
+  void ReadPoints(T *buffer, OutputPointIdentifier firstPoint, SizeValueType numberOfPoints);
+
   template< typename T >
   void ReadCells(T *buffer);
 
+  /** Add the cells of bufferSize values of buffer to the output mesh,
+   * from the cell identifier id, which is moved past the new cells. */
+  template< typename T >
+  void ReadCells(T *buffer, SizeValueType bufferSize, OutputCellIdentifier & id);
+
   void ReadPointData();
 
   void ReadCellData();
@@ -190,10 +208,25 @@ protected:
   /** Does the real work. */
   virtual void GenerateData();
 
+  /** Read the points, or cells, through a buffer of component type T,
+   * in blocks when the MeshIO can stream. */
+  template< typename T >
+  void ReadPointsAs();
+
+  template< typename T >
+  void ReadCellsAs();
+
+  /** Read the point, or cell, data block by block into the data
+   * container of the output mesh. */
+  void ReadPointDataBlocks();
+
+  void ReadCellDataBlocks();
+
   MeshIOBase::Pointer m_MeshIO;
   bool                m_UserSpecifiedMeshIO; // keep track whether the MeshIO is
                                              // user specified
   std::string m_FileName;                    // The file to be read
+  SizeValueType m_BlockSize;                 // The size of the streamed blocks
 
 private:
   MeshFileReader(const Self &); // purposely not implemented
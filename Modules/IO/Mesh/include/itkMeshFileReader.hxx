@@ -28,6 +28,7 @@
 #include "itkPixelTraits.h"
 
 #include <itksys/SystemTools.hxx>
+#include <algorithm>
 #include <fstream>
 
 namespace itk
@@ -39,6 +40,7 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
   m_MeshIO = 0;
   m_FileName = "";
   m_UserSpecifiedMeshIO = false;
+  m_BlockSize = 1048576;
 }
 
 template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
@@ -60,6 +62,7 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 
   os << indent << "UserSpecifiedMeshIO flag: " << m_UserSpecifiedMeshIO << "\n";
   os << indent << "FileName: " << m_FileName << "\n";
+  os << indent << "BlockSize: " << m_BlockSize << "\n";
 }
 
 template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
@@ -121,16 +124,27 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
   output->GetPoints()->Reserve( m_MeshIO->GetNumberOfPoints() );
+
+  this->ReadPoints( buffer, 0, m_MeshIO->GetNumberOfPoints() );
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadPoints(T *buffer, OutputPointIdentifier firstPoint, SizeValueType numberOfPoints)
+{
+  typename TOutputMesh::Pointer output = this->GetOutput();
   OutputPointType point;
 
-  for ( OutputPointIdentifier id = 0; id < output->GetNumberOfPoints(); id++ )
+  for ( OutputPointIdentifier id = 0; id < numberOfPoints; id++ )
     {
     for ( OutputPointIdentifier ii = 0; ii < OutputPointDimension; ii++ )
       {
       point[ii] = static_cast< typename OutputPointType::ValueType >( buffer[id * OutputPointDimension + ii] );
       }
 
-    output->SetPoint(id, point);
+    output->SetPoint(firstPoint + id, point);
     }
 }
 
@@ -139,12 +153,22 @@ template< class T >
 void
 MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadCells(T *buffer)
+{
+  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::Zero;
+
+  this->ReadCells(buffer, m_MeshIO->GetCellBufferSize(), id);
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadCells(T *buffer, SizeValueType bufferSize, OutputCellIdentifier & id)
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
 
-  SizeValueType        index = NumericTraits< SizeValueType >::Zero;
-  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::Zero;
-  while ( index < m_MeshIO->GetCellBufferSize() )
+  SizeValueType index = NumericTraits< SizeValueType >::Zero;
+  while ( index < bufferSize )
     {
     MeshIOBase::CellGeometryType type = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
     switch ( type )
@@ -338,11 +362,96 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
     }
 }
 
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadPointsAs()
+{
+  const SizeValueType numberOfPoints = m_MeshIO->GetNumberOfPoints();
+
+  if ( !m_MeshIO->CanStreamRead() )
+    {
+    T *pointsBuffer = new T[numberOfPoints * OutputPointDimension];
+    try
+      {
+      m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
+      this->ReadPoints(pointsBuffer);
+      }
+    catch ( ... )
+      {
+      delete[] pointsBuffer;
+      throw;
+      }
+    delete[] pointsBuffer;
+    return;
+    }
+
+  // Convert the points block by block into the points container, which
+  // is allocated first
+  this->GetOutput()->GetPoints()->Reserve(numberOfPoints);
+
+  std::vector< T > pointsBuffer( std::min(m_BlockSize, numberOfPoints) * OutputPointDimension );
+  for ( SizeValueType firstPoint = 0; firstPoint < numberOfPoints; )
+    {
+    const SizeValueType count = std::min(m_BlockSize, numberOfPoints - firstPoint);
+    m_MeshIO->ReadPointsBlock(static_cast< void * >( &pointsBuffer[0] ), count);
+    this->ReadPoints(&pointsBuffer[0], firstPoint, count);
+    firstPoint += count;
+    }
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadCellsAs()
+{
+  if ( !m_MeshIO->CanStreamRead() )
+    {
+    T *cellsBuffer = new T[m_MeshIO->GetCellBufferSize()];
+    try
+      {
+      m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
+      this->ReadCells(cellsBuffer);
+      }
+    catch ( ... )
+      {
+      delete[] cellsBuffer;
+      throw;
+      }
+    delete[] cellsBuffer;
+    return;
+    }
+
+  std::vector< T >     cellsBuffer( std::min( m_BlockSize, m_MeshIO->GetCellBufferSize() ) );
+  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::Zero;
+  SizeValueType        size;
+  while ( !cellsBuffer.empty()
+          && ( size = m_MeshIO->ReadCellsBlock(static_cast< void * >( &cellsBuffer[0] ), cellsBuffer.size()) ) > 0 )
+    {
+    // The buffer grows when a single cell does not fit in it
+    if ( size > cellsBuffer.size() )
+      {
+      cellsBuffer.resize(size);
+      continue;
+      }
+    this->ReadCells(&cellsBuffer[0], size, id);
+    }
+}
+
 template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
 void
 MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadPointData()
 {
+  if ( m_MeshIO->CanStreamRead() )
+    {
+    this->ReadPointDataBlocks();
+    return;
+    }
+
+
   typename TOutputMesh::Pointer output = this->GetOutput();
 
   char *                inputPointDataBuffer = 0;
@@ -424,6 +533,13 @@ void
 MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadCellData()
 {
+  if ( m_MeshIO->CanStreamRead() )
+    {
+    this->ReadCellDataBlocks();
+    return;
+    }
+
+
   typename TOutputMesh::Pointer output = this->GetOutput();
 
   char *               inputCellDataBuffer = 0;
@@ -501,6 +617,100 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
     }
 }
 
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadPointDataBlocks()
+{
+  typedef typename TOutputMesh::PointDataContainer PointDataContainerType;
+
+  const SizeValueType numberOfPixels = m_MeshIO->GetNumberOfPointPixels();
+  const SizeValueType blockSize = std::min(m_BlockSize, numberOfPixels);
+  const bool          convert =
+    ( m_MeshIO->GetPointPixelComponentType() !=
+      MeshIOBase::MapComponentType< typename ConvertPointPixelTraits::ComponentType >::CType )
+    || ( m_MeshIO->GetNumberOfPointPixelComponents() != ConvertPointPixelTraits::GetNumberOfComponents() );
+
+  typename PointDataContainerType::Pointer pointData = PointDataContainerType::New();
+  pointData->Reserve(numberOfPixels);
+  this->GetOutput()->SetPointData(pointData);
+
+  std::vector< OutputPointPixelType > outputPointDataBuffer(blockSize);
+  std::vector< char >                 inputPointDataBuffer;
+  if ( convert )
+    {
+    inputPointDataBuffer.resize( blockSize * m_MeshIO->GetNumberOfPointPixelComponents()
+                                 * m_MeshIO->GetComponentSize( m_MeshIO->GetPointPixelComponentType() ) );
+    }
+
+  for ( SizeValueType firstPixel = 0; firstPixel < numberOfPixels; )
+    {
+    const SizeValueType count = std::min(blockSize, numberOfPixels - firstPixel);
+    if ( convert )
+      {
+      m_MeshIO->ReadPointDataBlock(static_cast< void * >( &inputPointDataBuffer[0] ), count);
+      this->ConvertPointPixelBuffer(static_cast< void * >( &inputPointDataBuffer[0] ), &outputPointDataBuffer[0], count);
+      }
+    else
+      {
+      m_MeshIO->ReadPointDataBlock(static_cast< void * >( &outputPointDataBuffer[0] ), count);
+      }
+
+    for ( SizeValueType ii = 0; ii < count; ii++ )
+      {
+      pointData->SetElement(firstPixel + ii, outputPointDataBuffer[ii]);
+      }
+    firstPixel += count;
+    }
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadCellDataBlocks()
+{
+  typedef typename TOutputMesh::CellDataContainer CellDataContainerType;
+
+  const SizeValueType numberOfPixels = m_MeshIO->GetNumberOfCellPixels();
+  const SizeValueType blockSize = std::min(m_BlockSize, numberOfPixels);
+  const bool          convert =
+    ( m_MeshIO->GetCellPixelComponentType() !=
+      MeshIOBase::MapComponentType< typename ConvertCellPixelTraits::ComponentType >::CType )
+    || ( m_MeshIO->GetNumberOfCellPixelComponents() != ConvertCellPixelTraits::GetNumberOfComponents() );
+
+  typename CellDataContainerType::Pointer cellData = CellDataContainerType::New();
+  cellData->Reserve(numberOfPixels);
+  this->GetOutput()->SetCellData(cellData);
+
+  std::vector< OutputCellPixelType > outputCellDataBuffer(blockSize);
+  std::vector< char >                inputCellDataBuffer;
+  if ( convert )
+    {
+    inputCellDataBuffer.resize( blockSize * m_MeshIO->GetNumberOfCellPixelComponents()
+                                * m_MeshIO->GetComponentSize( m_MeshIO->GetCellPixelComponentType() ) );
+    }
+
+  for ( SizeValueType firstPixel = 0; firstPixel < numberOfPixels; )
+    {
+    const SizeValueType count = std::min(blockSize, numberOfPixels - firstPixel);
+    if ( convert )
+      {
+      m_MeshIO->ReadCellDataBlock(static_cast< void * >( &inputCellDataBuffer[0] ), count);
+      this->ConvertCellPixelBuffer(static_cast< void * >( &inputCellDataBuffer[0] ), &outputCellDataBuffer[0], count);
+      }
+    else
+      {
+      m_MeshIO->ReadCellDataBlock(static_cast< void * >( &outputCellDataBuffer[0] ), count);
+      }
+
+    for ( SizeValueType ii = 0; ii < count; ii++ )
+      {
+      cellData->SetElement(firstPixel + ii, outputCellDataBuffer[ii]);
+      }
+    firstPixel += count;
+    }
+}
+
 template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
 void
 MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
@@ -593,106 +803,67 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
       {
       case MeshIOBase::CHAR:
         {
-        char *pointsBuffer = new char[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< char >();
         break;
         }
       case MeshIOBase::UCHAR:
         {
-        unsigned char *pointsBuffer = new unsigned char[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< unsigned char >();
         break;
         }
       case MeshIOBase::SHORT:
         {
-        short *pointsBuffer = new short[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< short >();
         break;
         }
       case MeshIOBase::USHORT:
         {
-        unsigned short *pointsBuffer = new unsigned short[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< unsigned short >();
         break;
         }
       case MeshIOBase::INT:
         {
-        int *pointsBuffer = new int[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< int >();
         break;
         }
       case MeshIOBase::UINT:
         {
-        unsigned int *pointsBuffer = new unsigned int[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< unsigned int >();
         break;
         }
       case MeshIOBase::LONG:
         {
-        long *pointsBuffer = new long[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< long >();
         break;
         }
       case MeshIOBase::ULONG:
         {
-        unsigned long *pointsBuffer = new unsigned long[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< unsigned long >();
         break;
         }
       case MeshIOBase::LONGLONG:
         {
-        long long *pointsBuffer = new long long[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< long long >();
         break;
         }
       case MeshIOBase::ULONGLONG:
         {
-        unsigned long long *pointsBuffer = new unsigned long long[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< unsigned long long >();
         break;
         }
       case MeshIOBase::FLOAT:
         {
-        float *pointsBuffer = new float[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< float >();
         break;
         }
       case MeshIOBase::DOUBLE:
         {
-        double *pointsBuffer = new double[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< double >();
         break;
         }
       case MeshIOBase::LDOUBLE:
         {
-        long double *pointsBuffer = new long double[m_MeshIO->GetNumberOfPoints() * OutputPointDimension];
-        m_MeshIO->ReadPoints( static_cast< void * >( pointsBuffer ) );
-        ReadPoints(pointsBuffer);
-        delete[] pointsBuffer;
+        ReadPointsAs< long double >();
         break;
         }
       case MeshIOBase::UNKNOWNCOMPONENTTYPE:
@@ -710,106 +881,67 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
       {
       case MeshIOBase::CHAR:
         {
-        char *cellsBuffer = new char[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< char >();
         break;
         }
       case MeshIOBase::UCHAR:
         {
-        unsigned char *cellsBuffer = new unsigned char[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< unsigned char >();
         break;
         }
       case MeshIOBase::SHORT:
         {
-        short *cellsBuffer = new short[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< short >();
         break;
         }
       case MeshIOBase::USHORT:
         {
-        unsigned short *cellsBuffer = new unsigned short[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< unsigned short >();
         break;
         }
       case MeshIOBase::INT:
         {
-        int *cellsBuffer = new int[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< int >();
         break;
         }
       case MeshIOBase::UINT:
         {
-        unsigned int *cellsBuffer = new unsigned int[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< unsigned int >();
         break;
         }
       case MeshIOBase::LONG:
         {
-        long *cellsBuffer = new long[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< long >();
         break;
         }
       case MeshIOBase::ULONG:
         {
-        unsigned long *cellsBuffer = new unsigned long[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< unsigned long >();
         break;
         }
       case MeshIOBase::LONGLONG:
         {
-        long long *cellsBuffer = new long long[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< long long >();
         break;
         }
       case MeshIOBase::ULONGLONG:
         {
-        unsigned long long *cellsBuffer = new unsigned long long[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< unsigned long long >();
         break;
         }
       case MeshIOBase::FLOAT:
         {
-        float *cellsBuffer = new float[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< float >();
         break;
         }
       case MeshIOBase::DOUBLE:
         {
-        double *cellsBuffer = new double[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< double >();
         break;
         }
       case MeshIOBase::LDOUBLE:
         {
-        long double *cellsBuffer = new long double[m_MeshIO->GetCellBufferSize()];
-        m_MeshIO->ReadCells( static_cast< void * >( cellsBuffer ) );
-        ReadCells(cellsBuffer);
-        delete[] cellsBuffer;
+        ReadCellsAs< long double >();
         break;
         }
       case MeshIOBase::UNKNOWNCOMPONENTTYPE:
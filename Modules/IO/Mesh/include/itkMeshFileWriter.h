@@ -145,6 +145,13 @@ public:
     this->Write();
   }
 
+  /** Set/Get the number of points, pixels or cell buffer values written
+   * at once when the MeshIO can stream. The mesh is then copied to the
+   * MeshIO block by block, without a buffer of the whole mesh. The
+   * default is 1048576. */
+  itkSetClampMacro(BlockSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BlockSize, SizeValueType);
+
   /** Set the compression On or Off */
   itkSetMacro(UseCompression, bool);
   itkGetConstReferenceMacro(UseCompression, bool);
@@ -167,6 +174,27 @@ protected:
   template< class Output >
   void CopyCellDataToBuffer(Output *data);
 
+  /** Copy the numberOfPoints points from pter to data, and move pter
+   * past them. */
+  template< class Output >
+  void CopyPointsToBuffer(Output *data, typename InputMeshType::PointsContainerConstIterator & pter,
+                          SizeValueType numberOfPoints);
+
+  /** Copy the whole cells from cter which fit in bufferSize values of
+   * data, and move cter past them. Returns the number of values copied,
+   * and sets numberOfCells. */
+  template< class Output >
+  SizeValueType CopyCellsToBuffer(Output *data, typename InputMeshType::CellsContainerConstIterator & cter,
+                                  SizeValueType bufferSize, SizeValueType & numberOfCells);
+
+  template< class Output >
+  void CopyPointDataToBuffer(Output *data, typename InputMeshType::PointDataContainer::ConstIterator & pter,
+                             SizeValueType numberOfPixels);
+
+  template< class Output >
+  void CopyCellDataToBuffer(Output *data, typename InputMeshType::CellDataContainer::ConstIterator & cter,
+                            SizeValueType numberOfPixels);
+
   void WritePoints();
 
   void WriteCells();
@@ -187,6 +215,7 @@ private:
                                                 // mechanism set the MeshIO
   bool                m_UseCompression;
   bool                m_FileTypeIsBINARY;
+  SizeValueType       m_BlockSize;
 };
 } // end namespace itk
 
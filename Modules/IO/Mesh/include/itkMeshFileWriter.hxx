@@ -27,6 +27,9 @@
 
 #include "vnl/vnl_vector.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace itk
 {
 template< class TInputMesh >
@@ -38,6 +41,7 @@ MeshFileWriter< TInputMesh >
   m_FactorySpecifiedMeshIO = false;
   m_UserSpecifiedMeshIO = false;
   m_FileTypeIsBINARY = false;
+  m_BlockSize = 1048576;
 }
 
 template< class TInputMesh >
@@ -258,6 +262,23 @@ MeshFileWriter< TInputMesh >
   const InputMeshType *input = this->GetInput();
 
   itkDebugMacro(<< "Writing points: " << m_FileName);
+
+  if ( m_MeshIO->CanStreamWrite() )
+    {
+    const SizeValueType numberOfPoints = input->GetNumberOfPoints();
+    const SizeValueType blockSize = std::min(m_BlockSize, numberOfPoints);
+    std::vector< typename TInputMesh::PointType::ValueType > buffer(blockSize * TInputMesh::PointDimension);
+    typename TInputMesh::PointsContainerConstIterator pter = input->GetPoints()->Begin();
+    for ( SizeValueType firstPoint = 0; firstPoint < numberOfPoints; )
+      {
+      const SizeValueType count = std::min(blockSize, numberOfPoints - firstPoint);
+      CopyPointsToBuffer(&buffer[0], pter, count);
+      m_MeshIO->WritePointsBlock(&buffer[0], count);
+      firstPoint += count;
+      }
+    return;
+    }
+
   SizeValueType pointsBufferSize = input->GetNumberOfPoints() * TInputMesh::PointDimension;
   typename TInputMesh::PointType::ValueType * buffer = new typename TInputMesh::PointType::ValueType[pointsBufferSize];
   CopyPointsToBuffer(buffer);
@@ -272,6 +293,27 @@ MeshFileWriter< TInputMesh >
 {
   itkDebugMacro(<< "Writing cells: " << m_FileName);
 
+  if ( m_MeshIO->CanStreamWrite() )
+    {
+    const typename InputMeshType::CellsContainer *cells = this->GetInput()->GetCells();
+
+    // The buffer grows when a single cell does not fit in it
+    std::vector< typename TInputMesh::PointIdentifier > buffer( std::min( m_BlockSize, m_MeshIO->GetCellBufferSize() ) );
+    typename TInputMesh::CellsContainerConstIterator cter = cells->Begin();
+    while ( cter != cells->End() )
+      {
+      SizeValueType numberOfCells = 0;
+      SizeValueType size = CopyCellsToBuffer(&buffer[0], cter, buffer.size(), numberOfCells);
+      if ( numberOfCells == 0 )
+        {
+        buffer.resize(cter.Value()->GetNumberOfPoints() + 2);
+        continue;
+        }
+      m_MeshIO->WriteCellsBlock(&buffer[0], numberOfCells, size);
+      }
+    return;
+    }
+
   SizeValueType cellsBufferSize = m_MeshIO->GetCellBufferSize();
   typename TInputMesh::PointIdentifier * buffer = new typename TInputMesh::PointIdentifier[cellsBufferSize];
   CopyCellsToBuffer(buffer);
@@ -288,7 +330,25 @@ MeshFileWriter< TInputMesh >
 
   itkDebugMacro(<< "Writing point data: " << m_FileName);
 
-  if ( input->GetPointData()->Size() )
+  if ( input->GetPointData()->Size() && m_MeshIO->CanStreamWrite() )
+    {
+    const SizeValueType numberOfPixels = input->GetPointData()->Size();
+    const SizeValueType blockSize = std::min(m_BlockSize, numberOfPixels);
+    const unsigned int  numberOfComponents = MeshConvertPixelTraits< typename TInputMesh::PixelType >::GetNumberOfComponents(
+      input->GetPointData()->ElementAt(0) );
+
+    typedef typename itk::NumericTraits< typename TInputMesh::PixelType >::ValueType ValueType;
+    std::vector< ValueType > buffer(blockSize * numberOfComponents);
+    typename TInputMesh::PointDataContainer::ConstIterator iter = input->GetPointData()->Begin();
+    for ( SizeValueType firstPixel = 0; firstPixel < numberOfPixels; )
+      {
+      const SizeValueType count = std::min(blockSize, numberOfPixels - firstPixel);
+      CopyPointDataToBuffer(&buffer[0], iter, count);
+      m_MeshIO->WritePointDataBlock(&buffer[0], count);
+      firstPixel += count;
+      }
+    }
+  else if ( input->GetPointData()->Size() )
     {
     const SizeValueType numberOfComponents = input->GetPointData()->Size()
                                        * MeshConvertPixelTraits< typename TInputMesh::PixelType >::GetNumberOfComponents(
@@ -311,7 +371,25 @@ MeshFileWriter< TInputMesh >
 
   itkDebugMacro(<< "Writing cell data: " << m_FileName);
 
-  if ( input->GetCellData()->Size() )
+  if ( input->GetCellData()->Size() && m_MeshIO->CanStreamWrite() )
+    {
+    const SizeValueType numberOfPixels = input->GetCellData()->Size();
+    const SizeValueType blockSize = std::min(m_BlockSize, numberOfPixels);
+    const unsigned int  numberOfComponents = MeshConvertPixelTraits< typename TInputMesh::CellPixelType >::GetNumberOfComponents(
+      input->GetCellData()->ElementAt(0) );
+
+    typedef typename itk::NumericTraits< typename TInputMesh::CellPixelType >::ValueType ValueType;
+    std::vector< ValueType > buffer(blockSize * numberOfComponents);
+    typename TInputMesh::CellDataContainer::ConstIterator iter = input->GetCellData()->Begin();
+    for ( SizeValueType firstPixel = 0; firstPixel < numberOfPixels; )
+      {
+      const SizeValueType count = std::min(blockSize, numberOfPixels - firstPixel);
+      CopyCellDataToBuffer(&buffer[0], iter, count);
+      m_MeshIO->WriteCellDataBlock(&buffer[0], count);
+      firstPixel += count;
+      }
+    }
+  else if ( input->GetCellData()->Size() )
     {
     const SizeValueType numberOfComponents = input->GetCellData()->Size()
                                        * MeshConvertPixelTraits< typename TInputMesh::CellPixelType >::GetNumberOfComponents(
@@ -331,13 +409,21 @@ void
 MeshFileWriter< TInputMesh >
 ::CopyPointsToBuffer(Output *data)
 {
-  const typename InputMeshType::PointsContainer * points = this->GetInput()->GetPoints();
+  typename TInputMesh::PointsContainerConstIterator pter = this->GetInput()->GetPoints()->Begin();
 
-  typename TInputMesh::PointType point;
+  CopyPointsToBuffer( data, pter, this->GetInput()->GetNumberOfPoints() );
+}
+
+template< class TInputMesh >
+template< class Output >
+void
+MeshFileWriter< TInputMesh >
+::CopyPointsToBuffer(Output *data, typename InputMeshType::PointsContainerConstIterator & pter,
+                     SizeValueType numberOfPoints)
+{
   SizeValueType index = NumericTraits< SizeValueType >::Zero;
-  typename TInputMesh::PointsContainerConstIterator pter = points->Begin();
 
-  while ( pter != points->End() )
+  for ( SizeValueType ii = 0; ii < numberOfPoints; ii++ )
     {
     for ( unsigned int jj = 0; jj < TInputMesh::PointDimension; jj++ )
       {
@@ -353,6 +439,19 @@ template< class Output >
 void
 MeshFileWriter< TInputMesh >
 ::CopyCellsToBuffer(Output *data)
+{
+  typename TInputMesh::CellsContainerConstIterator cter = this->GetInput()->GetCells()->Begin();
+  SizeValueType numberOfCells;
+
+  CopyCellsToBuffer(data, cter, m_MeshIO->GetCellBufferSize(), numberOfCells);
+}
+
+template< class TInputMesh >
+template< class Output >
+typename MeshFileWriter< TInputMesh >::SizeValueType
+MeshFileWriter< TInputMesh >
+::CopyCellsToBuffer(Output *data, typename InputMeshType::CellsContainerConstIterator & cter,
+                    SizeValueType bufferSize, SizeValueType & numberOfCells)
 {
   // Get input mesh pointer
   const typename InputMeshType::CellsContainer * cells = this->GetInput()->GetCells();
@@ -361,12 +460,17 @@ MeshFileWriter< TInputMesh >
   typename TInputMesh::PointIdentifier const  *ptIds;
   typename TInputMesh::CellType * cellPtr;
 
-  // For each cell
+  // For each cell which fits in the buffer
   SizeValueType index = NumericTraits< SizeValueType >::Zero;
-  typename TInputMesh::CellsContainerConstIterator cter = cells->Begin();
+  numberOfCells = 0;
   while ( cter != cells->End() )
     {
     cellPtr = cter.Value();
+    unsigned int numberOfPoints = cellPtr->GetNumberOfPoints();
+    if ( index + numberOfPoints + 2 > bufferSize )
+      {
+      break;
+      }
 
     // Write the cell type
     switch ( cellPtr->GetType() )
@@ -403,18 +507,20 @@ MeshFileWriter< TInputMesh >
       }
 
     // The second element is number of points for each cell
-    data[index++] = cellPtr->GetNumberOfPoints();
+    data[index++] = numberOfPoints;
 
     // Others are point identifiers in the cell
     ptIds = cellPtr->GetPointIds();
-    unsigned int numberOfPoints = cellPtr->GetNumberOfPoints();
     for ( unsigned int ii = 0; ii < numberOfPoints; ii++ )
       {
       data[index++] = static_cast< Output >( ptIds[ii] );
       }
 
+    ++numberOfCells;
     ++cter;
     }
+
+  return index;
 }
 
 template< class TInputMesh >
@@ -422,6 +528,18 @@ template< class Output >
 void
 MeshFileWriter< TInputMesh >
 ::CopyPointDataToBuffer(Output *data)
+{
+  typename TInputMesh::PointDataContainer::ConstIterator pter = this->GetInput()->GetPointData()->Begin();
+
+  CopyPointDataToBuffer( data, pter, this->GetInput()->GetPointData()->Size() );
+}
+
+template< class TInputMesh >
+template< class Output >
+void
+MeshFileWriter< TInputMesh >
+::CopyPointDataToBuffer(Output *data, typename InputMeshType::PointDataContainer::ConstIterator & pter,
+                        SizeValueType numberOfPixels)
 {
   const typename InputMeshType::PointDataContainer * pointData = this->GetInput()->GetPointData();
 
@@ -434,8 +552,7 @@ MeshFileWriter< TInputMesh >
     pointData->ElementAt(0) );
 
   SizeValueType index = 0;
-  typename TInputMesh::PointDataContainer::ConstIterator pter = pointData->Begin();
-  while ( pter != pointData->End() )
+  for ( SizeValueType ii = 0; ii < numberOfPixels; ii++ )
     {
     for ( unsigned int jj = 0; jj < numberOfComponents; jj++ )
       {
@@ -452,6 +569,18 @@ template< class Output >
 void
 MeshFileWriter< TInputMesh >
 ::CopyCellDataToBuffer(Output *data)
+{
+  typename TInputMesh::CellDataContainer::ConstIterator cter = this->GetInput()->GetCellData()->Begin();
+
+  CopyCellDataToBuffer( data, cter, this->GetInput()->GetCellData()->Size() );
+}
+
+template< class TInputMesh >
+template< class Output >
+void
+MeshFileWriter< TInputMesh >
+::CopyCellDataToBuffer(Output *data, typename InputMeshType::CellDataContainer::ConstIterator & cter,
+                       SizeValueType numberOfPixels)
 {
   const typename InputMeshType::CellDataContainer * cellData = this->GetInput()->GetCellData();
 
@@ -463,8 +592,7 @@ MeshFileWriter< TInputMesh >
   unsigned int numberOfComponents = MeshConvertPixelTraits< typename TInputMesh::CellPixelType >::GetNumberOfComponents(
     cellData->ElementAt(0) );
   SizeValueType index = 0;
-  typename TInputMesh::CellDataContainer::ConstIterator cter = cellData->Begin();
-  while ( cter != cellData->End() )
+  for ( SizeValueType ii = 0; ii < numberOfPixels; ii++ )
     {
     for ( unsigned int jj = 0; jj < numberOfComponents; jj++ )
       {
@@ -512,6 +640,8 @@ MeshFileWriter< TInputMesh >
     {
     os << indent << "FactorySpecifiedMeshIO: Off\n";
     }
+
+  os << indent << "BlockSize: " << m_BlockSize << "\n";
 }
 } // end namespace itk
 
@@ -497,6 +497,52 @@ public:
 
   virtual void Write() = 0;
 
+  /*-------- This part of the interfaces deals with streaming ----- */
+
+  /** Return true if the points, cells, point data and cell data can be
+   * read in consecutive blocks with the Read*Block() methods, so that
+   * the whole file never has to be held in memory. */
+  virtual bool CanStreamRead()
+  {
+    return false;
+  }
+
+  /** Read the next numberOfPoints points, after ReadMeshInformation().
+   * Each part of the mesh is read from its beginning, in blocks of any
+   * size, until all its elements have been read. */
+  virtual void ReadPointsBlock(void *buffer, SizeValueType numberOfPoints);
+
+  /** Read the next cells into a buffer of bufferSize values, with the
+   * layout of ReadCells(). Only whole cells are read. Returns the number
+   * of values read, zero once all the cells have been read. If the next
+   * cell does not fit in bufferSize values, nothing is read and the
+   * number of values it needs, greater than bufferSize, is returned. */
+  virtual SizeValueType ReadCellsBlock(void *buffer, SizeValueType bufferSize);
+
+  virtual void ReadPointDataBlock(void *buffer, SizeValueType numberOfPixels);
+
+  virtual void ReadCellDataBlock(void *buffer, SizeValueType numberOfPixels);
+
+  /** Return true if the points, cells, point data and cell data can be
+   * written in consecutive blocks with the Write*Block() methods. */
+  virtual bool CanStreamWrite()
+  {
+    return false;
+  }
+
+  /** Write the next numberOfPoints points, after WriteMeshInformation().
+   * The parts of the mesh are written in the order of the non-streamed
+   * methods, each in blocks of any size, before Write() is called. */
+  virtual void WritePointsBlock(void *buffer, SizeValueType numberOfPoints);
+
+  /** Write the next numberOfCells cells, stored in bufferSize values with
+   * the layout of WriteCells(). */
+  virtual void WriteCellsBlock(void *buffer, SizeValueType numberOfCells, SizeValueType bufferSize);
+
+  virtual void WritePointDataBlock(void *buffer, SizeValueType numberOfPixels);
+
+  virtual void WriteCellDataBlock(void *buffer, SizeValueType numberOfPixels);
+
   /** This method returns an array with the list of filename extensions
    * supported for reading by this MeshIO class. This is intended to
    * facilitate GUI and application level integration.
@@ -582,7 +628,7 @@ protected:
         itk::ByteSwapper< TInput >::SwapRangeFromSystemToLittleEndian(buffer, numberOfComponents);
         }
 
-      outputFile.write(reinterpret_cast< char * >( buffer ), numberOfComponents);
+      outputFile.write(reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( TInput ) );
       }
     else
       {
@@ -601,7 +647,8 @@ protected:
         itk::ByteSwapper< TOutput >::SwapRangeFromSystemToLittleEndian(data, numberOfComponents);
         }
 
-      outputFile.write(reinterpret_cast< char * >( data ), numberOfComponents);
+      outputFile.write(reinterpret_cast< char * >( data ), numberOfComponents * sizeof( TOutput ) );
+      delete[] data;
       }
   }
 
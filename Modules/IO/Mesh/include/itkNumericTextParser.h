@@ -0,0 +1,201 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkNumericTextParser_h
+#define __itkNumericTextParser_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include <istream>
+#include <vector>
+
+namespace itk
+{
+/** \class NumericTextParser
+ * \brief Parses blocks of whitespace separated numbers on several
+ * threads.
+ *
+ * Read() parses a given number of values from the current position of
+ * a stream. The text is read in chunks of ChunkSize bytes, cut at
+ * whitespace. The values of each chunk are counted, then parsed into
+ * their place in the buffer, on one thread per chunk. The stream is
+ * left right after the last value parsed, so that the header of the
+ * next block can be read with the usual stream functions.
+ *
+ * The numbers are parsed without the C or C++ locale, the decimal
+ * point is always '.'. Integers and decimal numbers with up to 15
+ * significant digits are converted exactly by a fast path, the other
+ * numbers by the C library, or by a stream with the classic locale if
+ * the C locale does not use '.'.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOMesh
+ */
+class ITK_EXPORT NumericTextParser:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef NumericTextParser          Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(NumericTextParser, Object);
+
+  /** Set/Get the number of bytes of text parsed by a thread at once.
+   * The default is 1 MiB. */
+  itkSetClampMacro(ChunkSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(ChunkSize, SizeValueType);
+
+  /** Set/Get the number of threads which parse the chunks. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Parse numberOfValues values from the current position of the
+   * stream into buffer. An exception is thrown if a token is not a
+   * number or if the stream ends before numberOfValues values. */
+  template< typename T >
+  void Read(std::istream & stream, T *buffer, SizeValueType numberOfValues)
+  {
+    this->ReadValues(stream, buffer, sizeof( T ), numberOfValues, &Self::ParseValues< T >);
+  }
+
+  /** Move the stream past the next numberOfValues whitespace separated
+   * tokens, without parsing them. */
+  void Skip(std::istream & stream, SizeValueType numberOfValues)
+  {
+    this->ReadValues(stream, 0, 0, numberOfValues, 0);
+  }
+
+  /** Parse the number which begins at text, after any whitespace, and
+   * ends at whitespace or at end. On success text is moved after the
+   * number. */
+  template< typename T >
+  static bool ParseValue(const char * & text, const char *end, T & value)
+  {
+    if ( NumericTraits< T >::is_integer )
+      {
+      long long v;
+      if ( !ParseInteger(text, end, v) )
+        {
+        return false;
+        }
+      value = static_cast< T >( v );
+      }
+    else if ( sizeof( T ) > sizeof( double ) )
+      {
+      long double v;
+      if ( !ParseLongDouble(text, end, v) )
+        {
+        return false;
+        }
+      value = static_cast< T >( v );
+      }
+    else
+      {
+      double v;
+      if ( !ParseReal(text, end, v) )
+        {
+        return false;
+        }
+      value = static_cast< T >( v );
+      }
+    return true;
+  }
+
+  static bool ParseInteger(const char * & text, const char *end, long long & value);
+
+  static bool ParseReal(const char * & text, const char *end, double & value);
+
+  static bool ParseLongDouble(const char * & text, const char *end, long double & value);
+
+  static bool IsSpace(char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+  }
+
+protected:
+  NumericTextParser();
+  ~NumericTextParser() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Parse numberOfValues values from text into buffer, and set last to
+   * the end of the last value. */
+  typedef bool ( *ParseValuesFunction )(const char *text, const char *end, void *buffer,
+                                        SizeValueType numberOfValues, const char * & last);
+
+  template< typename T >
+  static bool ParseValues(const char *text, const char *end, void *buffer,
+                          SizeValueType numberOfValues, const char * & last)
+  {
+    T *values = static_cast< T * >( buffer );
+    for ( SizeValueType i = 0; i < numberOfValues; ++i )
+      {
+      if ( !ParseValue(text, end, values[i]) )
+        {
+        return false;
+        }
+      }
+    last = text;
+    return true;
+  }
+
+  /** Parse, or skip when parse is null, numberOfValues values of
+   * valueSize bytes. */
+  void ReadValues(std::istream & stream, void *buffer, SizeValueType valueSize,
+                  SizeValueType numberOfValues, ParseValuesFunction parse);
+
+  /** Count, or parse, the values of the chunks assigned to a thread. */
+  static ITK_THREAD_RETURN_TYPE CountThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE ParseThreaderCallback(void *arg);
+
+  void CountChunk(SizeValueType chunk);
+  void ParseChunk(SizeValueType chunk);
+
+  /** Run the callback on min(NumberOfThreads, number of chunks) threads,
+   * or directly when there is a single chunk. */
+  void ExecuteOnChunks(ThreadFunctionType callback);
+
+private:
+  NumericTextParser(const Self &); //purposely not implemented
+  void operator=(const Self &);    //purposely not implemented
+
+  SizeValueType m_ChunkSize;
+  ThreadIdType  m_NumberOfThreads;
+
+  /** State shared with the threads during ReadValues(). */
+  std::vector< char >          m_Text;
+  std::vector< SizeValueType > m_ChunkBegins;
+  std::vector< SizeValueType > m_ChunkEnds;
+  std::vector< SizeValueType > m_ChunkCounts;
+  std::vector< SizeValueType > m_ChunkOffsets;
+  std::vector< SizeValueType > m_ChunkValues;
+  std::vector< SizeValueType > m_ChunkLasts;
+  std::vector< char >          m_ChunkSucceeded;
+  char *                       m_Buffer;
+  SizeValueType                m_ValueSize;
+  ParseValuesFunction          m_Parse;
+};
+} // end namespace itk
+
+#endif
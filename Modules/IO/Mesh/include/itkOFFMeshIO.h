@@ -94,6 +94,18 @@ public:
 
   virtual void Write();
 
+  /** OFF files are written in blocks of points and cells, after the
+   * header of WriteMeshInformation(). They hold no point or cell data. */
+  virtual bool CanStreamWrite() { return true; }
+
+  virtual void WritePointsBlock(void *buffer, SizeValueType numberOfPoints);
+
+  virtual void WriteCellsBlock(void *buffer, SizeValueType numberOfCells, SizeValueType bufferSize);
+
+  virtual void WritePointDataBlock(void *buffer, SizeValueType numberOfPixels);
+
+  virtual void WriteCellDataBlock(void *buffer, SizeValueType numberOfPixels);
+
 protected:
   /** Read buffer as ascii stream */
   template< typename T >
@@ -119,13 +131,13 @@ protected:
     write all kind of cells as it is stored in cells container. It is used when
     cells container have only one kind of cells */
   template< typename TInput, typename TOutput >
-  void ReadCellsBuffer(TInput *input, TOutput *output)
+  void ReadCellsBuffer(TInput *input, TOutput *output, SizeValueType numberOfCells)
     {
     if ( input && output )
       {
       SizeValueType indInput  = 0;
       SizeValueType indOutput = 0;
-      for ( SizeValueType ii = 0; ii < this->m_NumberOfCells; ii++ )
+      for ( SizeValueType ii = 0; ii < numberOfCells; ii++ )
         {
         indInput++; // ignore the cell type
         unsigned int numberOfPoints = static_cast< unsigned int >( input[indInput++] );
@@ -139,11 +151,11 @@ protected:
     }
 
   template< typename T >
-  void WriteCellsAsAscii(T *buffer, std::ofstream & outputFile)
+  void WriteCellsAsAscii(T *buffer, std::ofstream & outputFile, SizeValueType numberOfCells)
     {
     SizeValueType index = 0;
 
-    for ( SizeValueType ii = 0; ii < this->m_NumberOfCells; ii++ )
+    for ( SizeValueType ii = 0; ii < numberOfCells; ii++ )
       {
       index++;
       unsigned int numberOfCellPoints = static_cast< unsigned int >( buffer[index++] );
@@ -159,12 +171,13 @@ protected:
     }
 
   template< typename TOutput, typename TInput >
-  void WriteCellsAsBinary(TInput *buffer, std::ofstream & outputFile)
+  void WriteCellsAsBinary(TInput *buffer, std::ofstream & outputFile, SizeValueType numberOfCells,
+                          SizeValueType bufferSize)
     {
-    TOutput *data = new TOutput[m_CellBufferSize - this->m_NumberOfCells];
+    TOutput *data = new TOutput[bufferSize - numberOfCells];
 
-    ReadCellsBuffer(buffer, data);
-    WriteBufferAsBinary< TOutput >(data, outputFile, m_CellBufferSize - this->m_NumberOfCells);
+    ReadCellsBuffer(buffer, data, numberOfCells);
+    WriteBufferAsBinary< TOutput >(data, outputFile, bufferSize - numberOfCells);
 
     delete[] data;
     }
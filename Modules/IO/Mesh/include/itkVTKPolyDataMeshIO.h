@@ -21,6 +21,7 @@
 #include "itkByteSwapper.h"
 #include "itkMetaDataObject.h"
 #include "itkMeshIOBase.h"
+#include "itkNumericTextParser.h"
 #include "itkVectorContainer.h"
 
 #include <fstream>
@@ -31,6 +32,12 @@ namespace itk
 /** \class VTKPolyDataMeshIO
  * \brief This class defines how to read and write vtk legacy file format.
  *
+ * ReadMeshInformation() records where the points, the cells and the
+ * point and cell data begin in the file, and skips the points and the
+ * cells. The ASCII values are parsed by a NumericTextParser, on
+ * several threads. The BINARY points and cells are read with a single
+ * read into the buffer and swapped in place.
+ *
  * \author Wanlin Zhu. Uviversity of New South Wales, Australia.
  * \ingroup IOFilters
  * \ingroup ITKIOMesh
@@ -80,6 +87,21 @@ public:
 
   virtual void ReadCellData(void *buffer);
 
+  /** The points, cells, point data and cell data can be read in blocks,
+   * from the positions found by ReadMeshInformation(). */
+  virtual bool CanStreamRead()
+  {
+    return true;
+  }
+
+  virtual void ReadPointsBlock(void *buffer, SizeValueType numberOfPoints);
+
+  virtual SizeValueType ReadCellsBlock(void *buffer, SizeValueType bufferSize);
+
+  virtual void ReadPointDataBlock(void *buffer, SizeValueType numberOfPixels);
+
+  virtual void ReadCellDataBlock(void *buffer, SizeValueType numberOfPixels);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
   /** Determine if the file can be written with this MeshIO implementation.
    * \param FileNameToWrite The name of the file to test for writing.
@@ -164,235 +186,132 @@ protected:
     return;
   }
 
+  /** Read the point coordinates, which begin at the current position of
+   * the file */
   template< typename T >
   void ReadPointsBufferAsASCII(std::ifstream & inputFile, T *buffer)
   {
-    std::string line;
-
-    while ( !inputFile.eof() )
-      {
-      std::getline(inputFile, line, '\n');
-
-      if ( line.find("POINTS") != std::string::npos )
-        {
-        /**  Load the point coordinates into the itk::Mesh */
-        SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
-        }
-      }
+    /**  Load the point coordinates into the itk::Mesh */
+    SizeValueType              numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
+    NumericTextParser::Pointer parser = NumericTextParser::New();
+    parser->Read(inputFile, buffer, numberOfComponents);
   }
 
   template< typename T >
   void ReadPointsBufferAsBINARY(std::ifstream & inputFile, T *buffer)
   {
-    std::string line;
-
-    while ( !inputFile.eof() )
+    /**  Load the point coordinates into the itk::Mesh */
+    SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
+    inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
+    if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
       {
-      std::getline(inputFile, line, '\n');
-
-      if ( line.find("POINTS") != std::string::npos )
-        {
-        /**  Load the point coordinates into the itk::Mesh */
-        SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
-        inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
-        if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
-          {
-          itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
-          }
-        }
+      itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
       }
   }
 
+  /** A block of VERTICES, LINES or POLYGONS of the file, and the
+   * position of its indices */
+  struct CellsBlock {
+    MeshIOBase::CellGeometryType CellType;
+    SizeValueType                NumberOfCells;
+    SizeValueType                NumberOfIndices;
+    StreamOffsetType             Position;
+  };
+
   void ReadCellsBufferAsASCII(std::ifstream & inputFile, void *buffer);
 
   void ReadCellsBufferAsBINARY(std::ifstream & inputFile, void *buffer);
 
+  /** Insert the cell types in the cells of a block, which were read at
+   * buffer + block.NumberOfCells */
+  void ExpandCellsBuffer(unsigned int *buffer, const CellsBlock & block);
+
+  /** Move the file past numberOfValues ASCII values, or BINARY values of
+   * valueSize bytes */
+  void SkipValues(std::ifstream & inputFile, SizeValueType numberOfValues, SizeValueType valueSize);
+
+  /** Skip the type line of the point, or cell, data of section, and its
+   * LOOKUP_TABLE line for scalars */
+  void SkipDataHeader(std::ifstream & inputFile, const char *section);
+
+  /** Open the input file, and move it to position */
+  void OpenInputFile(std::ifstream & inputFile, StreamOffsetType position);
+
+  /** Read numberOfValues ASCII, or BINARY, values of componentType from
+   * the current position of the file */
+  void ReadValues(std::ifstream & inputFile, void *buffer, IOComponentType componentType, SizeValueType numberOfValues);
+
   template< typename T >
-  void ReadPointDataBufferAsASCII(std::ifstream & inputFile, T *buffer)
+  void ReadValuesBuffer(std::ifstream & inputFile, T *buffer, SizeValueType numberOfValues)
   {
-    StringType line;
-
-    while ( !inputFile.eof() )
+    if ( this->m_FileType == ASCII )
+      {
+      NumericTextParser::Pointer parser = NumericTextParser::New();
+      parser->Read(inputFile, buffer, numberOfValues);
+      }
+    else
       {
-      std::getline(inputFile, line, '\n');
-      if ( line.find("POINT_DATA") != std::string::npos )
+      inputFile.read( reinterpret_cast< char * >( buffer ), numberOfValues * sizeof( T ) );
+      if ( static_cast< SizeValueType >( inputFile.gcount() ) != numberOfValues * sizeof( T ) )
         {
-        if ( !inputFile.eof() )
-          {
-          std::getline(inputFile, line, '\n');
-          }
-        else
-          {
-          itkExceptionMacro("UnExpected end of line while trying to read POINT_DATA");
-          }
-
-        /** For scalars we have to read the next line of LOOKUP_TABLE */
-        if ( line.find("SCALARS") != std::string::npos && line.find("COLOR_SCALARS") == std::string::npos )
-          {
-          if ( !inputFile.eof() )
-            {
-            std::getline(inputFile, line, '\n');
-            if ( line.find("LOOKUP_TABLE") == std::string::npos )
-              {
-              itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-              }
-            }
-          else
-            {
-            itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-            }
-          }
-
-        /** for VECTORS or NORMALS or TENSORS, we could read them directly */
-        SizeValueType numberOfComponents = this->m_NumberOfPointPixels * this->m_NumberOfPointPixelComponents;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
+        itkExceptionMacro(<< "Unexpected end of file while reading " << this->m_FileName);
+        }
+      if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
+        {
+        itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfValues);
         }
       }
   }
 
+  /** Read the point, or cell, data whose type line begins at the current
+   * position of the file */
   template< typename T >
-  void ReadPointDataBufferAsBINARY(std::ifstream & inputFile, T *buffer)
+  void ReadPointDataBufferAsASCII(std::ifstream & inputFile, T *buffer)
   {
-    StringType line;
+    this->SkipDataHeader(inputFile, "POINT_DATA");
 
-    while ( !inputFile.eof() )
-      {
-      std::getline(inputFile, line, '\n');
-      if ( line.find("POINT_DATA") != std::string::npos )
-        {
-        if ( !inputFile.eof() )
-          {
-          std::getline(inputFile, line, '\n');
-          }
-        else
-          {
-          itkExceptionMacro("UnExpected end of line while trying to read POINT_DATA");
-          }
+    /** for VECTORS or NORMALS or TENSORS, we could read them directly */
+    SizeValueType numberOfComponents = this->m_NumberOfPointPixels * this->m_NumberOfPointPixelComponents;
+    NumericTextParser::Pointer parser = NumericTextParser::New();
+    parser->Read(inputFile, buffer, numberOfComponents);
+  }
 
-        /** For scalars we have to read the next line of LOOKUP_TABLE */
-        if ( line.find("SCALARS") != std::string::npos && line.find("COLOR_SCALARS") == std::string::npos )
-          {
-          if ( !inputFile.eof() )
-            {
-            std::getline(inputFile, line, '\n');
-            if ( line.find("LOOKUP_TABLE") == std::string::npos )
-              {
-              itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-              }
-            }
-          else
-            {
-            itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-            }
-          }
+  template< typename T >
+  void ReadPointDataBufferAsBINARY(std::ifstream & inputFile, T *buffer)
+  {
+    this->SkipDataHeader(inputFile, "POINT_DATA");
 
-        /** for VECTORS or NORMALS or TENSORS, we could read them directly */
-        SizeValueType numberOfComponents = this->m_NumberOfPointPixels * this->m_NumberOfPointPixelComponents;
-        inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
-        if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
-          {
-          itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
-          }
-        }
+    /** for VECTORS or NORMALS or TENSORS, we could read them directly */
+    SizeValueType numberOfComponents = this->m_NumberOfPointPixels * this->m_NumberOfPointPixelComponents;
+    inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
+    if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
+      {
+      itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
       }
   }
 
   template< typename T >
   void ReadCellDataBufferAsASCII(std::ifstream & inputFile, T *buffer)
   {
-    StringType line;
-
-    while ( !inputFile.eof() )
-      {
-      std::getline(inputFile, line, '\n');
-      if ( line.find("CELL_DATA") != std::string::npos )
-        {
-        if ( !inputFile.eof() )
-          {
-          std::getline(inputFile, line, '\n');
-          }
-        else
-          {
-          itkExceptionMacro("UnExpected end of line while trying to read CELL_DATA");
-          }
-
-        /** For scalars we have to read the next line of LOOKUP_TABLE */
-        if ( line.find("SCALARS") != std::string::npos && line.find("COLOR_SCALARS") == std::string::npos )
-          {
-          if ( !inputFile.eof() )
-            {
-            std::getline(inputFile, line, '\n');
-            if ( line.find("LOOKUP_TABLE") == std::string::npos )
-              {
-              itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-              }
-            }
-          else
-            {
-            itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-            }
-          }
+    this->SkipDataHeader(inputFile, "CELL_DATA");
 
-        /** for VECTORS or NORMALS or TENSORS, we could read them directly */
-        SizeValueType numberOfComponents = this->m_NumberOfCellPixels * this->m_NumberOfCellPixelComponents;
-        for ( SizeValueType ii = 0; ii < numberOfComponents; ii++ )
-          {
-          inputFile >> buffer[ii];
-          }
-        }
-      }
+    /** for VECTORS or NORMALS or TENSORS, we could read them directly */
+    SizeValueType numberOfComponents = this->m_NumberOfCellPixels * this->m_NumberOfCellPixelComponents;
+    NumericTextParser::Pointer parser = NumericTextParser::New();
+    parser->Read(inputFile, buffer, numberOfComponents);
   }
 
   template< typename T >
   void ReadCellDataBufferAsBINARY(std::ifstream & inputFile, T *buffer)
   {
-    StringType line;
+    this->SkipDataHeader(inputFile, "CELL_DATA");
 
-    while ( !inputFile.eof() )
+    /** for VECTORS or NORMALS or TENSORS, we could read them directly */
+    SizeValueType numberOfComponents = this->m_NumberOfCellPixels * this->m_NumberOfCellPixelComponents;
+    inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
+    if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
       {
-      std::getline(inputFile, line, '\n');
-      if ( line.find("POINT_DATA") != std::string::npos )
-        {
-        if ( !inputFile.eof() )
-          {
-          std::getline(inputFile, line, '\n');
-          }
-        else
-          {
-          itkExceptionMacro("UnExpected end of line while trying to read POINT_DATA");
-          }
-
-        /** For scalars we have to read the next line of LOOKUP_TABLE */
-        if ( line.find("SCALARS") != std::string::npos && line.find("COLOR_SCALARS") == std::string::npos )
-          {
-          if ( !inputFile.eof() )
-            {
-            std::getline(inputFile, line, '\n');
-            if ( line.find("LOOKUP_TABLE") == std::string::npos )
-              {
-              itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-              }
-            }
-          else
-            {
-            itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
-            }
-          }
-        /** For VECTORS or NORMALS or TENSORS, we could read them directly */
-        SizeValueType numberOfComponents = this->m_NumberOfCellPixels * this->m_NumberOfCellPixelComponents;
-        inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
-        if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
-          {
-          itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
-          }
-        }
+      itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
       }
   }
 
@@ -587,7 +506,7 @@ protected:
       ExposeMetaData< unsigned int >(metaDic, "numberOfVertexIndices", numberOfVertexIndices);
       outputFile << "VERTICES " << numberOfVertices << " " << numberOfVertexIndices << '\n';
       unsigned int *data  = new unsigned int[numberOfVertexIndices];
-      ReadCellsBuffer(buffer, data);
+      ReadCellsBuffer(buffer, data, VERTEX_CELL);
       itk::ByteSwapper< unsigned int >::SwapWriteRangeFromSystemToBigEndian(data, numberOfVertexIndices, &outputFile);
       outputFile << "\n";
       delete[] data;
@@ -677,7 +596,7 @@ protected:
       ExposeMetaData< unsigned int >(metaDic, "numberOfPolygonIndices", numberOfPolygonIndices);
       outputFile << "POLYGONS " << numberOfPolygons << " " << numberOfPolygonIndices << '\n';
       unsigned int *data  = new unsigned int[numberOfPolygonIndices];
-      ReadCellsBuffer(buffer, data);
+      ReadCellsBuffer(buffer, data, POLYGON_CELL);
       itk::ByteSwapper< unsigned int >::SwapWriteRangeFromSystemToBigEndian(data, numberOfPolygonIndices, &outputFile);
       outputFile << "\n";
       delete[] data;
@@ -1138,9 +1057,60 @@ protected:
       }
   }
 
+  /** Convert the cells of the VERTICES (VERTEX_CELL) or POLYGONS
+  (POLYGON_CELL) section for output cells buffer. Triangles and
+  quadrilaterals are written as polygons */
+  template< typename TInput, typename TOutput >
+  void ReadCellsBuffer(TInput *input, TOutput *output, MeshIOBase::CellGeometryType sectionType)
+  {
+    SizeValueType inputIndex = 0;
+    SizeValueType outputIndex = 0;
+
+    if ( input && output )
+      {
+      for ( SizeValueType ii = 0; ii < this->m_NumberOfCells; ii++ )
+        {
+        MeshIOBase::CellGeometryType cellType = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( input[inputIndex++] ) );
+        unsigned int                 nn = static_cast< unsigned int >( input[inputIndex++] );
+        if ( cellType == TRIANGLE_CELL || cellType == QUADRILATERAL_CELL )
+          {
+          cellType = POLYGON_CELL;
+          }
+        if ( cellType == sectionType )
+          {
+          output[outputIndex++] = nn;
+          for ( unsigned int jj = 0; jj < nn; jj++ )
+            {
+            output[outputIndex++] = static_cast< TOutput >( input[inputIndex++] );
+            }
+          }
+        else
+          {
+          inputIndex += nn;
+          }
+        }
+      }
+  }
+
 private:
   VTKPolyDataMeshIO(const Self &); // purposely not implemented
   void operator=(const Self &);    // purposely not implemented
+
+  StreamOffsetType          m_PointsStartPosition;    // file position of the point coordinates
+  StreamOffsetType          m_PointDataStartPosition; // file position of the line after POINT_DATA
+  StreamOffsetType          m_CellDataStartPosition;  // file position of the line after CELL_DATA
+  std::vector< CellsBlock > m_CellsBlocks;
+
+  /** Where the next blocks of a streamed read begin. The data positions
+   * are zero until the data header has been read. */
+  StreamOffsetType            m_PointsPosition;
+  StreamOffsetType            m_PointDataPosition;
+  StreamOffsetType            m_CellDataPosition;
+  StreamOffsetType            m_CellsPosition;
+  SizeValueType               m_CellsBlockIndex;   // the cells block being read
+  SizeValueType               m_CellsIndicesLeft;  // its indices not read yet
+  std::vector< unsigned int > m_CellsIndices;      // indices read but not returned yet
+  SizeValueType               m_CellsIndicesIndex; // the first of them
 };
 } // end namespace itk
 
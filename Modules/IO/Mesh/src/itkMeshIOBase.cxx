@@ -73,6 +73,63 @@ MeshIOBase
   this->m_SupportedWriteExtensions.push_back(extension);
 }
 
+void
+MeshIOBase
+::ReadPointsBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPoints))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed reading");
+}
+
+MeshIOBase::SizeValueType
+MeshIOBase
+::ReadCellsBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(bufferSize))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed reading");
+  return 0;
+}
+
+void
+MeshIOBase
+::ReadPointDataBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPixels))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed reading");
+}
+
+void
+MeshIOBase
+::ReadCellDataBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPixels))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed reading");
+}
+
+void
+MeshIOBase
+::WritePointsBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPoints))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed writing");
+}
+
+void
+MeshIOBase
+::WriteCellsBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfCells), SizeValueType itkNotUsed(bufferSize))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed writing");
+}
+
+void
+MeshIOBase
+::WritePointDataBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPixels))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed writing");
+}
+
+void
+MeshIOBase
+::WriteCellDataBlock(void *itkNotUsed(buffer), SizeValueType itkNotUsed(numberOfPixels))
+{
+  itkExceptionMacro(<< this->GetNameOfClass() << " does not support streamed writing");
+}
+
 unsigned int
 MeshIOBase
 ::GetComponentSize(IOComponentType componentType) const
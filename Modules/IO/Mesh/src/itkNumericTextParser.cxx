@@ -0,0 +1,497 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkNumericTextParser.h"
+#include <algorithm>
+#include <clocale>
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+// powers of ten which are exact doubles
+const double ExactPowersOfTen[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MaximumExactExponent = 22;
+
+// largest integer below which all the integers are exact doubles
+const unsigned long long MaximumExactMantissa = 1ULL << 53;
+
+const int MaximumNumberOfDigits = 19;
+
+bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+const char * TokenEnd(const char *text, const char *end)
+{
+  while ( text != end && !NumericTextParser::IsSpace(*text) )
+    {
+    ++text;
+    }
+  return text;
+}
+
+// convert a token which the fast path did not handle, with the C
+// library when its locale uses a '.' decimal point
+template< typename T >
+bool ParseToken(const char *begin, const char *end, T & value)
+{
+  const std::string token(begin, end);
+  const struct lconv *conv = std::localeconv();
+  if ( conv && conv->decimal_point && std::string(conv->decimal_point) == "." )
+    {
+    char *last = 0;
+    const T v = ( sizeof( T ) > sizeof( double ) ) ?
+      static_cast< T >( strtold(token.c_str(), &last) ) :
+      static_cast< T >( strtod(token.c_str(), &last) );
+    if ( last != token.c_str() + token.size() )
+      {
+      return false;
+      }
+    value = v;
+    return true;
+    }
+
+  std::istringstream stream(token);
+  stream.imbue( std::locale::classic() );
+  T v;
+  stream >> v;
+  if ( stream.fail() || stream.peek() != std::istringstream::traits_type::eof() )
+    {
+    return false;
+    }
+  value = v;
+  return true;
+}
+}
+
+NumericTextParser::NumericTextParser()
+{
+  m_ChunkSize = 1 << 20;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_Buffer = 0;
+  m_ValueSize = 0;
+  m_Parse = 0;
+}
+
+bool
+NumericTextParser
+::ParseInteger(const char * & text, const char *end, long long & value)
+{
+  const char *p = text;
+  while ( p != end && IsSpace(*p) )
+    {
+    ++p;
+    }
+  bool negative = false;
+  if ( p != end && ( *p == '-' || *p == '+' ) )
+    {
+    negative = ( *p == '-' );
+    ++p;
+    }
+  if ( p == end || !IsDigit(*p) )
+    {
+    return false;
+    }
+  unsigned long long v = 0;
+  while ( p != end && IsDigit(*p) )
+    {
+    v = v * 10 + static_cast< unsigned long long >( *p - '0' );
+    ++p;
+    }
+  if ( p != end && !IsSpace(*p) )
+    {
+    return false;
+    }
+  value = negative ? -static_cast< long long >( v ) : static_cast< long long >( v );
+  text = p;
+  return true;
+}
+
+bool
+NumericTextParser
+::ParseReal(const char * & text, const char *end, double & value)
+{
+  const char *p = text;
+  while ( p != end && IsSpace(*p) )
+    {
+    ++p;
+    }
+  const char *begin = p;
+
+  bool negative = false;
+  if ( p != end && ( *p == '-' || *p == '+' ) )
+    {
+    negative = ( *p == '-' );
+    ++p;
+    }
+
+  // the significant digits are accumulated in mantissa, the value is
+  // mantissa * 10^exponent
+  unsigned long long mantissa = 0;
+  int                numberOfDigits = 0;
+  int                exponent = 0;
+  bool               hasDigits = false;
+  bool               exact = true;
+  while ( p != end && IsDigit(*p) )
+    {
+    hasDigits = true;
+    if ( numberOfDigits < MaximumNumberOfDigits )
+      {
+      mantissa = mantissa * 10 + static_cast< unsigned long long >( *p - '0' );
+      if ( mantissa )
+        {
+        ++numberOfDigits;
+        }
+      }
+    else
+      {
+      exact = false;
+      }
+    ++p;
+    }
+  if ( p != end && *p == '.' )
+    {
+    ++p;
+    while ( p != end && IsDigit(*p) )
+      {
+      hasDigits = true;
+      if ( numberOfDigits < MaximumNumberOfDigits )
+        {
+        mantissa = mantissa * 10 + static_cast< unsigned long long >( *p - '0' );
+        if ( mantissa )
+          {
+          ++numberOfDigits;
+          }
+        --exponent;
+        }
+      else
+        {
+        exact = false;
+        }
+      ++p;
+      }
+    }
+  if ( hasDigits && p != end && ( *p == 'e' || *p == 'E' ) )
+    {
+    ++p;
+    bool negativeExponent = false;
+    if ( p != end && ( *p == '-' || *p == '+' ) )
+      {
+      negativeExponent = ( *p == '-' );
+      ++p;
+      }
+    if ( p == end || !IsDigit(*p) )
+      {
+      hasDigits = false;
+      }
+    int e = 0;
+    while ( p != end && IsDigit(*p) )
+      {
+      if ( e < 100000 )
+        {
+        e = e * 10 + ( *p - '0' );
+        }
+      ++p;
+      }
+    exponent += negativeExponent ? -e : e;
+    }
+
+  if ( hasDigits && exact && ( p == end || IsSpace(*p) )
+       && mantissa <= MaximumExactMantissa
+       && exponent >= -MaximumExactExponent && exponent <= MaximumExactExponent )
+    {
+    // a single correctly rounded operation on exact values
+    double v = static_cast< double >( mantissa );
+    if ( exponent < 0 )
+      {
+      v /= ExactPowersOfTen[-exponent];
+      }
+    else
+      {
+      v *= ExactPowersOfTen[exponent];
+      }
+    value = negative ? -v : v;
+    text = p;
+    return true;
+    }
+
+  const char *last = TokenEnd(begin, end);
+  if ( last == begin || !ParseToken(begin, last, value) )
+    {
+    return false;
+    }
+  text = last;
+  return true;
+}
+
+bool
+NumericTextParser
+::ParseLongDouble(const char * & text, const char *end, long double & value)
+{
+  const char *begin = text;
+  while ( begin != end && IsSpace(*begin) )
+    {
+    ++begin;
+    }
+  const char *last = TokenEnd(begin, end);
+  if ( last == begin || !ParseToken(begin, last, value) )
+    {
+    return false;
+    }
+  text = last;
+  return true;
+}
+
+void
+NumericTextParser
+::ReadValues(std::istream & stream, void *buffer, SizeValueType valueSize,
+             SizeValueType numberOfValues, ParseValuesFunction parse)
+{
+  if ( numberOfValues == 0 )
+    {
+    return;
+    }
+
+  m_Buffer = static_cast< char * >( buffer );
+  m_ValueSize = valueSize;
+  m_Parse = parse;
+
+  // the text is read by waves of one chunk per thread, the bytes after
+  // the last whitespace of a wave may be the beginning of a value,
+  // they are carried to the next wave
+  const SizeValueType waveSize = m_ChunkSize * m_NumberOfThreads;
+  std::streamoff      waveStart = stream.tellg();
+  SizeValueType       carry = 0;
+  SizeValueType       numberOfParsedValues = 0;
+  while ( true )
+    {
+    m_Text.resize(carry + waveSize);
+    stream.read(&m_Text[carry], waveSize);
+    const SizeValueType size = carry + static_cast< SizeValueType >( stream.gcount() );
+    const bool          atEnd = ( size < carry + waveSize );
+
+    SizeValueType length = size;
+    if ( !atEnd )
+      {
+      while ( length > 0 && !IsSpace(m_Text[length - 1]) )
+        {
+        --length;
+        }
+      if ( length == 0 )
+        {
+        // a single token longer than the wave
+        carry = size;
+        continue;
+        }
+      }
+
+    m_ChunkBegins.clear();
+    m_ChunkEnds.clear();
+    for ( SizeValueType begin = 0; begin < length; )
+      {
+      SizeValueType chunkEnd = std::min(begin + m_ChunkSize, length);
+      while ( chunkEnd < length && !IsSpace(m_Text[chunkEnd]) )
+        {
+        ++chunkEnd;
+        }
+      m_ChunkBegins.push_back(begin);
+      m_ChunkEnds.push_back(chunkEnd);
+      begin = chunkEnd;
+      }
+    const SizeValueType numberOfChunks = m_ChunkBegins.size();
+
+    m_ChunkCounts.assign(numberOfChunks, 0);
+    this->ExecuteOnChunks(Self::CountThreaderCallback);
+
+    // assign to every chunk the place of its values in the buffer
+    m_ChunkOffsets.assign(numberOfChunks, 0);
+    m_ChunkValues.assign(numberOfChunks, 0);
+    m_ChunkLasts.assign(numberOfChunks, 0);
+    m_ChunkSucceeded.assign(numberOfChunks, 1);
+    SizeValueType lastChunk = numberOfChunks;
+    for ( SizeValueType c = 0; c < numberOfChunks; ++c )
+      {
+      m_ChunkOffsets[c] = numberOfParsedValues;
+      m_ChunkValues[c] = std::min(m_ChunkCounts[c], numberOfValues - numberOfParsedValues);
+      numberOfParsedValues += m_ChunkValues[c];
+      if ( numberOfParsedValues == numberOfValues && lastChunk == numberOfChunks && m_ChunkValues[c] )
+        {
+        lastChunk = c;
+        }
+      }
+
+    if ( m_Parse )
+      {
+      this->ExecuteOnChunks(Self::ParseThreaderCallback);
+      for ( SizeValueType c = 0; c < numberOfChunks; ++c )
+        {
+        if ( !m_ChunkSucceeded[c] )
+          {
+          m_Text.clear();
+          itkExceptionMacro(<< "Invalid number in the text between values "
+                            << m_ChunkOffsets[c] << " and " << m_ChunkOffsets[c] + m_ChunkValues[c]);
+          }
+        }
+      }
+    else if ( lastChunk != numberOfChunks )
+      {
+      this->ParseChunk(lastChunk);
+      }
+
+    if ( lastChunk != numberOfChunks )
+      {
+      // leave the stream right after the last value
+      stream.clear();
+      stream.seekg(waveStart + static_cast< std::streamoff >( m_ChunkLasts[lastChunk] ), std::ios::beg);
+      m_Text.clear();
+      return;
+      }
+
+    if ( atEnd )
+      {
+      m_Text.clear();
+      itkExceptionMacro(<< "Unexpected end of file after " << numberOfParsedValues
+                        << " of " << numberOfValues << " values");
+      }
+
+    std::copy(m_Text.begin() + length, m_Text.begin() + size, m_Text.begin());
+    carry = size - length;
+    waveStart += static_cast< std::streamoff >( length );
+    }
+}
+
+void
+NumericTextParser
+::ExecuteOnChunks(ThreadFunctionType callback)
+{
+  const SizeValueType numberOfChunks = m_ChunkBegins.size();
+  if ( numberOfChunks == 1 )
+    {
+    MultiThreader::ThreadInfoStruct info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = this;
+    ( *callback )( &info );
+    return;
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min( static_cast< SizeValueType >( m_NumberOfThreads ), numberOfChunks ) ) );
+  threader->SetSingleMethod(callback, this);
+  threader->SingleMethodExecute();
+}
+
+ITK_THREAD_RETURN_TYPE
+NumericTextParser
+::CountThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfChunks = self->m_ChunkBegins.size();
+  for ( SizeValueType c = info->ThreadID; c < numberOfChunks; c += info->NumberOfThreads )
+    {
+    self->CountChunk(c);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE
+NumericTextParser
+::ParseThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfChunks = self->m_ChunkBegins.size();
+  for ( SizeValueType c = info->ThreadID; c < numberOfChunks; c += info->NumberOfThreads )
+    {
+    if ( self->m_ChunkValues[c] )
+      {
+      self->ParseChunk(c);
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+NumericTextParser
+::CountChunk(SizeValueType chunk)
+{
+  const char *text = &m_Text[0];
+  bool        inToken = false;
+  SizeValueType count = 0;
+  for ( SizeValueType i = m_ChunkBegins[chunk]; i < m_ChunkEnds[chunk]; ++i )
+    {
+    if ( IsSpace(text[i]) )
+      {
+      inToken = false;
+      }
+    else if ( !inToken )
+      {
+      inToken = true;
+      ++count;
+      }
+    }
+  m_ChunkCounts[chunk] = count;
+}
+
+void
+NumericTextParser
+::ParseChunk(SizeValueType chunk)
+{
+  const char *text = &m_Text[0];
+  const char *begin = text + m_ChunkBegins[chunk];
+  const char *end = text + m_ChunkEnds[chunk];
+  const char *last = begin;
+  if ( m_Parse )
+    {
+    m_ChunkSucceeded[chunk] =
+      ( *m_Parse )(begin, end, m_Buffer + m_ChunkOffsets[chunk] * m_ValueSize, m_ChunkValues[chunk], last);
+    }
+  else
+    {
+    for ( SizeValueType i = 0; i < m_ChunkValues[chunk]; ++i )
+      {
+      while ( last != end && IsSpace(*last) )
+        {
+        ++last;
+        }
+      last = TokenEnd(last, end);
+      }
+    }
+  m_ChunkLasts[chunk] = last - text;
+}
+
+void
+NumericTextParser
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ChunkSize: " << m_ChunkSize << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+}
+} // end namespace itk
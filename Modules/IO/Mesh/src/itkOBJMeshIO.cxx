@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkOBJMeshIO.h"
+#include "itkNumericTextParser.h"
 #include "itkNumericTraits.h"
 #include <itksys/SystemTools.hxx>
 #include  <locale>
@@ -141,11 +142,16 @@ OBJMeshIO
         {
         this->m_NumberOfCells++;
 
-        std::stringstream ss(inputLine);
-        std::string       item;
-        while ( ss >> item )
+        const char *text = inputLine.c_str();
+        const char *end = text + inputLine.size();
+        while ( text != end )
           {
-          numberOfCellPoints++;
+          if ( !NumericTextParser::IsSpace(*text) && ( text == inputLine.c_str()
+                                                       || NumericTextParser::IsSpace(*( text - 1 ) ) ) )
+            {
+            numberOfCellPoints++;
+            }
+          ++text;
           }
         }
       else if ( type == "vn" )
@@ -234,10 +240,13 @@ OBJMeshIO
       {
       if ( type == "v" )
         {
-        std::stringstream ss(inputLine);
+        const char *text = inputLine.c_str();
+        const char *end = text + inputLine.size();
         for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
           {
-          ss >> data[index++];
+          float value = 0.0f;
+          NumericTextParser::ParseValue(text, end, value);
+          data[index++] = value;
           }
         }
       }
@@ -280,23 +289,33 @@ OBJMeshIO
       {
       if ( type == "f" )
         {
-        std::stringstream   ss(inputLine);
-        std::string         item;
+        // only the vertex index is kept from the vertex/texture/normal
+        // indices
+        const char *        text = inputLine.c_str();
+        const char *        end = text + inputLine.size();
         std::vector< long > idList;
-        while ( ss >> item )
+        while ( true )
           {
-          long                   id;
-          std::string::size_type pos = item.find('/');
-          while ( pos != std::string::npos )
+          while ( text != end && NumericTextParser::IsSpace(*text) )
             {
-            item.replace(pos, 1, " ");
-            pos = item.find('/', pos);
+            ++text;
             }
-
-          std::stringstream st(item);
-          st >> id;
-
+          if ( text == end )
+            {
+            break;
+            }
+          const char *idEnd = text;
+          while ( idEnd != end && *idEnd != '/' && !NumericTextParser::IsSpace(*idEnd) )
+            {
+            ++idEnd;
+            }
+          long id = 0;
+          NumericTextParser::ParseValue(text, idEnd, id);
           idList.push_back(id);
+          while ( text != end && !NumericTextParser::IsSpace(*text) )
+            {
+            ++text;
+            }
           }
 
         data[index++] = idList.size();
@@ -351,10 +370,13 @@ OBJMeshIO
       {
       if ( type == "vn" )
         {
-        std::stringstream ss(inputLine);
+        const char *text = inputLine.c_str();
+        const char *end = text + inputLine.size();
         for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
           {
-          ss >> data[index++];
+          float value = 0.0f;
+          NumericTextParser::ParseValue(text, end, value);
+          data[index++] = value;
           }
         }
       }
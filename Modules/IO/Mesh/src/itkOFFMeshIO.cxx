@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkOFFMeshIO.h"
+#include "itkNumericTextParser.h"
 
 #include <itksys/SystemTools.hxx>
 
@@ -140,11 +141,14 @@ OFFMeshIO
     this->m_PointDimension = 3;
     }
 
-  // Ignore comment lines
-  std::getline(m_InputFile, line, '\n');
-  while ( line.find("#") != std::string::npos )
+  // Ignore comment lines, the counts of binary files follow the header
+  if ( this->m_FileType == ASCII )
     {
     std::getline(m_InputFile, line, '\n');
+    while ( line.find("#") != std::string::npos )
+      {
+      std::getline(m_InputFile, line, '\n');
+      }
     }
 
   // Read points and cells information
@@ -276,7 +280,8 @@ OFFMeshIO
   // Read file according to ASCII or BINARY
   if ( this->m_FileType == ASCII )
     {
-    this->ReadBufferAsAscii(static_cast< float * >( buffer ), m_InputFile, this->m_NumberOfPoints * this->m_PointDimension);
+    NumericTextParser::Pointer parser = NumericTextParser::New();
+    parser->Read(m_InputFile, static_cast< float * >( buffer ), this->m_NumberOfPoints * this->m_PointDimension);
     }
   else if ( this->m_FileType == BINARY )
     {
@@ -369,7 +374,14 @@ OFFMeshIO
     }
 
   // Write Object file format header
-  outputFile << "OFF " << std::endl;
+  if ( this->m_FileType == BINARY )
+    {
+    outputFile << "OFF BINARY" << std::endl;
+    }
+  else
+    {
+    outputFile << "OFF " << std::endl;
+    }
 
   //Read points and cells information
   if ( this->m_FileType == ASCII )
@@ -405,6 +417,13 @@ OFFMeshIO
 void
 OFFMeshIO
 ::WritePoints(void *buffer)
+{
+  this->WritePointsBlock(buffer, this->m_NumberOfPoints);
+}
+
+void
+OFFMeshIO
+::WritePointsBlock(void *buffer, SizeValueType numberOfPoints)
 {
   // check file name
   if ( this->m_FileName == "" )
@@ -438,78 +457,78 @@ OFFMeshIO
       {
       case UCHAR:
         {
-        WriteBufferAsAscii(static_cast< unsigned char * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< unsigned char * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
         break;
         }
       case CHAR:
         {
-        WriteBufferAsAscii(static_cast< char * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< char * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case USHORT:
         {
-        WriteBufferAsAscii(static_cast< unsigned short * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< unsigned short * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case SHORT:
         {
-        WriteBufferAsAscii(static_cast< short * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< short * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case UINT:
         {
-        WriteBufferAsAscii(static_cast< unsigned int * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< unsigned int * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case INT:
         {
-        WriteBufferAsAscii(static_cast< int * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< int * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case ULONG:
         {
-        WriteBufferAsAscii(static_cast< unsigned long * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< unsigned long * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case LONG:
         {
-        WriteBufferAsAscii(static_cast< long * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< long * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case ULONGLONG:
         {
-        WriteBufferAsAscii(static_cast< unsigned long long * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< unsigned long long * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case LONGLONG:
         {
-        WriteBufferAsAscii(static_cast< long long * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< long long * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case FLOAT:
         {
-        WriteBufferAsAscii(static_cast< float * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< float * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case DOUBLE:
         {
-        WriteBufferAsAscii(static_cast< double * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< double * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
       case LDOUBLE:
         {
-        WriteBufferAsAscii(static_cast< long double * >( buffer ), outputFile, m_NumberOfPoints, m_PointDimension);
+        WriteBufferAsAscii(static_cast< long double * >( buffer ), outputFile, numberOfPoints, m_PointDimension);
 
         break;
         }
@@ -525,78 +544,78 @@ OFFMeshIO
       {
       case UCHAR:
         {
-        WriteBufferAsBinary< float >(static_cast< unsigned char * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< unsigned char * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
         break;
         }
       case CHAR:
         {
-        WriteBufferAsBinary< float >(static_cast< char * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< char * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case USHORT:
         {
-        WriteBufferAsBinary< float >(static_cast< unsigned short * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< unsigned short * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case SHORT:
         {
-        WriteBufferAsBinary< float >(static_cast< short * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< short * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case UINT:
         {
-        WriteBufferAsBinary< float >(static_cast< unsigned int * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< unsigned int * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case INT:
         {
-        WriteBufferAsBinary< float >(static_cast< int * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< int * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case ULONG:
         {
-        WriteBufferAsBinary< float >(static_cast< unsigned long * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< unsigned long * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case LONG:
         {
-        WriteBufferAsBinary< float >(static_cast< long * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< long * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case ULONGLONG:
         {
-        WriteBufferAsBinary< float >(static_cast< unsigned long long * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< unsigned long long * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case LONGLONG:
         {
-        WriteBufferAsBinary< float >(static_cast< long long * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< long long * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case FLOAT:
         {
-        WriteBufferAsBinary< float >(static_cast< float * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< float * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case DOUBLE:
         {
-        WriteBufferAsBinary< float >(static_cast< double * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< double * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
       case LDOUBLE:
         {
-        WriteBufferAsBinary< float >(static_cast< long double * >( buffer ), outputFile, m_NumberOfPoints * m_PointDimension);
+        WriteBufferAsBinary< float >(static_cast< long double * >( buffer ), outputFile, numberOfPoints * m_PointDimension);
 
         break;
         }
@@ -614,6 +633,13 @@ OFFMeshIO
 void
 OFFMeshIO
 ::WriteCells(void *buffer)
+{
+  this->WriteCellsBlock(buffer, this->m_NumberOfCells, this->m_CellBufferSize);
+}
+
+void
+OFFMeshIO
+::WriteCellsBlock(void *buffer, SizeValueType numberOfCells, SizeValueType bufferSize)
 {
   // Check file name
   if ( this->m_FileName == "" )
@@ -647,79 +673,79 @@ OFFMeshIO
       {
       case UCHAR:
         {
-        WriteCellsAsAscii(static_cast< unsigned char * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< unsigned char * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case CHAR:
         {
-        WriteCellsAsAscii(static_cast< unsigned char * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< unsigned char * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case USHORT:
         {
-        WriteCellsAsAscii(static_cast< unsigned short * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< unsigned short * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case SHORT:
         {
-        WriteCellsAsAscii(static_cast< short * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< short * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case UINT:
         {
-        WriteCellsAsAscii(static_cast< unsigned int * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< unsigned int * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case INT:
         {
-        WriteCellsAsAscii(static_cast< int * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< int * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case ULONG:
         {
-        WriteCellsAsAscii(static_cast< long * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< long * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case LONG:
         {
-        WriteCellsAsAscii(static_cast< long * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< long * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case ULONGLONG:
         {
-        WriteCellsAsAscii(static_cast< unsigned long long * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< unsigned long long * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case LONGLONG:
         {
-        WriteCellsAsAscii(static_cast< long long * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< long long * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case FLOAT:
         {
-        WriteCellsAsAscii(static_cast< float * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< float * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case DOUBLE:
         {
-        WriteCellsAsAscii(static_cast< double * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< double * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
       case LDOUBLE:
         {
-        WriteCellsAsAscii(static_cast< long double * >( buffer ), outputFile);
+        WriteCellsAsAscii(static_cast< long double * >( buffer ), outputFile, numberOfCells);
 
         break;
         }
@@ -735,79 +761,79 @@ OFFMeshIO
       {
       case UCHAR:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned char * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned char * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case CHAR:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< char * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< char * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case USHORT:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned short * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned short * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case SHORT:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< short * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< short * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case UINT:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned int * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned int * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case INT:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< int * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< int * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case ULONG:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< long * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< long * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case LONG:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< long * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< long * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case ULONGLONG:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned long long * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< unsigned long long * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case LONGLONG:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< long long * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< long long * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case FLOAT:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< float * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< float * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case DOUBLE:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< double * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< double * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
       case LDOUBLE:
         {
-        WriteCellsAsBinary< itk::uint32_t >(static_cast< long double * >( buffer ), outputFile);
+        WriteCellsAsBinary< itk::uint32_t >(static_cast< long double * >( buffer ), outputFile, numberOfCells, bufferSize);
 
         break;
         }
@@ -837,6 +863,20 @@ OFFMeshIO
   return;
 }
 
+void
+OFFMeshIO
+::WritePointDataBlock(void * itkNotUsed( buffer ), SizeValueType itkNotUsed( numberOfPixels ) )
+{
+  return;
+}
+
+void
+OFFMeshIO
+::WriteCellDataBlock(void * itkNotUsed( buffer ), SizeValueType itkNotUsed( numberOfPixels ) )
+{
+  return;
+}
+
 void
 OFFMeshIO
 ::Write()
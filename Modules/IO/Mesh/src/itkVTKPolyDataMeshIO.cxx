@@ -19,6 +19,7 @@
 #include "itkVTKPolyDataMeshIO.h"
 
 #include <itksys/SystemTools.hxx>
+#include <algorithm>
 #include <fstream>
 
 namespace itk
@@ -29,6 +30,16 @@ VTKPolyDataMeshIO
 {
   this->AddSupportedWriteExtension(".vtk");
   this->m_ByteOrder = BigEndian;
+  this->m_PointsStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_PointDataStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellDataStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_PointsPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_PointDataPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellDataPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellsPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellsBlockIndex = 0;
+  this->m_CellsIndicesLeft = 0;
+  this->m_CellsIndicesIndex = 0;
 
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
   EncapsulateMetaData< StringType >(metaDic, "pointScalarDataName", "PointScalarData");
@@ -147,6 +158,10 @@ VTKPolyDataMeshIO
   // Initialize number of cells
   this->m_NumberOfCells  = itk::NumericTraits<SizeValueType>::Zero;
   this->m_CellBufferSize = itk::NumericTraits<SizeValueType>::Zero;
+  this->m_PointsStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_PointDataStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellDataStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellsBlocks.clear();
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
 
   // Searching the vtk file
@@ -234,6 +249,11 @@ VTKPolyDataMeshIO
         }
 
       this->m_UpdatePoints = true;
+
+      // Skip the point coordinates, they are read by ReadPoints()
+      this->m_PointsStartPosition = inputFile.tellg();
+      this->SkipValues(inputFile, this->m_NumberOfPoints * this->m_PointDimension,
+                       this->GetComponentSize(this->m_PointComponentType));
       }
     else if ( line.find("VERTICES") != std::string::npos )
       {
@@ -273,6 +293,15 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      // Skip the cells, they are read by ReadCells()
+      CellsBlock block;
+      block.CellType = VERTEX_CELL;
+      block.NumberOfCells = numberOfVertices;
+      block.NumberOfIndices = numberOfVertexIndices;
+      block.Position = inputFile.tellg();
+      this->m_CellsBlocks.push_back(block);
+      this->SkipValues( inputFile, numberOfVertexIndices, sizeof( unsigned int ) );
       }
     else if ( line.find("LINES") != std::string::npos )
       {
@@ -312,6 +341,15 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      // Skip the cells, they are read by ReadCells()
+      CellsBlock block;
+      block.CellType = LINE_CELL;
+      block.NumberOfCells = numberOfLines;
+      block.NumberOfIndices = numberOfLineIndices;
+      block.Position = inputFile.tellg();
+      this->m_CellsBlocks.push_back(block);
+      this->SkipValues( inputFile, numberOfLineIndices, sizeof( unsigned int ) );
       }
     else if ( line.find("POLYGONS") != std::string::npos )
       {
@@ -351,6 +389,15 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      // Skip the cells, they are read by ReadCells()
+      CellsBlock block;
+      block.CellType = POLYGON_CELL;
+      block.NumberOfCells = numberOfPolygons;
+      block.NumberOfIndices = numberOfPolygonIndices;
+      block.Position = inputFile.tellg();
+      this->m_CellsBlocks.push_back(block);
+      this->SkipValues( inputFile, numberOfPolygonIndices, sizeof( unsigned int ) );
       }
     else if ( line.find("POINT_DATA") != std::string::npos )
       {
@@ -365,6 +412,7 @@ VTKPolyDataMeshIO
       pdss >> this->m_NumberOfPointPixels;
 
       // Continue to read line and get data type
+      this->m_PointDataStartPosition = inputFile.tellg();
       if ( !inputFile.eof() )
         {
         std::getline(inputFile, line, '\n');
@@ -662,6 +710,7 @@ VTKPolyDataMeshIO
       cdss >> this->m_NumberOfCellPixels;
 
       // Continue to read line and get data type
+      this->m_CellDataStartPosition = inputFile.tellg();
       if ( !inputFile.eof() )
         {
         std::getline(inputFile, line, '\n');
@@ -945,6 +994,16 @@ VTKPolyDataMeshIO
     this->m_CellBufferSize += this->m_NumberOfCells;
     }
 
+  // The streamed reads start at the beginning of every part
+  this->m_PointsPosition = this->m_PointsStartPosition;
+  this->m_PointDataPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellDataPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  this->m_CellsBlockIndex = 0;
+  this->m_CellsIndicesLeft = this->m_CellsBlocks.empty() ? 0 : this->m_CellsBlocks[0].NumberOfIndices;
+  this->m_CellsPosition = this->m_CellsBlocks.empty() ? 0 : this->m_CellsBlocks[0].Position;
+  this->m_CellsIndices.clear();
+  this->m_CellsIndicesIndex = 0;
+
   inputFile.close();
 }
 
@@ -970,6 +1029,7 @@ VTKPolyDataMeshIO
     itkExceptionMacro("Unable to open file\n" "inputFilename= " << this->m_FileName);
     return;
     }
+  inputFile.seekg(this->m_PointsStartPosition, std::ios::beg);
 
   // Read points according to filetype as ASCII or BINARY
   if ( this->m_FileType == ASCII )
@@ -1199,151 +1259,351 @@ VTKPolyDataMeshIO
 
 void VTKPolyDataMeshIO::ReadCellsBufferAsASCII(std::ifstream & inputFile, void *buffer)
 {
-  std::string   line;
-  SizeValueType index = 0;
-  unsigned int  numPoints; // number of point in each cell
+  unsigned int *             data = static_cast< unsigned int * >( buffer );
+  NumericTextParser::Pointer parser = NumericTextParser::New();
 
-  MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
-  unsigned int *       data = static_cast< unsigned int * >( buffer );
-
-  while ( !inputFile.eof() )
+  // The indices of each block are parsed at the end of its part of the
+  // buffer, then moved in front to insert the cell types
+  for ( std::vector< CellsBlock >::const_iterator block = this->m_CellsBlocks.begin();
+        block != this->m_CellsBlocks.end(); ++block )
     {
-    std::getline(inputFile, line, '\n');
-    if ( line.find("VERTICES") != std::string::npos )
-      {
-      unsigned int numberOfVertices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertices", numberOfVertices);
+    inputFile.seekg(block->Position, std::ios::beg);
+    parser->Read(inputFile, data + block->NumberOfCells, block->NumberOfIndices);
+    this->ExpandCellsBuffer(data, *block);
+    data += block->NumberOfCells + block->NumberOfIndices;
+    }
+}
 
-      for ( unsigned int ii = 0; ii < numberOfVertices; ii++ )
-        {
-        inputFile >> numPoints;
-        data[index++] = MeshIOBase::VERTEX_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+void
+VTKPolyDataMeshIO
+::ReadCellsBufferAsBINARY(std::ifstream & inputFile, void *buffer)
+{
+  unsigned int *data = static_cast< unsigned int * >( buffer );
+
+  // The indices of each block are read at the end of its part of the
+  // buffer, swapped in place, then moved in front to insert the cell
+  // types
+  for ( std::vector< CellsBlock >::const_iterator block = this->m_CellsBlocks.begin();
+        block != this->m_CellsBlocks.end(); ++block )
+    {
+    unsigned int *indices = data + block->NumberOfCells;
+    inputFile.seekg(block->Position, std::ios::beg);
+    inputFile.read( reinterpret_cast< char * >( indices ), block->NumberOfIndices * sizeof( unsigned int ) );
+    if ( static_cast< SizeValueType >( inputFile.gcount() ) != block->NumberOfIndices * sizeof( unsigned int ) )
+      {
+      itkExceptionMacro(<< "Unexpected end of file while reading the cells of " << this->m_FileName);
       }
-    else if ( line.find("LINES") != std::string::npos )
+    if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
       {
-      unsigned int numberOfLines = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLines", numberOfLines);
+      itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(indices, block->NumberOfIndices);
+      }
+    this->ExpandCellsBuffer(data, *block);
+    data += block->NumberOfCells + block->NumberOfIndices;
+    }
+}
 
-      for ( unsigned int ii = 0; ii < numberOfLines; ii++ )
-        {
-        inputFile >> numPoints;
-        data[index++] = MeshIOBase::LINE_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+void
+VTKPolyDataMeshIO
+::ExpandCellsBuffer(unsigned int *buffer, const CellsBlock & block)
+{
+  // The cells are stored as their number of points followed by the point
+  // indices from buffer + block.NumberOfCells. Every cell moves ahead by
+  // the number of cell types inserted before it, so it is never
+  // overwritten before it is read.
+  const unsigned int *input = buffer + block.NumberOfCells;
+  const unsigned int *end = input + block.NumberOfIndices;
+  unsigned int *      output = buffer;
+  for ( SizeValueType ii = 0; ii < block.NumberOfCells; ii++ )
+    {
+    if ( input == end )
+      {
+      itkExceptionMacro(<< "Too few cell indices in " << this->m_FileName);
       }
-    else if ( line.find("POLYGONS") != std::string::npos )
+    const unsigned int numberOfPoints = *input++;
+    if ( static_cast< SizeValueType >( end - input ) < numberOfPoints )
       {
-      unsigned int numberOfPolygons = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygons", numberOfPolygons);
-
-      for ( unsigned int ii = 0; ii < numberOfPolygons; ii++ )
-        {
-        inputFile >> numPoints;
-
-        data[index++] = MeshIOBase::POLYGON_CELL;
-        data[index++] = numPoints;
-        for ( unsigned int jj = 0; jj < numPoints; jj++ )
-          {
-          inputFile >> data[index++];
-          }
-        }
+      itkExceptionMacro(<< "Too few cell indices in " << this->m_FileName);
+      }
+    *output++ = static_cast< unsigned int >( block.CellType );
+    *output++ = numberOfPoints;
+    for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
+      {
+      *output++ = *input++;
       }
     }
-
-  return;
 }
 
 void
 VTKPolyDataMeshIO
-::ReadCellsBufferAsBINARY(std::ifstream & inputFile, void *buffer)
+::SkipValues(std::ifstream & inputFile, SizeValueType numberOfValues, SizeValueType valueSize)
 {
-  if ( !this->m_CellBufferSize )
+  if ( this->m_FileType == ASCII )
     {
-    return;
+    NumericTextParser::Pointer parser = NumericTextParser::New();
+    parser->Skip(inputFile, numberOfValues);
     }
+  else
+    {
+    inputFile.seekg(static_cast< StreamOffsetType >( numberOfValues * valueSize ), std::ios::cur);
+    }
+}
 
-  unsigned int *inputBuffer = new unsigned int[this->m_CellBufferSize - this->m_NumberOfCells];
-  void *        pv = inputBuffer;
-  char *        startBuffer = static_cast< char * >( pv );
-  unsigned int *outputBuffer = static_cast< unsigned int * >( buffer );
-
-  std::string          line;
-  MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
+void
+VTKPolyDataMeshIO
+::SkipDataHeader(std::ifstream & inputFile, const char *section)
+{
+  StringType line;
 
-  while ( !inputFile.eof() )
+  if ( !inputFile.eof() )
     {
     std::getline(inputFile, line, '\n');
-    if ( line.find("VERTICES") != std::string::npos )
-      {
-      unsigned int numberOfVertices = 0;
-      unsigned int numberOfVertexIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertices", numberOfVertices);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertexIndices", numberOfVertexIndices);
-      inputFile.read( startBuffer, numberOfVertexIndices * sizeof( unsigned int ) );
+    }
+  else
+    {
+    itkExceptionMacro("UnExpected end of line while trying to read " << section);
+    }
 
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
+  /** For scalars we have to read the next line of LOOKUP_TABLE */
+  if ( line.find("SCALARS") != std::string::npos && line.find("COLOR_SCALARS") == std::string::npos )
+    {
+    if ( !inputFile.eof() )
+      {
+      std::getline(inputFile, line, '\n');
+      if ( line.find("LOOKUP_TABLE") == std::string::npos )
         {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfVertexIndices);
+        itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
         }
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::VERTEX_CELL, numberOfVertices);
-      startBuffer += numberOfVertexIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfVertexIndices + numberOfVertices ) * sizeof( unsigned int );
       }
-    else if ( line.find("LINES") != std::string::npos )
+    else
       {
-      unsigned int numberOfLines = 0;
-      unsigned int numberOfLineIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLines", numberOfLines);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLineIndices", numberOfLineIndices);
-      inputFile.read( startBuffer, numberOfLineIndices * sizeof( unsigned int ) );
+      itkExceptionMacro("UnExpected end of line while trying to read LOOKUP_TABLE");
+      }
+    }
+}
 
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
-        {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfLineIndices);
-        }
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::LINE_CELL, numberOfLines);
-      startBuffer += numberOfLineIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfLineIndices + numberOfLines ) * sizeof( unsigned int );
+void
+VTKPolyDataMeshIO
+::OpenInputFile(std::ifstream & inputFile, StreamOffsetType position)
+{
+  if ( this->m_FileType == ASCII )
+    {
+    inputFile.open(this->m_FileName.c_str(), std::ios::in);
+    }
+  else if ( m_FileType == BINARY )
+    {
+    inputFile.open(this->m_FileName.c_str(), std::ios::in | std::ios::binary);
+    }
+
+  // Test whether the file has been opened
+  if ( !inputFile.is_open() )
+    {
+    itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
+    }
+  inputFile.seekg(position, std::ios::beg);
+}
+
+void
+VTKPolyDataMeshIO
+::ReadValues(std::ifstream & inputFile, void *buffer, IOComponentType componentType, SizeValueType numberOfValues)
+{
+  switch ( componentType )
+    {
+    case UCHAR:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< unsigned char * >( buffer ), numberOfValues);
+      break;
       }
-    else if ( line.find("POLYGONS") != std::string::npos )
+    case CHAR:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< char * >( buffer ), numberOfValues);
+      break;
+      }
+    case USHORT:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< unsigned short * >( buffer ), numberOfValues);
+      break;
+      }
+    case SHORT:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< short * >( buffer ), numberOfValues);
+      break;
+      }
+    case UINT:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< unsigned int * >( buffer ), numberOfValues);
+      break;
+      }
+    case INT:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< int * >( buffer ), numberOfValues);
+      break;
+      }
+    case ULONG:
       {
-      unsigned int numberOfPolygons = 0;
-      unsigned int numberOfPolygonIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygons", numberOfPolygons);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygonIndices", numberOfPolygonIndices);
-      inputFile.read( startBuffer, numberOfPolygonIndices * sizeof( unsigned int ) );
+      this->ReadValuesBuffer(inputFile, static_cast< unsigned long * >( buffer ), numberOfValues);
+      break;
+      }
+    case LONG:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< long * >( buffer ), numberOfValues);
+      break;
+      }
+    case ULONGLONG:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< unsigned long long * >( buffer ), numberOfValues);
+      break;
+      }
+    case LONGLONG:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< long long * >( buffer ), numberOfValues);
+      break;
+      }
+    case FLOAT:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< float * >( buffer ), numberOfValues);
+      break;
+      }
+    case DOUBLE:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< double * >( buffer ), numberOfValues);
+      break;
+      }
+    case LDOUBLE:
+      {
+      this->ReadValuesBuffer(inputFile, static_cast< long double * >( buffer ), numberOfValues);
+      break;
+      }
+    default:
+      {
+      itkExceptionMacro(<< "Unknown component type");
+      }
+    }
+}
+
+void
+VTKPolyDataMeshIO
+::ReadPointsBlock(void *buffer, SizeValueType numberOfPoints)
+{
+  std::ifstream inputFile;
+  this->OpenInputFile(inputFile, this->m_PointsPosition);
+
+  this->ReadValues(inputFile, buffer, this->m_PointComponentType, numberOfPoints * this->m_PointDimension);
+  this->m_PointsPosition = inputFile.tellg();
+}
 
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
+MeshIOBase::SizeValueType
+VTKPolyDataMeshIO
+::ReadCellsBlock(void *buffer, SizeValueType bufferSize)
+{
+  unsigned int *data = static_cast< unsigned int * >( buffer );
+  SizeValueType size = 0;
+
+  // The indices of the current cells block are read into m_CellsIndices
+  // about bufferSize at a time, and the whole cells among them are
+  // returned with the cell type of the block. A cell split by a read is
+  // kept for the next one.
+  while ( this->m_CellsBlockIndex < this->m_CellsBlocks.size() )
+    {
+    const SizeValueType available = this->m_CellsIndices.size() - this->m_CellsIndicesIndex;
+    SizeValueType       required = 1;
+    if ( available > 0 )
+      {
+      const unsigned int numberOfPoints = this->m_CellsIndices[this->m_CellsIndicesIndex];
+      if ( available > numberOfPoints )
         {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfPolygonIndices);
+        if ( size + numberOfPoints + 2 > bufferSize )
+          {
+          if ( size == 0 )
+            {
+            // Ask for a buffer large enough for the cell
+            return numberOfPoints + 2;
+            }
+          break;
+          }
+        data[size++] = static_cast< unsigned int >( this->m_CellsBlocks[this->m_CellsBlockIndex].CellType );
+        data[size++] = numberOfPoints;
+        const unsigned int *indices = &this->m_CellsIndices[this->m_CellsIndicesIndex + 1];
+        std::copy(indices, indices + numberOfPoints, data + size);
+        size += numberOfPoints;
+        this->m_CellsIndicesIndex += numberOfPoints + 1;
+        continue;
         }
+      required = numberOfPoints + 1 - available;
+      }
 
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::POLYGON_CELL, numberOfPolygons);
-      startBuffer += numberOfPolygonIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfPolygonIndices + numberOfPolygons ) * sizeof( unsigned int );
+    if ( this->m_CellsIndicesLeft == 0 )
+      {
+      // Move to the next cells block once all its cells are returned
+      if ( available > 0 )
+        {
+        itkExceptionMacro(<< "Too few cell indices in " << this->m_FileName);
+        }
+      this->m_CellsIndices.clear();
+      this->m_CellsIndicesIndex = 0;
+      if ( ++this->m_CellsBlockIndex < this->m_CellsBlocks.size() )
+        {
+        this->m_CellsIndicesLeft = this->m_CellsBlocks[this->m_CellsBlockIndex].NumberOfIndices;
+        this->m_CellsPosition = this->m_CellsBlocks[this->m_CellsBlockIndex].Position;
+        }
+      continue;
       }
+
+    // Keep the split cell, and read the next indices after it
+    this->m_CellsIndices.erase( this->m_CellsIndices.begin(),
+                                this->m_CellsIndices.begin() + this->m_CellsIndicesIndex );
+    this->m_CellsIndicesIndex = 0;
+
+    const SizeValueType count = std::min( this->m_CellsIndicesLeft, std::max(bufferSize, required) );
+    this->m_CellsIndices.resize(available + count);
+
+    std::ifstream inputFile;
+    this->OpenInputFile(inputFile, this->m_CellsPosition);
+    this->ReadValuesBuffer(inputFile, &this->m_CellsIndices[available], count);
+    this->m_CellsPosition = inputFile.tellg();
+    this->m_CellsIndicesLeft -= count;
     }
 
-  if ( this->m_CellBufferSize )
+  return size;
+}
+
+void
+VTKPolyDataMeshIO
+::ReadPointDataBlock(void *buffer, SizeValueType numberOfPixels)
+{
+  std::ifstream inputFile;
+  if ( this->m_PointDataPosition == 0 )
     {
-    delete[] inputBuffer;
+    this->OpenInputFile(inputFile, this->m_PointDataStartPosition);
+    this->SkipDataHeader(inputFile, "POINT_DATA");
     }
+  else
+    {
+    this->OpenInputFile(inputFile, this->m_PointDataPosition);
+    }
+
+  this->ReadValues(inputFile, buffer, this->m_PointPixelComponentType,
+                   numberOfPixels * this->m_NumberOfPointPixelComponents);
+  this->m_PointDataPosition = inputFile.tellg();
+}
+
+void
+VTKPolyDataMeshIO
+::ReadCellDataBlock(void *buffer, SizeValueType numberOfPixels)
+{
+  std::ifstream inputFile;
+  if ( this->m_CellDataPosition == 0 )
+    {
+    this->OpenInputFile(inputFile, this->m_CellDataStartPosition);
+    this->SkipDataHeader(inputFile, "CELL_DATA");
+    }
+  else
+    {
+    this->OpenInputFile(inputFile, this->m_CellDataPosition);
+    }
+
+  this->ReadValues(inputFile, buffer, this->m_CellPixelComponentType,
+                   numberOfPixels * this->m_NumberOfCellPixelComponents);
+  this->m_CellDataPosition = inputFile.tellg();
 }
 
 void
@@ -1368,6 +1628,7 @@ VTKPolyDataMeshIO
     itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
     return;
     }
+  inputFile.seekg(this->m_PointDataStartPosition, std::ios::beg);
 
   // Read cells according to file type
   if ( this->m_FileType == ASCII )
@@ -1577,6 +1838,7 @@ VTKPolyDataMeshIO
     itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
     return;
     }
+  inputFile.seekg(this->m_CellDataStartPosition, std::ios::beg);
 
   // Read cell data according file type
   if ( this->m_FileType == ASCII )
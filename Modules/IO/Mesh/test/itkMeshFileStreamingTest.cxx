@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMesh.h"
+#include "itkMeshFileReader.h"
+#include "itkMeshFileWriter.h"
+#include "itkVTKPolyDataMeshIO.h"
+#include "itkOFFMeshIO.h"
+#include "itkVertexCell.h"
+#include "itkLineCell.h"
+#include "itkTriangleCell.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Mesh< float, Dimension >   MeshType;
+typedef itk::MeshFileReader< MeshType > ReaderType;
+typedef itk::MeshFileWriter< MeshType > WriterType;
+
+typedef MeshType::CellType                CellType;
+typedef itk::VertexCell< CellType >       VertexType;
+typedef itk::LineCell< CellType >         LineType;
+typedef itk::TriangleCell< CellType >     TriangleType;
+
+template< typename TCell >
+void AddCell(MeshType *mesh, const MeshType::PointIdentifier *ids)
+{
+  MeshType::CellAutoPointer cell;
+  cell.TakeOwnership(new TCell);
+  cell->SetPointIds(ids);
+  mesh->SetCell(mesh->GetNumberOfCells(), cell);
+}
+
+// compare the points and the cells of two meshes, and their point data
+// when they have some
+int CompareMeshes(const MeshType *mesh0, const MeshType *mesh1, bool compareData)
+{
+  if ( mesh0->GetNumberOfPoints() != mesh1->GetNumberOfPoints()
+       || mesh0->GetNumberOfCells() != mesh1->GetNumberOfCells() )
+    {
+    std::cerr << "ERROR: the meshes have different numbers of points or cells" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for ( MeshType::PointIdentifier p = 0; p < mesh0->GetNumberOfPoints(); ++p )
+    {
+    if ( mesh0->GetPoint(p) != mesh1->GetPoint(p) )
+      {
+      std::cerr << "ERROR: point " << p << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    float data0 = 0;
+    float data1 = 0;
+    if ( compareData && ( !mesh0->GetPointData(p, &data0) || !mesh1->GetPointData(p, &data1) || data0 != data1 ) )
+      {
+      std::cerr << "ERROR: the data of point " << p << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  for ( MeshType::CellIdentifier c = 0; c < mesh0->GetNumberOfCells(); ++c )
+    {
+    MeshType::CellAutoPointer cell0;
+    MeshType::CellAutoPointer cell1;
+    mesh0->GetCell(c, cell0);
+    mesh1->GetCell(c, cell1);
+    if ( cell0->GetType() != cell1->GetType()
+         || cell0->GetNumberOfPoints() != cell1->GetNumberOfPoints()
+         || !std::equal( cell0->PointIdsBegin(), cell0->PointIdsEnd(), cell1->PointIdsBegin() ) )
+      {
+      std::cerr << "ERROR: cell " << c << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int WriteAndRead(MeshType *mesh, itk::MeshIOBase *writerIO, itk::MeshIOBase *readerIO,
+                 const std::string & fileName, bool binary, itk::SizeValueType writerBlockSize,
+                 itk::SizeValueType readerBlockSize, bool compareData)
+{
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(mesh);
+  writer->SetMeshIO(writerIO);
+  writer->SetBlockSize(writerBlockSize);
+  if ( binary )
+    {
+    writer->SetFileTypeAsBINARY();
+    }
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetMeshIO(readerIO);
+  reader->SetBlockSize(readerBlockSize);
+  try
+    {
+    writer->Update();
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( CompareMeshes(mesh, reader->GetOutput(), compareData) != EXIT_SUCCESS )
+    {
+    std::cerr << "ERROR: " << fileName << " read with blocks of " << readerBlockSize
+              << " differs from the mesh written with blocks of " << writerBlockSize << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMeshFileStreamingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  // a grid of points with vertices, disjoint lines, and triangles, in
+  // the order of the sections of the VTK files
+  const unsigned int gridSize = 6;
+  MeshType::Pointer  mesh = MeshType::New();
+  MeshType::Pointer  triangles = MeshType::New();
+  for ( unsigned int j = 0; j < gridSize; ++j )
+    {
+    for ( unsigned int i = 0; i < gridSize; ++i )
+      {
+      MeshType::PointType point;
+      point[0] = i * 0.5f;
+      point[1] = j * 0.25f;
+      point[2] = static_cast< float >( ( i * j ) % 3 );
+      const MeshType::PointIdentifier id = j * gridSize + i;
+      mesh->SetPoint(id, point);
+      mesh->SetPointData(id, id * 1.5f);
+      triangles->SetPoint(id, point);
+      }
+    }
+
+  for ( MeshType::PointIdentifier id = 0; id < 3; ++id )
+    {
+    const MeshType::PointIdentifier ids[] = { id * 7 };
+    AddCell< VertexType >(mesh, ids);
+    }
+  for ( MeshType::PointIdentifier id = 0; id + 1 < gridSize * gridSize; id += 3 )
+    {
+    const MeshType::PointIdentifier ids[] = { id, id + 1 };
+    AddCell< LineType >(mesh, ids);
+    }
+  for ( unsigned int j = 0; j + 1 < gridSize; ++j )
+    {
+    for ( unsigned int i = 0; i + 1 < gridSize; ++i )
+      {
+      const MeshType::PointIdentifier id = j * gridSize + i;
+      const MeshType::PointIdentifier lower[] = { id, id + 1, id + gridSize };
+      const MeshType::PointIdentifier upper[] = { id + 1, id + gridSize + 1, id + gridSize };
+      AddCell< TriangleType >(mesh, lower);
+      AddCell< TriangleType >(mesh, upper);
+      AddCell< TriangleType >(triangles, lower);
+      AddCell< TriangleType >(triangles, upper);
+      }
+    }
+
+  // VTK files are read in blocks smaller than a section, which split
+  // the cells between the reads, and in blocks smaller than a cell,
+  // which the reader grows
+  const itk::SizeValueType readerBlockSizes[] = { 1, 3, 5, 7, 1048576 };
+  for ( unsigned int b = 0; b < 5; ++b )
+    {
+    for ( unsigned int binary = 0; binary < 2; ++binary )
+      {
+      const std::string fileName = directory + ( binary ? "/itkMeshFileStreamingTestBinary.vtk"
+                                                        : "/itkMeshFileStreamingTest.vtk" );
+      if ( WriteAndRead(mesh, itk::VTKPolyDataMeshIO::New(), itk::VTKPolyDataMeshIO::New(), fileName,
+                        binary, 1048576, readerBlockSizes[b], true) != EXIT_SUCCESS )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // OFF files are written in blocks
+  for ( unsigned int binary = 0; binary < 2; ++binary )
+    {
+    const std::string fileName = directory + ( binary ? "/itkMeshFileStreamingTestBinary.off"
+                                                      : "/itkMeshFileStreamingTest.off" );
+    if ( WriteAndRead(triangles, itk::OFFMeshIO::New(), itk::OFFMeshIO::New(), fileName,
+                      binary, 5, 1048576, false) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
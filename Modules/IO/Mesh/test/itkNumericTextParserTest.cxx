@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNumericTextParser.h"
+#include "itkMesh.h"
+#include "itkMeshFileReader.h"
+#include "itkMeshFileWriter.h"
+#include "itkVTKPolyDataMeshIO.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+// parse text with a small chunk size, so that the values are split
+// between many chunks and waves
+template< typename T >
+bool ParseText(const std::string & text, std::vector< T > & values,
+               std::string & rest, itk::SizeValueType chunkSize)
+{
+  itk::NumericTextParser::Pointer parser = itk::NumericTextParser::New();
+  parser->SetChunkSize(chunkSize);
+  parser->SetNumberOfThreads(3);
+
+  std::istringstream stream(text);
+  try
+    {
+    parser->Read( stream, &values[0], values.size() );
+    }
+  catch ( itk::ExceptionObject & )
+    {
+    return false;
+    }
+  std::getline(stream, rest);
+  return true;
+}
+
+template< typename TMesh >
+int CompareMeshes(const TMesh *mesh0, const TMesh *mesh1)
+{
+  if ( mesh0->GetNumberOfPoints() != mesh1->GetNumberOfPoints()
+       || mesh0->GetNumberOfCells() != mesh1->GetNumberOfCells() )
+    {
+    std::cerr << "ERROR: the meshes have different numbers of points or cells" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for ( typename TMesh::PointIdentifier p = 0; p < mesh0->GetNumberOfPoints(); ++p )
+    {
+    if ( mesh0->GetPoint(p) != mesh1->GetPoint(p) )
+      {
+      std::cerr << "ERROR: point " << p << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    typename TMesh::PixelType data0 = 0;
+    typename TMesh::PixelType data1 = 0;
+    mesh0->GetPointData(p, &data0);
+    mesh1->GetPointData(p, &data1);
+    if ( data0 != data1 )
+      {
+      std::cerr << "ERROR: the data of point " << p << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  for ( typename TMesh::CellIdentifier c = 0; c < mesh0->GetNumberOfCells(); ++c )
+    {
+    typename TMesh::CellAutoPointer cell0;
+    typename TMesh::CellAutoPointer cell1;
+    mesh0->GetCell(c, cell0);
+    mesh1->GetCell(c, cell1);
+    if ( cell0->GetType() != cell1->GetType()
+         || cell0->GetNumberOfPoints() != cell1->GetNumberOfPoints()
+         || !std::equal( cell0->PointIdsBegin(), cell0->PointIdsEnd(), cell1->PointIdsBegin() ) )
+      {
+      std::cerr << "ERROR: cell " << c << " differs" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkNumericTextParserTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the values agree with the C++ streams whatever the chunk size
+  std::vector< std::string > tokens;
+  for ( unsigned int i = 0; i < 1000; ++i )
+    {
+    std::ostringstream os;
+    os.precision(i % 2 ? 17 : 6);
+    os << ( ( i % 7 == 0 ) ? i * 1.5e-7 : std::sin(i * 0.37) * ( i + 1 ) );
+    tokens.push_back( os.str() );
+    }
+  const char *special[] = { "1.25", "-3", "7e2", "+0.000125", "-0.0", "42.", "1e-300", "123456789012345678901" };
+  tokens.insert(tokens.end(), special, special + 8);
+
+  std::string text;
+  for ( unsigned int i = 0; i < tokens.size(); ++i )
+    {
+    text += tokens[i] + ( i % 5 == 4 ? "\n" : " \t" );
+    }
+  text += "\nNEXT 5\n";
+
+  const itk::SizeValueType chunkSizes[] = { 1, 7, 64, 1 << 20 };
+  for ( unsigned int c = 0; c < 4; ++c )
+    {
+    std::vector< double > values( tokens.size() );
+    std::string           rest;
+    if ( !ParseText(text, values, rest, chunkSizes[c]) )
+      {
+      std::cerr << "ERROR: parsing with chunks of " << chunkSizes[c] << " bytes failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    for ( unsigned int i = 0; i < values.size(); ++i )
+      {
+      std::istringstream is(tokens[i]);
+      double             streamed;
+      is >> streamed;
+      if ( values[i] != streamed )
+        {
+        std::cerr << "ERROR: " << tokens[i] << " was parsed as " << values[i]
+                  << " with chunks of " << chunkSizes[c] << " bytes" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if ( rest != " \t" )
+      {
+      std::cerr << "ERROR: the stream is not left after the last value: \"" << rest << "\"" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // integers, and the position of the stream after the values
+  std::vector< unsigned int > indices(5);
+  std::string                 rest;
+  if ( !ParseText(std::string("3 0 1 2\n4294967295 POLYGONS 1 2\n"), indices, rest, 3)
+       || indices[0] != 3 || indices[3] != 2 || indices[4] != 4294967295U || rest != " POLYGONS 1 2" )
+    {
+    std::cerr << "ERROR: the integers were not parsed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // invalid numbers, and too few numbers
+  std::vector< float > floats(3);
+  if ( ParseText(std::string("1 2,5 3"), floats, rest, 2) )
+    {
+    std::cerr << "ERROR: an invalid number was parsed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( ParseText(std::string("1 2"), floats, rest, 2) )
+    {
+    std::cerr << "ERROR: missing numbers were not reported" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector< int > ints(2);
+  if ( ParseText(std::string("1 2.5"), ints, rest, 64) )
+    {
+    std::cerr << "ERROR: a decimal number was parsed as an integer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a mesh with several blocks of cells and point data, read from ASCII
+  // then from BINARY
+  const std::string asciiFileName = std::string(argv[1]) + "/itkNumericTextParserTest.vtk";
+  std::ofstream     file( asciiFileName.c_str() );
+  file << "# vtk DataFile Version 2.0\nFile written by hand\nASCII\nDATASET POLYDATA\n"
+       << "POINTS 5 float\n0 0 0 1 0 0\n1 1 0 0 1 0\n0.5 0.5 1.25\n"
+       << "VERTICES 2 4\n1 4\n1 3\n"
+       << "LINES 1 4\n3 0 1 2\n"
+       << "POLYGONS 2 9\n3 0 1 4\n4 0 1 2 3\n"
+       << "POINT_DATA 5\nSCALARS PointScalarData float\nLOOKUP_TABLE default\n0.5 1 1.5 2 2.5\n";
+  file.close();
+
+  const unsigned int Dimension = 3;
+  typedef itk::Mesh< float, Dimension > MeshType;
+  typedef itk::MeshFileReader< MeshType > ReaderType;
+  typedef itk::MeshFileWriter< MeshType > WriterType;
+
+  ReaderType::Pointer asciiReader = ReaderType::New();
+  asciiReader->SetFileName(asciiFileName);
+  asciiReader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+
+  const std::string binaryFileName = std::string(argv[1]) + "/itkNumericTextParserTestBinary.vtk";
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(binaryFileName);
+  writer->SetInput( asciiReader->GetOutput() );
+  writer->SetFileTypeAsBINARY();
+
+  ReaderType::Pointer binaryReader = ReaderType::New();
+  binaryReader->SetFileName(binaryFileName);
+  binaryReader->SetMeshIO( itk::VTKPolyDataMeshIO::New() );
+  try
+    {
+    writer->Update();
+    binaryReader->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  MeshType::ConstPointer mesh = asciiReader->GetOutput();
+  MeshType::PointType    point;
+  mesh->GetPoint(4, &point);
+  float data = 0;
+  mesh->GetPointData(4, &data);
+  // the polyline is read as two lines
+  MeshType::CellAutoPointer cell;
+  mesh->GetCell(5, cell);
+  if ( mesh->GetNumberOfPoints() != 5 || mesh->GetNumberOfCells() != 6
+       || point[2] != 1.25 || data != 2.5 || cell->GetNumberOfPoints() != 4 )
+    {
+    std::cerr << "ERROR: the ASCII mesh was not read" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( CompareMeshes( mesh.GetPointer(), binaryReader->GetOutput() ) != EXIT_SUCCESS )
+    {
+    std::cerr << "ERROR: the BINARY mesh differs from the ASCII mesh" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -30,6 +30,15 @@ namespace itk
  *
  *  \brief Read MetaImage file format.
  *
+ *  When NumberOfCompressionThreads is greater than 1, compressed data
+ *  is deflated block by block in parallel by a GzipBlockCompressor, and
+ *  compressed data with a block index is inflated in parallel.
+ *
+ *  The block index also makes compressed data streamable: only the
+ *  blocks holding the requested region are read and inflated. The
+ *  blocks written by MetaImageIO hold whole rows or whole slices of the
+ *  image.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIOMeta
  */
@@ -69,6 +78,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Map the IORegion from the file holding the data. Only uncompressed
+   * binary data stored in a single file in the byte order of the system,
+   * or with single byte components, can be mapped. */
+  virtual MemoryMappedFileRegion::Pointer MapIORegion();
+
   MetaImage * GetMetaImagePointer(void);
 
   /*-------- This part of the interfaces deals with writing data. ----- */
@@ -115,11 +129,11 @@ public:
                            const ImageIORegion & largestPossibleRegion);
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
-   *  CanRead must be called prior to this function. */
+   *  file. Compressed data can only be streamed when it has a block
+   *  index. ReadImageInformation must be called prior to this function. */
   virtual bool CanStreamRead()
   {
-    if ( m_MetaImage.CompressedData() )
+    if ( m_MetaImage.CompressedData() && !m_CompressedDataHasBlockIndex )
       {
       return false;
       }
@@ -151,6 +165,22 @@ protected:
   ~MetaImageIO();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Read the compressed data of the whole image in buffer, inflating
+   * its blocks in parallel when it has a block index. Return false when
+   * the data is not compressed in a single file, or when
+   * NumberOfCompressionThreads is 1, to let MetaIO read it. */
+  bool ReadCompressedData(void *buffer);
+
+  /** Read the IORegion of compressed data with a block index in
+   * buffer, inflating only the blocks which hold it. Return false when
+   * the data has no block index to let MetaIO read it. */
+  bool ReadCompressedRegion(void *buffer);
+
+  /** Open the file holding the compressed data and move to the
+   * beginning of the data. Return false when the data is not binary
+   * data compressed in a single file. */
+  bool OpenCompressedDataFile(std::ifstream & dataFile);
+
 private:
 
   MetaImage m_MetaImage;
@@ -159,6 +189,8 @@ private:
   void operator=(const Self &); //purposely not implemented
 
   unsigned int m_SubSamplingFactor;
+
+  bool m_CompressedDataHasBlockIndex;
 };
 } // end namespace itk
 
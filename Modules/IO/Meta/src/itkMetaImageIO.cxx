@@ -20,6 +20,7 @@
 #include "itkSpatialOrientationAdapter.h"
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
+#include "itkGzipBlockCompressor.h"
 #include "itksys/SystemTools.hxx"
 
 namespace itk
@@ -28,6 +29,7 @@ MetaImageIO::MetaImageIO()
 {
   m_FileType = Binary;
   m_SubSamplingFactor = 1;
+  m_CompressedDataHasBlockIndex = false;
   if ( MET_SystemByteOrderMSB() )
     {
     m_ByteOrder = BigEndian;
@@ -52,6 +54,7 @@ void MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << "\n";
+  os << indent << "CompressedDataHasBlockIndex: " << m_CompressedDataHasBlockIndex << "\n";
 }
 
 void MetaImageIO::SetDataFileName(const char *filename)
@@ -87,6 +90,11 @@ void MetaImageIO::ReadImageInformation()
                        << itksys::SystemTools::GetLastSystemError() );
     }
 
+  // regions of compressed data with a block index can be streamed
+  std::ifstream dataFile;
+  m_CompressedDataHasBlockIndex = this->OpenCompressedDataFile(dataFile)
+                                  && GzipBlockCompressor::HasBlockIndex(dataFile);
+
   if ( m_MetaImage.BinaryData() )
     {
     this->SetFileType(Binary);
@@ -434,7 +442,7 @@ void MetaImageIO::Read(void *buffer)
     largestRegion.SetSize( i, this->GetDimensions(i) );
     }
 
-  if ( largestRegion != m_IORegion )
+  if ( largestRegion != m_IORegion && !this->ReadCompressedRegion(buffer) )
     {
     int *indexMin = new int[nDims];
     int *indexMax = new int[nDims];
@@ -471,7 +479,7 @@ void MetaImageIO::Read(void *buffer)
 
     m_MetaImage.ElementByteOrderFix( m_IORegion.GetNumberOfPixels() );
     }
-  else
+  else if ( largestRegion == m_IORegion && !this->ReadCompressedData(buffer) )
     {
     if ( !m_MetaImage.Read(m_FileName.c_str(), true, buffer) )
       {
@@ -487,6 +495,216 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+MemoryMappedFileRegion::Pointer MetaImageIO::MapIORegion()
+{
+  if ( !m_UseMemoryMapping
+       || m_MetaImage.CompressedData()
+       || !m_MetaImage.BinaryData()
+       || m_SubSamplingFactor != 1
+       || ( this->GetComponentSize() > 1
+            && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() ) )
+    {
+    return 0;
+    }
+
+  // the data is either after the header, or in a single raw file
+  std::string dataFileName = m_MetaImage.ElementDataFileName();
+  SizeType    dataPosition = 0;
+  if ( dataFileName == "LOCAL" )
+    {
+    dataFileName = m_FileName;
+    dataPosition = -1;
+    }
+  else if ( dataFileName.find("LIST") == 0
+            || dataFileName.find('%') != std::string::npos )
+    {
+    return 0;
+    }
+  else
+    {
+    if ( !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) )
+      {
+      const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+      if ( !path.empty() )
+        {
+        dataFileName = path + "/" + dataFileName;
+        }
+      }
+    dataPosition = m_MetaImage.HeaderSize();
+    }
+
+  // the data is at the end of the file when its position is not known
+  if ( dataPosition < 0 )
+    {
+    const SizeType fileLength = itksys::SystemTools::FileLength( dataFileName.c_str() );
+    if ( fileLength < this->GetImageSizeInBytes() )
+      {
+      return 0;
+      }
+    dataPosition = fileLength - this->GetImageSizeInBytes();
+    }
+
+  return this->MapIORegionFromFile(dataFileName, dataPosition);
+}
+
+bool MetaImageIO::OpenCompressedDataFile(std::ifstream & dataFile)
+{
+  if ( !m_MetaImage.CompressedData()
+       || !m_MetaImage.BinaryData()
+       || m_MetaImage.HeaderSize() != 0 )
+    {
+    return false;
+    }
+
+  // the compressed data is either after the header, or in a single file
+  std::string dataFileName = m_MetaImage.ElementDataFileName();
+  if ( dataFileName == "LOCAL" || dataFileName == "Local" || dataFileName == "local" )
+    {
+    // the data begins after the ElementDataFile line, which ends the header
+    dataFile.open(m_FileName.c_str(), std::ios::in | std::ios::binary);
+    std::string line;
+    while ( std::getline(dataFile, line) )
+      {
+      const std::string::size_type first = line.find_first_not_of(" \t");
+      if ( first != std::string::npos && line.compare(first, 15, "ElementDataFile") == 0 )
+        {
+        break;
+        }
+      }
+    }
+  else if ( dataFileName.find("LIST") == 0
+            || dataFileName.find('%') != std::string::npos )
+    {
+    return false;
+    }
+  else
+    {
+    if ( !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) )
+      {
+      const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+      if ( !path.empty() )
+        {
+        dataFileName = path + "/" + dataFileName;
+        }
+      }
+    dataFile.open(dataFileName.c_str(), std::ios::in | std::ios::binary);
+    }
+
+  return dataFile.good();
+}
+
+bool MetaImageIO::ReadCompressedData(void *buffer)
+{
+  std::ifstream dataFile;
+  if ( m_NumberOfCompressionThreads < 2
+       || !this->OpenCompressedDataFile(dataFile) )
+    {
+    return false;
+    }
+
+  const std::streampos dataPosition = dataFile.tellg();
+  dataFile.seekg(0, std::ios::end);
+  const SizeValueType compressedSize =
+    static_cast< SizeValueType >( dataFile.tellg() - dataPosition );
+  dataFile.seekg(dataPosition, std::ios::beg);
+
+  std::vector< char > compressedData(compressedSize);
+  if ( compressedSize == 0 || !dataFile.read(&compressedData[0], compressedSize) )
+    {
+    itkExceptionMacro( "File cannot be read: "
+                       << this->GetFileName() << " for reading."
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+  dataFile.close();
+
+  // the blocks of the data are inflated in parallel when the compressed
+  // data has a block index
+  GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+  compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+  compressor->Decompress( &compressedData[0], compressedSize,
+                          buffer, this->GetImageSizeInBytes() );
+
+  m_MetaImage.ElementData(buffer, false);
+  m_MetaImage.ElementByteOrderFix( this->GetImageSizeInPixels() );
+  m_MetaImage.ElementData(static_cast< void * >( 0 ), false);
+  return true;
+}
+
+bool MetaImageIO::ReadCompressedRegion(void *buffer)
+{
+  std::ifstream dataFile;
+  if ( !m_CompressedDataHasBlockIndex
+       || m_SubSamplingFactor != 1
+       || !this->OpenCompressedDataFile(dataFile) )
+    {
+    return false;
+    }
+
+  // the rows of the region, rows which follow each other in the file
+  // are merged
+  const unsigned int                    nDims = this->GetNumberOfDimensions();
+  const unsigned int                    regionDims = m_IORegion.GetImageDimension();
+  std::vector< SizeValueType >          strides(nDims);
+  std::vector< SizeValueType >          start(nDims, 0);
+  std::vector< SizeValueType >          size(nDims, 1);
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    strides[i] = ( i == 0 ) ? this->GetPixelSize() : strides[i - 1] * this->GetDimensions(i - 1);
+    if ( i < regionDims )
+      {
+      start[i] = m_IORegion.GetIndex()[i];
+      size[i] = m_IORegion.GetSize()[i];
+      }
+    }
+
+  const SizeValueType rowSize = size[0] * strides[0];
+  SizeValueType       numberOfRows = 1;
+  for ( unsigned int i = 1; i < nDims; i++ )
+    {
+    numberOfRows *= size[i];
+    }
+
+  GzipBlockCompressor::RangeContainerType ranges;
+  std::vector< SizeValueType >            position(start);
+  for ( SizeValueType row = 0; row < numberOfRows && rowSize > 0; ++row )
+    {
+    SizeValueType offset = 0;
+    for ( unsigned int i = 0; i < nDims; i++ )
+      {
+      offset += position[i] * strides[i];
+      }
+    if ( !ranges.empty() && ranges.back().first + ranges.back().second == offset )
+      {
+      ranges.back().second += rowSize;
+      }
+    else
+      {
+      ranges.push_back( GzipBlockCompressor::RangeType(offset, rowSize) );
+      }
+
+    for ( unsigned int i = 1; i < nDims; i++ )
+      {
+      if ( ++position[i] < start[i] + size[i] )
+        {
+        break;
+        }
+      position[i] = start[i];
+      }
+    }
+
+  // only the blocks holding the region are inflated
+  GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+  compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+  compressor->DecompressRanges(dataFile, ranges, buffer);
+
+  m_MetaImage.ElementData(buffer, false);
+  m_MetaImage.ElementByteOrderFix( m_IORegion.GetNumberOfPixels() );
+  m_MetaImage.ElementData(static_cast< void * >( 0 ), false);
+  return true;
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer(void)
 {
   return &m_MetaImage;
@@ -1081,7 +1299,33 @@ MetaImageIO
     }
   else
     {
-    if ( !m_MetaImage.Write( m_FileName.c_str() ) )
+    // the blocks of the compressed data are deflated in parallel, in a
+    // gzip member which MetaIO inflates as any other compressed data
+    std::vector< char > compressedData;
+    if ( m_UseCompression && binaryData && m_NumberOfCompressionThreads > 1
+         && !strchr(m_MetaImage.ElementDataFileName(), '%') )
+      {
+      // the blocks hold whole rows, or whole slices when they are small
+      // enough, so that a streamed read of a region inflates few blocks
+      GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+      SizeValueType                sliceSize = this->GetPixelSize() * this->GetDimensions(0);
+      for ( i = 1; i < nDims && sliceSize * this->GetDimensions(i) <= compressor->GetBlockSize(); i++ )
+        {
+        sliceSize *= this->GetDimensions(i);
+        }
+      if ( sliceSize > 0 )
+        {
+        compressor->SetBlockSize( sliceSize * std::max( compressor->GetBlockSize() / sliceSize,
+                                                        static_cast< SizeValueType >( 1 ) ) );
+        }
+      compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+      compressor->Compress(buffer, this->GetImageSizeInBytes(), compressedData);
+      m_MetaImage.CompressedElementData( &compressedData[0], compressedData.size() );
+      }
+
+    const bool written = m_MetaImage.Write( m_FileName.c_str() );
+    m_MetaImage.CompressedElementData(NULL, 0);
+    if ( !written )
       {
       itkExceptionMacro( "File cannot be written: "
                          << this->GetFileName()
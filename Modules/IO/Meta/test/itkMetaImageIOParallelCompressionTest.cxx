@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <fstream>
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkGzipBlockCompressor.h"
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+short ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast< short >( index[0] * index[1] - 3 * index[2] );
+}
+
+bool ReadImage(const std::string & fileName, itk::ThreadIdType numberOfThreads)
+{
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  io->SetNumberOfCompressionThreads(numberOfThreads);
+
+  itk::ImageFileReader< ImageType >::Pointer reader = itk::ImageFileReader< ImageType >::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( reader->GetOutput(),
+                                                          reader->GetOutput()->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << " of " << fileName
+                << " read with " << numberOfThreads << " threads" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// stream a region out of the compressed data
+bool ReadRegion(const std::string & fileName, const ImageType::RegionType & region,
+                itk::ThreadIdType numberOfThreads)
+{
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  io->SetNumberOfCompressionThreads(numberOfThreads);
+
+  itk::ImageFileReader< ImageType >::Pointer reader = itk::ImageFileReader< ImageType >::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->UseStreamingOn();
+  reader->UpdateOutputInformation();
+  if ( !io->CanStreamRead() )
+    {
+    std::cerr << "ERROR: " << fileName << " can not be streamed" << std::endl;
+    return false;
+    }
+
+  ImageType::Pointer output = reader->GetOutput();
+  output->SetRequestedRegion(region);
+  output->Update();
+  if ( output->GetBufferedRegion() != region )
+    {
+    std::cerr << "ERROR: " << output->GetBufferedRegion() << " was read instead of "
+              << region << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it(output, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << " of the region of "
+                << fileName << " read with " << numberOfThreads << " threads" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkMetaImageIOParallelCompressionTest(int argc, char* argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  // a few blocks of 1 MiB
+  ImageType::SizeType size;
+  size[0] = 256;
+  size[1] = 256;
+  size[2] = 21;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue( it.GetIndex() ) );
+    }
+
+  const char *extensions[] = { ".mha", ".mhd" };
+  for ( unsigned int e = 0; e < 2; ++e )
+    {
+    const std::string fileName = directory + "/itkMetaImageIOParallelCompressionTest" + extensions[e];
+
+    itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+    io->SetNumberOfCompressionThreads(4);
+
+    itk::ImageFileWriter< ImageType >::Pointer writer = itk::ImageFileWriter< ImageType >::New();
+    writer->SetFileName(fileName);
+    writer->SetInput(image);
+    writer->SetImageIO(io);
+    writer->UseCompressionOn();
+
+    try
+      {
+      writer->Update();
+
+      // MetaIO inflates the data sequentially, the block index is used
+      // with several threads
+      if ( !ReadImage(fileName, 1) || !ReadImage(fileName, 4) )
+        {
+        return EXIT_FAILURE;
+        }
+
+      // a box, and whole slices, are read from the blocks which hold them
+      ImageType::RegionType box;
+      box.SetIndex(0, 10);
+      box.SetIndex(1, 20);
+      box.SetIndex(2, 3);
+      box.SetSize(0, 100);
+      box.SetSize(1, 50);
+      box.SetSize(2, 15);
+      ImageType::RegionType slices = image->GetBufferedRegion();
+      slices.SetIndex(2, 19);
+      slices.SetSize(2, 2);
+      if ( !ReadRegion(fileName, box, 1) || !ReadRegion(fileName, box, 4)
+           || !ReadRegion(fileName, slices, 4) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    catch ( itk::ExceptionObject & err )
+      {
+      std::cerr << err << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the data file holds a single gzip member with a block index
+  const std::string dataFileName = directory + "/itkMetaImageIOParallelCompressionTest.zraw";
+  std::ifstream     dataFile(dataFileName.c_str(), std::ios::in | std::ios::binary);
+  std::vector< char > compressedData( ( std::istreambuf_iterator< char >(dataFile) ),
+                                      std::istreambuf_iterator< char >() );
+  itk::SizeValueType memberSize = 0;
+  itk::SizeValueType numberOfBytes = 0;
+  if ( compressedData.empty()
+       || !itk::GzipBlockCompressor::GetIndexedMemberSize(&compressedData[0], compressedData.size(),
+                                                          memberSize, numberOfBytes)
+       || memberSize != compressedData.size()
+       || numberOfBytes != image->GetBufferedRegion().GetNumberOfPixels() * sizeof( short ) )
+    {
+    std::cerr << "ERROR: " << dataFileName << " has no block index" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
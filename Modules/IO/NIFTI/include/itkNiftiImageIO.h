@@ -38,6 +38,10 @@ namespace itk
  * \brief Class that defines how to read Nifti file format.
  * Nifti IMAGE FILE FORMAT - As much information as I can determine from sourceforge.net/projects/Niftilib
  *
+ * When NumberOfCompressionThreads is greater than 1, single .nii.gz
+ * files are written as two gzip members, the header and the data,
+ * whose blocks are deflated in parallel by a GzipBlockCompressor.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
@@ -119,6 +123,10 @@ private:
 
   void  SetImageIOMetadataFromNIfTI();
 
+  /** Write m_NiftiImage, deflating the data of .nii.gz files block by
+   * block in parallel when NumberOfCompressionThreads is greater than 1. */
+  void  WriteNiftiImage();
+
   nifti_image *m_NiftiImage;
 
   double m_RescaleSlope;
@@ -19,6 +19,7 @@
 #include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
+#include "itkGzipBlockCompressor.h"
 
 namespace itk
 {
@@ -1844,6 +1845,47 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short int origdims, unsign
   //  this->m_NiftiImage->sform_code = 0;
 }
 
+void
+NiftiImageIO
+::WriteNiftiImage()
+{
+  nifti_image *nim = this->m_NiftiImage;
+  if ( m_NumberOfCompressionThreads < 2
+       || nim->nifti_type != NIFTI_FTYPE_NIFTI1_1
+       || !nifti_is_gzfile(nim->fname)
+       || nim->num_ext > 0 )
+    {
+    nifti_image_write(nim);
+    return;
+    }
+
+  // the header, followed by an empty extender, fills the bytes before
+  // the data
+  nifti_set_iname_offset(nim);
+  const struct nifti_1_header header = nifti_convert_nim2nhdr(nim);
+  std::vector< char >         headerBytes( nim->iname_offset, 0 );
+  memcpy( &headerBytes[0], &header, sizeof( header ) );
+
+  std::ofstream file(nim->fname, std::ios::out | std::ios::binary | std::ios::trunc);
+  if ( !file )
+    {
+    itkExceptionMacro( << "Cannot open " << nim->fname << " for writing" );
+    }
+
+  // gzip readers decompress the two members as a single file
+  GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+  compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+  std::vector< char > member;
+  compressor->Compress(&headerBytes[0], headerBytes.size(), member);
+  file.write( &member[0], member.size() );
+  compressor->Compress(nim->data, static_cast< SizeValueType >( nim->nvox ) * nim->nbyper, member);
+  file.write( &member[0], member.size() );
+  if ( !file )
+    {
+    itkExceptionMacro( << "Could not write " << nim->fname );
+    }
+}
+
 /**
  * Write the image Information before writing data
  */
@@ -1861,7 +1903,7 @@ NiftiImageIO
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
     this->m_NiftiImage->data = const_cast< void * >( buffer );
-    nifti_image_write(this->m_NiftiImage);
+    this->WriteNiftiImage();
     this->m_NiftiImage->data = 0; // if left pointing to data buffer
     // nifti_image_free will try and free this memory
     }
@@ -1947,7 +1989,7 @@ NiftiImageIO
     //Need a const cast here so that we don't have to copy the memory for
     //writing.
     this->m_NiftiImage->data = (void *)nifti_buf;
-    nifti_image_write(this->m_NiftiImage);
+    this->WriteNiftiImage();
     this->m_NiftiImage->data = 0; // if left pointing to data buffer
     delete[] nifti_buf;
     }
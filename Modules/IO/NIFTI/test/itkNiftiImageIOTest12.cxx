@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkGzipBlockCompressor.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+// write a .nii.gz file whose data is deflated in parallel, and read it
+// back with niftilib
+int itkNiftiImageIOTest12(int ac, char *av[])
+{
+  if ( ac < 3 )
+    {
+    std::cerr << "Usage: " << av[0] << " outputDirectory fileName" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+  const std::string testfilename = av[2];
+
+  typedef itk::Image< float, 3 > ImageType;
+  ImageType::SizeType size;
+  size[0] = 128;
+  size[1] = 128;
+  size[2] = 40;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< float >( index[0] * index[1] ) / ( index[2] + 1 ) );
+    }
+
+  itk::NiftiImageIO::Pointer io = itk::NiftiImageIO::New();
+  io->SetNumberOfCompressionThreads(4);
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetFileName(testfilename);
+  writer->SetInput(image);
+
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(testfilename);
+  try
+    {
+    writer->Update();
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator< ImageType > readIt( reader->GetOutput(), image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++readIt )
+    {
+    if ( readIt.Get() != it.Get() )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the header and the data are in two gzip members with a block index
+  std::ifstream       file(testfilename.c_str(), std::ios::in | std::ios::binary);
+  std::vector< char > compressedData( ( std::istreambuf_iterator< char >(file) ),
+                                      std::istreambuf_iterator< char >() );
+  itk::SizeValueType headerMemberSize = 0;
+  itk::SizeValueType headerSize = 0;
+  itk::SizeValueType dataMemberSize = 0;
+  itk::SizeValueType dataSize = 0;
+  if ( compressedData.empty()
+       || !itk::GzipBlockCompressor::GetIndexedMemberSize(&compressedData[0], compressedData.size(),
+                                                          headerMemberSize, headerSize)
+       || headerSize != 352
+       || !itk::GzipBlockCompressor::GetIndexedMemberSize(&compressedData[headerMemberSize],
+                                                          compressedData.size() - headerMemberSize,
+                                                          dataMemberSize, dataSize)
+       || dataSize != image->GetBufferedRegion().GetNumberOfPixels() * sizeof( float )
+       || headerMemberSize + dataMemberSize != compressedData.size() )
+    {
+    std::cerr << "ERROR: " << testfilename << " is not made of two indexed gzip members" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -21,6 +21,7 @@
 
 #include "itkImageIOBase.h"
 #include <fstream>
+#include <string>
 
 namespace itk
 {
@@ -30,6 +31,15 @@ namespace itk
  * The Nrrd format was developed as part of the Teem package
  * (teem.sourceforge.net).
  *
+ * Raw data, and gzip compressed data with a block index, stored in a
+ * single data file, attached or detached, are streamable: only the
+ * requested region is read, straight into the buffer of the image.
+ *
+ * When NumberOfCompressionThreads is greater than 1, the gzip
+ * compressed data of attached headers is deflated block by block in
+ * parallel by a GzipBlockCompressor, and the block index lets the
+ * blocks be inflated in parallel when reading.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
@@ -64,6 +74,22 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Determine if the ImageIO can stream reading from this file: the
+   * data must be raw, or gzip compressed with a block index, in a single
+   * data file. ReadImageInformation must be called prior to this
+   * function. */
+  virtual bool CanStreamRead()
+  {
+    return m_DataCanBeStreamed;
+  }
+
+  /** Method for supporting streaming.  Given a requested region, calculate what
+   * could be the region that we can read from the file. This is called the
+   * streamable region, which will be smaller than the LargestPossibleRegion and
+   * greater or equal to the RequestedRegion */
+  virtual ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   virtual bool CanWriteFile(const char *);
@@ -86,9 +112,19 @@ protected:
 
   ImageIOBase::IOComponentType NrrdToITKComponentType(const int) const;
 
+  /** Read the IORegion from the streamable data file into buffer,
+   * without going through NrrdIO. */
+  void ReadDataRegion(void *buffer);
+
 private:
   NrrdImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  /** Where the data lies when it can be streamed */
+  bool          m_DataCanBeStreamed;
+  bool          m_DataIsCompressed;
+  std::string   m_DataFileName;
+  SizeValueType m_DataPosition;
 };
 } // end namespace itk
 
@@ -22,13 +22,38 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkGzipBlockCompressor.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
+#include <algorithm>
 
 namespace itk
 {
 #define KEY_PREFIX "NRRD_"
 
+namespace
+{
+// swap the components read from a file of the given byte order to the
+// byte order of the system
+template< typename T >
+void SwapRangeFromFile(void *buffer, SizeValueType numberOfComponents, ImageIOBase::ByteOrder byteOrder)
+{
+  if ( byteOrder == ImageIOBase::BigEndian )
+    {
+    ByteSwapper< T >::SwapRangeFromSystemToBigEndian(static_cast< T * >( buffer ), numberOfComponents);
+    }
+  else if ( byteOrder == ImageIOBase::LittleEndian )
+    {
+    ByteSwapper< T >::SwapRangeFromSystemToLittleEndian(static_cast< T * >( buffer ), numberOfComponents);
+    }
+}
+}
+
 NrrdImageIO::NrrdImageIO()
 {
+  m_DataCanBeStreamed = false;
+  m_DataIsCompressed = false;
+  m_DataPosition = 0;
   this->SetNumberOfDimensions(3);
   this->AddSupportedWriteExtension(".nrrd");
   this->AddSupportedReadExtension(".nrrd");
@@ -55,6 +80,7 @@ bool NrrdImageIO::SupportsDimension(unsigned long dim)
 void NrrdImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "DataCanBeStreamed: " << ( m_DataCanBeStreamed ? "On" : "Off" ) << std::endl;
 }
 
 ImageIOBase::IOComponentType
@@ -245,8 +271,14 @@ void NrrdImageIO::ReadImageInformation()
     FloatingPointExceptions::Disable();
 
     // this is the mechanism by which we tell nrrdLoad to read
-    // just the header, and none of the data
+    // just the header, and none of the data; a single data file is
+    // kept open at the beginning of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+    m_DataCanBeStreamed = false;
+    m_DataIsCompressed = false;
+    m_DataFileName = "";
+    m_DataPosition = 0;
     if ( nrrdLoad(nrrd, this->GetFileName(), nio) != 0 )
       {
       char *err = biffGetDone(NRRD);
@@ -263,6 +295,13 @@ void NrrdImageIO::ReadImageInformation()
     // restore state
     FloatingPointExceptions::SetEnabled(saveFPEState);
 
+    long dataPosition = -1;
+    if ( nio->dataFile )
+      {
+      dataPosition = ftell(nio->dataFile);
+      nio->dataFile = airFclose(nio->dataFile);
+      }
+
     if ( nrrdTypeBlock == nrrd->type )
       {
       itkExceptionMacro("ReadImageInformation: Cannot currently "
@@ -683,6 +722,45 @@ void NrrdImageIO::ReadImageInformation()
                                                                   msrFrame);
       }
 
+    // The data can be read region by region when the pixels are stored
+    // in the order of ITK, in a single data file, and either raw or
+    // compressed with a block index.
+    if ( dataPosition >= 0 && !nio->dataFNFormat && nio->dataFNArr->len <= 1
+         && ( 0 == rangeAxisNum || 0 == rangeAxisIdx[0] )
+         && ImageIOBase::SYMMETRICSECONDRANKTENSOR != this->GetPixelType() )
+      {
+      if ( 0 == nio->dataFNArr->len )
+        {
+        m_DataFileName = this->GetFileName();
+        }
+      else if ( strcmp(nio->dataFN[0], "-") )
+        {
+        // detached data files are relative to the header
+        m_DataFileName = nio->dataFN[0];
+        if ( !itksys::SystemTools::FileIsFullPath( m_DataFileName.c_str() ) && airStrlen(nio->path) )
+          {
+          m_DataFileName = std::string(nio->path) + "/" + m_DataFileName;
+          }
+        }
+      m_DataPosition = static_cast< SizeValueType >( dataPosition );
+
+      if ( m_DataFileName.empty() )
+        {
+        // the data is read from the standard input
+        }
+      else if ( nio->encoding == nrrdEncodingRaw )
+        {
+        m_DataCanBeStreamed = true;
+        }
+      else if ( nio->encoding == nrrdEncodingGzip && 0 == nio->byteSkip )
+        {
+        std::ifstream dataFile(m_DataFileName.c_str(), std::ios::in | std::ios::binary);
+        dataFile.seekg(static_cast< std::streamoff >( m_DataPosition ), std::ios::beg);
+        m_DataCanBeStreamed = dataFile.good() && GzipBlockCompressor::HasBlockIndex(dataFile);
+        m_DataIsCompressed = true;
+        }
+      }
+
     nrrd = nrrdNix(nrrd);
     nio = nrrdIoStateNix(nio);
     }
@@ -697,8 +775,126 @@ void NrrdImageIO::ReadImageInformation()
     }
 }
 
+ImageIORegion
+NrrdImageIO
+::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if ( !m_UseStreamedReading || !m_DataCanBeStreamed )
+    {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+    }
+  return requestedRegion;
+}
+
+void NrrdImageIO::ReadDataRegion(void *buffer)
+{
+  std::ifstream dataFile(m_DataFileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !dataFile )
+    {
+    itkExceptionMacro("Read: Could not open data file " << m_DataFileName);
+    }
+  dataFile.seekg(static_cast< std::streamoff >( m_DataPosition ), std::ios::beg);
+
+  // the rows of the region, rows which follow each other in the file
+  // are merged
+  const unsigned int           nDims = this->GetNumberOfDimensions();
+  const unsigned int           regionDims = m_IORegion.GetImageDimension();
+  std::vector< SizeValueType > strides(nDims);
+  std::vector< SizeValueType > start(nDims, 0);
+  std::vector< SizeValueType > size(nDims, 1);
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    strides[i] = ( i == 0 ) ? this->GetPixelSize() : strides[i - 1] * this->GetDimensions(i - 1);
+    if ( i < regionDims )
+      {
+      start[i] = m_IORegion.GetIndex()[i];
+      size[i] = m_IORegion.GetSize()[i];
+      }
+    }
+
+  const SizeValueType rowSize = size[0] * strides[0];
+  SizeValueType       numberOfRows = 1;
+  for ( unsigned int i = 1; i < nDims; i++ )
+    {
+    numberOfRows *= size[i];
+    }
+
+  GzipBlockCompressor::RangeContainerType ranges;
+  std::vector< SizeValueType >            position(start);
+  for ( SizeValueType row = 0; row < numberOfRows && rowSize > 0; ++row )
+    {
+    SizeValueType offset = 0;
+    for ( unsigned int i = 0; i < nDims; i++ )
+      {
+      offset += position[i] * strides[i];
+      }
+    if ( !ranges.empty() && ranges.back().first + ranges.back().second == offset )
+      {
+      ranges.back().second += rowSize;
+      }
+    else
+      {
+      ranges.push_back( GzipBlockCompressor::RangeType(offset, rowSize) );
+      }
+
+    for ( unsigned int i = 1; i < nDims; i++ )
+      {
+      if ( ++position[i] < start[i] + size[i] )
+        {
+        break;
+        }
+      position[i] = start[i];
+      }
+    }
+
+  if ( m_DataIsCompressed )
+    {
+    // only the blocks holding the region are inflated, in parallel
+    GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+    compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+    compressor->DecompressRanges(dataFile, ranges, buffer);
+    }
+  else
+    {
+    char *p = static_cast< char * >( buffer );
+    for ( GzipBlockCompressor::RangeContainerType::const_iterator it = ranges.begin(); it != ranges.end(); ++it )
+      {
+      dataFile.seekg(static_cast< std::streamoff >( m_DataPosition + it->first ), std::ios::beg);
+      if ( !dataFile.read( p, static_cast< std::streamsize >( it->second ) ) )
+        {
+        itkExceptionMacro("Read: Error reading " << it->second << " bytes of data from " << m_DataFileName);
+        }
+      p += it->second;
+      }
+    }
+
+  const SizeValueType numberOfComponents = m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+  switch ( this->GetComponentSize() )
+    {
+    case 2:
+      SwapRangeFromFile< uint16_t >(buffer, numberOfComponents, this->GetByteOrder());
+      break;
+    case 4:
+      SwapRangeFromFile< uint32_t >(buffer, numberOfComponents, this->GetByteOrder());
+      break;
+    case 8:
+      SwapRangeFromFile< uint64_t >(buffer, numberOfComponents, this->GetByteOrder());
+      break;
+    default:
+      break;
+    }
+}
+
 void NrrdImageIO::Read(void *buffer)
 {
+  // raw data, and compressed data with a block index, are read straight
+  // into the buffer, without the copy of NrrdIO
+  if ( m_DataCanBeStreamed )
+    {
+    this->ReadDataRegion(buffer);
+    return;
+    }
+
   Nrrd *       nrrd = nrrdNew();
   unsigned int baseDim;
   bool         nrrdAllocated;
@@ -1113,6 +1309,18 @@ void NrrdImageIO::Write(const void *buffer)
       break;
     }
 
+  // The blocks of the compressed data of an attached header are
+  // deflated in parallel, in a gzip member which NrrdIO inflates as any
+  // other gzip data; NrrdIO only writes the header.
+  const bool compressInParallel = nio->encoding == nrrdEncodingGzip
+                                  && m_NumberOfCompressionThreads > 1
+                                  && itksys::SystemTools::LowerCase(
+                                    itksys::SystemTools::GetFilenameLastExtension(m_FileName) ) == ".nrrd";
+  if ( compressInParallel )
+    {
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    }
+
   // Write the nrrd to file.
   if ( nrrdSave(this->GetFileName(), nrrd, nio) )
     {
@@ -1121,6 +1329,39 @@ void NrrdImageIO::Write(const void *buffer)
                       << this->GetFileName() << ":\n" << err);
     }
 
+  if ( compressInParallel )
+    {
+    // the blocks hold whole rows, or whole slices when they are small
+    // enough, so that a streamed read of a region inflates few blocks
+    GzipBlockCompressor::Pointer compressor = GzipBlockCompressor::New();
+    SizeValueType                sliceSize = this->GetPixelSize() * this->GetDimensions(0);
+    for ( unsigned int i = 1; i < this->GetNumberOfDimensions()
+          && sliceSize * this->GetDimensions(i) <= compressor->GetBlockSize(); i++ )
+      {
+      sliceSize *= this->GetDimensions(i);
+      }
+    if ( sliceSize > 0 )
+      {
+      compressor->SetBlockSize( sliceSize * std::max( compressor->GetBlockSize() / sliceSize,
+                                                      static_cast< SizeValueType >( 1 ) ) );
+      }
+    compressor->SetNumberOfThreads(m_NumberOfCompressionThreads);
+    if ( m_CompressionLevel >= 0 )
+      {
+      compressor->SetCompressionLevel(m_CompressionLevel);
+      }
+    std::vector< char > member;
+    compressor->Compress(buffer, static_cast< SizeValueType >( nrrdElementNumber(nrrd) * nrrdElementSize(nrrd) ),
+                         member);
+
+    std::ofstream file(m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    file.write( &member[0], member.size() );
+    if ( !file )
+      {
+      itkExceptionMacro("Write: Error writing the data of " << this->GetFileName());
+      }
+    }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrd = nrrdNix(nrrd);
   nio = nrrdIoStateNix(nio);
@@ -0,0 +1,242 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNrrdImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+#include "NrrdIO.h"
+
+namespace
+{
+typedef itk::Image< short, 3 >                               ImageType;
+typedef itk::ImageFileReader< ImageType >                    ReaderType;
+typedef itk::StreamingImageFilter< ImageType, ImageType >    StreamerType;
+
+short ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast< short >( index[0] + 50 * index[1] - 1300 * index[2] );
+}
+
+bool Write(ImageType *image, const std::string & fileName, bool useCompression,
+           itk::ThreadIdType numberOfThreads)
+{
+  itk::NrrdImageIO::Pointer io = itk::NrrdImageIO::New();
+  io->SetNumberOfCompressionThreads(numberOfThreads);
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetImageIO(io);
+  writer->SetUseCompression(useCompression);
+  try
+    {
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// read the file in pieces, and check that the ImageIO streams when
+// expected
+bool ReadStreamed(const std::string & fileName, unsigned int numberOfDivisions, bool streamable)
+{
+  itk::NrrdImageIO::Pointer io = itk::NrrdImageIO::New();
+  io->SetNumberOfCompressionThreads(3);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->SetUseStreaming(true);
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( reader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfDivisions);
+  try
+    {
+    streamer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+
+  if ( io->CanStreamRead() != streamable )
+    {
+    std::cerr << "ERROR: " << fileName << " can " << ( streamable ? "not " : "" ) << "be streamed" << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( streamer->GetOutput(),
+                                                          streamer->GetOutput()->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << " in " << fileName << " read in "
+                << numberOfDivisions << " pieces" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// read the file in one piece, without the streaming of the reader
+bool ReadNotStreamed(const std::string & fileName)
+{
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO( itk::NrrdImageIO::New() );
+  reader->SetUseStreaming(false);
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( reader->GetOutput(),
+                                                          reader->GetOutput()->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << " in " << fileName
+                << " read without streaming" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// read the file with NrrdIO alone, as a reader that knows nothing of
+// the block index would
+bool ReadWithNrrdIO(const std::string & fileName, const ImageType::SizeType & size)
+{
+  Nrrd *nrrd = nrrdNew();
+  if ( nrrdLoad(nrrd, fileName.c_str(), NULL) != 0 )
+    {
+    char *err = biffGetDone(NRRD);
+    std::cerr << "ERROR: NrrdIO can not read " << fileName << ":\n" << err << std::endl;
+    free(err);
+    nrrdNuke(nrrd);
+    return false;
+    }
+
+  bool ok = nrrd->dim == 3 && nrrd->type == nrrdTypeShort;
+  for ( unsigned int d = 0; ok && d < 3; ++d )
+    {
+    ok = nrrd->axis[d].size == size[d];
+    }
+  if ( !ok )
+    {
+    std::cerr << "ERROR: NrrdIO read wrong dimensions or type in " << fileName << std::endl;
+    nrrdNuke(nrrd);
+    return false;
+    }
+
+  const short *       data = static_cast< const short * >( nrrd->data );
+  ImageType::IndexType index;
+  for ( index[2] = 0; index[2] < static_cast< ImageType::IndexValueType >( size[2] ); ++index[2] )
+    {
+    for ( index[1] = 0; index[1] < static_cast< ImageType::IndexValueType >( size[1] ); ++index[1] )
+      {
+      for ( index[0] = 0; index[0] < static_cast< ImageType::IndexValueType >( size[0] ); ++index[0] )
+        {
+        if ( *data++ != ExpectedValue(index) )
+          {
+          std::cerr << "ERROR: wrong value at " << index << " in " << fileName << " read by NrrdIO" << std::endl;
+          nrrdNuke(nrrd);
+          return false;
+          }
+        }
+      }
+    }
+  nrrdNuke(nrrd);
+  return true;
+}
+}
+
+int itkNrrdImageIOStreamingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 37;
+  size[2] = 29;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue( it.GetIndex() ) );
+    }
+
+  // raw data, attached or detached, is streamed; compressed data only
+  // when its blocks were deflated in parallel, whatever the case of the
+  // extension. All the files are still read without streaming, and by
+  // NrrdIO alone.
+  const char *              fileNames[] = { "/itkNrrdImageIOStreamingTest.nrrd",
+                                            "/itkNrrdImageIOStreamingTest.nhdr",
+                                            "/itkNrrdImageIOStreamingTestGzip.nrrd",
+                                            "/itkNrrdImageIOStreamingTestGzipBlocks.nrrd",
+                                            "/itkNrrdImageIOStreamingTestGzipBlocksUpper.NRRD" };
+  const bool                useCompression[] = { false, false, true, true, true };
+  const itk::ThreadIdType   numberOfThreads[] = { 1, 1, 1, 3, 3 };
+  const bool                streamable[] = { true, true, false, true, true };
+  const unsigned int        divisions[] = { 1, 4, 29 };
+  for ( unsigned int f = 0; f < 5; ++f )
+    {
+    const std::string fileName = directory + fileNames[f];
+    if ( !Write(image, fileName, useCompression[f], numberOfThreads[f]) )
+      {
+      return EXIT_FAILURE;
+      }
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      if ( !ReadStreamed(fileName, divisions[d], streamable[f]) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    if ( !ReadNotStreamed(fileName) || !ReadWithNrrdIO(fileName, size) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
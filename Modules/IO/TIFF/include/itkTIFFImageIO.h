@@ -19,6 +19,7 @@
 #define __itkTIFFImageIO_h
 
 #include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
 #include <fstream>
 
 #include "itk_tiff.h"
@@ -33,6 +34,16 @@ class TIFFReaderInternal;
  *
  * \brief ImageIO object for reading and writing TIFF images
  *
+ * Grayscale and RGB images which are uncompressed, or compressed with
+ * PackBits or LZW, can be streamed: only the tiles or the strips which
+ * hold the requested region are decoded, in parallel when
+ * NumberOfCompressionThreads is greater than 1. Tiled images are read
+ * the same way.
+ *
+ * Images are written in strips, or in tiles when TileWidth and
+ * TileHeight are set. Writing can be streamed by whole pages, or by
+ * bands of rows which hold whole rows of tiles.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOTIFF
@@ -73,6 +84,18 @@ public:
   /** Reads 3D data from tiled tiff. */
   virtual void ReadTiles(void *buffer);
 
+  /** Determine if the ImageIO can stream reading from the file. This
+   * is only known after ReadImageInformation. */
+  virtual bool CanStreamRead()
+  {
+    return m_CanStreamReadFile;
+  }
+
+  /** Return the requested region when streaming is used and the file
+   * can be streamed, the largest possible region otherwise. */
+  virtual ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -87,6 +110,34 @@ public:
    * that the IORegion has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** Writing can be streamed by whole pages, or by bands of whole rows,
+   * written one after the other. Pasting a region in an existing file
+   * is not supported. */
+  virtual bool CanStreamWrite()
+  {
+    return true;
+  }
+
+  virtual unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion);
+
+  virtual ImageIORegion
+  GetSplitRegionForWriting(unsigned int ithPiece,
+                           unsigned int numberOfActualSplits,
+                           const ImageIORegion & pasteRegion,
+                           const ImageIORegion & largestPossibleRegion);
+
+  /** Set/Get the size of the tiles of the written images. The image is
+   * written in strips when either is 0, which is the default. TIFF
+   * requires tile sizes which are multiples of 16, other sizes are
+   * rounded up. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
   enum { NOFORMAT, RGB_, GRAYSCALE, PALETTE_RGB, PALETTE_GRAYSCALE, OTHER };
 
   //BTX
@@ -133,6 +184,27 @@ protected:
 
   void InternalWrite(const void *buffer);
 
+  /** Set the fields of a page of the written file. */
+  void WritePageInformation(TIFF *tif, unsigned int page, unsigned int pages);
+
+  /** Write rows of the current page, in strips or in whole rows of
+   * tiles. */
+  void WriteRows(TIFF *tif, const char *buffer, unsigned int firstRow,
+                 unsigned int numberOfRows);
+
+  /** The axis along which written images are split, and the number of
+   * rows or pages of the pieces must be a multiple of unitSize. */
+  void GetWritingSplitAxis(const ImageIORegion & largestPossibleRegion,
+                           unsigned int & axis, SizeValueType & unitSize) const;
+
+  /** Decode the tiles, or the strips, which hold the IORegion and copy
+   * their pixels in buffer. The tiles and strips are decoded in parallel
+   * by NumberOfCompressionThreads threads, each one with its own handle
+   * on the file. */
+  void ReadIORegion(void *buffer);
+
+  static ITK_THREAD_RETURN_TYPE ReadIORegionThreaderCallback(void *arg);
+
   void InitializeColors();
 
   void ReadGenericImage(void *out,
@@ -166,6 +238,9 @@ protected:
 
   int m_Compression;
 
+  unsigned int m_TileWidth;
+  unsigned int m_TileHeight;
+
 private:
   TIFFImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -175,6 +250,11 @@ private:
   unsigned short *m_ColorBlue;
   int             m_TotalColors;
   unsigned int    m_ImageFormat;
+
+  bool m_CanStreamReadFile;
+
+  /** The file written by successive pieces of a streamed write. */
+  TIFF *m_StreamedFile;
 };
 } // end namespace itk
 
@@ -20,9 +20,41 @@
 #include "itksys/SystemTools.hxx"
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace itk
 {
+namespace
+{
+// a tile, or a strip, of a page holding a part of the IORegion
+struct TIFFRegionPiece {
+  unsigned int Page;
+  unsigned int FirstRow;
+  unsigned int FirstColumn;
+  unsigned int NumberOfRows;
+  unsigned int NumberOfColumns;
+};
+
+// the tile or strip sizes given to libtiff are multiples of 16
+unsigned int RoundTileSize(unsigned int size)
+{
+  return ( size + 15 ) / 16 * 16;
+}
+
+// the state shared by the threads which read the IORegion
+struct TIFFReadIORegionStruct {
+  TIFFImageIO *                   ImageIO;
+  char *                          Buffer;
+  std::vector< TIFFRegionPiece >  Pieces;
+  std::vector< char >             ThreadSucceeded;
+  unsigned int                    FirstPage;
+  unsigned int                    FirstFileRow;
+  unsigned int                    NumberOfFileRows;
+};
+}
+
 class TIFFReaderInternal
 {
 public:
@@ -1370,6 +1402,222 @@ void TIFFImageIO::ReadVolume(void *buffer)
     }
 }
 
+void TIFFImageIO::ReadIORegion(void *buffer)
+{
+  TIFF *             tif = m_InternalImage->m_Image;
+  const unsigned int width = m_InternalImage->m_Width;
+  const unsigned int height = m_InternalImage->m_Height;
+
+  // the IORegion, a 2D region of a multi-pages file is on the first page
+  unsigned int index[3] = { 0, 0, 0 };
+  unsigned int size[3] = { 1, 1, 1 };
+  for ( unsigned int i = 0; i < m_IORegion.GetImageDimension() && i < 3; i++ )
+    {
+    index[i] = static_cast< unsigned int >( m_IORegion.GetIndex()[i] );
+    size[i] = static_cast< unsigned int >( m_IORegion.GetSize()[i] );
+    }
+
+  // rows are stored from the bottom when the orientation is not top left
+  TIFFReadIORegionStruct str;
+  str.ImageIO = this;
+  str.Buffer = static_cast< char * >( buffer );
+  str.FirstPage = index[2];
+  str.FirstFileRow = index[1];
+  str.NumberOfFileRows = size[1];
+  if ( m_InternalImage->m_Orientation != ORIENTATION_TOPLEFT )
+    {
+    str.FirstFileRow = height - index[1] - size[1];
+    }
+
+  // the format of the pixels is evaluated before it is used by the threads
+  this->InitializeColors();
+  this->GetFormat();
+
+  for ( unsigned int page = index[2]; page < index[2] + size[2]; page++ )
+    {
+    if ( !TIFFSetDirectory( tif, static_cast< tdir_t >( page ) ) )
+      {
+      itkExceptionMacro(<< "Cannot read page " << page << " of " << m_FileName);
+      }
+    uint32 pageWidth = 0;
+    uint32 pageHeight = 0;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &pageWidth);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &pageHeight);
+    if ( pageWidth != width || pageHeight != height )
+      {
+      itkExceptionMacro(<< "Page " << page << " of " << m_FileName
+                        << " does not have the size of the first page");
+      }
+
+    uint32 pieceWidth = width;
+    uint32 pieceHeight = 0;
+    if ( TIFFIsTiled(tif) )
+      {
+      TIFFGetField(tif, TIFFTAG_TILEWIDTH, &pieceWidth);
+      TIFFGetField(tif, TIFFTAG_TILELENGTH, &pieceHeight);
+      }
+    else
+      {
+      TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &pieceHeight);
+      pieceHeight = std::min(pieceHeight, static_cast< uint32 >( height ) );
+      }
+    if ( pieceWidth == 0 || pieceHeight == 0 )
+      {
+      itkExceptionMacro(<< "Cannot read the tile or strip size of " << m_FileName);
+      }
+
+    const unsigned int lastFileRow = str.FirstFileRow + size[1];
+    const unsigned int lastColumn = index[0] + size[0];
+    for ( unsigned int row = str.FirstFileRow / pieceHeight * pieceHeight; row < lastFileRow;
+          row += pieceHeight )
+      {
+      for ( unsigned int column = index[0] / pieceWidth * pieceWidth; column < lastColumn;
+            column += pieceWidth )
+        {
+        TIFFRegionPiece piece;
+        piece.Page = page;
+        piece.FirstRow = row;
+        piece.FirstColumn = column;
+        piece.NumberOfRows = std::min( static_cast< unsigned int >( pieceHeight ), height - row );
+        piece.NumberOfColumns = std::min( static_cast< unsigned int >( pieceWidth ), width - column );
+        str.Pieces.push_back(piece);
+        }
+      }
+    }
+  TIFFSetDirectory(tif, 0);
+
+  if ( str.Pieces.empty() )
+    {
+    return;
+    }
+
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( m_NumberOfCompressionThreads ),
+              static_cast< SizeValueType >( str.Pieces.size() ) ) );
+  str.ThreadSucceeded.assign(numberOfThreads, 0);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(Self::ReadIORegionThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for ( ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    if ( !str.ThreadSucceeded[t] )
+      {
+      itkExceptionMacro(<< "Cannot read the tiles or strips of " << m_FileName);
+      }
+    }
+}
+
+ITK_THREAD_RETURN_TYPE TIFFImageIO::ReadIORegionThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  TIFFReadIORegionStruct *         str = static_cast< TIFFReadIORegionStruct * >( info->UserData );
+  Self *                           self = str->ImageIO;
+  TIFFReaderInternal *             internalImage = self->m_InternalImage;
+
+  // each thread decodes consecutive pieces with its own handle on the file
+  const SizeValueType numberOfPieces = str->Pieces.size();
+  const SizeValueType firstPiece = numberOfPieces * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType lastPiece = numberOfPieces * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+
+  TIFF *tif = TIFFOpen(self->m_FileName.c_str(), "r");
+  if ( !tif )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const bool         flipped = ( internalImage->m_Orientation != ORIENTATION_TOPLEFT );
+  const unsigned int regionColumn = static_cast< unsigned int >( self->m_IORegion.GetIndex()[0] );
+  const unsigned int regionWidth = static_cast< unsigned int >( self->m_IORegion.GetSize()[0] );
+  const unsigned int regionHeight = str->NumberOfFileRows;
+  const SizeValueType outputPixelSize = self->GetNumberOfComponents() * self->GetComponentSize();
+  const SizeValueType inputPixelSize = internalImage->m_SamplesPerPixel * internalImage->m_BitsPerSample / 8;
+
+  // the pixels are copied when EvaluateImageAt() would not change them
+  const unsigned int format = self->GetFormat();
+  const bool         copy =
+    ( format == TIFFImageIO::GRAYSCALE && internalImage->m_Photometrics == PHOTOMETRIC_MINISBLACK )
+    || ( format == TIFFImageIO::RGB_ && internalImage->m_SamplesPerPixel == 3
+         && ( self->m_ComponentType == UCHAR || self->m_ComponentType == CHAR
+              || self->m_ComponentType == USHORT ) );
+
+  bool         succeeded = true;
+  unsigned int currentPage = 0;
+  tdata_t      pieceBuffer = 0;
+  for ( SizeValueType p = firstPiece; p < lastPiece && succeeded; p++ )
+    {
+    const TIFFRegionPiece & piece = str->Pieces[p];
+    if ( !pieceBuffer || piece.Page != currentPage )
+      {
+      if ( !TIFFSetDirectory( tif, static_cast< tdir_t >( piece.Page ) ) )
+        {
+        succeeded = false;
+        break;
+        }
+      currentPage = piece.Page;
+      _TIFFfree(pieceBuffer);
+      pieceBuffer = _TIFFmalloc( TIFFIsTiled(tif) ? TIFFTileSize(tif) : TIFFStripSize(tif) );
+      if ( !pieceBuffer )
+        {
+        succeeded = false;
+        break;
+        }
+      }
+
+    SizeValueType rowSize;
+    if ( TIFFIsTiled(tif) )
+      {
+      rowSize = TIFFTileRowSize(tif);
+      succeeded = TIFFReadEncodedTile(tif, TIFFComputeTile(tif, piece.FirstColumn, piece.FirstRow, 0, 0),
+                                      pieceBuffer, static_cast< tsize_t >( -1 ) ) >= 0;
+      }
+    else
+      {
+      rowSize = TIFFScanlineSize(tif);
+      succeeded = TIFFReadEncodedStrip(tif, TIFFComputeStrip(tif, piece.FirstRow, 0),
+                                       pieceBuffer, static_cast< tsize_t >( -1 ) ) >= 0;
+      }
+
+    // copy the part of the piece which is in the region
+    const unsigned int firstRow = std::max(piece.FirstRow, str->FirstFileRow);
+    const unsigned int lastRow = std::min(piece.FirstRow + piece.NumberOfRows,
+                                          str->FirstFileRow + regionHeight);
+    const unsigned int firstColumn = std::max(piece.FirstColumn, regionColumn);
+    const unsigned int lastColumn = std::min(piece.FirstColumn + piece.NumberOfColumns,
+                                             regionColumn + regionWidth);
+    for ( unsigned int row = firstRow; row < lastRow && succeeded; row++ )
+      {
+      const unsigned int regionRow = flipped ? str->FirstFileRow + regionHeight - 1 - row
+                                             : row - str->FirstFileRow;
+      char *out = str->Buffer
+                  + ( ( static_cast< SizeValueType >( piece.Page - str->FirstPage ) * regionHeight + regionRow )
+                      * regionWidth + ( firstColumn - regionColumn ) ) * outputPixelSize;
+      char *in = static_cast< char * >( pieceBuffer ) + ( row - piece.FirstRow ) * rowSize
+                 + ( firstColumn - piece.FirstColumn ) * inputPixelSize;
+      if ( copy )
+        {
+        memcpy(out, in, ( lastColumn - firstColumn ) * outputPixelSize);
+        }
+      else
+        {
+        for ( unsigned int column = firstColumn; column < lastColumn; column++ )
+          {
+          self->EvaluateImageAt(out, in);
+          out += outputPixelSize;
+          in += inputPixelSize;
+          }
+        }
+      }
+    }
+
+  _TIFFfree(pieceBuffer);
+  TIFFClose(tif);
+  str->ThreadSucceeded[info->ThreadID] = succeeded;
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 void TIFFImageIO::Read(void *buffer)
 {
 
@@ -1389,6 +1637,24 @@ void TIFFImageIO::Read(void *buffer)
     return;
     }
 
+  // regions and tiled images are read from the tiles or strips which
+  // hold them, as are whole images decoded by several threads
+  if ( m_CanStreamReadFile )
+    {
+    bool wholeImage = true;
+    for ( unsigned int i = 0; i < m_IORegion.GetImageDimension() && i < m_NumberOfDimensions; i++ )
+      {
+      wholeImage = wholeImage && m_IORegion.GetIndex()[i] == 0
+                   && m_IORegion.GetSize()[i] == m_Dimensions[i];
+      }
+    if ( !wholeImage || TIFFIsTiled(m_InternalImage->m_Image) || m_NumberOfCompressionThreads > 1 )
+      {
+      this->ReadIORegion(buffer);
+      m_InternalImage->Clean();
+      return;
+      }
+    }
+
   // The IO region should be of dimensions 3 otherwise we read only the first
   // page
   if ( m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2 )
@@ -1491,6 +1757,11 @@ TIFFImageIO::TIFFImageIO()
 
   m_Compression = TIFFImageIO::PackBits;
 
+  m_TileWidth = 0;
+  m_TileHeight = 0;
+  m_CanStreamReadFile = false;
+  m_StreamedFile = NULL;
+
   this->AddSupportedWriteExtension(".tif");
   this->AddSupportedWriteExtension(".TIF");
   this->AddSupportedWriteExtension(".tiff");
@@ -1504,6 +1775,10 @@ TIFFImageIO::TIFFImageIO()
 
 TIFFImageIO::~TIFFImageIO()
 {
+  if ( m_StreamedFile )
+    {
+    TIFFClose(m_StreamedFile);
+    }
   m_InternalImage->Clean();
   delete m_InternalImage;
 }
@@ -1512,6 +1787,8 @@ void TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Compression: " << m_Compression << "\n";
+  os << indent << "TileWidth: " << m_TileWidth << "\n";
+  os << indent << "TileHeight: " << m_TileHeight << "\n";
 }
 
 void TIFFImageIO::InitializeColors()
@@ -1658,9 +1935,53 @@ void TIFFImageIO::ReadImageInformation()
     m_Origin[2] = 0.0;
     }
 
+  // the tiles or strips of grayscale and RGB pixels can be decoded
+  // independently, when every page is an image of the volume
+  const unsigned int format = this->GetFormat();
+  m_CanStreamReadFile = m_InternalImage->CanRead()
+                        && ( ( format == TIFFImageIO::GRAYSCALE && m_InternalImage->m_SamplesPerPixel == 1 )
+                             || ( format == TIFFImageIO::RGB_ && m_InternalImage->m_SamplesPerPixel >= 3 ) )
+                        && ( m_InternalImage->m_BitsPerSample != 32 || m_ComponentType == FLOAT )
+                        && m_InternalImage->m_IgnoredSubFiles == 0
+                        && ( m_InternalImage->m_SubFiles == 0
+                             || m_InternalImage->m_SubFiles == m_InternalImage->m_NumberOfPages )
+                        && m_InternalImage->m_NumberOfTiles <= 1;
+
   return;
 }
 
+ImageIORegion
+TIFFImageIO
+::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  ImageIORegion streamableRegion(this->m_NumberOfDimensions);
+
+  for ( unsigned int i = 0; i < this->m_NumberOfDimensions; i++ )
+    {
+    if ( m_UseStreamedReading && m_CanStreamReadFile )
+      {
+      // the other pages are not read
+      if ( i < requestedRegion.GetImageDimension() )
+        {
+        streamableRegion.SetIndex( i, requestedRegion.GetIndex(i) );
+        streamableRegion.SetSize( i, requestedRegion.GetSize(i) );
+        }
+      else
+        {
+        streamableRegion.SetIndex(i, 0);
+        streamableRegion.SetSize(i, 1);
+        }
+      }
+    else
+      {
+      streamableRegion.SetIndex(i, 0);
+      streamableRegion.SetSize(i, this->m_Dimensions[i]);
+      }
+    }
+
+  return streamableRegion;
+}
+
 bool TIFFImageIO::CanWriteFile(const char *name)
 {
   std::string filename = name;
@@ -1717,11 +2038,73 @@ void TIFFImageIO::Write(const void *buffer)
     }
 }
 
+void TIFFImageIO::GetWritingSplitAxis(const ImageIORegion & largestPossibleRegion,
+                                      unsigned int & axis, SizeValueType & unitSize) const
+{
+  // whole pages, or bands of whole rows of tiles
+  axis = 1;
+  if ( largestPossibleRegion.GetImageDimension() > 2 && largestPossibleRegion.GetSize(2) > 1 )
+    {
+    axis = 2;
+    }
+  unitSize = 1;
+  if ( axis == 1 && m_TileWidth > 0 && m_TileHeight > 0 )
+    {
+    unitSize = RoundTileSize(m_TileHeight);
+    }
+}
+
+unsigned int
+TIFFImageIO::GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  if ( pasteRegion != largestPossibleRegion )
+    {
+    itkExceptionMacro( "Pasting is not supported! Can't write:" << this->GetFileName() );
+    }
+
+  unsigned int  axis;
+  SizeValueType unitSize;
+  this->GetWritingSplitAxis(largestPossibleRegion, axis, unitSize);
+
+  const SizeValueType numberOfUnits = ( largestPossibleRegion.GetSize(axis) + unitSize - 1 ) / unitSize;
+  const SizeValueType numberOfSplits =
+    std::max( std::min( static_cast< SizeValueType >( numberOfRequestedSplits ), numberOfUnits ),
+              static_cast< SizeValueType >( 1 ) );
+  const SizeValueType unitsPerPiece = ( numberOfUnits + numberOfSplits - 1 ) / numberOfSplits;
+
+  return static_cast< unsigned int >( std::max( ( numberOfUnits + unitsPerPiece - 1 ) / unitsPerPiece,
+                                                static_cast< SizeValueType >( 1 ) ) );
+}
+
+ImageIORegion
+TIFFImageIO::GetSplitRegionForWriting(unsigned int ithPiece,
+                                      unsigned int numberOfActualSplits,
+                                      const ImageIORegion & itkNotUsed(pasteRegion),
+                                      const ImageIORegion & largestPossibleRegion)
+{
+  unsigned int  axis;
+  SizeValueType unitSize;
+  this->GetWritingSplitAxis(largestPossibleRegion, axis, unitSize);
+
+  const SizeValueType size = largestPossibleRegion.GetSize(axis);
+  const SizeValueType numberOfUnits = ( size + unitSize - 1 ) / unitSize;
+  const SizeValueType unitsPerPiece = ( numberOfUnits + numberOfActualSplits - 1 ) / numberOfActualSplits;
+  const SizeValueType first = std::min(ithPiece * unitsPerPiece * unitSize, size);
+  const SizeValueType last = std::min( ( ithPiece + 1 ) * unitsPerPiece * unitSize, size );
+
+  ImageIORegion splitRegion(largestPossibleRegion);
+  splitRegion.SetIndex(axis, largestPossibleRegion.GetIndex(axis) + first);
+  splitRegion.SetSize(axis, last - first);
+  return splitRegion;
+}
+
 void TIFFImageIO::InternalWrite(const void *buffer)
 {
-  char *outPtr = (char *)buffer;
+  const char *outPtr = static_cast< const char * >( buffer );
 
-  unsigned int width, height, page, pages = 1;
+  unsigned int width, height, pages = 1;
 
   width =  m_Dimensions[0];
   height = m_Dimensions[1];
@@ -1730,6 +2113,123 @@ void TIFFImageIO::InternalWrite(const void *buffer)
     pages = m_Dimensions[2];
     }
 
+  switch ( this->GetComponentType() )
+    {
+    case UCHAR:
+    case CHAR:
+    case USHORT:
+    case SHORT:
+    case FLOAT:
+      break;
+    default:
+      itkExceptionMacro(
+        << "TIFF supports unsigned/signed char, unsigned/signed short, and float");
+    }
+
+  // the pages, or the rows, of the IORegion; the file is opened by the
+  // first piece and closed by the last one
+  unsigned int firstPage = 0;
+  unsigned int numberOfPages = pages;
+  unsigned int firstRow = 0;
+  unsigned int numberOfRows = height;
+  if ( m_NumberOfDimensions == 3 && m_IORegion.GetImageDimension() > 2 && pages > 1 )
+    {
+    firstPage = static_cast< unsigned int >( m_IORegion.GetIndex(2) );
+    numberOfPages = static_cast< unsigned int >( m_IORegion.GetSize(2) );
+    }
+  else if ( m_IORegion.GetImageDimension() > 1 )
+    {
+    firstRow = static_cast< unsigned int >( m_IORegion.GetIndex(1) );
+    numberOfRows = static_cast< unsigned int >( m_IORegion.GetSize(1) );
+    }
+  const bool firstPiece = ( firstPage == 0 && firstRow == 0 );
+  const bool lastPiece = ( firstPage + numberOfPages == pages && firstRow + numberOfRows == height );
+
+  if ( firstPiece )
+    {
+    if ( m_StreamedFile )
+      {
+      TIFFClose(m_StreamedFile);
+      m_StreamedFile = NULL;
+      }
+
+    const char *mode = "w";
+
+    // If the size of the image if greater then 2GB then use big tiff
+    const SizeType oneKiloByte = 1024;
+    const SizeType oneMegaByte = 1024 * oneKiloByte;
+    const SizeType oneGigaByte = 1024 * oneMegaByte;
+    const SizeType twoGigaBytes = 2 * oneGigaByte;
+
+    if ( this->GetImageSizeInBytes() > twoGigaBytes )
+      {
+#ifdef TIFF_INT64_T  // detect if libtiff4
+      // Adding the "8" option enables the use of big tiff
+      mode = "w8";
+#else
+      itkExceptionMacro( << "Size of image exceeds the limit of libtiff." );
+#endif
+      }
+
+    m_StreamedFile = TIFFOpen(m_FileName.c_str(), mode );
+    if ( !m_StreamedFile )
+      {
+      itkExceptionMacro( "Error while trying to open file for writing: "
+                         << this->GetFileName()
+                         << std::endl
+                         << "Reason: "
+                         << itksys::SystemTools::GetLastSystemError() );
+      }
+
+    if ( this->GetComponentType() == SHORT
+         || this->GetComponentType() == CHAR )
+      {
+      TIFFSetField(m_StreamedFile, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
+      }
+    else if ( this->GetComponentType() == FLOAT )
+      {
+      TIFFSetField(m_StreamedFile, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
+      }
+
+    if ( m_NumberOfDimensions == 3 )
+      {
+      TIFFCreateDirectory(m_StreamedFile);
+      }
+    }
+  else if ( !m_StreamedFile )
+    {
+    itkExceptionMacro(<< "The pieces of " << m_FileName << " must be written in order");
+    }
+
+  TIFF *tif = m_StreamedFile;
+
+  const SizeValueType rowLength = this->GetComponentSize() * this->GetNumberOfComponents() * width;
+
+  for ( unsigned int page = firstPage; page < firstPage + numberOfPages; page++ )
+    {
+    if ( firstRow == 0 )
+      {
+      this->WritePageInformation(tif, page, pages);
+      }
+
+    this->WriteRows(tif, outPtr, firstRow, numberOfRows);
+    outPtr += rowLength * numberOfRows;
+
+    if ( m_NumberOfDimensions == 3 && firstRow + numberOfRows == height )
+      {
+      TIFFWriteDirectory(tif);
+      }
+    }
+
+  if ( lastPiece )
+    {
+    TIFFClose(tif);
+    m_StreamedFile = NULL;
+    }
+}
+
+void TIFFImageIO::WritePageInformation(TIFF *tif, unsigned int page, unsigned int pages)
+{
   int    scomponents = this->GetNumberOfComponents();
   float  resolution_x = static_cast< float >( m_Spacing[0] != 0.0 ? 25.4 / m_Spacing[0] : 0.0);
   float  resolution_y = static_cast< float >( m_Spacing[1] != 0.0 ? 25.4 / m_Spacing[1] : 0.0);
@@ -1760,34 +2260,16 @@ void TIFFImageIO::InternalWrite(const void *buffer)
 
   int predictor;
 
-  const char *mode = "w";
-
-  // If the size of the image if greater then 2GB then use big tiff
-  const SizeType oneKiloByte = 1024;
-  const SizeType oneMegaByte = 1024 * oneKiloByte;
-  const SizeType oneGigaByte = 1024 * oneMegaByte;
-  const SizeType twoGigaBytes = 2 * oneGigaByte;
-
-  if ( this->GetImageSizeInBytes() > twoGigaBytes )
-    {
-#ifdef TIFF_INT64_T  // detect if libtiff4
-    // Adding the "8" option enables the use of big tiff
-    mode = "w8";
-#else
-    itkExceptionMacro( << "Size of image exceeds the limit of libtiff." );
-#endif
-    }
-
-  TIFF *tif = TIFFOpen(m_FileName.c_str(), mode );
-  if ( !tif )
-    {
-    itkExceptionMacro( "Error while trying to open file for writing: "
-                       << this->GetFileName()
-                       << std::endl
-                       << "Reason: "
-                       << itksys::SystemTools::GetLastSystemError() );
-    }
+  uint32 w = m_Dimensions[0];
+  uint32 h = m_Dimensions[1];
 
+  TIFFSetDirectory(tif, page);
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+  TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
   if ( this->GetComponentType() == SHORT
        || this->GetComponentType() == CHAR )
     {
@@ -1797,161 +2279,150 @@ void TIFFImageIO::InternalWrite(const void *buffer)
     {
     TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
     }
+  TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
 
-  uint32 w = width;
-  uint32 h = height;
-
-  if ( m_NumberOfDimensions == 3 )
-    {
-    TIFFCreateDirectory(tif);
-    }
-  for ( page = 0; page < pages; page++ )
+  if ( scomponents > 3 )
     {
-    TIFFSetDirectory(tif, page);
-    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
-    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
-    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
-    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
-    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-    if ( this->GetComponentType() == SHORT
-         || this->GetComponentType() == CHAR )
-      {
-      TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
-      }
-    else if ( this->GetComponentType() == FLOAT )
+    // if number of scalar components is greater than 3, that means we assume
+    // there is alpha.
+    uint16  extra_samples = scomponents - 3;
+    uint16 *sample_info = new uint16[scomponents - 3];
+    sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
+    int cc;
+    for ( cc = 1; cc < scomponents - 3; cc++ )
       {
-      TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
-      }
-    TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
-
-    if ( scomponents > 3 )
-      {
-      // if number of scalar components is greater than 3, that means we assume
-      // there is alpha.
-      uint16  extra_samples = scomponents - 3;
-      uint16 *sample_info = new uint16[scomponents - 3];
-      sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
-      int cc;
-      for ( cc = 1; cc < scomponents - 3; cc++ )
-        {
-        sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
-        }
-      TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples,
-                   sample_info);
-      delete[] sample_info;
+      sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
       }
+    TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples,
+                 sample_info);
+    delete[] sample_info;
+    }
 
-    int compression;
+  int compression;
 
-    if ( m_UseCompression )
-      {
-      switch ( m_Compression )
-        {
-        case TIFFImageIO::PackBits:
-          compression = COMPRESSION_PACKBITS; break;
-        case TIFFImageIO::JPEG:
-          compression = COMPRESSION_JPEG; break;
-        case TIFFImageIO::Deflate:
-          compression = COMPRESSION_DEFLATE; break;
-        case TIFFImageIO::LZW:
-          compression = COMPRESSION_LZW; break;
-        default:
-          compression = COMPRESSION_NONE;
-        }
-      }
-    else
+  if ( m_UseCompression )
+    {
+    switch ( m_Compression )
       {
-      compression = COMPRESSION_NONE;
+      case TIFFImageIO::PackBits:
+        compression = COMPRESSION_PACKBITS; break;
+      case TIFFImageIO::JPEG:
+        compression = COMPRESSION_JPEG; break;
+      case TIFFImageIO::Deflate:
+        compression = COMPRESSION_DEFLATE; break;
+      case TIFFImageIO::LZW:
+        compression = COMPRESSION_LZW; break;
+      default:
+        compression = COMPRESSION_NONE;
       }
+    }
+  else
+    {
+    compression = COMPRESSION_NONE;
+    }
 
-    TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
 
-    uint16 photometric = ( scomponents == 1 ) ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB;
+  uint16 photometric = ( scomponents == 1 ) ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB;
 
-    if ( compression == COMPRESSION_JPEG )
-      {
-      TIFFSetField(tif, TIFFTAG_JPEGQUALITY, 75); // Parameter
-      TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
-      photometric = PHOTOMETRIC_YCBCR;
-      }
-    else if ( compression == COMPRESSION_LZW )
-      {
-      predictor = 2;
-      TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
-      itkDebugMacro(<< "LZW compression is patented outside US so it is disabled");
-      }
-    else if ( compression == COMPRESSION_DEFLATE )
-      {
-      predictor = 2;
-      TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
-      }
+  if ( compression == COMPRESSION_JPEG )
+    {
+    TIFFSetField(tif, TIFFTAG_JPEGQUALITY, 75); // Parameter
+    TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+    photometric = PHOTOMETRIC_YCBCR;
+    }
+  else if ( compression == COMPRESSION_LZW )
+    {
+    predictor = 2;
+    TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+    itkDebugMacro(<< "LZW compression is patented outside US so it is disabled");
+    }
+  else if ( compression == COMPRESSION_DEFLATE )
+    {
+    predictor = 2;
+    TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+    }
 
-    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, photometric); // Fix for scomponents
+  TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, photometric); // Fix for scomponents
 
+  if ( m_TileWidth > 0 && m_TileHeight > 0 )
+    {
+    TIFFSetField( tif, TIFFTAG_TILEWIDTH, RoundTileSize(m_TileWidth) );
+    TIFFSetField( tif, TIFFTAG_TILELENGTH, RoundTileSize(m_TileHeight) );
+    }
+  else
+    {
     TIFFSetField( tif,
                   TIFFTAG_ROWSPERSTRIP,
                   TIFFDefaultStripSize(tif, rowsperstrip) );
+    }
 
-    if ( resolution_x > 0 && resolution_y > 0 )
-      {
-      TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
-      TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
-      TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
-      }
-
-    if ( m_NumberOfDimensions == 3 )
-      {
-      // We are writing single page of the multipage file
-      TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
-      // Set the page number
-      TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
-      }
-    int rowLength; // in bytes
+  if ( resolution_x > 0 && resolution_y > 0 )
+    {
+    TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
+    TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
+    TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+    }
 
-    switch ( this->GetComponentType() )
-      {
-      case UCHAR:
-        rowLength = sizeof( unsigned char );
-        break;
-      case USHORT:
-        rowLength = sizeof( unsigned short );
-        break;
-      case CHAR:
-        rowLength = sizeof( char );
-        break;
-      case SHORT:
-        rowLength = sizeof( short );
-        break;
-      case FLOAT:
-        rowLength = sizeof( float );
-        break;
-      default:
-        itkExceptionMacro(
-          << "TIFF supports unsigned/signed char, unsigned/signed short, and float");
-      }
+  if ( m_NumberOfDimensions == 3 )
+    {
+    // We are writing single page of the multipage file
+    TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
+    // Set the page number
+    TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
+    }
+}
 
-    rowLength *= this->GetNumberOfComponents();
-    rowLength *= width;
+void TIFFImageIO::WriteRows(TIFF *tif, const char *buffer, unsigned int firstRow,
+                            unsigned int numberOfRows)
+{
+  const unsigned int  width = m_Dimensions[0];
+  const SizeValueType pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+  const SizeValueType rowLength = pixelSize * width;
 
-    int row = 0;
-    for ( unsigned int idx2 = 0; idx2 < height; idx2++ )
+  if ( !TIFFIsTiled(tif) )
+    {
+    for ( unsigned int row = firstRow; row < firstRow + numberOfRows; row++ )
       {
-      if ( TIFFWriteScanline(tif, const_cast< char * >( outPtr ), row, 0) < 0 )
+      if ( TIFFWriteScanline(tif, const_cast< char * >( buffer ), row, 0) < 0 )
         {
         itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
-        break;
         }
-      outPtr += rowLength;
-      row++;
+      buffer += rowLength;
       }
+    return;
+    }
 
-    if ( m_NumberOfDimensions == 3 )
+  // the rows hold whole rows of tiles, the tiles past the border of the
+  // image are padded with zeros
+  uint32 tileWidth = 0;
+  uint32 tileHeight = 0;
+  TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tileWidth);
+  TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileHeight);
+
+  std::vector< char > tile(tileWidth * tileHeight * pixelSize);
+  for ( unsigned int row = 0; row < numberOfRows; row += tileHeight )
+    {
+    const unsigned int rows = std::min( static_cast< unsigned int >( tileHeight ), numberOfRows - row );
+    for ( unsigned int column = 0; column < width; column += tileWidth )
       {
-      TIFFWriteDirectory(tif);
+      const unsigned int columns = std::min( static_cast< unsigned int >( tileWidth ), width - column );
+      if ( rows < tileHeight || columns < tileWidth )
+        {
+        std::fill(tile.begin(), tile.end(), 0);
+        }
+      for ( unsigned int r = 0; r < rows; r++ )
+        {
+        memcpy(&tile[r * tileWidth * pixelSize],
+               buffer + ( row + r ) * rowLength + column * pixelSize,
+               columns * pixelSize);
+        }
+      if ( TIFFWriteTile(tif, &tile[0], column, firstRow + row, 0, 0) < 0 )
+        {
+        itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        }
       }
     }
-  TIFFClose(tif);
 }
 
 bool TIFFImageIO::CanFindTIFFTag(unsigned int t)
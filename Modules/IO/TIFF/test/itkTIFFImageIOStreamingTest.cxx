@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTIFFImageIO.h"
+
+namespace
+{
+template< class TImage >
+typename TImage::PixelType ExpectedValue(const typename TImage::IndexType & index)
+{
+  typename TImage::IndexValueType value = 3 * index[0] + 7 * index[1];
+  if ( TImage::ImageDimension > 2 )
+    {
+    value += 1000 * index[TImage::ImageDimension - 1];
+    }
+  return static_cast< typename TImage::PixelType >( value );
+}
+
+template< class TImage >
+bool CheckImage(const TImage *image, const typename TImage::RegionType & region)
+{
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << "ERROR: " << image->GetBufferedRegion() << " was read instead of "
+              << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(image, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue< TImage >( it.GetIndex() ) )
+      {
+      std::cerr << "ERROR: wrong value at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// write the image in several pieces, then read it whole and read a
+// region, with one and several threads
+template< class TImage >
+bool WriteAndRead(const std::string & fileName, const typename TImage::SizeType & size,
+                  const typename TImage::RegionType & region, unsigned int tileSize)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue< TImage >( it.GetIndex() ) );
+    }
+
+  itk::TIFFImageIO::Pointer writerIO = itk::TIFFImageIO::New();
+  writerIO->SetTileWidth(tileSize);
+  writerIO->SetTileHeight(tileSize);
+
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetImageIO(writerIO);
+  writer->SetNumberOfStreamDivisions(3);
+  writer->UseCompressionOn();
+  writer->Update();
+
+  const itk::ThreadIdType numberOfThreads[] = { 1, 4 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    typedef itk::ImageFileReader< TImage > ReaderType;
+    itk::TIFFImageIO::Pointer readerIO = itk::TIFFImageIO::New();
+    readerIO->SetNumberOfCompressionThreads(numberOfThreads[t]);
+    typename ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(readerIO);
+    reader->Update();
+    if ( !CheckImage< TImage >( reader->GetOutput(), image->GetBufferedRegion() ) )
+      {
+      std::cerr << "ERROR: " << fileName << " read with " << numberOfThreads[t] << " threads" << std::endl;
+      return false;
+      }
+
+    readerIO = itk::TIFFImageIO::New();
+    readerIO->SetNumberOfCompressionThreads(numberOfThreads[t]);
+    reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(readerIO);
+    reader->UseStreamingOn();
+    reader->UpdateOutputInformation();
+    if ( !readerIO->CanStreamRead() )
+      {
+      std::cerr << "ERROR: " << fileName << " can not be streamed" << std::endl;
+      return false;
+      }
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->GetOutput()->Update();
+    if ( !CheckImage< TImage >( reader->GetOutput(), region ) )
+      {
+      std::cerr << "ERROR: region of " << fileName << " read with " << numberOfThreads[t]
+                << " threads" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkTIFFImageIOStreamingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  try
+    {
+    // a tiled image, with tiles cut by the border of the image
+    typedef itk::Image< unsigned char, 2 > ImageType2D;
+    ImageType2D::SizeType size2D;
+    size2D[0] = 300;
+    size2D[1] = 200;
+    ImageType2D::RegionType region2D;
+    region2D.SetIndex(0, 50);
+    region2D.SetIndex(1, 30);
+    region2D.SetSize(0, 170);
+    region2D.SetSize(1, 150);
+    if ( !WriteAndRead< ImageType2D >(directory + "/itkTIFFImageIOStreamingTest.tif",
+                                      size2D, region2D, 64) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // a multi-pages image in strips
+    typedef itk::Image< short, 3 > ImageType3D;
+    ImageType3D::SizeType size3D;
+    size3D[0] = 100;
+    size3D[1] = 80;
+    size3D[2] = 6;
+    ImageType3D::RegionType region3D;
+    region3D.SetIndex(0, 10);
+    region3D.SetIndex(1, 20);
+    region3D.SetIndex(2, 2);
+    region3D.SetSize(0, 50);
+    region3D.SetSize(1, 40);
+    region3D.SetSize(2, 3);
+    if ( !WriteAndRead< ImageType3D >(directory + "/itkTIFFImageIOStreamingTest3D.tif",
+                                      size3D, region3D, 0) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -84,6 +84,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Map the IORegion from the file. Only binary files of scalar, vector
+   * or color pixels can be mapped, and the components must be single
+   * bytes on little endian systems since VTK files are big endian. */
+  virtual MemoryMappedFileRegion::Pointer MapIORegion();
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -591,6 +591,19 @@ void VTKImageIO::Read(void *buffer)
     }
 }
 
+MemoryMappedFileRegion::Pointer VTKImageIO::MapIORegion()
+{
+  if ( m_FileType == ASCII
+       || this->GetPixelType() == ImageIOBase::SYMMETRICSECONDRANKTENSOR
+       || ( this->GetComponentSize() > 1 && !ByteSwapper< uint16_t >::SystemIsBigEndian() ) )
+    {
+    return 0;
+    }
+
+  itkAssertOrThrowMacro(this->GetHeaderSize() != 0, "Header size is unknown when it shouldn't be!");
+  return this->MapIORegionFromFile( m_FileName, this->GetHeaderSize() );
+}
+
 void VTKImageIO::ReadImageInformation()
 {
   std::ifstream file;
@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkVTKImageIO.h"
+#include "itkImageFileWriter.h"
+#include "itkImageFileReader.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+// the streamed VTK files keep the byte order of the system, which the
+// reader only swaps when it reads the whole file
+typedef itk::Image< unsigned char, 3 >    ImageType;
+typedef itk::ImageFileWriter< ImageType > WriterType;
+typedef itk::ImageFileReader< ImageType > ReaderType;
+
+unsigned char ExpectedValue(const ImageType::IndexType & index, bool pasted)
+{
+  return static_cast< unsigned char >( ( index[0] + 7 * index[1] + 13 * index[2] + ( pasted ? 101 : 0 ) ) % 256 );
+}
+
+ImageType::Pointer CreateImage(bool pasted)
+{
+  ImageType::SizeType size;
+  size[0] = 67;
+  size[1] = 45;
+  size[2] = 23;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue(it.GetIndex(), pasted) );
+    }
+  return image;
+}
+
+// write the image read from inputFileName in pieces, the streamed
+// reader lets the writer stream
+bool Write(const std::string & inputFileName, const std::string & fileName, bool useDirectIO,
+           itk::ThreadIdType numberOfThreads, const itk::ImageIORegion *pasteRegion)
+{
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFileName);
+  reader->SetUseStreaming(true);
+
+  itk::VTKImageIO::Pointer io = itk::VTKImageIO::New();
+  io->SetUseDirectIO(useDirectIO);
+  io->SetNumberOfWritingThreads(numberOfThreads);
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput( reader->GetOutput() );
+  writer->SetImageIO(io);
+  writer->SetNumberOfStreamDivisions(5);
+  if ( pasteRegion )
+    {
+    writer->SetIORegion(*pasteRegion);
+    }
+  try
+    {
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+  return true;
+}
+
+std::string ReadFile(const std::string & fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  return std::string( std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >() );
+}
+}
+
+int itkVTKImageIODirectWriteTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+  const std::string imageFileName = directory + "/itkVTKImageIODirectWriteTestImage.vtk";
+  const std::string pastedImageFileName = directory + "/itkVTKImageIODirectWriteTestPastedImage.vtk";
+  const std::string bufferedFileName = directory + "/itkVTKImageIODirectWriteTestBuffered.vtk";
+  const std::string directFileName = directory + "/itkVTKImageIODirectWriteTest.vtk";
+
+  WriterType::Pointer writer = WriterType::New();
+  try
+    {
+    writer->SetInput( CreateImage(false) );
+    writer->SetFileName(imageFileName);
+    writer->Update();
+    writer->SetInput( CreateImage(true) );
+    writer->SetFileName(pastedImageFileName);
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a region whose lines are split in many chunks, which do not fill
+  // the pages of the file
+  itk::ImageIORegion pasteRegion(3);
+  pasteRegion.SetIndex(0, 3);
+  pasteRegion.SetIndex(1, 5);
+  pasteRegion.SetIndex(2, 2);
+  pasteRegion.SetSize(0, 20);
+  pasteRegion.SetSize(1, 11);
+  pasteRegion.SetSize(2, 7);
+
+  // the file written in parallel, with or without direct I/O, is the
+  // file written through the stream
+  if ( !Write(imageFileName, bufferedFileName, false, 1, NULL)
+       || !Write(pastedImageFileName, bufferedFileName, false, 1, &pasteRegion) )
+    {
+    return EXIT_FAILURE;
+    }
+  const std::string expected = ReadFile(bufferedFileName);
+
+  const bool               useDirectIO[] = { true, false, true };
+  const itk::ThreadIdType  numberOfThreads[] = { 1, 3, 3 };
+  for ( unsigned int t = 0; t < 3; ++t )
+    {
+    if ( !Write(imageFileName, directFileName, useDirectIO[t], numberOfThreads[t], NULL)
+         || !Write(pastedImageFileName, directFileName, useDirectIO[t], numberOfThreads[t], &pasteRegion) )
+      {
+      return EXIT_FAILURE;
+      }
+    if ( ReadFile(directFileName) != expected )
+      {
+      std::cerr << "ERROR: the file written with UseDirectIO " << useDirectIO[t] << " and "
+                << numberOfThreads[t] << " threads differs from the file written through the stream" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(directFileName);
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( reader->GetOutput(),
+                                                                reader->GetOutput()->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    bool                         pasted = true;
+    for ( unsigned int i = 0; i < 3; ++i )
+      {
+      pasted &= ( index[i] >= pasteRegion.GetIndex(i)
+                  && index[i] < pasteRegion.GetIndex(i) + static_cast< itk::IndexValueType >( pasteRegion.GetSize(i) ) );
+      }
+    if ( it.Get() != ExpectedValue(index, pasted) )
+      {
+      std::cerr << "ERROR: wrong value at " << index << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
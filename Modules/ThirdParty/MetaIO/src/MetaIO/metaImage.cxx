@@ -469,6 +469,9 @@ void MetaImage::Clear(void)
 
   m_ElementData = NULL;
 
+  m_CompressedElementData = NULL;
+  m_CompressedElementDataSize = 0;
+
   strcpy(m_ElementDataFileName, "");
 
   MetaObject::Clear();
@@ -922,6 +925,23 @@ AutoFreeElementData(bool _autoFreeElementData)
   m_AutoFreeElementData = _autoFreeElementData;
   }
 
+//
+//
+//
+const void * MetaImage::
+CompressedElementData(void) const
+  {
+  return m_CompressedElementData;
+  }
+
+void MetaImage::
+CompressedElementData(const void * _compressedData,
+                      METAIO_STL::streamoff _compressedDataSize)
+  {
+  m_CompressedElementData = _compressedData;
+  m_CompressedElementDataSize = _compressedDataSize;
+  }
+
 //
 //
 //
@@ -1628,7 +1648,11 @@ WriteStream(METAIO_STREAM::ofstream * _stream,
     MET_SizeOfType(m_ElementType, &elementSize);
     int elementNumberOfBytes = elementSize*m_ElementNumberOfChannels;
 
-    if(_constElementData == NULL)
+    if(m_CompressedElementData != NULL)
+      {
+      m_CompressedDataSize = m_CompressedElementDataSize;
+      }
+    else if(_constElementData == NULL)
       {
       compressedElementData = MET_PerformCompression(
                                   (const unsigned char *)m_ElementData,
@@ -1653,9 +1677,18 @@ WriteStream(METAIO_STREAM::ofstream * _stream,
     if(m_BinaryData && m_CompressedData && !strstr(m_ElementDataFileName, "%"))
       // compressed & !slice/file
       {
-      M_WriteElements(m_WriteStream,
-                      compressedElementData,
-                      m_CompressedDataSize);
+      if(m_CompressedElementData != NULL)
+        {
+        M_WriteElements(m_WriteStream,
+                        m_CompressedElementData,
+                        m_CompressedDataSize);
+        }
+      else
+        {
+        M_WriteElements(m_WriteStream,
+                        compressedElementData,
+                        m_CompressedDataSize);
+        }
 
       delete [] compressedElementData;
       m_CompressedDataSize = 0;
@@ -221,6 +221,15 @@ class METAIO_EXPORT MetaImage : public MetaObject
     bool   ElementData(METAIO_STL::streamoff _i, double _v);
     void   ElementData(void * _data, bool _autoFreeElementData=false);
 
+    //
+    //    CompressedElementData(...)
+    //       Compressed data written by Write() instead of compressing
+    //       the element data, which is then only used for the header.
+    //       The caller keeps the ownership of the data.
+    const void * CompressedElementData(void) const;
+    void   CompressedElementData(const void * _compressedData,
+                                 METAIO_STL::streamoff _compressedDataSize);
+
     //    ConverTo(...)
     //       Converts to a new data type
     //       Rescales using Min and Max (see above)
@@ -324,6 +333,9 @@ class METAIO_EXPORT MetaImage : public MetaObject
 
     void  *            m_ElementData;
 
+    const void *          m_CompressedElementData;
+    METAIO_STL::streamoff m_CompressedElementDataSize;
+
     char               m_ElementDataFileName[255];
 
 